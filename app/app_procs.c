@@ -1091,10 +1091,12 @@ internal_plugin_init (PluginInfo *info)
 
   /* register import filters */
   filter_register_import (&dia_import_filter);
+  filter_register_import (&dia_binary_import_filter);
 
   /* register export filters */
   /* Standard Dia format */
   filter_register_export (&dia_export_filter);
+  filter_register_export (&dia_binary_export_filter);
 
   return DIA_PLUGIN_INIT_OK;
 }
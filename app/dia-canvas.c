@@ -28,6 +28,7 @@
 #include "disp_callbacks.h"
 #include "toolbox.h"
 #include "diainteractiverenderer.h"
+#include "dia-render-profile.h"
 #include "interface.h"
 #include "object.h"
 
@@ -35,6 +36,9 @@ struct _DiaCanvas {
   GtkDrawingArea parent;
 
   DDisplay *display;
+
+  /* Where the render profile was last drawn */
+  GdkRectangle profile_area;
 };
 
 G_DEFINE_TYPE (DiaCanvas, dia_canvas, GTK_TYPE_DRAWING_AREA)
@@ -134,14 +138,66 @@ dia_canvas_configure_event (GtkWidget *widget, GdkEventConfigure *cevent)
 }
 
 
+/*
+ * Frame times in the top left corner, drawn straight onto the widget so
+ * they never end up in the renderer's own surface
+ */
+static void
+draw_profile (DiaCanvas *self, cairo_t *ctx, gboolean new_frame)
+{
+  PangoLayout *layout;
+  GdkRectangle clip, area;
+  char *summary = dia_render_profile_summary ();
+  int width, height;
+
+  if (!summary) {
+    return;
+  }
+
+  layout = gtk_widget_create_pango_layout (GTK_WIDGET (self), summary);
+  pango_layout_get_pixel_size (layout, &width, &height);
+
+  area.x = 4;
+  area.y = 4;
+  area.width = width + 8;
+  area.height = height + 8;
+
+  cairo_save (ctx);
+  cairo_rectangle (ctx, area.x, area.y, area.width, area.height);
+  cairo_set_source_rgba (ctx, 0.0, 0.0, 0.0, 0.7);
+  cairo_fill (ctx);
+  cairo_move_to (ctx, area.x + 4, area.y + 4);
+  cairo_set_source_rgb (ctx, 1.0, 1.0, 1.0);
+  pango_cairo_show_layout (ctx, layout);
+  cairo_restore (ctx);
+
+  /* Only part of the canvas was exposed, show the new numbers too.  That
+   * draw doesn't render a frame so this doesn't go round in circles */
+  if (new_frame &&
+      (!gdk_cairo_get_clip_rectangle (ctx, &clip) ||
+       clip.x > area.x || clip.y > area.y ||
+       clip.x + clip.width < area.x + area.width ||
+       clip.y + clip.height < area.y + area.height)) {
+    gdk_rectangle_union (&area, &self->profile_area, &area);
+    gtk_widget_queue_draw_area (GTK_WIDGET (self),
+                                area.x, area.y, area.width, area.height);
+  }
+  self->profile_area = area;
+
+  g_clear_object (&layout);
+  g_clear_pointer (&summary, g_free);
+}
+
+
 static gboolean
 dia_canvas_draw (GtkWidget *widget, cairo_t *ctx)
 {
   DiaCanvas *self = DIA_CANVAS (widget);
-  GSList *l;
-  DiaRectangle *r, totrect;
+  GArray *areas;
+  DiaRectangle totrect;
   GtkAllocation alloc;
   DiaRenderer *renderer;
+  gboolean rendered = FALSE;
 
   g_return_val_if_fail (self->display, FALSE);
   g_return_val_if_fail (self->display->renderer != NULL, FALSE);
@@ -149,23 +205,19 @@ dia_canvas_draw (GtkWidget *widget, cairo_t *ctx)
   renderer = self->display->renderer;
 
   /* Only update if update_areas exist */
-  l = self->display->update_areas;
-  if (l != NULL) {
-    totrect = *(DiaRectangle *) l->data;
+  areas = ddisplay_steal_update_areas (self->display);
+  if (areas != NULL) {
+    totrect = g_array_index (areas, DiaRectangle, 0);
 
     dia_interactive_renderer_clip_region_clear (DIA_INTERACTIVE_RENDERER (renderer));
 
-    while ( l!= NULL) {
-      r = (DiaRectangle *) l->data;
+    for (guint i = 0; i < areas->len; i++) {
+      DiaRectangle *r = &g_array_index (areas, DiaRectangle, i);
 
       rectangle_union (&totrect, r);
       dia_interactive_renderer_clip_region_add_rect (DIA_INTERACTIVE_RENDERER (renderer), r);
-
-      l = g_slist_next (l);
     }
-    /* Free update_areas list: */
-    g_slist_free_full (self->display->update_areas, g_free);
-    self->display->update_areas = NULL;
+    g_array_unref (areas);
 
     totrect.left -= 0.1;
     totrect.right += 0.1;
@@ -173,6 +225,7 @@ dia_canvas_draw (GtkWidget *widget, cairo_t *ctx)
     totrect.bottom += 0.1;
 
     ddisplay_render_pixmap (self->display, &totrect);
+    rendered = TRUE;
   }
 
   gtk_widget_get_allocation (widget, &alloc);
@@ -182,6 +235,10 @@ dia_canvas_draw (GtkWidget *widget, cairo_t *ctx)
                                   alloc.width,
                                   alloc.height);
 
+  if (dia_render_profile_enabled ()) {
+    draw_profile (self, ctx, rendered);
+  }
+
   return FALSE;
 }
 
@@ -29,6 +29,7 @@
 #include "focus.h"
 #include "message.h"
 #include "menus.h"
+#include "navigation.h"
 #include "preferences.h"
 #include "properties-dialog.h"
 #include "cut_n_paste.h"
@@ -300,7 +301,7 @@ diagram_load_into (Diagram         *diagram,
   if (ifilter->import_func (filename, diagram->data, ctx, ifilter->user_data)) {
     GFile *file = NULL;
 
-    if (ifilter != &dia_import_filter) {
+    if (ifilter != &dia_import_filter && ifilter != &dia_binary_import_filter) {
       /* When loading non-Dia files, change filename to reflect that saving
        * will produce a Dia file. See bug #440093 */
       if (strcmp (diagram->filename, filename) == 0) {
@@ -960,6 +961,8 @@ diagram_add_update_all (Diagram *dia)
 
     l = g_slist_next (l);
   }
+
+  navigation_thumbnail_add_update_all (dia);
 }
 
 
@@ -977,6 +980,8 @@ diagram_add_update (Diagram *dia, const DiaRectangle *update)
 
     l = g_slist_next(l);
   }
+
+  navigation_thumbnail_add_update (dia, update);
 }
 
 /**
@@ -1006,6 +1011,8 @@ diagram_add_update_with_border (Diagram            *dia,
 
     l = g_slist_next(l);
   }
+
+  navigation_thumbnail_add_update (dia, update);
 }
 
 void
@@ -1618,6 +1625,10 @@ diagram_modified_exists (void)
 void
 diagram_object_modified(Diagram *dia, DiaObject *object)
 {
+  if (dia_object_get_parent_layer (object)) {
+    dia_layer_changed (dia_object_get_parent_layer (object));
+  }
+
   /* signal about the change */
   dia_application_diagram_change (dia_application_get_default (),
                                   dia,
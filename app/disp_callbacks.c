@@ -1030,21 +1030,19 @@ ddisplay_canvas_events (GtkWidget *canvas,
           case GDK_KEY_Home:
           case GDK_KEY_KP_Home:
             /* match upper left corner of the diagram with it's view */
-            ddisplay_set_origo (ddisp,
+            ddisplay_scroll_to (ddisp,
                                 ddisp->diagram->data->extents.left,
                                 ddisp->diagram->data->extents.top);
             ddisplay_update_scrollbars (ddisp);
-            ddisplay_add_update_all (ddisp);
             break;
           case GDK_KEY_End:
           case GDK_KEY_KP_End:
             /* match lower right corner of the diagram with it's view */
             visible = &ddisp->visible;
-            ddisplay_set_origo (ddisp,
+            ddisplay_scroll_to (ddisp,
                                 ddisp->diagram->data->extents.right - (visible->right - visible->left),
                                 ddisp->diagram->data->extents.bottom - (visible->bottom - visible->top));
             ddisplay_update_scrollbars (ddisp);
-            ddisplay_add_update_all (ddisp);
             break;
           case GDK_KEY_Page_Up:
           case GDK_KEY_KP_Page_Up:
@@ -1190,8 +1188,7 @@ int
 ddisplay_hsb_update (GtkAdjustment *adjustment,
                      DDisplay      *ddisp)
 {
-  ddisplay_set_origo (ddisp, gtk_adjustment_get_value (adjustment), ddisp->origo.y);
-  ddisplay_add_update_all (ddisp);
+  ddisplay_scroll_to (ddisp, gtk_adjustment_get_value (adjustment), ddisp->origo.y);
   ddisplay_flush (ddisp);
   return FALSE;
 }
@@ -1201,8 +1198,7 @@ int
 ddisplay_vsb_update (GtkAdjustment *adjustment,
                      DDisplay      *ddisp)
 {
-  ddisplay_set_origo (ddisp, ddisp->origo.x, gtk_adjustment_get_value (adjustment));
-  ddisplay_add_update_all (ddisp);
+  ddisplay_scroll_to (ddisp, ddisp->origo.x, gtk_adjustment_get_value (adjustment));
   ddisplay_flush (ddisp);
   return FALSE;
 }
@@ -43,6 +43,7 @@
 #include "dia-diagram-properties-dialog.h"
 #include "dia-graphene.h"
 #include "dia-layer.h"
+#include "dia-render-profile.h"
 #include "renderer/diacairo.h"
 #include "diatransform.h"
 #include "recent_files.h"
@@ -199,6 +200,7 @@ copy_display (DDisplay *orig_ddisp)
   g_object_ref (dia);
 
   ddisp->grid = orig_ddisp->grid;
+  ddisp->grid.tile = NULL;
 
   ddisp->show_cx_pts = orig_ddisp->show_cx_pts;
 
@@ -208,7 +210,7 @@ copy_display (DDisplay *orig_ddisp)
 
   ddisp->aa_renderer = orig_ddisp->aa_renderer;
 
-  ddisp->update_areas = orig_ddisp->update_areas;
+  ddisp->update_areas = g_array_new (FALSE, FALSE, sizeof (DiaRectangle));
 
   ddisp->clicked_position.x = ddisp->clicked_position.y = 0.0;
 
@@ -281,7 +283,7 @@ new_display(Diagram *dia)
   if (preset != 0)
     ddisp->aa_renderer = (preset > 0 ? TRUE : FALSE);
 
-  ddisp->update_areas = NULL;
+  ddisp->update_areas = g_array_new (FALSE, FALSE, sizeof (DiaRectangle));
 
   ddisp->clicked_position.x = ddisp->clicked_position.y = 0.0;
 
@@ -403,8 +405,110 @@ ddisplay_add_update_pixels (DDisplay *ddisp,
 static void
 ddisplay_free_update_areas (DDisplay *ddisp)
 {
-  g_slist_free_full (ddisp->update_areas, g_free);
-  ddisp->update_areas = NULL;
+  g_clear_pointer (&ddisp->update_areas, g_array_unref);
+}
+
+
+static double
+update_area_size (const DiaRectangle *rect)
+{
+  return (rect->right - rect->left) * (rect->bottom - rect->top);
+}
+
+
+/*
+ * Two pending updates are drawn as one if that doesn't draw much more than
+ * the two of them.  Overlapping and adjacent rectangles always merge.
+ */
+static gboolean
+update_areas_should_merge (const DiaRectangle *r1, const DiaRectangle *r2)
+{
+  DiaRectangle merged = *r1;
+
+  rectangle_union (&merged, r2);
+
+  return update_area_size (&merged) <=
+           1.25 * (update_area_size (r1) + update_area_size (r2));
+}
+
+
+static void
+ddisplay_queue_draw_rect (DDisplay *ddisp, const DiaRectangle *rect)
+{
+  int x1, y1, x2, y2;
+
+  ddisplay_transform_coords (ddisp, rect->left, rect->top, &x1, &y1);
+  ddisplay_transform_coords (ddisp, rect->right, rect->bottom, &x2, &y2);
+
+  /* A pixel extra on each side, the clip region rounds outwards, too */
+  gtk_widget_queue_draw_area (ddisp->canvas,
+                              x1 - 1,
+                              y1 - 1,
+                              x2 - x1 + 3,
+                              y2 - y1 + 3);
+}
+
+
+/**
+ * ddisplay_steal_update_areas:
+ * @ddisp: the #DDisplay
+ *
+ * Takes the pending updates to draw them, they are reset.
+ *
+ * Returns: (transfer full): the merged #DiaRectangle s to draw,
+ * or %NULL if there is nothing to do
+ *
+ * Since: 0.98
+ */
+GArray *
+ddisplay_steal_update_areas (DDisplay *ddisp)
+{
+  GArray *areas;
+
+  if (ddisp->update_areas == NULL || ddisp->update_areas->len == 0) {
+    return NULL;
+  }
+
+  areas = g_steal_pointer (&ddisp->update_areas);
+  ddisp->update_areas = g_array_new (FALSE, FALSE, sizeof (DiaRectangle));
+
+  ddisp->update_stats.drawn += areas->len;
+  ddisp->update_stats.frames++;
+
+  return areas;
+}
+
+
+/**
+ * ddisplay_get_update_stats:
+ * @ddisp: the #DDisplay
+ * @stats: (out): the counters
+ *
+ * How many update rectangles were asked for, compared to what was drawn
+ * after merging them, since the display was created.
+ *
+ * Since: 0.98
+ */
+void
+ddisplay_get_update_stats (DDisplay *ddisp, DDisplayUpdateStats *stats)
+{
+  g_return_if_fail (ddisp != NULL);
+  g_return_if_fail (stats != NULL);
+
+  *stats = ddisp->update_stats;
+}
+
+
+/* Redraw everything, but not necessarily because everything changed */
+static void
+ddisplay_queue_update_all (DDisplay *ddisp)
+{
+  g_array_set_size (ddisp->update_areas, 0);
+  g_array_append_val (ddisp->update_areas, ddisp->visible);
+  ddisp->update_stats.submitted++;
+  ddisp->update_stats.full++;
+
+  gtk_widget_queue_draw (ddisp->canvas);
 }
 
 
@@ -420,11 +524,14 @@ ddisplay_free_update_areas (DDisplay *ddisp)
 void
 ddisplay_add_update_all (DDisplay *ddisp)
 {
-  if (ddisp->update_areas != NULL) {
-    ddisplay_free_update_areas (ddisp);
+  if (!ddisp->renderer) {
+    return;
   }
 
-  ddisplay_add_update (ddisp, &ddisp->visible);
+  /* Whatever changed might not be seen by the layer caches */
+  dia_interactive_renderer_invalidate_layers (DIA_INTERACTIVE_RENDERER (ddisp->renderer));
+
+  ddisplay_queue_update_all (ddisp);
 }
 
 
@@ -452,33 +559,68 @@ ddisplay_add_update_with_border (DDisplay           *ddisp,
   ddisplay_add_update (ddisp, &r);
 }
 
+/**
+ * ddisplay_add_update:
+ * @ddisp: the #DDisplay
+ * @rect: the area to update
+ *
+ * Marks a rectangle for update.  It's merged with the pending updates it
+ * overlaps, or is close to, and only it's area of the canvas is redrawn.
+ * Too many, or too large, updates turn into a redraw of everything.
+ */
 void
 ddisplay_add_update (DDisplay *ddisp, const DiaRectangle *rect)
 {
-  DiaRectangle *r;
-  // int width, height;
+  DiaRectangle r;
+  double size = 0.0;
+  guint i = 0;
 
   if (!ddisp->renderer)
     return; /* can happen at creation time of the diagram */
-  // width = dia_renderer_get_width_pixels (ddisp->renderer);
-  // height = dia_renderer_get_height_pixels (ddisp->renderer);
 
   if (!rectangle_intersects(rect, &ddisp->visible))
     return;
 
-  /* Temporarily just do a union of all rectangles: */
-  if (ddisp->update_areas==NULL) {
-    r = g_new(DiaRectangle, 1);
-    *r = *rect;
-    rectangle_intersection(r, &ddisp->visible);
-    ddisp->update_areas = g_slist_prepend(ddisp->update_areas, r);
-  } else {
-    r = (DiaRectangle *) ddisp->update_areas->data;
-    rectangle_union(r, rect);
-    rectangle_intersection(r, &ddisp->visible);
+  ddisp->update_stats.submitted++;
+
+  r = *rect;
+  rectangle_intersection (&r, &ddisp->visible);
+
+  /* Already covered, e.g. everything is drawn anyway */
+  for (i = 0; i < ddisp->update_areas->len; i++) {
+    if (rectangle_in_rectangle (&g_array_index (ddisp->update_areas, DiaRectangle, i), &r)) {
+      return;
+    }
   }
 
-  gtk_widget_queue_draw (ddisp->canvas);
+  /* Growing may make it mergeable with ones already looked at */
+  i = 0;
+  while (i < ddisp->update_areas->len) {
+    DiaRectangle *pending = &g_array_index (ddisp->update_areas, DiaRectangle, i);
+
+    if (update_areas_should_merge (pending, &r)) {
+      rectangle_union (&r, pending);
+      g_array_remove_index_fast (ddisp->update_areas, i);
+      i = 0;
+    } else {
+      i++;
+    }
+  }
+
+  size = update_area_size (&r);
+  for (i = 0; i < ddisp->update_areas->len; i++) {
+    size += update_area_size (&g_array_index (ddisp->update_areas, DiaRectangle, i));
+  }
+
+  if (ddisp->update_areas->len >= DDISPLAY_MAX_UPDATE_AREAS ||
+      size > 0.5 * update_area_size (&ddisp->visible)) {
+    ddisplay_queue_update_all (ddisp);
+    return;
+  }
+
+  g_array_append_val (ddisp->update_areas, r);
+
+  ddisplay_queue_draw_rect (ddisp, &r);
 }
 
 void
@@ -491,8 +633,13 @@ ddisplay_flush(DDisplay *ddisp)
    * GDK_PRIORITY_REDRAW = (G_PRIORITY_HIGH_IDLE + 20) with gtk-2-22
    * GTK_PRIORITY_RESIZE = (G_PRIORITY_HIGH_IDLE + 10)
    * Dia's canvas rendering is in between
+   *
+   * Pending updates have queued their own area, everything else is only
+   * a change of the overlays painted over the whole canvas
    */
-  gtk_widget_queue_draw (ddisp->canvas);
+  if (ddisp->update_areas == NULL || ddisp->update_areas->len == 0) {
+    gtk_widget_queue_draw (ddisp->canvas);
+  }
 }
 
 static void
@@ -526,15 +673,15 @@ ddisplay_render_pixmap (DDisplay     *ddisp,
   GList *list;
   DiaObject *obj;
   int i;
-#ifdef TRACES
-  GTimer *timer;
-#endif
+  gint64 start;
 
   if (ddisp->renderer==NULL) {
     g_critical ("ERROR! Renderer was NULL!!");
     return;
   }
 
+  dia_render_profile_frame_begin ();
+
   /* Erase background */
   dia_renderer_begin_render (ddisp->renderer, update);
   if (update) {
@@ -558,22 +705,22 @@ ddisplay_render_pixmap (DDisplay     *ddisp,
   }
 
   /* Draw grid */
+  start = dia_render_profile_start ();
   grid_draw (ddisp, update);
+  dia_render_profile_add (DIA_RENDER_PROFILE_SECTION, "grid", start);
+
+  start = dia_render_profile_start ();
   pagebreak_draw (ddisp, update);
   guidelines_draw (ddisp, update);
+  dia_render_profile_add (DIA_RENDER_PROFILE_SECTION, "pagebreaks and guides", start);
 
-#ifdef TRACES
-  timer = g_timer_new();
-#endif
   data_render (ddisp->diagram->data,
                ddisp->renderer, update,
                ddisplay_obj_render,
                (gpointer) ddisp);
-#ifdef TRACES
-  g_printerr ("data_render(%g%%) took %g seconds\n", ddisp->zoom_factor * 5.0, g_timer_elapsed (timer, NULL));
-  g_timer_destroy (timer);
-#endif
+
   /* Draw handles for all selected objects */
+  start = dia_render_profile_start ();
   list = ddisp->diagram->data->selected;
   while (list!=NULL) {
     obj = (DiaObject *) list->data;
@@ -583,7 +730,11 @@ ddisplay_render_pixmap (DDisplay     *ddisp,
     }
     list = g_list_next(list);
   }
+  dia_render_profile_add (DIA_RENDER_PROFILE_SECTION, "handles", start);
+
   dia_renderer_end_render (ddisp->renderer);
+
+  dia_render_profile_frame_end ();
 }
 
 void
@@ -650,6 +801,78 @@ ddisplay_set_origo (DDisplay *ddisp, double x, double y)
 }
 
 
+/**
+ * ddisplay_scroll_to:
+ * @ddisp: the #DDisplay
+ * @x: the new left edge of the visible area
+ * @y: the new top edge of the visible area
+ *
+ * Moves the visible area at the same zoom.  What stays visible is moved on
+ * screen rather than drawn again, only the uncovered strips are updated.
+ * To allow that the position is rounded to whole pixels.
+ *
+ * Since: 0.98
+ */
+void
+ddisplay_scroll_to (DDisplay *ddisp, double x, double y)
+{
+  int width, height, dx, dy;
+  DiaRectangle strip;
+
+  g_return_if_fail (ddisp->renderer != NULL);
+
+  width = dia_interactive_renderer_get_width_pixels (DIA_INTERACTIVE_RENDERER (ddisp->renderer));
+  height = dia_interactive_renderer_get_height_pixels (DIA_INTERACTIVE_RENDERER (ddisp->renderer));
+
+  dx = (int) round (ddisplay_transform_length (ddisp, x - ddisp->origo.x));
+  dy = (int) round (ddisplay_transform_length (ddisp, y - ddisp->origo.y));
+
+  if (dx == 0 && dy == 0) {
+    return;
+  }
+
+  /* Nothing left to keep */
+  if (ABS (dx) >= width || ABS (dy) >= height) {
+    ddisplay_set_origo (ddisp, x, y);
+    ddisplay_queue_update_all (ddisp);
+    return;
+  }
+
+  ddisplay_set_origo (ddisp,
+                      ddisp->origo.x + ddisplay_untransform_length (ddisp, dx),
+                      ddisp->origo.y + ddisplay_untransform_length (ddisp, dy));
+
+  if (!dia_interactive_renderer_scroll (DIA_INTERACTIVE_RENDERER (ddisp->renderer), dx, dy)) {
+    ddisplay_queue_update_all (ddisp);
+    return;
+  }
+
+  /* A pixel more, the edges are antialiased */
+  if (dx != 0) {
+    strip = ddisp->visible;
+    if (dx > 0) {
+      strip.left = strip.right - ddisplay_untransform_length (ddisp, dx + 1);
+    } else {
+      strip.right = strip.left + ddisplay_untransform_length (ddisp, 1 - dx);
+    }
+    ddisplay_add_update (ddisp, &strip);
+  }
+
+  if (dy != 0) {
+    strip = ddisp->visible;
+    if (dy > 0) {
+      strip.top = strip.bottom - ddisplay_untransform_length (ddisp, dy + 1);
+    } else {
+      strip.bottom = strip.top + ddisplay_untransform_length (ddisp, 1 - dy);
+    }
+    ddisplay_add_update (ddisp, &strip);
+  }
+
+  /* Everything else moved */
+  gtk_widget_queue_draw (ddisp->canvas);
+}
+
+
 void
 ddisplay_zoom (DDisplay *ddisp, Point *point, double magnify)
 {
@@ -916,9 +1139,8 @@ ddisplay_scroll (DDisplay *ddisp, Point *delta)
 
   if ( (new_origo.x != ddisp->origo.x) ||
        (new_origo.y != ddisp->origo.y) ) {
-    ddisplay_set_origo (ddisp, new_origo.x, new_origo.y);
+    ddisplay_scroll_to (ddisp, new_origo.x, new_origo.y);
     ddisplay_update_scrollbars (ddisp);
-    ddisplay_add_update_all (ddisp);
     return TRUE;
   }
 
@@ -1102,6 +1324,52 @@ ddisplay_get_clicked_position (DDisplay *ddisp)
 }
 
 
+/**
+ * ddisplay_update_lod:
+ * @ddisp: the #DDisplay
+ *
+ * Pass the level of detail preferences on to the renderer. The limits are
+ * in pixels, the renderer applies the zoom itself.
+ *
+ * Since: 0.98
+ */
+void
+ddisplay_update_lod (DDisplay *ddisp)
+{
+  if (!ddisp->renderer) {
+    return;
+  }
+
+  g_object_set (ddisp->renderer,
+                "min-object-size", (double) prefs.lod.object_pixels,
+                "min-text-size", (double) prefs.lod.text_pixels,
+                NULL);
+}
+
+
+/**
+ * ddisplay_update_all_lod:
+ *
+ * Call ddisplay_update_lod() for every display, after the preferences changed
+ *
+ * Since: 0.98
+ */
+void
+ddisplay_update_all_lod (void)
+{
+  GList *list;
+
+  for (list = dia_open_diagrams (); list != NULL; list = g_list_next (list)) {
+    Diagram *dia = (Diagram *) list->data;
+    GSList *slist;
+
+    for (slist = dia->displays; slist != NULL; slist = g_slist_next (slist)) {
+      ddisplay_update_lod ((DDisplay *) slist->data);
+    }
+  }
+}
+
+
 void
 ddisplay_set_renderer (DDisplay *ddisp, int aa_renderer)
 {
@@ -1126,6 +1394,7 @@ ddisplay_set_renderer (DDisplay *ddisp, int aa_renderer)
                 "zoom", &ddisp->zoom_factor,
                 "rect", &ddisp->visible,
                 NULL);
+  ddisplay_update_lod (ddisp);
 
   if (window) {
     dia_interactive_renderer_set_size (DIA_INTERACTIVE_RENDERER (ddisp->renderer),
@@ -1150,6 +1419,7 @@ ddisplay_resize_canvas (DDisplay *ddisp,
                   "zoom", &ddisp->zoom_factor,
                   "rect", &ddisp->visible,
                   NULL);
+    ddisplay_update_lod (ddisp);
   }
 
   dia_interactive_renderer_set_size (DIA_INTERACTIVE_RENDERER (ddisp->renderer),
@@ -1357,6 +1627,16 @@ ddisplay_really_destroy (DDisplay *ddisp)
   }
 
   g_clear_object (&ddisp->renderer);
+  grid_clear_tile (&ddisp->grid);
+
+  g_debug ("%s: %" G_GUINT64_FORMAT " updates, %" G_GUINT64_FORMAT
+           " drawn in %" G_GUINT64_FORMAT " frames, %" G_GUINT64_FORMAT
+           " full redraws",
+           G_STRLOC,
+           ddisp->update_stats.submitted,
+           ddisp->update_stats.drawn,
+           ddisp->update_stats.frames,
+           ddisp->update_stats.full);
 
   /* Free update_areas list: */
   ddisplay_free_update_areas(ddisp);
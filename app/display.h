@@ -46,6 +46,27 @@ G_BEGIN_DECLS
 #define DDISPLAY_NORMAL_ZOOM 1.0
 #define DDISPLAY_MIN_ZOOM 0.01
 */
+
+/* More pending update rectangles than this are drawn as one */
+#define DDISPLAY_MAX_UPDATE_AREAS 16
+
+/**
+ * DDisplayUpdateStats:
+ * @submitted: rectangles passed to ddisplay_add_update()
+ * @drawn: rectangles left after merging, when they were drawn
+ * @full: times the pending updates were given up for a full redraw
+ * @frames: number of redraws
+ *
+ * Counters for the dirty region handling of a #DDisplay
+ */
+typedef struct _DDisplayUpdateStats DDisplayUpdateStats;
+struct _DDisplayUpdateStats {
+  guint64 submitted;
+  guint64 drawn;
+  guint64 full;
+  guint64 frames;
+};
+
 struct _DDisplay {
   Diagram *diagram;                  /* pointer to the associated diagram */
 
@@ -88,7 +109,8 @@ struct _DDisplay {
   int aa_renderer;
   DiaRenderer *renderer;
 
-  GSList *update_areas;           /* Update areas list                 */
+  GArray *update_areas;           /* Pending DiaRectangles, merged     */
+  DDisplayUpdateStats update_stats;
 
   GtkIMContext *im_context;
 
@@ -153,10 +175,16 @@ void ddisplay_add_update_with_border(DDisplay *ddisp, const DiaRectangle *rect,
 				     int pixel_border);
 void ddisplay_add_update(DDisplay *ddisp, const DiaRectangle *rect);
 void ddisplay_flush(DDisplay *ddisp);
+GArray  *ddisplay_steal_update_areas      (DDisplay            *ddisp);
+void     ddisplay_get_update_stats        (DDisplay            *ddisp,
+                                           DDisplayUpdateStats *stats);
 void ddisplay_update_scrollbars(DDisplay *ddisp);
 void     ddisplay_set_origo               (DDisplay *ddisp,
                                            double    x,
                                            double    y);
+void     ddisplay_scroll_to               (DDisplay *ddisp,
+                                           double    x,
+                                           double    y);
 void     ddisplay_zoom                    (DDisplay *ddisp,
                                            Point    *point,
                                            double    zoom_factor);
@@ -169,6 +197,8 @@ void ddisplay_set_snap_to_grid(DDisplay *ddisp, gboolean snap);
 void ddisplay_set_snap_to_guides(DDisplay *ddisp, gboolean snap);
 void ddisplay_set_snap_to_objects(DDisplay *ddisp, gboolean magnetic);
 void ddisplay_set_renderer(DDisplay *ddisp, int aa_renderer);
+void     ddisplay_update_lod              (DDisplay *ddisp);
+void     ddisplay_update_all_lod          (void);
 void ddisplay_resize_canvas(DDisplay *ddisp,
 			    int width,
 			    int height);
@@ -22,6 +22,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include <glib.h>
 
@@ -30,6 +31,37 @@
 #include "diainteractiverenderer.h"
 
 
+/* Bigger tiles aren't worth it, the lines are drawn one by one instead */
+#define GRID_TILE_MAX 512
+
+/* Origins closer than 1/64 device pixel use the same tile */
+#define GRID_TILE_SUBPIXEL 64.0
+
+/*
+ * The grid repeats every few lines, so instead of drawing each line on
+ * every expose one tile is drawn once and then used as a pattern
+ */
+struct _GridTile {
+  /* What the tile was made for */
+  double    zoom;
+  double    length_x;
+  double    length_y;
+  guint     major_lines;
+  gboolean  hex;
+  Color     colour;
+  int       scale;              /* Device pixels per pixel of the display */
+  int       subpixel_x;         /* Where the grid's origin is in its device pixel */
+  int       subpixel_y;
+  int       extent_x;           /* The display's size in pixels */
+  int       extent_y;
+
+  /* NULL if the lines don't repeat exactly enough in device pixels */
+  cairo_pattern_t *pattern;
+  int       width;              /* In device pixels */
+  int       height;
+};
+
+
 /**
  * calculate_dynamic_grid:
  * @ddisp: the #DDisplay
@@ -301,6 +333,245 @@ grid_draw_hex (DDisplay *ddisp, DiaRectangle *update, real length)
 
 }
 
+/**
+ * grid_clear_tile:
+ * @grid: the #Grid of a display
+ *
+ * Drop the tile grid_draw() keeps.
+ *
+ * Since: 0.98
+ */
+void
+grid_clear_tile (Grid *grid)
+{
+  if (grid->tile) {
+    g_clear_pointer (&grid->tile->pattern, cairo_pattern_destroy);
+    g_clear_pointer (&grid->tile, g_free);
+  }
+}
+
+
+/*
+ * How many periods of @period pixels, a multiple of @multiple, make
+ * a tile of a whole number of pixels, close enough that the lines are off
+ * by less than a quarter pixel over @extent pixels.  0 if there are none
+ * below GRID_TILE_MAX.
+ */
+static int
+grid_tile_periods (double period, int multiple, int extent, int *pixels)
+{
+  for (int k = multiple; k * period <= GRID_TILE_MAX; k += multiple) {
+    double size = k * period;
+    int whole = ROUND (size);
+
+    if (whole > 0 && fabs (size - whole) * (extent / size + 1) < 0.25) {
+      *pixels = whole;
+      return k;
+    }
+  }
+
+  return 0;
+}
+
+
+/* One display pixel wide, from the given device pixel to the right and down */
+static void
+grid_tile_line (GridTile *tile, cairo_t *cr, int x1, int y1, int x2, int y2)
+{
+  double offset = tile->scale / 2.0;
+
+  cairo_move_to (cr, x1 + offset, y1 + offset);
+  cairo_line_to (cr, x2 + offset, y2 + offset);
+  cairo_stroke (cr);
+}
+
+
+static void
+grid_tile_draw_lines (GridTile *tile, cairo_t *cr, int n_x, int n_y)
+{
+  double subpixel_x = tile->subpixel_x / GRID_TILE_SUBPIXEL;
+  double subpixel_y = tile->subpixel_y / GRID_TILE_SUBPIXEL;
+  double zoom = tile->zoom * tile->scale;
+  /* What DIA_LINE_STYLE_DOTTED of 31 pixels is in the display renderer */
+  double dots[] = { 3.1 * tile->scale, 3.1 * tile->scale };
+
+  for (int i = 0; i < n_x; i++) {
+    int x = ROUND (subpixel_x + i * tile->length_x * zoom);
+
+    cairo_set_dash (cr, dots, tile->major_lines && i % tile->major_lines ? 2 : 0, 0);
+    grid_tile_line (tile, cr, x, 0, x, tile->height);
+  }
+
+  for (int i = 0; i < n_y; i++) {
+    int y = ROUND (subpixel_y + i * tile->length_y * zoom);
+
+    cairo_set_dash (cr, dots, tile->major_lines && i % tile->major_lines ? 2 : 0, 0);
+    grid_tile_line (tile, cr, 0, y, tile->width, y);
+  }
+}
+
+
+static void
+grid_tile_draw_hex (GridTile *tile, cairo_t *cr, int n_x, int n_y)
+{
+  double l = tile->length_x;
+  double h = sqrt (3) * l;
+  double zoom = tile->zoom * tile->scale;
+  /* The segments of one period, relative to a corner, as grid_draw_hex() */
+  double segments[][4] = {
+    { -2.5 * l, 0.0, -1.5 * l, 0.0 },
+    { -l, -0.5 * h, 0.0, -0.5 * h },
+    { -1.5 * l, -h, -l, -0.5 * h },
+    { -2.5 * l, -h, -3.0 * l, -0.5 * h },
+    { -l, -0.5 * h, -1.5 * l, 0.0 },
+    { 0.0, -0.5 * h, 0.5 * l, 0.0 },
+  };
+
+  /* One more around, for the segments crossing the edges */
+  for (int n = -1; n <= n_y + 1; n++) {
+    for (int m = -1; m <= n_x + 1; m++) {
+      for (gsize i = 0; i < G_N_ELEMENTS (segments); i++) {
+        double *segment = segments[i];
+
+        grid_tile_line (tile,
+                        cr,
+                        ROUND (tile->subpixel_x / GRID_TILE_SUBPIXEL + (m * 3 * l + segment[0]) * zoom),
+                        ROUND (tile->subpixel_y / GRID_TILE_SUBPIXEL + (n * h + segment[1]) * zoom),
+                        ROUND (tile->subpixel_x / GRID_TILE_SUBPIXEL + (m * 3 * l + segment[2]) * zoom),
+                        ROUND (tile->subpixel_y / GRID_TILE_SUBPIXEL + (n * h + segment[3]) * zoom));
+      }
+    }
+  }
+}
+
+
+static void
+grid_tile_render (GridTile *tile)
+{
+  double period_x, period_y;
+  int multiple = tile->hex || tile->major_lines == 0 ? 1 : tile->major_lines;
+  /* All in device pixels, so the tile is as sharp as the display */
+  double zoom = tile->zoom * tile->scale;
+  int n_x, n_y;
+  cairo_surface_t *surface;
+  cairo_t *cr;
+
+  if (tile->hex) {
+    period_x = 3 * tile->length_x * zoom;
+    period_y = sqrt (3) * tile->length_x * zoom;
+  } else {
+    period_x = tile->length_x * zoom;
+    period_y = tile->length_y * zoom;
+  }
+
+  n_x = grid_tile_periods (period_x, multiple, tile->extent_x * tile->scale, &tile->width);
+  n_y = grid_tile_periods (period_y, multiple, tile->extent_y * tile->scale, &tile->height);
+  if (n_x == 0 || n_y == 0) {
+    return;
+  }
+
+  surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, tile->width, tile->height);
+  cr = cairo_create (surface);
+  cairo_set_line_width (cr, tile->scale);
+  cairo_set_source_rgba (cr,
+                         tile->colour.red,
+                         tile->colour.green,
+                         tile->colour.blue,
+                         tile->colour.alpha);
+
+  if (tile->hex) {
+    grid_tile_draw_hex (tile, cr, n_x, n_y);
+  } else {
+    grid_tile_draw_lines (tile, cr, n_x, n_y);
+  }
+
+  cairo_destroy (cr);
+
+  /* Used in display pixels, but maps 1:1 on the device pixels */
+  cairo_surface_set_device_scale (surface, tile->scale, tile->scale);
+
+  tile->pattern = cairo_pattern_create_for_surface (surface);
+  cairo_pattern_set_extend (tile->pattern, CAIRO_EXTEND_REPEAT);
+  cairo_pattern_set_filter (tile->pattern, CAIRO_FILTER_NEAREST);
+  cairo_surface_destroy (surface);
+}
+
+
+/* Draws the grid from its tile, FALSE if it has to be drawn line by line */
+static gboolean
+grid_draw_tiled (DDisplay     *ddisp,
+                 DiaRectangle *update,
+                 double        length_x,
+                 double        length_y,
+                 gboolean      hex)
+{
+  DiaInteractiveRenderer *renderer = DIA_INTERACTIVE_RENDERER (ddisp->renderer);
+  GridTile key = { 0, };
+  GridTile *tile;
+  double origin_x, origin_y;
+  cairo_matrix_t matrix;
+  int x1, y1, x2, y2;
+
+  key.scale = ddisp->canvas ? gtk_widget_get_scale_factor (ddisp->canvas) : 1;
+
+  /* Where the grid's origin is, in device pixels */
+  ddisplay_transform_coords_double (ddisp, 0.0, 0.0, &origin_x, &origin_y);
+  origin_x *= key.scale;
+  origin_y *= key.scale;
+
+  key.zoom = ddisp->zoom_factor;
+  key.length_x = length_x;
+  key.length_y = length_y;
+  key.major_lines = hex ? 0 : ddisp->diagram->grid.major_lines;
+  key.hex = hex;
+  key.colour = ddisp->diagram->grid.colour;
+  key.subpixel_x = (origin_x - floor (origin_x)) * GRID_TILE_SUBPIXEL;
+  key.subpixel_y = (origin_y - floor (origin_y)) * GRID_TILE_SUBPIXEL;
+  key.extent_x = dia_interactive_renderer_get_width_pixels (renderer);
+  key.extent_y = dia_interactive_renderer_get_height_pixels (renderer);
+
+  tile = ddisp->grid.tile;
+  if (!tile ||
+      tile->zoom != key.zoom ||
+      tile->length_x != key.length_x ||
+      tile->length_y != key.length_y ||
+      tile->major_lines != key.major_lines ||
+      tile->hex != key.hex ||
+      memcmp (&tile->colour, &key.colour, sizeof (Color)) != 0 ||
+      tile->scale != key.scale ||
+      tile->subpixel_x != key.subpixel_x ||
+      tile->subpixel_y != key.subpixel_y ||
+      tile->extent_x != key.extent_x ||
+      tile->extent_y != key.extent_y) {
+    grid_clear_tile (&ddisp->grid);
+
+    tile = g_memdup2 (&key, sizeof (GridTile));
+    grid_tile_render (tile);
+    ddisp->grid.tile = tile;
+  }
+
+  if (!tile->pattern) {
+    return FALSE;
+  }
+
+  /* The tile's corner goes on the grid's origin, the pattern is in display pixels */
+  cairo_matrix_init_translate (&matrix,
+                               -fmod (floor (origin_x), tile->width) / tile->scale,
+                               -fmod (floor (origin_y), tile->height) / tile->scale);
+  cairo_pattern_set_matrix (tile->pattern, &matrix);
+
+  ddisplay_transform_coords (ddisp, update->left, update->top, &x1, &y1);
+  ddisplay_transform_coords (ddisp, update->right, update->bottom, &x2, &y2);
+
+  return dia_interactive_renderer_fill_pixel_pattern (renderer,
+                                                      x1,
+                                                      y1,
+                                                      x2 - x1 + 1,
+                                                      y2 - y1 + 1,
+                                                      tile->pattern);
+}
+
+
 void
 grid_draw (DDisplay *ddisp, DiaRectangle *update)
 {
@@ -323,10 +594,17 @@ grid_draw (DDisplay *ddisp, DiaRectangle *update)
     dia_renderer_set_linewidth (renderer, 0.0);
 
     if (ddisp->diagram->grid.hex) {
-      grid_draw_hex (ddisp, update, ddisp->diagram->grid.hex_size);
+      real hex_size = ddisp->diagram->grid.hex_size;
+
+      /* Same limit as grid_draw_hex() */
+      if (hex_size >= 0.1 &&
+          !grid_draw_tiled (ddisp, update, hex_size, hex_size, TRUE)) {
+        grid_draw_hex (ddisp, update, hex_size);
+      }
     } else {
       if (ddisplay_transform_length (ddisp, width_y) >= 2.0 &&
-          ddisplay_transform_length (ddisp, width_x) >= 2.0) {
+          ddisplay_transform_length (ddisp, width_x) >= 2.0 &&
+          !grid_draw_tiled (ddisp, update, width_x, width_y, FALSE)) {
         /* Vertical lines: */
         grid_draw_vertical_lines (ddisp, update, width_x);
         /* Horizontal lines: */
@@ -21,16 +21,20 @@
 #include <gtk/gtk.h>
 
 typedef struct _Grid Grid;
+typedef struct _GridTile GridTile;
 
 #include "geometry.h"
 struct _Grid {
   guint visible;
   guint snap;
+
+  GridTile *tile; /* What grid_draw() repeats over the display, or NULL */
 };
 
 #include "display.h"
 
 void grid_draw(DDisplay *ddisp, DiaRectangle *update);
+void grid_clear_tile (Grid *grid);
 void pagebreak_draw(DDisplay *ddisp, DiaRectangle *update);
 void guidelines_draw(DDisplay *ddisp, DiaRectangle *update);
 void snap_to_grid(DDisplay *ddisp, double *x, double *y);
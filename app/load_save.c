@@ -51,6 +51,7 @@
 #include "autosave.h"
 #include "display.h"
 #include "dia-io.h"
+#include "dia-binary.h"
 #include "dia-layer.h"
 
 #ifdef G_OS_WIN32
@@ -78,9 +79,9 @@ static gboolean write_objects(GList *objects, xmlNodePtr objects_node,
 			      const char *filename, DiaContext *ctx);
 static gboolean write_connections(GList *objects, xmlNodePtr layer_node,
 				  GHashTable *objects_hash);
-static xmlDocPtr diagram_data_write_doc(DiagramData *data, const char *filename, DiaContext *ctx);
-static int diagram_data_raw_save(DiagramData *data, const char *filename, DiaContext *ctx);
-static gboolean diagram_data_save(DiagramData *data, DiaContext *ctx, const char *filename);
+static xmlDocPtr diagram_data_write_doc(DiagramData *data, const char *filename, gboolean binary, DiaContext *ctx);
+static int diagram_data_raw_save(DiagramData *data, const char *filename, gboolean binary, DiaContext *ctx);
+static gboolean diagram_data_save(DiagramData *data, DiaContext *ctx, const char *filename, gboolean binary);
 
 
 static void
@@ -387,6 +388,273 @@ _get_bool_prop (xmlNodePtr node, const char *name, gboolean preset)
 }
 
 
+static void
+report_unknown_objects (GHashTable *unknown_objects_hash)
+{
+  GString *unknown_str;
+
+  if (g_hash_table_size (unknown_objects_hash) == 0) {
+    return;
+  }
+
+  unknown_str = g_string_new ("Unknown types while reading diagram file");
+
+  /* show all the unknown types in one message */
+  g_hash_table_foreach (unknown_objects_hash,
+                        GHFuncUnknownObjects,
+                        unknown_str);
+  message_warning ("%s", unknown_str->str);
+  g_string_free (unknown_str, TRUE);
+}
+
+
+typedef struct _ObjectRef ObjectRef;
+struct _ObjectRef {
+  xmlNodePtr  layer_node;
+  xmlChar    *id;
+};
+
+
+static void
+collect_object_refs (xmlNodePtr  node,
+                     xmlNodePtr  layer_node,
+                     GHashTable *owners,
+                     GArray     *refs)
+{
+  for (xmlNodePtr child = node->children; child != NULL; child = child->next) {
+    ObjectRef ref = { layer_node, NULL };
+
+    if (child->type != XML_ELEMENT_NODE) {
+      continue;
+    }
+
+    if (xmlStrcmp (child->name, (const xmlChar *) "object") == 0) {
+      xmlChar *id = xmlGetProp (child, (const xmlChar *) "id");
+
+      if (id) {
+        g_hash_table_insert (owners, id, layer_node);
+      }
+    } else if (xmlStrcmp (child->name, (const xmlChar *) "connection") == 0) {
+      ref.id = xmlGetProp (child, (const xmlChar *) "to");
+    } else if (xmlStrcmp (child->name, (const xmlChar *) "childnode") == 0) {
+      ref.id = xmlGetProp (child, (const xmlChar *) "parent");
+    }
+
+    if (ref.id) {
+      g_array_append_val (refs, ref);
+    }
+
+    collect_object_refs (child, layer_node, owners, refs);
+  }
+}
+
+
+typedef struct _RefScan RefScan;
+struct _RefScan {
+  xmlNodePtr  layer_node;
+  GHashTable *owners;
+  GArray     *refs;
+};
+
+
+static const char *
+find_attribute (const char **names, const char **values, const char *name)
+{
+  for (int i = 0; names[i] != NULL; i++) {
+    if (g_str_equal (names[i], name)) {
+      return values[i];
+    }
+  }
+
+  return NULL;
+}
+
+
+/* collect_object_refs() for a layer still in the binary file */
+static void
+scan_object_refs (const char  *name,
+                  const char **attribute_names,
+                  const char **attribute_values,
+                  gpointer     user_data)
+{
+  RefScan *scan = user_data;
+  ObjectRef ref = { scan->layer_node, NULL };
+  const char *id = NULL;
+
+  if (g_str_equal (name, "object")) {
+    id = find_attribute (attribute_names, attribute_values, "id");
+
+    if (id) {
+      g_hash_table_insert (scan->owners,
+                           xmlStrdup ((const xmlChar *) id),
+                           scan->layer_node);
+    }
+
+    return;
+  } else if (g_str_equal (name, "connection")) {
+    id = find_attribute (attribute_names, attribute_values, "to");
+  } else if (g_str_equal (name, "childnode")) {
+    id = find_attribute (attribute_names, attribute_values, "parent");
+  }
+
+  if (id) {
+    ref.id = xmlStrdup ((const xmlChar *) id);
+    g_array_append_val (scan->refs, ref);
+  }
+}
+
+
+/*
+ * Connections and parents may point into other layers.  Such layers have
+ * to be read together, so they can't be deferred.
+ *
+ * Returns: the set of <layer> nodes referencing, or referenced by, another
+ */
+static GHashTable *
+find_linked_layers (xmlNodePtr root)
+{
+  GHashTable *owners = g_hash_table_new_full (g_str_hash,
+                                              g_str_equal,
+                                              xmlFree,
+                                              NULL);
+  GArray *refs = g_array_new (FALSE, FALSE, sizeof (ObjectRef));
+  GHashTable *linked = g_hash_table_new (NULL, NULL);
+
+  for (xmlNodePtr node = root->children; node != NULL; node = node->next) {
+    if (node->type != XML_ELEMENT_NODE ||
+        xmlStrcmp (node->name, (const xmlChar *) "layer") != 0) {
+      continue;
+    }
+
+    if (dia_binary_doc_is_pending (root->doc, node)) {
+      RefScan scan = { node, owners, refs };
+
+      /* Damaged, so better not defer it and report when decoding */
+      if (!dia_binary_doc_scan_node (root->doc, node, scan_object_refs, &scan)) {
+        g_hash_table_add (linked, node);
+      }
+    } else {
+      collect_object_refs (node, node, owners, refs);
+    }
+  }
+
+  for (guint i = 0; i < refs->len; i++) {
+    ObjectRef *ref = &g_array_index (refs, ObjectRef, i);
+    xmlNodePtr owner = g_hash_table_lookup (owners, ref->id);
+
+    if (owner && owner != ref->layer_node) {
+      g_hash_table_add (linked, owner);
+      g_hash_table_add (linked, ref->layer_node);
+    }
+
+    xmlFree (ref->id);
+  }
+
+  g_array_free (refs, TRUE);
+  g_hash_table_destroy (owners);
+
+  return linked;
+}
+
+
+/* A hidden layer still waiting in the parsed file */
+typedef struct _DeferredLayer DeferredLayer;
+struct _DeferredLayer {
+  /* A GRcBox, shared by all deferred layers of one file */
+  xmlDocPtr  *doc;
+  xmlNodePtr  layer_node;
+  char       *filename;
+  /* Content of @layer_node complete, see deferred_layer_decode() */
+  gboolean    decoded;
+};
+
+
+static void
+clear_shared_doc (xmlDocPtr *doc)
+{
+  g_clear_pointer (doc, dia_binary_free_document);
+}
+
+
+static void
+deferred_layer_free (gpointer data)
+{
+  DeferredLayer *deferred = data;
+
+  g_rc_box_release_full (deferred->doc, (GDestroyNotify) clear_shared_doc);
+  g_clear_pointer (&deferred->filename, g_free);
+  g_free (deferred);
+}
+
+
+/*
+ * Binary diagrams only decode the content of a layer when it's needed.
+ * Once done the node is only read, so copies may be saved in another
+ * thread, see deferred_layer_copy().
+ */
+static void
+deferred_layer_decode (DeferredLayer *deferred, DiaContext *ctx)
+{
+  if (!deferred->decoded) {
+    dia_binary_doc_decode_node (*deferred->doc, deferred->layer_node, ctx);
+    deferred->decoded = TRUE;
+  }
+}
+
+
+/* For diagram_data_clone(), the autosave writes the copy in a thread */
+static gpointer
+deferred_layer_copy (gconstpointer data)
+{
+  DeferredLayer *deferred = (DeferredLayer *) data;
+  DeferredLayer *copy = g_new0 (DeferredLayer, 1);
+  DiaContext *ctx = dia_context_new (_("Load Layer"));
+
+  dia_context_set_filename (ctx, deferred->filename);
+  deferred_layer_decode (deferred, ctx);
+  dia_context_release (ctx);
+
+  copy->doc = g_rc_box_acquire (deferred->doc);
+  copy->layer_node = deferred->layer_node;
+  copy->filename = g_strdup (deferred->filename);
+  copy->decoded = TRUE;
+
+  return copy;
+}
+
+
+static GList *
+load_deferred_layer (DiaLayer *layer, gpointer user_data)
+{
+  DeferredLayer *deferred = user_data;
+  GHashTable *objects_hash = g_hash_table_new (g_str_hash, g_str_equal);
+  GHashTable *unknown_objects_hash = g_hash_table_new (g_str_hash, g_str_equal);
+  DiaContext *ctx = dia_context_new (_("Load Layer"));
+  GList *list;
+
+  dia_context_set_filename (ctx, deferred->filename);
+
+  deferred_layer_decode (deferred, ctx);
+
+  list = read_objects (deferred->layer_node,
+                       objects_hash,
+                       ctx,
+                       NULL,
+                       unknown_objects_hash);
+  /* Self contained, see find_linked_layers() */
+  read_connections (list, deferred->layer_node, objects_hash);
+
+  report_unknown_objects (unknown_objects_hash);
+
+  g_hash_table_foreach (objects_hash, hash_free_string, NULL);
+  g_hash_table_destroy (objects_hash);
+  g_hash_table_destroy (unknown_objects_hash);
+  dia_context_release (ctx);
+
+  return list;
+}
+
+
 static gboolean
 diagram_data_load (const char  *filename,
                    DiagramData *data,
@@ -408,10 +676,18 @@ diagram_data_load (const char  *filename,
   DiaLayer *initial_layer = NULL;
   GHashTable* unknown_objects_hash = g_hash_table_new(g_str_hash, g_str_equal);
   int num_layers_added = 0;
+  GHashTable *linked_layers;
+  GHashTable *deferred_nodes = NULL;
+  xmlDocPtr *shared_doc = NULL;
 
   g_return_val_if_fail (data != NULL, FALSE);
 
-  doc = dia_io_load_document (filename, ctx, &data->is_compressed);
+  if (dia_binary_check (filename)) {
+    doc = dia_binary_load_document (filename, ctx);
+    data->is_compressed = FALSE;
+  } else {
+    doc = dia_io_load_document (filename, ctx, &data->is_compressed);
+  }
 
   if (doc == NULL){
     /* this was talking about unknown file type but it could as well be broken XML */
@@ -428,7 +704,7 @@ diagram_data_load (const char  *filename,
   if (root == NULL) {
     message_error (_("Error loading diagram %s.\nUnknown file type."),
                    dia_message_filename (filename));
-    xmlFreeDoc (doc);
+    dia_binary_free_document (doc);
     return FALSE;
   }
 
@@ -436,7 +712,7 @@ diagram_data_load (const char  *filename,
   if (xmlStrcmp (root->name, (const xmlChar *) "diagram") || (namespace == NULL)) {
     message_error (_("Error loading diagram %s.\nNot a Dia file."),
                    dia_message_filename (filename));
-    xmlFreeDoc (doc);
+    dia_binary_free_document (doc);
     return FALSE;
   }
 
@@ -690,6 +966,7 @@ diagram_data_load (const char  *filename,
     find_node_named (root->xmlChildrenNode, "layer");
 
   objects_hash = g_hash_table_new (g_str_hash, g_str_equal);
+  linked_layers = find_linked_layers (root);
 
   while (layer_node != NULL) {
     xmlChar *name;
@@ -712,9 +989,34 @@ diagram_data_load (const char  *filename,
                   "connectable", _get_bool_prop (layer_node, "connectable", FALSE),
                   NULL);
 
-    /* Read in all objects: */
-    list = read_objects (layer_node, objects_hash, ctx, NULL, unknown_objects_hash);
-    dia_layer_add_objects (layer, list);
+    if (!dia_layer_is_visible (layer) &&
+        !g_hash_table_contains (linked_layers, layer_node)) {
+      /* Hidden and self contained, so read it once it's looked at */
+      DeferredLayer *deferred = g_new0 (DeferredLayer, 1);
+
+      if (!shared_doc) {
+        shared_doc = g_rc_box_new (xmlDocPtr);
+        *shared_doc = doc;
+        deferred_nodes = g_hash_table_new (NULL, NULL);
+      }
+
+      deferred->doc = g_rc_box_acquire (shared_doc);
+      deferred->layer_node = layer_node;
+      deferred->filename = g_strdup (filename);
+      g_hash_table_add (deferred_nodes, layer_node);
+
+      dia_layer_defer_objects (layer,
+                               load_deferred_layer,
+                               deferred,
+                               deferred_layer_copy,
+                               deferred_layer_free);
+    } else {
+      dia_binary_doc_decode_node (doc, layer_node, ctx);
+
+      /* Read in all objects: */
+      list = read_objects (layer_node, objects_hash, ctx, NULL, unknown_objects_hash);
+      dia_layer_add_objects (layer, list);
+    }
 
     data_add_layer (data, layer);
     ++num_layers_added;
@@ -743,7 +1045,9 @@ diagram_data_load (const char  *filename,
         break;
       }
 
-      read_connections (dia_layer_get_object_list (layer), layer_node, objects_hash);
+      if (dia_layer_is_loaded (layer)) {
+        read_connections (dia_layer_get_object_list (layer), layer_node, objects_hash);
+      }
       layer_node = layer_node->next;
     }
   }
@@ -763,7 +1067,28 @@ diagram_data_load (const char  *filename,
 
   g_clear_object (&initial_layer);
   g_clear_object (&active_layer);
-  xmlFreeDoc (doc);
+
+  if (shared_doc) {
+    xmlNodePtr node = root->children;
+
+    /* Keep nothing but what the deferred layers need */
+    while (node != NULL) {
+      xmlNodePtr next = node->next;
+
+      if (!g_hash_table_contains (deferred_nodes, node)) {
+        xmlUnlinkNode (node);
+        xmlFreeNode (node);
+      }
+
+      node = next;
+    }
+
+    g_hash_table_destroy (deferred_nodes);
+    g_rc_box_release_full (shared_doc, (GDestroyNotify) clear_shared_doc);
+  } else {
+    dia_binary_free_document (doc);
+  }
+  g_hash_table_destroy (linked_layers);
 
   g_hash_table_foreach (objects_hash, hash_free_string, NULL);
 
@@ -774,16 +1099,9 @@ diagram_data_load (const char  *filename,
                      "A valid Dia file defines at least one layer."),
                    dia_message_filename(filename));
     return FALSE;
-  } else if (0 < g_hash_table_size (unknown_objects_hash)) {
-    GString *unknown_str = g_string_new ("Unknown types while reading diagram file");
-
-    /* show all the unknown types in one message */
-    g_hash_table_foreach (unknown_objects_hash,
-                          GHFuncUnknownObjects,
-                          unknown_str);
-    message_warning ("%s", unknown_str->str);
-    g_string_free (unknown_str, TRUE);
   }
+
+  report_unknown_objects (unknown_objects_hash);
   g_hash_table_destroy (unknown_objects_hash);
 
   return TRUE;
@@ -933,9 +1251,117 @@ write_connections(GList *objects, xmlNodePtr layer_node,
   return TRUE;
 }
 
-/* Filename seems to be junk, but is passed on to objects */
+static void
+renumber_objects (xmlNodePtr node, GHashTable *ids, int *obj_nr)
+{
+  for (xmlNodePtr child = node->children; child != NULL; child = child->next) {
+    xmlChar *id;
+
+    if (child->type != XML_ELEMENT_NODE) {
+      continue;
+    }
+
+    if (xmlStrcmp (child->name, (const xmlChar *) "object") == 0 &&
+        (id = xmlGetProp (child, (const xmlChar *) "id")) != NULL) {
+      char *new_id = g_strdup_printf ("O%d", (*obj_nr)++);
+
+      xmlSetProp (child, (const xmlChar *) "id", (xmlChar *) new_id);
+      g_hash_table_insert (ids, id, new_id);
+    }
+
+    renumber_objects (child, ids, obj_nr);
+  }
+}
+
+
+static void
+renumber_refs (xmlNodePtr node, GHashTable *ids)
+{
+  for (xmlNodePtr child = node->children; child != NULL; child = child->next) {
+    const char *attr = NULL;
+    xmlChar *id;
+
+    if (child->type != XML_ELEMENT_NODE) {
+      continue;
+    }
+
+    if (xmlStrcmp (child->name, (const xmlChar *) "connection") == 0) {
+      attr = "to";
+    } else if (xmlStrcmp (child->name, (const xmlChar *) "childnode") == 0) {
+      attr = "parent";
+    }
+
+    if (attr && (id = xmlGetProp (child, (const xmlChar *) attr)) != NULL) {
+      const char *new_id = g_hash_table_lookup (ids, id);
+
+      if (new_id) {
+        xmlSetProp (child, (const xmlChar *) attr, (const xmlChar *) new_id);
+      }
+      dia_clear_xml_string (&id);
+    }
+
+    renumber_refs (child, ids);
+  }
+}
+
+
+/*
+ * A layer nobody looked at is saved as it was read, without creating the
+ * objects.  Only the ids change, to not clash with the other layers, and
+ * as it is self contained (see find_linked_layers()) its connections and
+ * parents can simply follow.
+ */
+static void
+write_deferred_objects (DeferredLayer *deferred,
+                        xmlNodePtr     layer_node,
+                        int           *obj_nr,
+                        DiaContext    *ctx)
+{
+  GHashTable *ids = g_hash_table_new_full (g_str_hash,
+                                           g_str_equal,
+                                           xmlFree,
+                                           g_free);
+  xmlDOMWrapCtxtPtr wrap = xmlDOMWrapNewCtxt ();
+
+  deferred_layer_decode (deferred, ctx);
+
+  for (xmlNodePtr node = deferred->layer_node->children;
+       node != NULL;
+       node = node->next) {
+    xmlNodePtr copy = NULL;
+
+    /* The objects, the formatting is redone */
+    if (node->type != XML_ELEMENT_NODE) {
+      continue;
+    }
+
+    /* Takes the name space of @layer_node rather than declaring it again */
+    if (xmlDOMWrapCloneNode (wrap, *deferred->doc, node, &copy,
+                             layer_node->doc, layer_node, 1, 0) != 0) {
+      dia_context_add_message (ctx,
+                               _("Error saving the objects of a hidden layer"));
+      continue;
+    }
+
+    xmlAddChild (layer_node, copy);
+  }
+
+  renumber_objects (layer_node, ids, obj_nr);
+  renumber_refs (layer_node, ids);
+  data_adopt_blobs (layer_node, *deferred->doc, ctx);
+
+  xmlDOMWrapFreeCtxt (wrap);
+  g_hash_table_destroy (ids);
+}
+
+
+/* Filename seems to be junk, but is passed on to objects.
+ * With binary the images go out of line, see dia_binary_doc_use_blobs() */
 static xmlDocPtr
-diagram_data_write_doc(DiagramData *data, const char *filename, DiaContext *ctx)
+diagram_data_write_doc (DiagramData *data,
+                        const char  *filename,
+                        gboolean     binary,
+                        DiaContext  *ctx)
 {
   xmlDocPtr doc;
   xmlNodePtr tree;
@@ -953,6 +1379,9 @@ diagram_data_write_doc(DiagramData *data, const char *filename, DiaContext *ctx)
   doc = xmlNewDoc((const xmlChar *)"1.0");
   doc->encoding = xmlStrdup((const xmlChar *)"UTF-8");
   doc->xmlRootNode = xmlNewDocNode(doc, NULL, (const xmlChar *)"diagram", NULL);
+  if (binary) {
+    dia_binary_doc_use_blobs (doc);
+  }
 
   name_space = xmlNewNs(doc->xmlRootNode,
                         (const xmlChar *)DIA_XML_NAME_SPACE_BASE,
@@ -1059,6 +1488,9 @@ diagram_data_write_doc(DiagramData *data, const char *filename, DiaContext *ctx)
   obj_nr = 0;
 
   DIA_FOR_LAYER_IN_DIAGRAM (data, layer, i, {
+    DeferredLayer *deferred = dia_layer_get_load_data (layer,
+                                                       load_deferred_layer);
+
     layer_node = xmlNewChild (doc->xmlRootNode,
                               name_space,
                               (const xmlChar *) "layer", NULL);
@@ -1079,12 +1511,16 @@ diagram_data_write_doc(DiagramData *data, const char *filename, DiaContext *ctx)
                   (const xmlChar *) "true");
     }
 
-    write_objects (dia_layer_get_object_list (layer),
-                   layer_node,
-                   objects_hash,
-                   &obj_nr,
-                   filename,
-                   ctx);
+    if (deferred) {
+      write_deferred_objects (deferred, layer_node, &obj_nr, ctx);
+    } else {
+      write_objects (dia_layer_get_object_list (layer),
+                     layer_node,
+                     objects_hash,
+                     &obj_nr,
+                     filename,
+                     ctx);
+    }
   });
   /* The connections are stored per layer in the file format, but connections are not any longer
    * restricted to objects on the same layer. So we iterate over all the layer (nodes) again to
@@ -1101,6 +1537,11 @@ diagram_data_write_doc(DiagramData *data, const char *filename, DiaContext *ctx)
                                dia_layer_get_name (layer));
       break;
     }
+    /* Connected already, see write_deferred_objects() */
+    if (!dia_layer_is_loaded (layer)) {
+      layer_node = layer_node->next;
+      continue;
+    }
     res = write_connections (dia_layer_get_object_list (layer),
                              layer_node,
                              objects_hash);
@@ -1124,15 +1565,20 @@ diagram_data_write_doc(DiagramData *data, const char *filename, DiaContext *ctx)
 static gboolean
 diagram_data_raw_save (DiagramData *data,
                        const char  *filename,
+                       gboolean     binary,
                        DiaContext  *ctx)
 {
   xmlDocPtr doc;
   gboolean ret;
 
-  doc = diagram_data_write_doc (data, filename, ctx);
-  ret = dia_io_save_document (filename, doc, data->is_compressed, ctx);
+  doc = diagram_data_write_doc (data, filename, binary, ctx);
+  if (binary) {
+    ret = dia_binary_save_document (filename, doc, ctx);
+  } else {
+    ret = dia_io_save_document (filename, doc, data->is_compressed, ctx);
+  }
 
-  g_clear_pointer (&doc, xmlFreeDoc);
+  g_clear_pointer (&doc, dia_binary_free_document);
 
   return ret;
 }
@@ -1141,15 +1587,17 @@ diagram_data_raw_save (DiagramData *data,
 /** This saves the diagram, using a backup in case of failure.
  * @param data
  * @param filename
+ * @param binary write the binary container rather than XML
  * @returns TRUE on successful save, FALSE otherwise.  If a failure is
  * indicated, an error message will already have been given to the user.
  */
 static gboolean
 diagram_data_save (DiagramData *data,
                    DiaContext  *ctx,
-                   const char  *user_filename)
+                   const char  *user_filename,
+                   gboolean     binary)
 {
-  gboolean ret = diagram_data_raw_save (data, user_filename, ctx);
+  gboolean ret = diagram_data_raw_save (data, user_filename, binary, ctx);
 
   if (!ret) {
     /* Save failed; we clean our stuff up, without touching the file named
@@ -1169,7 +1617,11 @@ diagram_save (Diagram *dia, const char *filename, DiaContext *ctx)
 {
   gboolean res = FALSE;
 
-  if (diagram_data_save(dia->data, ctx, filename)) {
+  /* Keep files in the format their name promises */
+  if (diagram_data_save (dia->data,
+                         ctx,
+                         filename,
+                         g_str_has_suffix (filename, ".diab"))) {
     dia->unsaved = FALSE;
     undo_mark_save(dia->undo);
     diagram_set_modified (dia, FALSE);
@@ -1210,6 +1662,7 @@ typedef struct {
   DiagramData *clone;
   gchar       *filename;
   DiaContext  *ctx;
+  gboolean     binary;
 } AutoSaveInfo;
 /*!
  * Efficient and easy to implement autosave in a thread:
@@ -1229,7 +1682,7 @@ _autosave_in_thread (gpointer data)
 {
   AutoSaveInfo *asi = (AutoSaveInfo *)data;
 
-  diagram_data_raw_save(asi->clone, asi->filename, asi->ctx);
+  diagram_data_raw_save (asi->clone, asi->filename, asi->binary, asi->ctx);
   g_clear_object (&asi->clone);
   g_clear_pointer (&asi->filename, g_free);
   /* FIXME: this is throwing away potential messages ... */
@@ -1277,6 +1730,7 @@ diagram_autosave (Diagram *dia)
         asi->clone = diagram_data_clone (dia->data);
         asi->filename = g_strdup (save_filename);
         asi->ctx = dia_context_new (_("Auto save"));
+        asi->binary = g_str_has_suffix (dia->filename, ".diab");
 
         if (!g_thread_try_new ("Autosave", _autosave_in_thread, asi, &error)) {
           message_error ("%s", error->message);
@@ -1289,7 +1743,10 @@ diagram_autosave (Diagram *dia)
       {
         DiaContext *ctx = dia_context_new (_("Auto save"));
         dia_context_set_filename (ctx, save_filename);
-        diagram_data_raw_save (dia->data, save_filename, ctx);
+        diagram_data_raw_save (dia->data,
+                               save_filename,
+                               g_str_has_suffix (dia->filename, ".diab"),
+                               ctx);
         dia->autosaved = TRUE;
         dia_context_release (ctx);
       }
@@ -1306,7 +1763,17 @@ export_native(DiagramData *data, DiaContext *ctx,
 	      const gchar *filename, const gchar *diafilename,
 	      void* user_data)
 {
-  return diagram_data_save(data, ctx, filename);
+  return diagram_data_save(data, ctx, filename, FALSE);
+}
+
+static gboolean
+export_binary (DiagramData *data,
+               DiaContext  *ctx,
+               const char  *filename,
+               const char  *diafilename,
+               void        *user_data)
+{
+  return diagram_data_save (data, ctx, filename, TRUE);
 }
 
 static const gchar *extensions[] = { "dia", NULL };
@@ -1320,3 +1787,21 @@ DiaImportFilter dia_import_filter = {
   extensions,
   diagram_data_load
 };
+
+/* The same diagram model without the XML tokenising, for huge diagrams.
+ * diagram_data_load() tells the two apart by content. */
+static const char *binary_extensions[] = { "diab", NULL };
+DiaExportFilter dia_binary_export_filter = {
+  N_("Dia Binary Diagram File"),
+  binary_extensions,
+  export_binary,
+  NULL,
+  "dia-binary"
+};
+DiaImportFilter dia_binary_import_filter = {
+  N_("Dia Binary Diagram File"),
+  binary_extensions,
+  diagram_data_load,
+  NULL,
+  "dia-binary"
+};
@@ -27,5 +27,7 @@ void diagram_cleanup_autosave(Diagram *dia);
 
 extern DiaExportFilter dia_export_filter;
 extern DiaImportFilter dia_import_filter;
+extern DiaExportFilter dia_binary_export_filter;
+extern DiaImportFilter dia_binary_import_filter;
 
 #endif /* LOAD_SAVE_H */
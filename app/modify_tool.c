@@ -85,6 +85,20 @@ struct _ModifyTool {
 
   /* Guide info: */
   DiaGuide *guide;
+
+  /* Drags are applied once per frame, with the latest position: */
+  GdkEvent *pending_motion;
+  DDisplay *pending_ddisp;
+  gint64 pending_since;
+  GtkWidget *tick_widget;
+  guint tick_id;
+
+  /* ...and how that went, see modify_motion_trace() */
+  guint motion_events;
+  guint motion_moves;
+  guint64 motion_start_frames;
+  gint64 motion_total_latency;
+  gint64 motion_max_latency;
 };
 
 
@@ -158,6 +172,11 @@ void
 free_modify_tool (Tool *tool)
 {
   ModifyTool *mtool = (ModifyTool *)tool;
+
+  if (mtool->tick_id != 0) {
+    gtk_widget_remove_tick_callback (mtool->tick_widget, mtool->tick_id);
+  }
+  g_clear_pointer (&mtool->pending_motion, gdk_event_free);
   g_clear_pointer (&mtool, g_free);
 }
 
@@ -467,9 +486,9 @@ modify_move_already(ModifyTool *tool, DDisplay *ddisp, Point *to)
 }
 
 static void
-modify_motion (ModifyTool     *tool,
-               GdkEventMotion *event,
-               DDisplay       *ddisp)
+modify_apply_motion (ModifyTool     *tool,
+                     GdkEventMotion *event,
+                     DDisplay       *ddisp)
 {
   Point to;
   Point now, delta, full_delta;
@@ -707,6 +726,134 @@ modify_motion (ModifyTool     *tool,
   tool->auto_scrolled = auto_scroll;
 }
 
+
+static void
+modify_apply_pending_motion (ModifyTool *tool)
+{
+  GdkEvent *event = g_steal_pointer (&tool->pending_motion);
+  gint64 latency;
+
+  if (event == NULL) {
+    return;
+  }
+
+  latency = g_get_monotonic_time () - tool->pending_since;
+  tool->motion_moves++;
+  tool->motion_total_latency += latency;
+  tool->motion_max_latency = MAX (tool->motion_max_latency, latency);
+
+  modify_apply_motion (tool, (GdkEventMotion *) event, tool->pending_ddisp);
+
+  gdk_event_free (event);
+}
+
+
+static gboolean
+modify_motion_tick (GtkWidget     *widget,
+                    GdkFrameClock *frame_clock,
+                    gpointer       user_data)
+{
+  ModifyTool *tool = user_data;
+
+  modify_apply_pending_motion (tool);
+
+  return G_SOURCE_REMOVE;
+}
+
+
+static void
+modify_motion_tick_removed (gpointer user_data)
+{
+  ModifyTool *tool = user_data;
+
+  tool->tick_id = 0;
+  tool->tick_widget = NULL;
+  /* Only left over if the canvas went away */
+  g_clear_pointer (&tool->pending_motion, gdk_event_free);
+}
+
+
+/* Apply a drag now, before the frame clock gets to it */
+static void
+modify_flush_motion (ModifyTool *tool)
+{
+  modify_apply_pending_motion (tool);
+
+  if (tool->tick_id != 0) {
+    gtk_widget_remove_tick_callback (tool->tick_widget, tool->tick_id);
+    tool->tick_id = 0;
+    tool->tick_widget = NULL;
+  }
+}
+
+
+/*
+ * With G_MESSAGES_DEBUG set this tells how many motion events a drag got,
+ * how many of them were applied and drawn, and how long they waited.
+ */
+static void
+modify_motion_trace (ModifyTool *tool, DDisplay *ddisp)
+{
+  DDisplayUpdateStats stats;
+
+  if (tool->motion_events == 0) {
+    return;
+  }
+
+  ddisplay_get_update_stats (ddisp, &stats);
+
+  g_debug ("%s: %u motion events, %u moves, %" G_GUINT64_FORMAT " frames, "
+           "latency %.1fms average, %.1fms max",
+           G_STRLOC,
+           tool->motion_events,
+           tool->motion_moves,
+           stats.frames - tool->motion_start_frames,
+           tool->motion_moves ? tool->motion_total_latency / (1000.0 * tool->motion_moves) : 0.0,
+           tool->motion_max_latency / 1000.0);
+
+  tool->motion_events = 0;
+  tool->motion_moves = 0;
+  tool->motion_total_latency = 0;
+  tool->motion_max_latency = 0;
+}
+
+
+static void
+modify_motion (ModifyTool     *tool,
+               GdkEventMotion *event,
+               DDisplay       *ddisp)
+{
+  /* Everything else is cheap enough to do right away */
+  if (tool->state != STATE_MOVE_OBJECT && tool->state != STATE_MOVE_HANDLE) {
+    modify_apply_motion (tool, event, ddisp);
+    return;
+  }
+
+  if (tool->motion_events == 0) {
+    DDisplayUpdateStats stats;
+
+    ddisplay_get_update_stats (ddisp, &stats);
+    tool->motion_start_frames = stats.frames;
+  }
+  tool->motion_events++;
+
+  /* Only the latest position matters */
+  if (tool->pending_motion == NULL) {
+    tool->pending_since = g_get_monotonic_time ();
+  }
+  g_clear_pointer (&tool->pending_motion, gdk_event_free);
+  tool->pending_motion = gdk_event_copy ((GdkEvent *) event);
+  tool->pending_ddisp = ddisp;
+
+  if (tool->tick_id == 0) {
+    tool->tick_widget = ddisp->canvas;
+    tool->tick_id = gtk_widget_add_tick_callback (ddisp->canvas,
+                                                  modify_motion_tick,
+                                                  tool,
+                                                  modify_motion_tick_removed);
+  }
+}
+
 /** Find the list of objects selected by current rubberbanding.
  * The list should be freed after use. */
 static GList *
@@ -739,6 +886,10 @@ modify_button_release (ModifyTool     *tool,
   int i;
   DiaObjectChange *objchange;
 
+  /* Where the pointer was last, before it let go */
+  modify_flush_motion (tool);
+  modify_motion_trace (tool, ddisp);
+
   tool->break_connections = FALSE;
   ddisplay_set_all_cursor(default_cursor);
 
@@ -22,20 +22,250 @@
  *
  */
 
+#include <math.h>
+#include <string.h>
+
 #include <gtk/gtk.h>
 
 #include <xpm-pixbuf.h>
 
 #include "diagram.h"
 #include "display.h"
+#include "diainteractiverenderer.h"
 #include "renderer/diacairo.h"
 #include "navigation.h"
 
 #define THUMBNAIL_MAX_SIZE 150 /*(pixels) this may be a preference*/
+#define THUMBNAIL_BAND 16 /*(pixels) rows rendered per idle call*/
+#define THUMBNAIL_MIN_OBJECT 2.0 /*(pixels) smaller objects are just boxes*/
+#define THUMBNAIL_MIN_TEXT 3.0 /*(pixels) lower text is just a bar*/
 #define DIAGRAM_OFFSET 1 /*(diagram's unit) so we can see the little green boxes :)*/
 #define FRAME_THICKNESS 2 /*(pixels)*/
 #define STD_CURSOR_MIN 16 /*(pixels)*/
 
+
+/*
+ * The thumbnail of a diagram is kept up to date with the same updates
+ * its displays get, rendered in bands when there is nothing else to do,
+ * so the popup only has to show it
+ */
+typedef struct _NavigationThumbnail NavigationThumbnail;
+struct _NavigationThumbnail {
+  Diagram *diagram;       /* Not owned, the thumbnail is its data */
+
+  DiaRenderer *renderer;  /* Holds the thumbnail's surface */
+  DiaRectangle visible;   /* The diagram's extents when last rendered */
+  double zoom;
+  int width;
+  int height;
+
+  cairo_region_t *dirty;  /* What's still to be rendered, in pixels */
+  guint idle_id;
+};
+
+
+static void
+thumbnail_free (gpointer data)
+{
+  NavigationThumbnail *thumbnail = data;
+
+  g_clear_handle_id (&thumbnail->idle_id, g_source_remove);
+  g_clear_object (&thumbnail->renderer);
+  g_clear_pointer (&thumbnail->dirty, cairo_region_destroy);
+  g_free (thumbnail);
+}
+
+
+static NavigationThumbnail *
+thumbnail_get (Diagram *dia, gboolean create)
+{
+  NavigationThumbnail *thumbnail = g_object_get_data (G_OBJECT (dia),
+                                                      "dia-navigation-thumbnail");
+
+  if (!thumbnail && create) {
+    thumbnail = g_new0 (NavigationThumbnail, 1);
+    thumbnail->diagram = dia;
+    thumbnail->dirty = cairo_region_create ();
+    thumbnail->renderer = dia_cairo_interactive_renderer_new ();
+    g_object_set (thumbnail->renderer,
+                  "zoom", &thumbnail->zoom,
+                  "rect", &thumbnail->visible,
+                  "min-object-size", THUMBNAIL_MIN_OBJECT,
+                  "min-text-size", THUMBNAIL_MIN_TEXT,
+                  NULL);
+
+    g_object_set_data_full (G_OBJECT (dia),
+                            "dia-navigation-thumbnail",
+                            thumbnail,
+                            thumbnail_free);
+  }
+
+  return thumbnail;
+}
+
+
+static void
+thumbnail_dirty_all (NavigationThumbnail *thumbnail)
+{
+  cairo_rectangle_int_t all = { 0, 0, thumbnail->width, thumbnail->height };
+
+  cairo_region_union_rectangle (thumbnail->dirty, &all);
+}
+
+
+/* Follows the diagram's extents, starting over if they changed */
+static void
+thumbnail_update_geometry (NavigationThumbnail *thumbnail)
+{
+  DiagramData *data = DIA_DIAGRAM_DATA (thumbnail->diagram);
+  DiaRectangle rect;
+
+  rect.top    = data->extents.top    - DIAGRAM_OFFSET;
+  rect.left   = data->extents.left   - DIAGRAM_OFFSET;
+  rect.bottom = data->extents.bottom + DIAGRAM_OFFSET + 1;
+  rect.right  = data->extents.right  + DIAGRAM_OFFSET + 1;
+
+  if (thumbnail->width > 0 && memcmp (&rect, &thumbnail->visible, sizeof (rect)) == 0) {
+    return;
+  }
+
+  thumbnail->visible = rect;
+  thumbnail->zoom = THUMBNAIL_MAX_SIZE / MAX ((rect.right - rect.left), (rect.bottom - rect.top));
+  thumbnail->width = MIN (THUMBNAIL_MAX_SIZE, (rect.right - rect.left) * thumbnail->zoom);
+  thumbnail->height = MIN (THUMBNAIL_MAX_SIZE, (rect.bottom - rect.top) * thumbnail->zoom);
+
+  dia_interactive_renderer_set_size (DIA_INTERACTIVE_RENDERER (thumbnail->renderer),
+                                     NULL,
+                                     thumbnail->width,
+                                     thumbnail->height);
+
+  cairo_region_destroy (thumbnail->dirty);
+  thumbnail->dirty = cairo_region_create ();
+  thumbnail_dirty_all (thumbnail);
+}
+
+
+/* Renders the first band of what is dirty, returns FALSE if there was none */
+static gboolean
+thumbnail_render_band (NavigationThumbnail *thumbnail)
+{
+  DiaInteractiveRenderer *renderer = DIA_INTERACTIVE_RENDERER (thumbnail->renderer);
+  DiagramData *data = DIA_DIAGRAM_DATA (thumbnail->diagram);
+  cairo_rectangle_int_t band;
+  DiaRectangle update;
+
+  if (cairo_region_is_empty (thumbnail->dirty)) {
+    return FALSE;
+  }
+
+  cairo_region_get_rectangle (thumbnail->dirty, 0, &band);
+  band.height = MIN (band.height, THUMBNAIL_BAND);
+  cairo_region_subtract_rectangle (thumbnail->dirty, &band);
+
+  update.left = thumbnail->visible.left + band.x / thumbnail->zoom;
+  update.top = thumbnail->visible.top + band.y / thumbnail->zoom;
+  update.right = thumbnail->visible.left + (band.x + band.width) / thumbnail->zoom;
+  update.bottom = thumbnail->visible.top + (band.y + band.height) / thumbnail->zoom;
+
+  dia_interactive_renderer_clip_region_clear (renderer);
+  dia_interactive_renderer_clip_region_add_rect (renderer, &update);
+
+  dia_renderer_begin_render (thumbnail->renderer, &update);
+  dia_interactive_renderer_fill_pixel_rect (renderer,
+                                            band.x,
+                                            band.y,
+                                            band.width,
+                                            band.height,
+                                            &data->bg_color);
+  data_render (data, thumbnail->renderer, &update, NULL, NULL);
+  dia_renderer_end_render (thumbnail->renderer);
+
+  return TRUE;
+}
+
+
+static gboolean
+thumbnail_idle (gpointer data)
+{
+  NavigationThumbnail *thumbnail = data;
+
+  thumbnail_update_geometry (thumbnail);
+
+  if (thumbnail_render_band (thumbnail)) {
+    return G_SOURCE_CONTINUE;
+  }
+
+  thumbnail->idle_id = 0;
+
+  return G_SOURCE_REMOVE;
+}
+
+
+static void
+thumbnail_queue (NavigationThumbnail *thumbnail)
+{
+  if (thumbnail->idle_id == 0) {
+    thumbnail->idle_id = g_idle_add_full (G_PRIORITY_LOW,
+                                          thumbnail_idle,
+                                          thumbnail,
+                                          NULL);
+  }
+}
+
+
+/**
+ * navigation_thumbnail_add_update:
+ * @dia: the #Diagram that changed
+ * @update: the area that changed
+ *
+ * Marks @update as to be rendered again in the navigation thumbnail
+ * of @dia, if it has one.
+ *
+ * Since: 0.98
+ */
+void
+navigation_thumbnail_add_update (Diagram *dia, const DiaRectangle *update)
+{
+  NavigationThumbnail *thumbnail = thumbnail_get (dia, FALSE);
+  cairo_rectangle_int_t pixels;
+
+  if (!thumbnail || thumbnail->width == 0) {
+    return;
+  }
+
+  /* One pixel more around, for antialiasing */
+  pixels.x = floor ((update->left - thumbnail->visible.left) * thumbnail->zoom) - 1;
+  pixels.y = floor ((update->top - thumbnail->visible.top) * thumbnail->zoom) - 1;
+  pixels.width = ceil ((update->right - thumbnail->visible.left) * thumbnail->zoom) + 1 - pixels.x;
+  pixels.height = ceil ((update->bottom - thumbnail->visible.top) * thumbnail->zoom) + 1 - pixels.y;
+
+  cairo_region_union_rectangle (thumbnail->dirty, &pixels);
+  thumbnail_queue (thumbnail);
+}
+
+
+/**
+ * navigation_thumbnail_add_update_all:
+ * @dia: the #Diagram that changed
+ *
+ * Marks the whole navigation thumbnail of @dia, if it has one, as to be
+ * rendered again.
+ *
+ * Since: 0.98
+ */
+void
+navigation_thumbnail_add_update_all (Diagram *dia)
+{
+  NavigationThumbnail *thumbnail = thumbnail_get (dia, FALSE);
+
+  if (!thumbnail) {
+    return;
+  }
+
+  thumbnail_dirty_all (thumbnail);
+  thumbnail_queue (thumbnail);
+}
+
 #define DIA_TYPE_NAVIGATION_WINDOW dia_navigation_window_get_type ()
 G_DECLARE_FINAL_TYPE (DiaNavigationWindow, dia_navigation_window, DIA, NAVIGATION_WINDOW, GtkWindow)
 
@@ -59,8 +289,8 @@ struct _DiaNavigationWindow {
   double hadj_coef;
   double vadj_coef;
 
-  /*diagram thumbnail's buffer*/
-  cairo_surface_t *surface;
+  /*renders and holds the diagram's thumbnail*/
+  DiaRenderer *renderer;
 
   /*display to navigate*/
   DDisplay * ddisp;
@@ -137,17 +367,19 @@ static void
 dia_navigation_window_constructed (GObject *object)
 {
   DiaNavigationWindow *self = DIA_NAVIGATION_WINDOW (object);
-  DiagramData * data;
+  NavigationThumbnail *thumbnail;
 
   DiaRectangle rect;/*diagram's extents*/
-  double zoom;/*zoom factor for thumbnail rendering*/
-
-  DiaCairoRenderer *renderer;
 
   G_OBJECT_CLASS (dia_navigation_window_parent_class)->constructed (object);
 
-  /*--Retrieve the diagram's data*/
-  data = self->ddisp->diagram->data;
+  /*--Bring the thumbnail up to date, usually it already is*/
+  thumbnail = thumbnail_get (self->ddisp->diagram, TRUE);
+  thumbnail_update_geometry (thumbnail);
+  while (thumbnail_render_band (thumbnail)) {
+    /* the rest of what the idle handler didn't get to */
+  }
+  self->renderer = g_object_ref (thumbnail->renderer);
 
   /*--Calculate sizes*/
   {
@@ -159,15 +391,10 @@ dia_navigation_window_constructed (GObject *object)
     self->max_size = THUMBNAIL_MAX_SIZE;
 
     /*size: Diagram <--> thumbnail*/
-    rect.top    = data->extents.top    - DIAGRAM_OFFSET;
-    rect.left   = data->extents.left   - DIAGRAM_OFFSET;
-    rect.bottom = data->extents.bottom + DIAGRAM_OFFSET + 1;
-    rect.right  = data->extents.right  + DIAGRAM_OFFSET + 1;
-
-    zoom = self->max_size / MAX( (rect.right - rect.left) , (rect.bottom - rect.top) );
+    rect = thumbnail->visible;
 
-    self->width  = MIN (self->max_size, (rect.right  - rect.left) * zoom);
-    self->height = MIN (self->max_size, (rect.bottom - rect.top)  * zoom);
+    self->width  = thumbnail->width;
+    self->height = thumbnail->height;
 
     /*size: display canvas <--> frame cursor*/
     diagram_width  = (int) ddisplay_transform_length (self->ddisp, (rect.right - rect.left));
@@ -200,20 +427,6 @@ dia_navigation_window_constructed (GObject *object)
 
   gtk_widget_set_size_request (GTK_WIDGET (self), self->width, self->height);
 
-  /* surface to draw the thumbnail on */
-  self->surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
-                                             self->width,
-                                             self->height);
-
-  renderer = g_object_new (DIA_CAIRO_TYPE_RENDERER, NULL);
-  renderer->scale = zoom;
-  renderer->surface = cairo_surface_reference (self->surface);
-
-  /*render the data*/
-  data_render (data, DIA_RENDERER (renderer), NULL, NULL, NULL);
-
-  g_clear_object (&renderer);
-
   self->is_first_expose = TRUE;/*set to request to draw the miniframe*/
 }
 
@@ -224,7 +437,7 @@ dia_navigation_window_dispose (GObject *object)
   DiaNavigationWindow *self = DIA_NAVIGATION_WINDOW (object);
 
   g_clear_object (&self->cursor);
-  g_clear_pointer (&self->surface, cairo_surface_destroy);
+  g_clear_object (&self->renderer);
 
   G_OBJECT_CLASS (dia_navigation_window_parent_class)->dispose (object);
 }
@@ -242,8 +455,10 @@ dia_navigation_window_draw (GtkWidget *widget, cairo_t *ctx)
   cairo_set_line_join (ctx, CAIRO_LINE_JOIN_MITER);
 
   /*refresh the part outdated by the event*/
-  cairo_set_source_surface (ctx, self->surface, 0, 0);
-  cairo_paint (ctx);
+  dia_interactive_renderer_paint (DIA_INTERACTIVE_RENDERER (self->renderer),
+                                  ctx,
+                                  self->width,
+                                  self->height);
 
   adj = self->ddisp->hsbdata;
   x = (gtk_adjustment_get_value (adj) - gtk_adjustment_get_lower (adj)) /
@@ -478,6 +693,9 @@ navigation_popup_new (DDisplay *ddisp)
   GtkWidget *image;
   GdkPixbuf *pixbuf;
 
+  /* Have the thumbnail ready before it's asked for */
+  thumbnail_queue (thumbnail_get (ddisp->diagram, TRUE));
+
   button = gtk_button_new ();
   gtk_container_set_border_width (GTK_CONTAINER (button), 0);
   gtk_button_set_relief (GTK_BUTTON (button), GTK_RELIEF_NONE);
@@ -29,6 +29,9 @@
 
 G_BEGIN_DECLS
 
-GtkWidget *navigation_popup_new (DDisplay *ddisp);
+GtkWidget *navigation_popup_new                (DDisplay           *ddisp);
+void       navigation_thumbnail_add_update     (Diagram            *dia,
+                                                const DiaRectangle *update);
+void       navigation_thumbnail_add_update_all (Diagram            *dia);
 
 G_END_DECLS
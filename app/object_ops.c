@@ -27,6 +27,7 @@
 #include "handle_ops.h"
 #include "message.h"
 #include "object.h"
+#include "dia-layer.h"
 
 #define OBJECT_CONNECT_DISTANCE 4.5
 
@@ -35,6 +36,11 @@ object_add_updates(DiaObject *obj, Diagram *dia)
 {
   int i;
 
+  /* Before and after every change, so the layer caches see it */
+  if (dia_object_get_parent_layer (obj)) {
+    dia_layer_changed (dia_object_get_parent_layer (obj));
+  }
+
   /* Bounding box */
   if (data_object_get_highlight(dia->data,obj) != DIA_HIGHLIGHT_NONE) {
     diagram_add_update_with_border(dia, dia_object_get_enclosing_box (obj), 5);
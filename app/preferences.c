@@ -28,6 +28,7 @@
 #include <gtk/gtk.h>
 
 #include "diagram.h"
+#include "display.h"
 #include "message.h"
 #include "preferences.h"
 #include "dia_dirs.h"
@@ -385,6 +386,26 @@ vd_antialiased_toggled (GtkCheckButton *check,
 }
 
 
+static void
+vd_lod_object_value_changed (GtkSpinButton *spin,
+                             gpointer       data)
+{
+  prefs.lod.object_pixels = gtk_spin_button_get_value (spin);
+  persistence_set_integer ("lod_object_pixels", prefs.lod.object_pixels);
+  ddisplay_update_all_lod ();
+}
+
+
+static void
+vd_lod_text_value_changed (GtkSpinButton *spin,
+                           gpointer       data)
+{
+  prefs.lod.text_pixels = gtk_spin_button_get_value (spin);
+  persistence_set_integer ("lod_text_pixels", prefs.lod.text_pixels);
+  ddisplay_update_all_lod ();
+}
+
+
 static void
 vd_pb_visible_toggled (GtkCheckButton *check,
                        gpointer        data)
@@ -737,6 +758,8 @@ dia_preferences_dialog_init (DiaPreferencesDialog *self)
   GtkAdjustment *vd_height_adj;
   GtkAdjustment *vd_zoom_adj;
   GtkWidget *vd_antialiased;
+  GtkAdjustment *vd_lod_object_adj;
+  GtkAdjustment *vd_lod_text_adj;
   GtkWidget *vd_pb_visible;
   GtkWidget *vd_pb_colour;
   GtkWidget *vd_pb_solid;
@@ -809,6 +832,8 @@ dia_preferences_dialog_init (DiaPreferencesDialog *self)
                    "vd_height_adj", &vd_height_adj,
                    "vd_zoom_adj", &vd_zoom_adj,
                    "vd_antialiased", &vd_antialiased,
+                   "vd_lod_object_adj", &vd_lod_object_adj,
+                   "vd_lod_text_adj", &vd_lod_text_adj,
                    "vd_pb_visible", &vd_pb_visible,
                    "vd_pb_colour", &vd_pb_colour,
                    "vd_pb_solid", &vd_pb_solid,
@@ -908,6 +933,8 @@ dia_preferences_dialog_init (DiaPreferencesDialog *self)
   gtk_adjustment_set_value (vd_zoom_adj, prefs.new_view.zoom);
   gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (vd_antialiased),
                                 prefs.view_antialiased);
+  gtk_adjustment_set_value (vd_lod_object_adj, prefs.lod.object_pixels);
+  gtk_adjustment_set_value (vd_lod_text_adj, prefs.lod.text_pixels);
   gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (vd_pb_visible),
                                 prefs.pagebreak.visible);
   dia_colour_selector_set_colour (DIA_COLOUR_SELECTOR (vd_pb_colour),
@@ -997,6 +1024,8 @@ dia_preferences_dialog_init (DiaPreferencesDialog *self)
                        "vd_height_value_changed", G_CALLBACK (vd_height_value_changed),
                        "vd_zoom_value_changed", G_CALLBACK (vd_zoom_value_changed),
                        "vd_antialiased_toggled", G_CALLBACK (vd_antialiased_toggled),
+                       "vd_lod_object_value_changed", G_CALLBACK (vd_lod_object_value_changed),
+                       "vd_lod_text_value_changed", G_CALLBACK (vd_lod_text_value_changed),
                        "vd_pb_visible_toggled", G_CALLBACK (vd_pb_visible_toggled),
                        "vd_pb_colour_changed", G_CALLBACK (vd_pb_colour_changed),
                        "vd_pb_solid_toggled", G_CALLBACK (vd_pb_solid_toggled),
@@ -1063,6 +1092,8 @@ dia_preferences_init (void)
   /* This used to be length_unit and font_unit but the underlying representation changed */
   prefs_set_length_unit (g_enum_get_value_by_nick (unit_class, persistence_register_string ("length-unit", "centimetre"))->value);
   prefs_set_fontsize_unit (g_enum_get_value_by_nick (unit_class, persistence_register_string ("font-unit", "point"))->value);
+  /* Fractional digits of cm written for coordinates in .dia files, e.g. 4 for 1/1000 mm; -1 keeps them exact */
+  prefs_set_save_precision (persistence_register_integer ("save_precision", -1));
   prefs.snap_distance = persistence_register_integer ("snap_distance", 10);
   prefs.new_view.use_menu_bar = persistence_register_boolean ("use_menu_bar", TRUE);
   prefs.toolbox_on_top = persistence_register_boolean ("toolbox_on_top", FALSE);
@@ -1078,6 +1109,8 @@ dia_preferences_init (void)
   prefs.new_view.height = persistence_register_integer ("new_view_height", 400);
   prefs.new_view.zoom = persistence_register_real ("new_view_zoom", 100);
   prefs.view_antialiased = persistence_register_boolean ("view_antialiased", TRUE);
+  prefs.lod.object_pixels = persistence_register_integer ("lod_object_pixels", 3);
+  prefs.lod.text_pixels = persistence_register_integer ("lod_text_pixels", 4);
   prefs.pagebreak.visible = persistence_register_boolean ("pagebreak_visible", TRUE);
   prefs.new_diagram.pagebreak_color = *persistence_register_color ("pagebreak_colour", &break_bg);
   prefs.pagebreak.solid = persistence_register_boolean ("pagebreak_solid", TRUE);
@@ -51,6 +51,12 @@ struct DiaPreferences {
   int snap_object; /* mainpoint_magnetism : the whole object is the connection point */
   int view_antialiased;
 
+  /* Below these sizes, in pixels, the display draws simplified */
+  struct {
+    int object_pixels;
+    int text_pixels;
+  } lod;
+
   int reset_tools_after_create;
   int undo_depth;
   int reverse_rubberbanding_intersects;
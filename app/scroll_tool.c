@@ -126,9 +126,8 @@ scroll_motion(ScrollTool *tool, GdkEventMotion *event,
 
     /* we use this so you can scroll past the edge of the image */
     point_add(&delta, &ddisp->origo);
-    ddisplay_set_origo(ddisp, delta.x, delta.y);
-    ddisplay_update_scrollbars(ddisp);
-    ddisplay_add_update_all(ddisp);
+    ddisplay_scroll_to (ddisp, delta.x, delta.y);
+    ddisplay_update_scrollbars (ddisp);
   } else {
     delta = to;
     point_sub(&delta, &tool->last_pos);
@@ -0,0 +1,1305 @@
+/* Dia -- an diagram creation/manipulation program
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#define G_LOG_DOMAIN "DiaBinary"
+
+#include <glib/gi18n-lib.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <gio/gio.h>
+#include <glib/gstdio.h>
+
+#include "dia-binary.h"
+
+/*
+ * The binary container holds exactly the same element/attribute tree as
+ * a .dia XML file, so anything reading the xmlDoc (diagram_data_load(),
+ * the object loaders) works unchanged.  What goes away is the tokenising:
+ * every name and value is stored once in a string table and referenced
+ * by index, and the tree is a flat stream of tagged records.
+ *
+ * All integers are unsigned LEB128 varints.
+ *
+ *   magic        DIA_BINARY_MAGIC
+ *   version      DIA_BINARY_VERSION
+ *   n_strings    then per string: length, bytes, '\0'
+ *   n_chunks     then per chunk: offset into the chunk area, length
+ *   chunk area
+ *
+ * Chunk 0 holds the root element.  Each <layer> directly below the root
+ * is written to a chunk of its own and referenced from its parent by
+ * NODE_CHUNK, so a layer can be located (and skipped) without decoding
+ * what comes before it.
+ *
+ * A chunk holds a single node:
+ *
+ *   NODE_ELEMENT  name, has_ns [, ns prefix],
+ *                 n_ns_defs × (prefix, href), n_attrs × (name, value),
+ *                 child nodes..., NODE_END
+ *   NODE_TEXT     content
+ *   NODE_CHUNK    chunk index
+ *
+ * An empty prefix stands for the default namespace.
+ *
+ * Version 2 adds blobs, encoded images stored out of line instead of as
+ * base64 text.  The chunk table is followed by
+ *
+ *   n_blobs      then per blob: name (string index), offset into the
+ *                chunk area, length
+ *
+ * A blob is named after the SHA-256 of its content, so the same image is
+ * stored only once however often it is used.  See dia_binary_doc_use_blobs().
+ * Files without blobs are still written as version 1.
+ */
+
+#define DIA_BINARY_MAGIC "DiaB\r\n\032\n"
+#define DIA_BINARY_MAGIC_LEN 8
+#define DIA_BINARY_VERSION 1
+#define DIA_BINARY_VERSION_BLOBS 2
+
+/* Protects the decoder's stack against hostile files */
+#define MAX_DEPTH 1024
+
+
+enum {
+  NODE_END = 0,
+  NODE_ELEMENT,
+  NODE_TEXT,
+  NODE_CHUNK,
+};
+
+
+typedef struct _Decoder Decoder;
+static void decoder_free (Decoder *dec);
+
+
+/* Kept in xmlDoc::_private */
+typedef struct _DocPrivate DocPrivate;
+struct _DocPrivate {
+  /* blob name -> GBytes, NULL if the document has no blobs */
+  GHashTable *by_name;
+  /* the blob names, in the order they were added */
+  GPtrArray  *names;
+  /* for the layers still to decode, see dia_binary_load_document() */
+  Decoder    *decoder;
+};
+
+
+static DocPrivate *
+doc_private (xmlDocPtr doc)
+{
+  if (!doc->_private) {
+    doc->_private = g_new0 (DocPrivate, 1);
+  }
+
+  return doc->_private;
+}
+
+
+static void
+doc_private_use_blobs (DocPrivate *priv)
+{
+  priv->by_name = g_hash_table_new_full (g_str_hash,
+                                         g_str_equal,
+                                         NULL,
+                                         (GDestroyNotify) g_bytes_unref);
+  priv->names = g_ptr_array_new_with_free_func (g_free);
+}
+
+
+static void
+doc_private_free (DocPrivate *priv)
+{
+  g_clear_pointer (&priv->by_name, g_hash_table_destroy);
+  g_clear_pointer (&priv->names, g_ptr_array_unref);
+  g_clear_pointer (&priv->decoder, decoder_free);
+
+  g_free (priv);
+}
+
+
+static void
+blobs_insert (DocPrivate *priv, const char *name, GBytes *bytes)
+{
+  char *key = g_strdup (name);
+
+  g_ptr_array_add (priv->names, key);
+  g_hash_table_insert (priv->by_name, key, g_bytes_ref (bytes));
+}
+
+
+/**
+ * dia_binary_doc_use_blobs:
+ * @doc: a document about to be filled
+ *
+ * Let data_add_pixbuf() and friends put images into @doc as blobs rather
+ * than as base64 text.  Only dia_binary_encode() knows how to write them,
+ * release @doc with dia_binary_free_document()
+ *
+ * Since: 0.98
+ */
+void
+dia_binary_doc_use_blobs (xmlDocPtr doc)
+{
+  g_return_if_fail (doc != NULL);
+  g_return_if_fail (!dia_binary_doc_has_blobs (doc));
+
+  doc_private_use_blobs (doc_private (doc));
+}
+
+
+/**
+ * dia_binary_doc_has_blobs:
+ * @doc: (nullable): the document
+ *
+ * Returns: %TRUE if @doc stores images as blobs
+ *
+ * Since: 0.98
+ */
+gboolean
+dia_binary_doc_has_blobs (xmlDocPtr doc)
+{
+  return doc && doc->_private && ((DocPrivate *) doc->_private)->by_name;
+}
+
+
+/**
+ * dia_binary_doc_add_blob:
+ * @doc: a document set up with dia_binary_doc_use_blobs()
+ * @bytes: the encoded image
+ *
+ * Returns: (transfer full): the name to refer to @bytes by, the same for
+ *          the same content
+ *
+ * Since: 0.98
+ */
+char *
+dia_binary_doc_add_blob (xmlDocPtr doc, GBytes *bytes)
+{
+  DocPrivate *priv;
+  char *name;
+
+  g_return_val_if_fail (dia_binary_doc_has_blobs (doc), NULL);
+  g_return_val_if_fail (bytes != NULL, NULL);
+
+  priv = doc->_private;
+  name = g_compute_checksum_for_bytes (G_CHECKSUM_SHA256, bytes);
+
+  if (!g_hash_table_contains (priv->by_name, name)) {
+    blobs_insert (priv, name, bytes);
+  }
+
+  return name;
+}
+
+
+/**
+ * dia_binary_doc_get_blob:
+ * @doc: (nullable): the document
+ * @name: from dia_binary_doc_add_blob()
+ *
+ * Returns: (transfer none) (nullable): the content of blob @name
+ *
+ * Since: 0.98
+ */
+GBytes *
+dia_binary_doc_get_blob (xmlDocPtr doc, const char *name)
+{
+  g_return_val_if_fail (name != NULL, NULL);
+
+  if (!dia_binary_doc_has_blobs (doc)) {
+    return NULL;
+  }
+
+  return g_hash_table_lookup (((DocPrivate *) doc->_private)->by_name, name);
+}
+
+
+/**
+ * dia_binary_free_document:
+ * @doc: (nullable): the document
+ *
+ * xmlFreeDoc() for documents that may have blobs or layers still to decode
+ *
+ * Since: 0.98
+ */
+void
+dia_binary_free_document (xmlDocPtr doc)
+{
+  if (!doc) {
+    return;
+  }
+
+  g_clear_pointer ((DocPrivate **) &doc->_private, doc_private_free);
+  xmlFreeDoc (doc);
+}
+
+
+typedef struct _Encoder Encoder;
+struct _Encoder {
+  xmlNodePtr  root;
+  /* string -> index in table */
+  GHashTable *strings;
+  GPtrArray  *table;
+  GPtrArray  *chunks;
+};
+
+
+static void
+put_varint (GByteArray *out, guint64 value)
+{
+  do {
+    guint8 byte = value & 0x7f;
+
+    value >>= 7;
+    if (value) {
+      byte |= 0x80;
+    }
+    g_byte_array_append (out, &byte, 1);
+  } while (value);
+}
+
+
+static void
+put_byte (GByteArray *out, guint8 byte)
+{
+  g_byte_array_append (out, &byte, 1);
+}
+
+
+static guint
+string_index (Encoder *enc, const xmlChar *str)
+{
+  const char *key = str ? (const char *) str : "";
+  gpointer index;
+
+  if (!g_hash_table_lookup_extended (enc->strings, key, NULL, &index)) {
+    char *copy = g_strdup (key);
+
+    index = GUINT_TO_POINTER (enc->table->len);
+    g_ptr_array_add (enc->table, copy);
+    g_hash_table_insert (enc->strings, copy, index);
+  }
+
+  return GPOINTER_TO_UINT (index);
+}
+
+
+static void
+put_string (Encoder *enc, GByteArray *out, const xmlChar *str)
+{
+  put_varint (out, string_index (enc, str));
+}
+
+
+static void encode_element (Encoder *enc, GByteArray *out, xmlNodePtr node);
+
+
+static void
+encode_node (Encoder *enc, GByteArray *out, xmlNodePtr node)
+{
+  switch (node->type) {
+    case XML_ELEMENT_NODE:
+      if (node->parent == enc->root &&
+          xmlStrcmp (node->name, (const xmlChar *) "layer") == 0) {
+        GByteArray *chunk = g_byte_array_new ();
+
+        put_byte (out, NODE_CHUNK);
+        put_varint (out, enc->chunks->len);
+        g_ptr_array_add (enc->chunks, chunk);
+
+        encode_element (enc, chunk, node);
+      } else {
+        encode_element (enc, out, node);
+      }
+      break;
+    case XML_TEXT_NODE:
+    case XML_CDATA_SECTION_NODE:
+      put_byte (out, NODE_TEXT);
+      put_string (enc, out, node->content);
+      break;
+    default:
+      /* Comments and the like carry nothing Dia reads */
+      break;
+  }
+}
+
+
+static void
+encode_element (Encoder *enc, GByteArray *out, xmlNodePtr node)
+{
+  guint n_items = 0;
+
+  put_byte (out, NODE_ELEMENT);
+  put_string (enc, out, node->name);
+
+  put_varint (out, node->ns != NULL);
+  if (node->ns) {
+    put_string (enc, out, node->ns->prefix);
+  }
+
+  for (xmlNsPtr ns = node->nsDef; ns != NULL; ns = ns->next) {
+    n_items++;
+  }
+  put_varint (out, n_items);
+  for (xmlNsPtr ns = node->nsDef; ns != NULL; ns = ns->next) {
+    put_string (enc, out, ns->prefix);
+    put_string (enc, out, ns->href);
+  }
+
+  n_items = 0;
+  for (xmlAttrPtr attr = node->properties; attr != NULL; attr = attr->next) {
+    n_items++;
+  }
+  put_varint (out, n_items);
+  for (xmlAttrPtr attr = node->properties; attr != NULL; attr = attr->next) {
+    xmlChar *value = xmlNodeGetContent ((xmlNodePtr) attr);
+
+    put_string (enc, out, attr->name);
+    put_string (enc, out, value);
+
+    xmlFree (value);
+  }
+
+  for (xmlNodePtr child = node->children; child != NULL; child = child->next) {
+    encode_node (enc, out, child);
+  }
+
+  put_byte (out, NODE_END);
+}
+
+
+/**
+ * dia_binary_encode:
+ * @doc: the document to convert, usually a diagram
+ *
+ * Encode @doc in Dia's binary container.  dia_binary_decode() turns the
+ * result back into an equivalent document, with the same blobs.
+ *
+ * Returns: (transfer full): the encoded document
+ *
+ * Since: 0.98
+ */
+GBytes *
+dia_binary_encode (xmlDocPtr doc)
+{
+  Encoder enc;
+  GByteArray *out;
+  gsize offset = 0;
+  DocPrivate *blobs = NULL;
+  guint *blob_names = NULL;
+
+  g_return_val_if_fail (doc != NULL, NULL);
+  g_return_val_if_fail (xmlDocGetRootElement (doc) != NULL, NULL);
+  /* Whatever was not decoded would be lost */
+  g_return_val_if_fail (!doc->_private || !((DocPrivate *) doc->_private)->decoder, NULL);
+
+  enc.root = xmlDocGetRootElement (doc);
+  enc.strings = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  enc.table = g_ptr_array_new ();
+  enc.chunks = g_ptr_array_new_with_free_func ((GDestroyNotify) g_byte_array_unref);
+
+  /* Reserve chunk 0 for the root element */
+  g_ptr_array_add (enc.chunks, g_byte_array_new ());
+  encode_element (&enc, g_ptr_array_index (enc.chunks, 0), enc.root);
+
+  if (dia_binary_doc_has_blobs (doc) &&
+      ((DocPrivate *) doc->_private)->names->len > 0) {
+    blobs = doc->_private;
+    /* the names go into the string table */
+    blob_names = g_new (guint, blobs->names->len);
+    for (guint i = 0; i < blobs->names->len; i++) {
+      blob_names[i] = string_index (&enc,
+                                    (const xmlChar *) g_ptr_array_index (blobs->names, i));
+    }
+  }
+
+  out = g_byte_array_new ();
+  g_byte_array_append (out,
+                       (const guint8 *) DIA_BINARY_MAGIC,
+                       DIA_BINARY_MAGIC_LEN);
+  put_varint (out, blobs ? DIA_BINARY_VERSION_BLOBS : DIA_BINARY_VERSION);
+
+  put_varint (out, enc.table->len);
+  for (guint i = 0; i < enc.table->len; i++) {
+    const char *str = g_ptr_array_index (enc.table, i);
+    gsize len = strlen (str);
+
+    put_varint (out, len);
+    g_byte_array_append (out, (const guint8 *) str, len + 1);
+  }
+
+  put_varint (out, enc.chunks->len);
+  for (guint i = 0; i < enc.chunks->len; i++) {
+    GByteArray *chunk = g_ptr_array_index (enc.chunks, i);
+
+    put_varint (out, offset);
+    put_varint (out, chunk->len);
+    offset += chunk->len;
+  }
+
+  /* the blobs follow the chunks in the chunk area */
+  if (blobs) {
+    put_varint (out, blobs->names->len);
+    for (guint i = 0; i < blobs->names->len; i++) {
+      const char *name = g_ptr_array_index (blobs->names, i);
+      GBytes *blob = g_hash_table_lookup (blobs->by_name, name);
+
+      put_varint (out, blob_names[i]);
+      put_varint (out, offset);
+      put_varint (out, g_bytes_get_size (blob));
+      offset += g_bytes_get_size (blob);
+    }
+  }
+
+  for (guint i = 0; i < enc.chunks->len; i++) {
+    GByteArray *chunk = g_ptr_array_index (enc.chunks, i);
+
+    g_byte_array_append (out, chunk->data, chunk->len);
+  }
+
+  for (guint i = 0; blobs && i < blobs->names->len; i++) {
+    GBytes *blob = g_hash_table_lookup (blobs->by_name,
+                                        g_ptr_array_index (blobs->names, i));
+    gsize len;
+    gconstpointer data = g_bytes_get_data (blob, &len);
+
+    g_byte_array_append (out, data, len);
+  }
+
+  g_clear_pointer (&blob_names, g_free);
+  g_ptr_array_free (enc.chunks, TRUE);
+  g_ptr_array_free (enc.table, TRUE);
+  g_hash_table_destroy (enc.strings);
+
+  return g_byte_array_free_to_bytes (out);
+}
+
+
+typedef struct _Cursor Cursor;
+struct _Cursor {
+  const guint8 *pos;
+  const guint8 *end;
+};
+
+
+typedef struct _Chunk Chunk;
+struct _Chunk {
+  gsize    offset;
+  gsize    len;
+  gboolean seen;
+};
+
+
+struct _Decoder {
+  xmlDocPtr      doc;
+  /* Point into the encoded data */
+  const char   **strings;
+  gsize          n_strings;
+  Chunk         *chunks;
+  gsize          n_chunks;
+  const guint8  *chunk_area;
+  gsize          chunk_area_len;
+  /* Leave the layers for dia_binary_doc_decode_node() */
+  gboolean       lazy;
+  /* xmlNodePtr -> Cursor on its children, for the layers left */
+  GHashTable    *pending;
+  /* The encoded data, held while anything is pending */
+  GBytes        *bytes;
+};
+
+
+static void
+decoder_free (Decoder *dec)
+{
+  g_clear_pointer (&dec->pending, g_hash_table_destroy);
+  g_clear_pointer (&dec->chunks, g_free);
+  g_clear_pointer (&dec->strings, g_free);
+  g_clear_pointer (&dec->bytes, g_bytes_unref);
+
+  g_free (dec);
+}
+
+
+static gboolean
+get_varint (Cursor *cur, guint64 *value)
+{
+  guint64 result = 0;
+
+  for (int shift = 0; shift < 64; shift += 7) {
+    guint8 byte;
+
+    if (cur->pos >= cur->end) {
+      return FALSE;
+    }
+
+    byte = *cur->pos++;
+    result |= (guint64) (byte & 0x7f) << shift;
+
+    if (!(byte & 0x80)) {
+      *value = result;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+
+static gboolean
+get_size (Cursor *cur, gsize limit, gsize *value)
+{
+  guint64 result;
+
+  if (!get_varint (cur, &result) || result > limit) {
+    return FALSE;
+  }
+
+  *value = result;
+
+  return TRUE;
+}
+
+
+static gboolean
+get_string (Decoder *dec, Cursor *cur, const xmlChar **str)
+{
+  gsize index;
+
+  if (dec->n_strings == 0 || !get_size (cur, dec->n_strings - 1, &index)) {
+    return FALSE;
+  }
+
+  *str = (const xmlChar *) dec->strings[index];
+
+  return TRUE;
+}
+
+
+/* NULL for the default namespace */
+static inline const xmlChar *
+ns_prefix (const xmlChar *prefix)
+{
+  return prefix[0] ? prefix : NULL;
+}
+
+
+static gboolean decode_node (Decoder    *dec,
+                             Cursor     *cur,
+                             xmlNodePtr  parent,
+                             guint       depth);
+static gboolean decode_element_start (Decoder     *dec,
+                                      Cursor      *cur,
+                                      xmlNodePtr   parent,
+                                      xmlNodePtr  *element);
+
+
+static gboolean
+decode_chunk (Decoder *dec, gsize index, xmlNodePtr parent, guint depth)
+{
+  Chunk *chunk;
+  Cursor cur;
+
+  if (index >= dec->n_chunks) {
+    return FALSE;
+  }
+  chunk = &dec->chunks[index];
+
+  /* Every chunk is referenced exactly once, anything else is a loop */
+  if (chunk->seen ||
+      chunk->offset > dec->chunk_area_len ||
+      chunk->len > dec->chunk_area_len - chunk->offset) {
+    return FALSE;
+  }
+  chunk->seen = TRUE;
+
+  cur.pos = dec->chunk_area + chunk->offset;
+  cur.end = cur.pos + chunk->len;
+
+  /* The layers below the root, see encode_node() */
+  if (dec->lazy && parent && parent == xmlDocGetRootElement (dec->doc)) {
+    xmlNodePtr node;
+
+    if (cur.pos >= cur.end || *cur.pos++ != NODE_ELEMENT ||
+        !decode_element_start (dec, &cur, parent, &node)) {
+      return FALSE;
+    }
+
+    g_hash_table_insert (dec->pending, node, g_memdup2 (&cur, sizeof (Cursor)));
+
+    return TRUE;
+  }
+
+  return decode_node (dec, &cur, parent, depth) && cur.pos == cur.end;
+}
+
+
+/* The element itself, without its children */
+static gboolean
+decode_element_start (Decoder     *dec,
+                      Cursor      *cur,
+                      xmlNodePtr   parent,
+                      xmlNodePtr  *element)
+{
+  const xmlChar *name, *prefix = NULL;
+  guint64 has_ns;
+  gsize n_items;
+  xmlNodePtr node;
+
+  if (!get_string (dec, cur, &name) ||
+      !get_varint (cur, &has_ns) ||
+      (has_ns && !get_string (dec, cur, &prefix))) {
+    return FALSE;
+  }
+
+  /* Attach right away, so failures further down are freed with the doc */
+  node = xmlNewDocNode (dec->doc, NULL, name, NULL);
+  if (parent) {
+    xmlAddChild (parent, node);
+  } else if (xmlDocGetRootElement (dec->doc) == NULL) {
+    xmlDocSetRootElement (dec->doc, node);
+  } else {
+    xmlFreeNode (node);
+    return FALSE;
+  }
+
+  if (!get_size (cur, cur->end - cur->pos, &n_items)) {
+    return FALSE;
+  }
+  for (gsize i = 0; i < n_items; i++) {
+    const xmlChar *ns_def, *href;
+
+    if (!get_string (dec, cur, &ns_def) || !get_string (dec, cur, &href)) {
+      return FALSE;
+    }
+    xmlNewNs (node, href, ns_prefix (ns_def));
+  }
+
+  if (has_ns) {
+    xmlNsPtr ns = xmlSearchNs (dec->doc, node, ns_prefix (prefix));
+
+    if (!ns) {
+      return FALSE;
+    }
+    xmlSetNs (node, ns);
+  }
+
+  if (!get_size (cur, cur->end - cur->pos, &n_items)) {
+    return FALSE;
+  }
+  for (gsize i = 0; i < n_items; i++) {
+    const xmlChar *attr, *value;
+
+    if (!get_string (dec, cur, &attr) || !get_string (dec, cur, &value)) {
+      return FALSE;
+    }
+    xmlNewProp (node, attr, value);
+  }
+
+  *element = node;
+
+  return TRUE;
+}
+
+
+static gboolean
+decode_children (Decoder *dec, Cursor *cur, xmlNodePtr node, guint depth)
+{
+  while (cur->pos < cur->end) {
+    if (*cur->pos == NODE_END) {
+      cur->pos++;
+      return TRUE;
+    }
+
+    if (!decode_node (dec, cur, node, depth + 1)) {
+      return FALSE;
+    }
+  }
+
+  /* Ran out of data before NODE_END */
+  return FALSE;
+}
+
+
+static gboolean
+decode_element (Decoder *dec, Cursor *cur, xmlNodePtr parent, guint depth)
+{
+  xmlNodePtr node;
+
+  return decode_element_start (dec, cur, parent, &node) &&
+           decode_children (dec, cur, node, depth);
+}
+
+
+static gboolean
+decode_node (Decoder *dec, Cursor *cur, xmlNodePtr parent, guint depth)
+{
+  const xmlChar *content;
+  gsize index;
+
+  if (depth > MAX_DEPTH || cur->pos >= cur->end) {
+    return FALSE;
+  }
+
+  switch (*cur->pos++) {
+    case NODE_ELEMENT:
+      return decode_element (dec, cur, parent, depth);
+    case NODE_TEXT:
+      if (!parent || !get_string (dec, cur, &content)) {
+        return FALSE;
+      }
+      xmlAddChild (parent, xmlNewDocText (dec->doc, content));
+      return TRUE;
+    case NODE_CHUNK:
+      return get_size (cur, G_MAXSIZE, &index) &&
+               decode_chunk (dec, index, parent, depth + 1);
+    default:
+      return FALSE;
+  }
+}
+
+
+static xmlDocPtr
+decode_bytes (GBytes *bytes, DiaContext *ctx, gboolean lazy)
+{
+  Decoder *dec;
+  Cursor cur;
+  gsize len;
+  guint64 version;
+  gboolean ok = FALSE;
+  gsize n_blobs = 0;
+  Chunk *blob_table = NULL;
+  const char **blob_names = NULL;
+  xmlDocPtr doc;
+
+  cur.pos = g_bytes_get_data (bytes, &len);
+  cur.end = cur.pos + len;
+
+  if (len < DIA_BINARY_MAGIC_LEN ||
+      memcmp (cur.pos, DIA_BINARY_MAGIC, DIA_BINARY_MAGIC_LEN) != 0) {
+    dia_context_add_message (ctx, _("Not a binary Dia diagram."));
+    return NULL;
+  }
+  cur.pos += DIA_BINARY_MAGIC_LEN;
+
+  if (!get_varint (&cur, &version)) {
+    dia_context_add_message (ctx, _("The binary diagram is damaged."));
+    return NULL;
+  } else if (version != DIA_BINARY_VERSION &&
+             version != DIA_BINARY_VERSION_BLOBS) {
+    dia_context_add_message (ctx,
+                             _("Unsupported binary diagram version %" G_GUINT64_FORMAT "."),
+                             version);
+    return NULL;
+  }
+
+  dec = g_new0 (Decoder, 1);
+  dec->lazy = lazy;
+
+  /* Every string takes at least two bytes, its length and the nul */
+  if (!get_size (&cur, (cur.end - cur.pos) / 2, &dec->n_strings)) {
+    goto out;
+  }
+  dec->strings = g_new (const char *, dec->n_strings);
+  for (gsize i = 0; i < dec->n_strings; i++) {
+    gsize str_len;
+
+    if (!get_size (&cur, G_MAXSIZE, &str_len) ||
+        str_len >= (gsize) (cur.end - cur.pos) ||
+        cur.pos[str_len] != '\0' ||
+        !g_utf8_validate_len ((const char *) cur.pos, str_len, NULL)) {
+      goto out;
+    }
+
+    dec->strings[i] = (const char *) cur.pos;
+    cur.pos += str_len + 1;
+  }
+
+  if (!get_size (&cur, (cur.end - cur.pos) / 2, &dec->n_chunks) ||
+      dec->n_chunks == 0) {
+    goto out;
+  }
+  dec->chunks = g_new0 (Chunk, dec->n_chunks);
+  for (gsize i = 0; i < dec->n_chunks; i++) {
+    if (!get_size (&cur, G_MAXSIZE, &dec->chunks[i].offset) ||
+        !get_size (&cur, G_MAXSIZE, &dec->chunks[i].len)) {
+      goto out;
+    }
+  }
+
+  if (version == DIA_BINARY_VERSION_BLOBS) {
+    /* name, offset and length, at least a byte each */
+    if (!get_size (&cur, (cur.end - cur.pos) / 3, &n_blobs)) {
+      goto out;
+    }
+    blob_table = g_new (Chunk, n_blobs);
+    blob_names = g_new (const char *, n_blobs);
+    for (gsize i = 0; i < n_blobs; i++) {
+      const xmlChar *name;
+
+      if (!get_string (dec, &cur, &name) ||
+          !get_size (&cur, G_MAXSIZE, &blob_table[i].offset) ||
+          !get_size (&cur, G_MAXSIZE, &blob_table[i].len)) {
+        goto out;
+      }
+      blob_names[i] = (const char *) name;
+    }
+  }
+
+  /* Whatever follows the chunk table */
+  dec->chunk_area = cur.pos;
+  dec->chunk_area_len = cur.end - cur.pos;
+
+  dec->doc = xmlNewDoc ((const xmlChar *) "1.0");
+  dec->doc->encoding = xmlStrdup ((const xmlChar *) "UTF-8");
+  /* Share element and attribute names, like the parser does */
+  dec->doc->dict = xmlDictCreate ();
+
+  if (n_blobs > 0) {
+    DocPrivate *priv = doc_private (dec->doc);
+    gsize area_offset = dec->chunk_area - (const guint8 *) g_bytes_get_data (bytes, NULL);
+
+    doc_private_use_blobs (priv);
+    for (gsize i = 0; i < n_blobs; i++) {
+      GBytes *blob;
+
+      if (blob_table[i].offset > dec->chunk_area_len ||
+          blob_table[i].len > dec->chunk_area_len - blob_table[i].offset) {
+        goto out;
+      }
+
+      /* no copy, it keeps @bytes alive */
+      blob = g_bytes_new_from_bytes (bytes,
+                                     area_offset + blob_table[i].offset,
+                                     blob_table[i].len);
+      blobs_insert (priv, blob_names[i], blob);
+      g_clear_pointer (&blob, g_bytes_unref);
+    }
+  }
+
+  dec->pending = g_hash_table_new_full (NULL, NULL, NULL, g_free);
+
+  ok = decode_chunk (dec, 0, NULL, 0);
+
+out:
+  g_clear_pointer (&blob_table, g_free);
+  g_clear_pointer (&blob_names, g_free);
+
+  doc = g_steal_pointer (&dec->doc);
+
+  if (!ok) {
+    dia_context_add_message (ctx, _("The binary diagram is damaged."));
+    g_clear_pointer (&doc, dia_binary_free_document);
+    decoder_free (dec);
+  } else if (g_hash_table_size (dec->pending) > 0) {
+    /* Decoded later, from @bytes */
+    dec->doc = doc;
+    dec->bytes = g_bytes_ref (bytes);
+    doc_private (doc)->decoder = dec;
+  } else {
+    decoder_free (dec);
+  }
+
+  return doc;
+}
+
+
+/**
+ * dia_binary_decode:
+ * @bytes: data written by dia_binary_encode()
+ * @ctx: reports problems with @bytes
+ *
+ * Rebuild the document stored in @bytes.
+ *
+ * Strings are only referenced while decoding, @bytes may come straight
+ * from a #GMappedFile.  Blobs keep referencing it.
+ *
+ * Returns: (transfer full) (nullable): the document, free it with
+ *          dia_binary_free_document(), or %NULL if @bytes is not a valid
+ *          binary diagram
+ *
+ * Since: 0.98
+ */
+xmlDocPtr
+dia_binary_decode (GBytes *bytes, DiaContext *ctx)
+{
+  g_return_val_if_fail (bytes != NULL, NULL);
+
+  return decode_bytes (bytes, ctx, FALSE);
+}
+
+
+/**
+ * dia_binary_doc_is_pending:
+ * @doc: (nullable): the document
+ * @node: an element of @doc
+ *
+ * Returns: %TRUE if the content of @node is still to be decoded, see
+ *          dia_binary_load_document()
+ *
+ * Since: 0.98
+ */
+gboolean
+dia_binary_doc_is_pending (xmlDocPtr doc, xmlNodePtr node)
+{
+  DocPrivate *priv = doc ? doc->_private : NULL;
+
+  g_return_val_if_fail (node != NULL, FALSE);
+
+  return priv && priv->decoder &&
+           g_hash_table_contains (priv->decoder->pending, node);
+}
+
+
+static void
+free_children (xmlNodePtr node)
+{
+  while (node->children) {
+    xmlNodePtr child = node->children;
+
+    xmlUnlinkNode (child);
+    xmlFreeNode (child);
+  }
+}
+
+
+/**
+ * dia_binary_doc_decode_node:
+ * @doc: (nullable): the document
+ * @node: an element of @doc
+ * @ctx: reports problems with the content
+ *
+ * Decode what is left of @node, nothing if it's not pending.
+ *
+ * Returns: %FALSE if the content of @node is damaged, it stays empty then
+ *
+ * Since: 0.98
+ */
+gboolean
+dia_binary_doc_decode_node (xmlDocPtr   doc,
+                            xmlNodePtr  node,
+                            DiaContext *ctx)
+{
+  Decoder *dec;
+  Cursor *rest;
+  Cursor cur;
+  gboolean ok;
+
+  if (!dia_binary_doc_is_pending (doc, node)) {
+    return TRUE;
+  }
+
+  dec = ((DocPrivate *) doc->_private)->decoder;
+  rest = g_hash_table_lookup (dec->pending, node);
+  cur = *rest;
+  g_hash_table_remove (dec->pending, node);
+
+  /* The root and the layer */
+  ok = decode_children (dec, &cur, node, 2) && cur.pos == cur.end;
+  if (!ok) {
+    dia_context_add_message (ctx, _("The binary diagram is damaged."));
+    free_children (node);
+  }
+
+  /* Let go of the file with the last layer */
+  if (g_hash_table_size (dec->pending) == 0) {
+    g_clear_pointer (&((DocPrivate *) doc->_private)->decoder, decoder_free);
+  }
+
+  return ok;
+}
+
+
+typedef struct _Scanner Scanner;
+struct _Scanner {
+  Decoder              *dec;
+  DiaBinaryElementFunc  func;
+  gpointer              user_data;
+  /* NULL terminated, reused for every element */
+  GPtrArray            *names;
+  GPtrArray            *values;
+};
+
+
+static gboolean scan_children (Scanner *scan, Cursor *cur, guint depth);
+
+
+static gboolean
+scan_element (Scanner *scan, Cursor *cur, guint depth)
+{
+  const xmlChar *name, *str;
+  guint64 has_ns;
+  gsize n_items;
+
+  if (!get_string (scan->dec, cur, &name) ||
+      !get_varint (cur, &has_ns) ||
+      (has_ns && !get_string (scan->dec, cur, &str))) {
+    return FALSE;
+  }
+
+  if (!get_size (cur, cur->end - cur->pos, &n_items)) {
+    return FALSE;
+  }
+  for (gsize i = 0; i < n_items; i++) {
+    if (!get_string (scan->dec, cur, &str) ||
+        !get_string (scan->dec, cur, &str)) {
+      return FALSE;
+    }
+  }
+
+  g_ptr_array_set_size (scan->names, 0);
+  g_ptr_array_set_size (scan->values, 0);
+  if (!get_size (cur, cur->end - cur->pos, &n_items)) {
+    return FALSE;
+  }
+  for (gsize i = 0; i < n_items; i++) {
+    const xmlChar *attr, *value;
+
+    if (!get_string (scan->dec, cur, &attr) ||
+        !get_string (scan->dec, cur, &value)) {
+      return FALSE;
+    }
+    g_ptr_array_add (scan->names, (gpointer) attr);
+    g_ptr_array_add (scan->values, (gpointer) value);
+  }
+  g_ptr_array_add (scan->names, NULL);
+  g_ptr_array_add (scan->values, NULL);
+
+  scan->func ((const char *) name,
+              (const char **) scan->names->pdata,
+              (const char **) scan->values->pdata,
+              scan->user_data);
+
+  return scan_children (scan, cur, depth);
+}
+
+
+static gboolean
+scan_children (Scanner *scan, Cursor *cur, guint depth)
+{
+  const xmlChar *content;
+
+  if (depth > MAX_DEPTH) {
+    return FALSE;
+  }
+
+  while (cur->pos < cur->end) {
+    switch (*cur->pos++) {
+      case NODE_END:
+        return TRUE;
+      case NODE_ELEMENT:
+        if (!scan_element (scan, cur, depth + 1)) {
+          return FALSE;
+        }
+        break;
+      case NODE_TEXT:
+        if (!get_string (scan->dec, cur, &content)) {
+          return FALSE;
+        }
+        break;
+      default:
+        /* Chunks are only below the root */
+        return FALSE;
+    }
+  }
+
+  /* Ran out of data before NODE_END */
+  return FALSE;
+}
+
+
+/**
+ * dia_binary_doc_scan_node:
+ * @doc: (nullable): the document
+ * @node: a pending element of @doc
+ * @func: called for every element below @node, in document order
+ * @user_data: passed to @func
+ *
+ * Look at the content of a node still to decode, without building it.
+ * Much cheaper than decoding, e.g. to find references between layers.
+ *
+ * Returns: %FALSE if @node isn't pending or its content is damaged
+ *
+ * Since: 0.98
+ */
+gboolean
+dia_binary_doc_scan_node (xmlDocPtr             doc,
+                          xmlNodePtr            node,
+                          DiaBinaryElementFunc  func,
+                          gpointer              user_data)
+{
+  Scanner scan;
+  Cursor cur;
+  gboolean ok;
+
+  g_return_val_if_fail (func != NULL, FALSE);
+
+  if (!dia_binary_doc_is_pending (doc, node)) {
+    return FALSE;
+  }
+
+  scan.dec = ((DocPrivate *) doc->_private)->decoder;
+  scan.func = func;
+  scan.user_data = user_data;
+  scan.names = g_ptr_array_new ();
+  scan.values = g_ptr_array_new ();
+
+  cur = *(Cursor *) g_hash_table_lookup (scan.dec->pending, node);
+  ok = scan_children (&scan, &cur, 2) && cur.pos == cur.end;
+
+  g_ptr_array_unref (scan.names);
+  g_ptr_array_unref (scan.values);
+
+  return ok;
+}
+
+
+/**
+ * dia_binary_check:
+ * @path: the file to look at
+ *
+ * Returns: %TRUE if @path starts like a binary diagram
+ *
+ * Since: 0.98
+ */
+gboolean
+dia_binary_check (const char *path)
+{
+  char magic[DIA_BINARY_MAGIC_LEN];
+  gboolean result = FALSE;
+  FILE *file;
+
+  g_return_val_if_fail (path != NULL, FALSE);
+
+  file = g_fopen (path, "rb");
+  if (file) {
+    result = fread (magic, 1, DIA_BINARY_MAGIC_LEN, file) == DIA_BINARY_MAGIC_LEN &&
+               memcmp (magic, DIA_BINARY_MAGIC, DIA_BINARY_MAGIC_LEN) == 0;
+    fclose (file);
+  }
+
+  return result;
+}
+
+
+/**
+ * dia_binary_load_document:
+ * @path: the file to read
+ * @ctx: the current #DiaContext
+ *
+ * Read a binary diagram.  The file is mapped rather than read, so only
+ * the parts actually decoded are paged in.
+ *
+ * The layers are left empty, with just their attributes, see
+ * dia_binary_doc_is_pending().  Their content is decoded from the file
+ * once asked for with dia_binary_doc_decode_node(), the file stays mapped
+ * until then.
+ *
+ * Returns: (transfer full) (nullable): the document, free it with
+ *          dia_binary_free_document()
+ *
+ * Since: 0.98
+ */
+xmlDocPtr
+dia_binary_load_document (const char *path, DiaContext *ctx)
+{
+  GError *error = NULL;
+  GMappedFile *map;
+  GBytes *bytes;
+  xmlDocPtr doc;
+
+  g_return_val_if_fail (path != NULL, NULL);
+
+  map = g_mapped_file_new (path, FALSE, &error);
+  if (!map) {
+    dia_context_add_message (ctx, _("Unable to open: %s"), error->message);
+    g_clear_error (&error);
+
+    return NULL;
+  }
+
+  /* keeps @map alive as long as the document needs it */
+  bytes = g_mapped_file_get_bytes (map);
+  doc = decode_bytes (bytes, ctx, TRUE);
+
+  g_clear_pointer (&bytes, g_bytes_unref);
+  g_clear_pointer (&map, g_mapped_file_unref);
+
+  return doc;
+}
+
+
+/**
+ * dia_binary_save_document:
+ * @path: the file to write
+ * @doc: the document to save
+ * @ctx: the current #DiaContext
+ *
+ * The binary counterpart of dia_io_save_document()
+ *
+ * Returns: %TRUE on success
+ *
+ * Since: 0.98
+ */
+gboolean
+dia_binary_save_document (const char *path,
+                          xmlDocPtr   doc,
+                          DiaContext *ctx)
+{
+  GError *error = NULL;
+  GFile *file;
+  GBytes *bytes;
+  gboolean result;
+
+  g_return_val_if_fail (path != NULL, FALSE);
+  g_return_val_if_fail (doc != NULL, FALSE);
+
+  file = g_file_new_for_path (path);
+  bytes = dia_binary_encode (doc);
+
+  result = g_file_replace_contents (file,
+                                    g_bytes_get_data (bytes, NULL),
+                                    g_bytes_get_size (bytes),
+                                    NULL,
+                                    TRUE,
+                                    G_FILE_CREATE_PRIVATE,
+                                    NULL,
+                                    NULL,
+                                    &error);
+
+  if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_IS_DIRECTORY)) {
+    char *basename = g_file_get_basename (file);
+
+    dia_context_add_message (ctx, _("‘%s’ is a directory"), basename);
+
+    g_clear_pointer (&basename, g_free);
+  } else if (error) {
+    dia_context_add_message (ctx, _("Unable to write: %s"), error->message);
+  }
+
+  g_clear_error (&error);
+  g_clear_pointer (&bytes, g_bytes_unref);
+  g_clear_object (&file);
+
+  return result;
+}
@@ -0,0 +1,71 @@
+/* Dia -- an diagram creation/manipulation program
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <libxml/tree.h>
+
+#include "diacontext.h"
+
+G_BEGIN_DECLS
+
+/**
+ * DiaBinaryElementFunc:
+ * @name: the element name
+ * @attribute_names: %NULL terminated
+ * @attribute_values: %NULL terminated
+ * @user_data: as passed to dia_binary_doc_scan_node()
+ *
+ * Since: 0.98
+ */
+typedef void (*DiaBinaryElementFunc) (const char  *name,
+                                      const char **attribute_names,
+                                      const char **attribute_values,
+                                      gpointer     user_data);
+
+GBytes    *dia_binary_encode        (xmlDocPtr   doc);
+xmlDocPtr  dia_binary_decode        (GBytes     *bytes,
+                                     DiaContext *ctx);
+gboolean   dia_binary_check         (const char *path);
+xmlDocPtr  dia_binary_load_document (const char *path,
+                                     DiaContext *ctx);
+gboolean   dia_binary_save_document (const char *path,
+                                     xmlDocPtr   doc,
+                                     DiaContext *ctx);
+void       dia_binary_free_document (xmlDocPtr   doc);
+
+void       dia_binary_doc_use_blobs (xmlDocPtr   doc);
+gboolean   dia_binary_doc_has_blobs (xmlDocPtr   doc);
+char      *dia_binary_doc_add_blob  (xmlDocPtr   doc,
+                                     GBytes     *bytes);
+GBytes    *dia_binary_doc_get_blob  (xmlDocPtr   doc,
+                                     const char *name);
+
+gboolean   dia_binary_doc_is_pending   (xmlDocPtr             doc,
+                                        xmlNodePtr            node);
+gboolean   dia_binary_doc_decode_node  (xmlDocPtr             doc,
+                                        xmlNodePtr            node,
+                                        DiaContext           *ctx);
+gboolean   dia_binary_doc_scan_node    (xmlDocPtr             doc,
+                                        xmlNodePtr            node,
+                                        DiaBinaryElementFunc  func,
+                                        gpointer              user_data);
+
+G_END_DECLS
@@ -37,6 +37,18 @@ struct _DiaLayerClass
   GObjectClass parent_class;
 };
 
+/**
+ * DiaLayerLoadFunc:
+ * @layer: the #DiaLayer being loaded
+ * @user_data: as passed to dia_layer_defer_objects()
+ *
+ * Returns: (transfer full): the objects of @layer, topmost last
+ *
+ * Since: 0.98
+ */
+typedef GList *(*DiaLayerLoadFunc) (DiaLayer *layer,
+                                    gpointer  user_data);
+
 DiaLayer    *dia_layer_new                                 (const char       *name,
                                                             DiagramData      *parent);
 DiaLayer    *dia_layer_new_from_layer                      (DiaLayer         *old);
@@ -100,5 +112,15 @@ void         dia_layer_set_visible                         (DiaLayer         *se
                                                             gboolean          visible);
 void         dia_layer_get_extents                         (DiaLayer         *self,
                                                             DiaRectangle     *rect);
+void         dia_layer_defer_objects                       (DiaLayer         *self,
+                                                            DiaLayerLoadFunc  load_func,
+                                                            gpointer          load_data,
+                                                            GBoxedCopyFunc    load_data_copy,
+                                                            GDestroyNotify    load_data_destroy);
+gboolean     dia_layer_is_loaded                           (DiaLayer         *self);
+gpointer     dia_layer_get_load_data                       (DiaLayer         *self,
+                                                            DiaLayerLoadFunc  load_func);
+void         dia_layer_changed                             (DiaLayer         *self);
+guint64      dia_layer_get_changes                         (DiaLayer         *self);
 
 G_END_DECLS
@@ -0,0 +1,227 @@
+/* Dia -- an diagram creation/manipulation program
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/** \file dia-number.c  Locale independent conversion of doubles to and from text */
+
+#include "config.h"
+
+#include <math.h>
+
+#include "dia-number.h"
+
+
+/* Every power of ten up to here is exactly representable as a double */
+#define MAX_EXACT_POW10 22
+/* Largest integer a double holds without losing precision, 2^53 */
+#define MAX_EXACT_MANTISSA G_GUINT64_CONSTANT (9007199254740992)
+/* Stop accumulating before the mantissa can overflow a guint64 */
+#define MAX_MANTISSA_DIGITS 19
+
+
+static const double pow10_table[MAX_EXACT_POW10 + 1] = {
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+  1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+  1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+
+/**
+ * dia_number_format:
+ * @buffer: where to place the result
+ * @buf_len: size of @buffer, %DIA_NUMBER_BUF_SIZE is always enough
+ * @value: the number to convert
+ * @decimals: number of fractional digits to keep, or %DIA_NUMBER_EXACT
+ *
+ * Format @value in the C locale using as few significant digits as possible.
+ *
+ * With %DIA_NUMBER_EXACT the result is the shortest of 15, 16 or 17
+ * significant digits that dia_number_parse() turns back into exactly
+ * @value, so "12.3" is written rather than g_ascii_dtostr()'s
+ * "12.300000000000001" whenever that is lossless.  Otherwise @value is first
+ * rounded to @decimals fractional digits, trading exactness for compactness.
+ *
+ * Returns: @buffer
+ *
+ * Since: 0.98
+ */
+char *
+dia_number_format (char   *buffer,
+                   gsize   buf_len,
+                   double  value,
+                   int     decimals)
+{
+  static const char *formats[] = { "%.15g", "%.16g", "%.17g" };
+
+  g_return_val_if_fail (buffer != NULL, NULL);
+
+  if (!isfinite (value)) {
+    return g_ascii_dtostr (buffer, buf_len, value);
+  }
+
+  if (decimals >= 0) {
+    double scale = decimals <= MAX_EXACT_POW10 ? pow10_table[decimals]
+                                               : pow (10.0, decimals);
+    double scaled = value * scale;
+
+    /* Beyond this the value has no fractional digits left to drop */
+    if (fabs (scaled) < (double) MAX_EXACT_MANTISSA) {
+      value = round (scaled) / scale;
+    }
+  }
+
+  /* Avoid "-0", it reads back as 0 anyway */
+  if (value == 0.0) {
+    g_strlcpy (buffer, "0", buf_len);
+    return buffer;
+  }
+
+  for (gsize i = 0; i < G_N_ELEMENTS (formats) - 1; i++) {
+    g_ascii_formatd (buffer, buf_len, formats[i], value);
+    if (dia_number_parse (buffer, NULL) == value) {
+      return buffer;
+    }
+  }
+
+  /* 17 significant digits always round-trip */
+  return g_ascii_formatd (buffer, buf_len, formats[G_N_ELEMENTS (formats) - 1], value);
+}
+
+
+/**
+ * dia_number_parse:
+ * @str: the string to convert
+ * @endptr: (out) (optional): the first character after the number
+ *
+ * A drop-in replacement for g_ascii_strtod(), and just as exact.
+ *
+ * The plain decimals Dia writes itself (at most 15 significant digits and a
+ * small exponent) are converted with a single multiplication or division of
+ * two exactly representable values, which IEEE 754 rounds correctly.  Anything
+ * else, hexadecimal, inf, nan, overlong mantissas, is left to g_ascii_strtod().
+ *
+ * Returns: the parsed value
+ *
+ * Since: 0.98
+ */
+double
+dia_number_parse (const char  *str,
+                  char       **endptr)
+{
+  const char *p;
+  guint64 mantissa = 0;
+  int n_digits = 0;
+  int exponent = 0;
+  gboolean negative = FALSE;
+  gboolean any_digit = FALSE;
+  double value;
+
+  g_return_val_if_fail (str != NULL, 0.0);
+
+  p = str;
+  while (g_ascii_isspace (*p)) {
+    p++;
+  }
+
+  if (*p == '-') {
+    negative = TRUE;
+    p++;
+  } else if (*p == '+') {
+    p++;
+  }
+
+  while (g_ascii_isdigit (*p)) {
+    any_digit = TRUE;
+    if (mantissa != 0 || *p != '0') {
+      if (++n_digits > MAX_MANTISSA_DIGITS) {
+        goto fallback;
+      }
+      mantissa = mantissa * 10 + (*p - '0');
+    }
+    p++;
+  }
+
+  if (*p == '.') {
+    p++;
+    while (g_ascii_isdigit (*p)) {
+      any_digit = TRUE;
+      if (mantissa != 0 || *p != '0') {
+        if (++n_digits > MAX_MANTISSA_DIGITS) {
+          goto fallback;
+        }
+        mantissa = mantissa * 10 + (*p - '0');
+      }
+      exponent--;
+      p++;
+    }
+  }
+
+  /* Also catches "0x..." which strtod reads as hexadecimal */
+  if (!any_digit || *p == 'x' || *p == 'X') {
+    goto fallback;
+  }
+
+  if (*p == 'e' || *p == 'E') {
+    const char *e = p + 1;
+    gboolean exp_negative = FALSE;
+    int exp_value = 0;
+
+    if (*e == '-') {
+      exp_negative = TRUE;
+      e++;
+    } else if (*e == '+') {
+      e++;
+    }
+
+    /* Without digits the 'e' isn't part of the number */
+    if (g_ascii_isdigit (*e)) {
+      while (g_ascii_isdigit (*e)) {
+        if (exp_value > 1000) {
+          goto fallback;
+        }
+        exp_value = exp_value * 10 + (*e - '0');
+        e++;
+      }
+      exponent += exp_negative ? -exp_value : exp_value;
+      p = e;
+    }
+  }
+
+  if (mantissa == 0) {
+    value = 0.0;
+  } else if (mantissa <= MAX_EXACT_MANTISSA &&
+             exponent >= -MAX_EXACT_POW10 &&
+             exponent <= MAX_EXACT_POW10) {
+    if (exponent < 0) {
+      value = (double) mantissa / pow10_table[-exponent];
+    } else {
+      value = (double) mantissa * pow10_table[exponent];
+    }
+  } else {
+    goto fallback;
+  }
+
+  if (endptr) {
+    *endptr = (char *) p;
+  }
+
+  return negative ? -value : value;
+
+fallback:
+  return g_ascii_strtod (str, endptr);
+}
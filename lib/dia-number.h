@@ -0,0 +1,49 @@
+/* Dia -- an diagram creation/manipulation program
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * DIA_NUMBER_BUF_SIZE:
+ *
+ * A buffer size large enough for any string produced by dia_number_format()
+ */
+#define DIA_NUMBER_BUF_SIZE G_ASCII_DTOSTR_BUF_SIZE
+
+/**
+ * DIA_NUMBER_EXACT:
+ *
+ * Passed as `decimals` to dia_number_format() to request the shortest
+ * string that reads back as the very same double
+ */
+#define DIA_NUMBER_EXACT (-1)
+
+
+char   *dia_number_format (char        *buffer,
+                           gsize        buf_len,
+                           double       value,
+                           int          decimals);
+double  dia_number_parse  (const char  *str,
+                           char       **endptr);
+
+G_END_DECLS
@@ -0,0 +1,463 @@
+/* Dia -- an diagram creation/manipulation program
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#define G_LOG_DOMAIN "DiaRenderProfile"
+
+#include <glib/gi18n-lib.h>
+
+#include <string.h>
+
+#include "dia-render-profile.h"
+
+/*
+ * Where the display spends its time: every frame drawn by
+ * ddisplay_render_pixmap() is bracketed with frame_begin/frame_end and the
+ * interesting parts inside report how long they took.  Anything reported
+ * outside a frame (exports, the navigation thumbnail) is ignored, and so is
+ * what other threads report, like the page workers of an export drawing
+ * while a frame is timed.  The state is behind the profile lock, only
+ * @enabled is read without it, to keep profiling cheap while it's off.
+ */
+
+typedef struct _ProfileEntry ProfileEntry;
+struct _ProfileEntry {
+  DiaRenderProfileKind  kind;
+  char                 *name;
+  guint64               calls;
+  gint64                total;   /* µs */
+  gint64                max;     /* µs, for a single call */
+  gint64                frame;   /* µs, in the current frame */
+};
+
+static const char *kind_names[] = { "object", "layer", "section" };
+
+G_LOCK_DEFINE_STATIC (profile);
+
+static gboolean    checked = FALSE;
+static gint        enabled = FALSE;   /* atomic */
+static GHashTable *entries[G_N_ELEMENTS (kind_names)];
+
+static GThread *frame_thread = NULL;  /* Timing the frame */
+static gint64   frame_start = 0;
+static guint64  n_frames = 0;
+static gint64   frames_total = 0;
+static gint64   frames_max = 0;
+static gint64   last_frame = 0;
+static char    *last_slowest = NULL;
+static gint64   last_slowest_time = 0;
+
+
+static void
+profile_entry_free (gpointer data)
+{
+  ProfileEntry *entry = data;
+
+  g_clear_pointer (&entry->name, g_free);
+  g_free (entry);
+}
+
+
+/**
+ * dia_render_profile_enabled:
+ *
+ * Render profiling is off unless the environment variable
+ * DIA_RENDER_PROFILE is set or it was switched on with
+ * dia_render_profile_set_enabled()
+ *
+ * Returns: %TRUE while profiling
+ *
+ * Since: 0.98
+ */
+gboolean
+dia_render_profile_enabled (void)
+{
+  G_LOCK (profile);
+  if (!checked) {
+    g_atomic_int_set (&enabled, g_getenv ("DIA_RENDER_PROFILE") != NULL);
+    checked = TRUE;
+  }
+  G_UNLOCK (profile);
+
+  return g_atomic_int_get (&enabled);
+}
+
+
+/**
+ * dia_render_profile_set_enabled:
+ * @enable: switch profiling on or off
+ *
+ * The collected numbers are kept when switching off, so they can still be
+ * saved, use dia_render_profile_reset() to start over
+ *
+ * Since: 0.98
+ */
+void
+dia_render_profile_set_enabled (gboolean enable)
+{
+  G_LOCK (profile);
+  checked = TRUE;
+  g_atomic_int_set (&enabled, enable);
+  frame_start = 0;
+  G_UNLOCK (profile);
+}
+
+
+/**
+ * dia_render_profile_reset:
+ *
+ * Forget everything collected so far
+ *
+ * Since: 0.98
+ */
+void
+dia_render_profile_reset (void)
+{
+  G_LOCK (profile);
+  for (gsize i = 0; i < G_N_ELEMENTS (entries); i++) {
+    g_clear_pointer (&entries[i], g_hash_table_destroy);
+  }
+
+  frame_start = 0;
+  n_frames = 0;
+  frames_total = 0;
+  frames_max = 0;
+  last_frame = 0;
+  last_slowest_time = 0;
+  g_clear_pointer (&last_slowest, g_free);
+  G_UNLOCK (profile);
+}
+
+
+/**
+ * dia_render_profile_frame_begin:
+ *
+ * Start timing a frame of the display
+ *
+ * Since: 0.98
+ */
+void
+dia_render_profile_frame_begin (void)
+{
+  if (!dia_render_profile_enabled ()) {
+    return;
+  }
+
+  G_LOCK (profile);
+  frame_start = g_get_monotonic_time ();
+  frame_thread = g_thread_self ();
+  G_UNLOCK (profile);
+}
+
+
+/**
+ * dia_render_profile_frame_end:
+ *
+ * Finish the frame started with dia_render_profile_frame_begin()
+ *
+ * Since: 0.98
+ */
+void
+dia_render_profile_frame_end (void)
+{
+  GHashTable *objects;
+  ProfileEntry *slowest = NULL;
+
+  if (!dia_render_profile_enabled ()) {
+    return;
+  }
+
+  G_LOCK (profile);
+  if (frame_start == 0) {
+    G_UNLOCK (profile);
+    return;
+  }
+
+  objects = entries[DIA_RENDER_PROFILE_OBJECT];
+
+  last_frame = g_get_monotonic_time () - frame_start;
+  frame_start = 0;
+
+  n_frames++;
+  frames_total += last_frame;
+  frames_max = MAX (frames_max, last_frame);
+
+  /* Which type cost the most in this frame, the overlay shows it */
+  if (objects) {
+    GHashTableIter iter;
+    ProfileEntry *entry;
+
+    g_hash_table_iter_init (&iter, objects);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &entry)) {
+      if (!slowest || entry->frame > slowest->frame) {
+        slowest = entry;
+      }
+    }
+  }
+
+  g_clear_pointer (&last_slowest, g_free);
+  last_slowest_time = 0;
+  if (slowest && slowest->frame > 0) {
+    last_slowest = g_strdup (slowest->name);
+    last_slowest_time = slowest->frame;
+  }
+
+  for (gsize i = 0; i < G_N_ELEMENTS (entries); i++) {
+    GHashTableIter iter;
+    ProfileEntry *entry;
+
+    if (!entries[i]) {
+      continue;
+    }
+
+    g_hash_table_iter_init (&iter, entries[i]);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &entry)) {
+      entry->frame = 0;
+    }
+  }
+  G_UNLOCK (profile);
+}
+
+
+/**
+ * dia_render_profile_start:
+ *
+ * Returns: a time stamp to pass to dia_render_profile_add(), or 0 when
+ *          there is nothing to time
+ *
+ * Since: 0.98
+ */
+gint64
+dia_render_profile_start (void)
+{
+  gboolean timing;
+
+  if (!g_atomic_int_get (&enabled)) {
+    return 0;
+  }
+
+  G_LOCK (profile);
+  timing = frame_start != 0 && frame_thread == g_thread_self ();
+  G_UNLOCK (profile);
+
+  return timing ? g_get_monotonic_time () : 0;
+}
+
+
+/**
+ * dia_render_profile_add:
+ * @kind: what was timed
+ * @name: the #DiaObjectType name, layer name or section
+ * @start: from dia_render_profile_start()
+ *
+ * Account the time since @start to @name
+ *
+ * Since: 0.98
+ */
+void
+dia_render_profile_add (DiaRenderProfileKind  kind,
+                        const char           *name,
+                        gint64                start)
+{
+  ProfileEntry *entry;
+  gint64 elapsed;
+
+  if (start == 0) {
+    return;
+  }
+
+  g_return_if_fail (kind < G_N_ELEMENTS (entries));
+
+  elapsed = g_get_monotonic_time () - start;
+
+  G_LOCK (profile);
+  if (frame_start == 0 || frame_thread != g_thread_self ()) {
+    G_UNLOCK (profile);
+    return;
+  }
+
+  if (!entries[kind]) {
+    entries[kind] = g_hash_table_new_full (g_str_hash,
+                                           g_str_equal,
+                                           NULL,
+                                           profile_entry_free);
+  }
+
+  entry = g_hash_table_lookup (entries[kind], name ? name : "");
+  if (!entry) {
+    entry = g_new0 (ProfileEntry, 1);
+    entry->kind = kind;
+    entry->name = g_strdup (name ? name : "");
+    g_hash_table_insert (entries[kind], entry->name, entry);
+  }
+
+  entry->calls++;
+  entry->total += elapsed;
+  entry->frame += elapsed;
+  entry->max = MAX (entry->max, elapsed);
+  G_UNLOCK (profile);
+}
+
+
+/**
+ * dia_render_profile_summary:
+ *
+ * A line or two about the last frame, for drawing over the canvas
+ *
+ * Returns: (transfer full): the summary, or %NULL before the first frame
+ *
+ * Since: 0.98
+ */
+char *
+dia_render_profile_summary (void)
+{
+  GString *summary;
+
+  G_LOCK (profile);
+  if (n_frames == 0) {
+    G_UNLOCK (profile);
+    return NULL;
+  }
+
+  summary = g_string_new (NULL);
+  g_string_printf (summary,
+                   _("Frame %.1f ms (mean %.1f, max %.1f, %u frames)"),
+                   last_frame / 1000.0,
+                   frames_total / 1000.0 / n_frames,
+                   frames_max / 1000.0,
+                   (guint) n_frames);
+
+  if (last_slowest) {
+    g_string_append_c (summary, '\n');
+    g_string_append_printf (summary,
+                            _("Slowest type: %s, %.1f ms"),
+                            last_slowest,
+                            last_slowest_time / 1000.0);
+  }
+  G_UNLOCK (profile);
+
+  return g_string_free (summary, FALSE);
+}
+
+
+static int
+compare_entries (gconstpointer a, gconstpointer b)
+{
+  const ProfileEntry *ea = *(const ProfileEntry **) a;
+  const ProfileEntry *eb = *(const ProfileEntry **) b;
+
+  if (ea->kind != eb->kind) {
+    return ea->kind < eb->kind ? -1 : 1;
+  }
+  if (ea->total != eb->total) {
+    return ea->total > eb->total ? -1 : 1;
+  }
+  return strcmp (ea->name, eb->name);
+}
+
+
+/* Not printf(), it would write a decimal comma in some locales */
+static void
+append_csv_ms (GString *csv, double usec)
+{
+  char buf[G_ASCII_DTOSTR_BUF_SIZE];
+
+  g_string_append_c (csv, ',');
+  g_string_append (csv, g_ascii_formatd (buf, sizeof (buf), "%.3f", usec / 1000.0));
+}
+
+
+static void
+append_csv_string (GString *csv, const char *str)
+{
+  g_string_append_c (csv, '"');
+  for (const char *p = str; *p; p++) {
+    if (*p == '"') {
+      g_string_append_c (csv, '"');
+    }
+    g_string_append_c (csv, *p);
+  }
+  g_string_append_c (csv, '"');
+}
+
+
+/**
+ * dia_render_profile_save_csv:
+ * @filename: where to write
+ * @error: return location for a #GError
+ *
+ * Write everything collected so far, one row per frame total, object
+ * type, layer and section, slowest first
+ *
+ * Returns: %TRUE on success
+ *
+ * Since: 0.98
+ */
+gboolean
+dia_render_profile_save_csv (const char *filename, GError **error)
+{
+  GString *csv = g_string_new ("kind,name,calls,total_ms,mean_ms,max_ms\n");
+  GPtrArray *sorted = g_ptr_array_new ();
+  gboolean res;
+
+  G_LOCK (profile);
+  g_string_append_printf (csv, "frame,\"\",%" G_GUINT64_FORMAT, n_frames);
+  append_csv_ms (csv, frames_total);
+  append_csv_ms (csv, n_frames ? (double) frames_total / n_frames : 0.0);
+  append_csv_ms (csv, frames_max);
+  g_string_append_c (csv, '\n');
+
+  for (gsize i = 0; i < G_N_ELEMENTS (entries); i++) {
+    GHashTableIter iter;
+    ProfileEntry *entry;
+
+    if (!entries[i]) {
+      continue;
+    }
+
+    g_hash_table_iter_init (&iter, entries[i]);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &entry)) {
+      g_ptr_array_add (sorted, entry);
+    }
+  }
+  g_ptr_array_sort (sorted, compare_entries);
+
+  for (guint i = 0; i < sorted->len; i++) {
+    ProfileEntry *entry = g_ptr_array_index (sorted, i);
+
+    g_string_append_printf (csv, "%s,", kind_names[entry->kind]);
+    append_csv_string (csv, entry->name);
+    g_string_append_printf (csv, ",%" G_GUINT64_FORMAT, entry->calls);
+    append_csv_ms (csv, entry->total);
+    append_csv_ms (csv, (double) entry->total / entry->calls);
+    append_csv_ms (csv, entry->max);
+    g_string_append_c (csv, '\n');
+  }
+  G_UNLOCK (profile);
+
+  res = g_file_set_contents (filename, csv->str, csv->len, error);
+
+  g_debug ("%s: %u rows to %s", G_STRFUNC, sorted->len, filename);
+
+  g_ptr_array_free (sorted, TRUE);
+  g_string_free (csv, TRUE);
+
+  return res;
+}
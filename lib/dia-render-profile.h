@@ -0,0 +1,54 @@
+/* Dia -- an diagram creation/manipulation program
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * DiaRenderProfileKind:
+ * @DIA_RENDER_PROFILE_OBJECT: time spent drawing objects of one #DiaObjectType
+ * @DIA_RENDER_PROFILE_LAYER: time spent on a whole layer, cached or not
+ * @DIA_RENDER_PROFILE_SECTION: everything else in a frame (grid, handles...)
+ *
+ * Since: 0.98
+ */
+typedef enum {
+  DIA_RENDER_PROFILE_OBJECT,
+  DIA_RENDER_PROFILE_LAYER,
+  DIA_RENDER_PROFILE_SECTION,
+} DiaRenderProfileKind;
+
+
+gboolean  dia_render_profile_enabled     (void);
+void      dia_render_profile_set_enabled (gboolean              enable);
+void      dia_render_profile_reset       (void);
+void      dia_render_profile_frame_begin (void);
+void      dia_render_profile_frame_end   (void);
+gint64    dia_render_profile_start       (void);
+void      dia_render_profile_add         (DiaRenderProfileKind  kind,
+                                          const char           *name,
+                                          gint64                start);
+char     *dia_render_profile_summary     (void);
+gboolean  dia_render_profile_save_csv    (const char           *filename,
+                                          GError              **error);
+
+G_END_DECLS
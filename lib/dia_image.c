@@ -21,6 +21,7 @@
 #include <glib/gi18n-lib.h>
 
 #include <string.h> /* memmove */
+#include <glib/gstdio.h>
 
 #include "geometry.h"
 #include "dia_image.h"
@@ -46,15 +47,152 @@ struct _DiaImage {
   GdkPixbuf *image;
   gchar *filename;
   gchar *mime_type; /* optional */
+  int width, height; /* known before the pixels are, see _pixbuf() */
+  GBytes *data; /* the encoded image, for dia_image_new_deferred() */
+  /* what dia_image_get_encoded() gave before, if not data */
+  GBytes *encoded;
+  const char *encoded_type;
   GdkPixbuf *scaled; /* a cache of the last scaled version */
   int scaled_width, scaled_height;
   cairo_surface_t *surface;
+  /* ever smaller copies of surface, see dia_image_get_surface_for_size() */
+  GPtrArray *mipmaps;
+  /* the surfaces are made when needed, maybe by more than one thread */
+  GMutex lock;
+  char *cache_key; /* in the cache under this, see dia_image_cache_add() */
 };
 
 
 G_DEFINE_TYPE (DiaImage, dia_image, G_TYPE_OBJECT)
 
 
+/*
+ * All images loaded from the same file, or read from the same inline data,
+ * are the same DiaImage so they are decoded only once.  The cache only
+ * holds weak references: an image goes away with its last user.
+ */
+G_LOCK_DEFINE_STATIC (cache);
+static GHashTable *cache = NULL; /* key -> GWeakRef to DiaImage */
+
+
+static void
+_weak_ref_free (gpointer data)
+{
+  GWeakRef *ref = data;
+
+  g_weak_ref_clear (ref);
+  g_free (ref);
+}
+
+
+static void
+_cache_remove (DiaImage *image)
+{
+  GWeakRef *ref;
+  DiaImage *other = NULL;
+
+  G_LOCK (cache);
+  ref = cache ? g_hash_table_lookup (cache, image->cache_key) : NULL;
+  if (ref) {
+    other = g_weak_ref_get (ref);
+    /* unless it was replaced meanwhile */
+    if (!other) {
+      g_hash_table_remove (cache, image->cache_key);
+    }
+  }
+  G_UNLOCK (cache);
+
+  /* not while locked, it could be the last reference */
+  g_clear_object (&other);
+}
+
+
+/**
+ * dia_image_cache_lookup:
+ * @key: what the image was added with
+ *
+ * Returns: (transfer full) (nullable): the image added with
+ *          dia_image_cache_add() under @key, if it's still around
+ *
+ * Since: 0.98
+ */
+DiaImage *
+dia_image_cache_lookup (const char *key)
+{
+  GWeakRef *ref;
+  DiaImage *image = NULL;
+
+  g_return_val_if_fail (key != NULL, NULL);
+
+  G_LOCK (cache);
+  ref = cache ? g_hash_table_lookup (cache, key) : NULL;
+  if (ref) {
+    image = g_weak_ref_get (ref);
+  }
+  G_UNLOCK (cache);
+
+  return image;
+}
+
+
+/**
+ * dia_image_cache_add:
+ * @self: the #DiaImage
+ * @key: identifies the content, like a digest of the encoded data
+ *
+ * Share @self with everyone asking dia_image_cache_lookup() for @key, which
+ * is why a cached image must not be changed anymore
+ *
+ * Since: 0.98
+ */
+void
+dia_image_cache_add (DiaImage *self, const char *key)
+{
+  GWeakRef *ref;
+
+  g_return_if_fail (DIA_IS_IMAGE (self));
+  g_return_if_fail (key != NULL);
+  g_return_if_fail (self->cache_key == NULL);
+
+  ref = g_new0 (GWeakRef, 1);
+  g_weak_ref_init (ref, self);
+  self->cache_key = g_strdup (key);
+
+  G_LOCK (cache);
+  if (!cache) {
+    cache = g_hash_table_new_full (g_str_hash,
+                                   g_str_equal,
+                                   g_free,
+                                   _weak_ref_free);
+  }
+  g_hash_table_replace (cache, g_strdup (key), ref);
+  G_UNLOCK (cache);
+}
+
+
+/* The same file, as long as it wasn't changed */
+static char *
+_file_cache_key (const char *filename)
+{
+  GStatBuf st;
+  char *canonical;
+  char *key;
+
+  if (g_stat (filename, &st) != 0) {
+    return NULL;
+  }
+
+  canonical = g_canonicalize_filename (filename, NULL);
+  key = g_strdup_printf ("file:%" G_GINT64_FORMAT ":%" G_GINT64_FORMAT ":%s",
+                         (gint64) st.st_mtime,
+                         (gint64) st.st_size,
+                         canonical);
+  g_clear_pointer (&canonical, g_free);
+
+  return key;
+}
+
+
 static void
 dia_image_finalize (GObject *object)
 {
@@ -65,9 +203,20 @@ dia_image_finalize (GObject *object)
 
   g_clear_pointer (&image->filename, g_free);
   g_clear_pointer (&image->mime_type, g_free);
+  g_clear_pointer (&image->data, g_bytes_unref);
+  g_clear_pointer (&image->encoded, g_bytes_unref);
 
   cairo_surface_destroy (image->surface);
   image->surface = NULL;
+  g_clear_pointer (&image->mipmaps, g_ptr_array_unref);
+  g_mutex_clear (&image->lock);
+
+  if (image->cache_key) {
+    _cache_remove (image);
+    g_clear_pointer (&image->cache_key, g_free);
+  }
+
+  G_OBJECT_CLASS (dia_image_parent_class)->finalize (object);
 }
 
 
@@ -90,6 +239,7 @@ dia_image_init (DiaImage *image)
   /* GObject *gobject = G_OBJECT(image);  */
   /* zero intialization should be good for us */
   image->surface = NULL;
+  g_mutex_init (&image->lock);
 }
 
 /*!
@@ -98,17 +248,28 @@ dia_image_init (DiaImage *image)
  * @return A statically allocated image.
  * \memberof _DiaImage
  */
+static GdkPixbuf *
+_broken_pixbuf (void)
+{
+  static GdkPixbuf *broken = NULL;
+
+  if (g_once_init_enter (&broken)) {
+    g_once_init_leave (&broken,
+                       pixbuf_from_resource ("/org/gnome/Dia/broken-image.png"));
+  }
+
+  return broken;
+}
+
 DiaImage *
 dia_image_get_broken (void)
 {
-  static GdkPixbuf *broken = NULL;
   DiaImage *image;
 
   image = DIA_IMAGE (g_object_new (DIA_TYPE_IMAGE, NULL));
-  if (broken == NULL) {
-    broken = pixbuf_from_resource ("/org/gnome/Dia/broken-image.png");
-  }
-  image->image = g_object_ref (broken);
+  image->image = g_object_ref (_broken_pixbuf ());
+  image->width = gdk_pixbuf_get_width (image->image);
+  image->height = gdk_pixbuf_get_height (image->image);
   /* Kinda hard to export :) */
   image->filename = g_strdup("<broken>");
   image->scaled = NULL;
@@ -121,6 +282,7 @@ dia_image_get_broken (void)
  * @param filename Name of the file to load.
  * @return An image loaded from file, or NULL if an error occurred.
  *          Error messages will be displayed to the user.
+ *          Loading the same, unchanged file again gives the same image.
  * \memberof _DiaImage
  */
 DiaImage *
@@ -129,6 +291,13 @@ dia_image_load (const gchar *filename)
   DiaImage *dia_img;
   GdkPixbuf *image;
   GError *error = NULL;
+  char *key = _file_cache_key (filename);
+
+  if (key && (dia_img = dia_image_cache_lookup (key)) != NULL) {
+    g_clear_pointer (&key, g_free);
+
+    return dia_img;
+  }
 
   image = gdk_pixbuf_new_from_file (filename, &error);
   if (image == NULL) {
@@ -141,12 +310,15 @@ dia_image_load (const gchar *filename)
     }
 
     g_clear_error (&error);
+    g_clear_pointer (&key, g_free);
 
     return NULL;
   }
 
   dia_img = DIA_IMAGE (g_object_new (DIA_TYPE_IMAGE, NULL));
   dia_img->image = image;
+  dia_img->width = gdk_pixbuf_get_width (image);
+  dia_img->height = gdk_pixbuf_get_height (image);
   dia_img->filename = g_strdup (filename);
   /* the pixbuf does not know anymore where it came from */
   {
@@ -157,9 +329,308 @@ dia_image_load (const gchar *filename)
   }
   dia_img->scaled = NULL;
 
+  if (key) {
+    dia_image_cache_add (dia_img, key);
+    g_clear_pointer (&key, g_free);
+  }
+
   return dia_img;
 }
 
+/* The pixels, decoding them if that was deferred. Call with the lock held */
+static GdkPixbuf *
+_pixbuf_locked (DiaImage *self)
+{
+  GdkPixbuf *pixbuf = NULL;
+  GError *error = NULL;
+
+  if (self->image) {
+    return self->image;
+  }
+
+  if (self->data) {
+    GdkPixbufLoader *loader = gdk_pixbuf_loader_new ();
+
+    if (gdk_pixbuf_loader_write_bytes (loader, self->data, &error) &&
+        gdk_pixbuf_loader_close (loader, &error)) {
+      pixbuf = g_object_ref (gdk_pixbuf_loader_get_pixbuf (loader));
+    } else {
+      gdk_pixbuf_loader_close (loader, NULL);
+    }
+    g_clear_object (&loader);
+  } else if (self->filename) {
+    pixbuf = gdk_pixbuf_new_from_file (self->filename, &error);
+  }
+
+  if (!pixbuf) {
+    /* it looked fine when only the header was read */
+    message_warning (_("Failed to load image:\n%s"),
+                     error ? error->message : dia_image_filename (self));
+    g_clear_error (&error);
+    /* keeping the size everything was laid out with */
+    pixbuf = gdk_pixbuf_scale_simple (_broken_pixbuf (),
+                                      MAX (1, self->width),
+                                      MAX (1, self->height),
+                                      GDK_INTERP_NEAREST);
+  }
+
+  self->image = pixbuf;
+  self->width = gdk_pixbuf_get_width (pixbuf);
+  self->height = gdk_pixbuf_get_height (pixbuf);
+
+  return pixbuf;
+}
+
+
+static GdkPixbuf *
+_pixbuf (const DiaImage *image)
+{
+  DiaImage *self = (DiaImage *) image;
+  GdkPixbuf *pixbuf;
+
+  g_mutex_lock (&self->lock);
+  pixbuf = _pixbuf_locked (self);
+  g_mutex_unlock (&self->lock);
+
+  return pixbuf;
+}
+
+
+static char *
+_format_mime_type (GdkPixbufFormat *format)
+{
+  char **mime_types = gdk_pixbuf_format_get_mime_types (format);
+  char *mime_type = g_strdup (mime_types[0]);
+
+  g_strfreev (mime_types);
+
+  return mime_type;
+}
+
+
+/**
+ * dia_image_load_deferred:
+ * @filename: the image file
+ *
+ * Like dia_image_load(), but only the header is read now to know the
+ * size.  The pixels are decoded when they are first needed, should the
+ * file turn out to be broken then it is drawn as such.
+ *
+ * Returns: (transfer full) (nullable): the image, %NULL if @filename is not
+ *          there or not an image
+ *
+ * Since: 0.98
+ */
+DiaImage *
+dia_image_load_deferred (const char *filename)
+{
+  char *key = _file_cache_key (filename);
+  GdkPixbufFormat *format;
+  DiaImage *image;
+  int width, height;
+
+  if (!key) {
+    return NULL;
+  }
+
+  if ((image = dia_image_cache_lookup (key)) != NULL) {
+    g_clear_pointer (&key, g_free);
+
+    return image;
+  }
+
+  format = gdk_pixbuf_get_file_info (filename, &width, &height);
+  if (!format || width < 1 || height < 1) {
+    g_clear_pointer (&key, g_free);
+
+    return NULL;
+  }
+
+  image = DIA_IMAGE (g_object_new (DIA_TYPE_IMAGE, NULL));
+  image->filename = g_strdup (filename);
+  image->mime_type = _format_mime_type (format);
+  image->width = width;
+  image->height = height;
+
+  dia_image_cache_add (image, key);
+  g_clear_pointer (&key, g_free);
+
+  return image;
+}
+
+
+static void
+_size_prepared (GdkPixbufLoader *loader, int width, int height, gpointer data)
+{
+  int *size = data;
+
+  size[0] = width;
+  size[1] = height;
+}
+
+
+/**
+ * dia_image_new_deferred:
+ * @data: an encoded image, like the contents of a file
+ *
+ * Only the header of @data is read now to know the size, it is decoded
+ * when the pixels are first needed
+ *
+ * Returns: (transfer full) (nullable): the image, %NULL if @data is not an
+ *          image
+ *
+ * Since: 0.98
+ */
+DiaImage *
+dia_image_new_deferred (GBytes *data)
+{
+#define PROBE_SIZE 256
+  GdkPixbufLoader *loader = gdk_pixbuf_loader_new ();
+  GdkPixbufFormat *format;
+  GdkPixbuf *decoded = NULL;
+  DiaImage *image = NULL;
+  int size[2] = { 0, 0 };
+  const guchar *bytes;
+  gsize len;
+
+  g_return_val_if_fail (data != NULL, NULL);
+
+  bytes = g_bytes_get_data (data, &len);
+
+  g_signal_connect (loader, "size-prepared", G_CALLBACK (_size_prepared), size);
+  for (gsize offset = 0; offset < len && size[0] == 0; offset += PROBE_SIZE) {
+    if (!gdk_pixbuf_loader_write (loader,
+                                  bytes + offset,
+                                  MIN (PROBE_SIZE, len - offset),
+                                  NULL)) {
+      break;
+    }
+  }
+
+  /* some formats only tell at the end, then it's decoded anyway */
+  if (size[0] == 0 && gdk_pixbuf_loader_close (loader, NULL)) {
+    decoded = gdk_pixbuf_loader_get_pixbuf (loader);
+  }
+
+  format = gdk_pixbuf_loader_get_format (loader);
+  if (format && size[0] > 0 && size[1] > 0) {
+    image = DIA_IMAGE (g_object_new (DIA_TYPE_IMAGE, NULL));
+    image->data = g_bytes_ref (data);
+    image->mime_type = _format_mime_type (format);
+    image->width = size[0];
+    image->height = size[1];
+    if (decoded) {
+      image->image = g_object_ref (decoded);
+    }
+  }
+
+  /* not interested in the rest */
+  gdk_pixbuf_loader_close (loader, NULL);
+  g_clear_object (&loader);
+
+  return image;
+#undef PROBE_SIZE
+}
+
+/**
+ * dia_image_get_data:
+ * @self: the #DiaImage
+ *
+ * Returns: (transfer none) (nullable): the encoded image @self was made
+ *          from by dia_image_new_deferred()
+ *
+ * Since: 0.98
+ */
+GBytes *
+dia_image_get_data (DiaImage *self)
+{
+  g_return_val_if_fail (DIA_IS_IMAGE (self), NULL);
+
+  return self->data;
+}
+
+
+/**
+ * dia_image_get_encoded:
+ * @self: the #DiaImage
+ * @mime_type: (out) (optional): the type of the result
+ *
+ * The image as a file would hold it: the data or the file it was made
+ * from if there is any, otherwise the pixels encoded as PNG.  That is
+ * done only once, a #DiaImage doesn't change, its pixels are replaced by
+ * making a new one.
+ *
+ * Returns: (transfer full) (nullable): the encoded image, %NULL if it
+ *          can't be encoded
+ *
+ * Since: 0.98
+ */
+GBytes *
+dia_image_get_encoded (DiaImage *self, const char **mime_type)
+{
+  GBytes *encoded = NULL;
+
+  g_return_val_if_fail (DIA_IS_IMAGE (self), NULL);
+
+  if (self->data) {
+    if (mime_type) {
+      *mime_type = dia_image_get_mime_type (self);
+    }
+
+    return g_bytes_ref (self->data);
+  }
+
+  g_mutex_lock (&self->lock);
+  if (!self->encoded && self->filename) {
+    GFile *file = g_file_new_for_path (self->filename);
+    GdkPixbufFormat *format = gdk_pixbuf_get_file_info (self->filename, NULL, NULL);
+
+    /* as it is, not encoded again maybe losing quality */
+    if (format) {
+      self->encoded = g_file_load_bytes (file, NULL, NULL, NULL);
+    }
+    if (self->encoded) {
+      char *file_type = _format_mime_type (format);
+
+      /* only ever a handful of them */
+      self->encoded_type = g_intern_string (file_type);
+      g_clear_pointer (&file_type, g_free);
+    }
+
+    g_clear_object (&file);
+  }
+
+  if (!self->encoded) {
+    GError *error = NULL;
+    gchar *buffer = NULL;
+    gsize len = 0;
+
+    if (gdk_pixbuf_save_to_buffer (_pixbuf_locked (self),
+                                   &buffer,
+                                   &len,
+                                   "png",
+                                   &error,
+                                   NULL)) {
+      self->encoded = g_bytes_new_take (buffer, len);
+      self->encoded_type = "image/png";
+    } else {
+      message_error (_("Saving inline pixbuf failed:\n%s"), error->message);
+      g_clear_error (&error);
+    }
+  }
+
+  if (self->encoded) {
+    encoded = g_bytes_ref (self->encoded);
+    if (mime_type) {
+      *mime_type = self->encoded_type;
+    }
+  }
+  g_mutex_unlock (&self->lock);
+
+  return encoded;
+}
+
+
 /*!
  * \brief Create a Dia Image from in memory GdkPixbuf
  *
@@ -176,6 +647,8 @@ dia_image_new_from_pixbuf (GdkPixbuf *pixbuf)
 
   dia_img = DIA_IMAGE (g_object_new (DIA_TYPE_IMAGE, NULL));
   dia_img->image = g_object_ref (pixbuf);
+  dia_img->width = gdk_pixbuf_get_width (pixbuf);
+  dia_img->height = gdk_pixbuf_get_height (pixbuf);
   mime_type = g_object_get_data (G_OBJECT (pixbuf), "mime-type");
   if (mime_type) {
     dia_img->mime_type = g_strdup (mime_type);
@@ -184,6 +657,51 @@ dia_image_new_from_pixbuf (GdkPixbuf *pixbuf)
   return dia_img;
 }
 
+/**
+ * dia_image_new_shared:
+ * @pixbuf: the #GdkPixbuf
+ *
+ * Like dia_image_new_from_pixbuf(), but if there already is an image
+ * created this way with the same pixels that one is returned
+ *
+ * Returns: (transfer full): the image
+ *
+ * Since: 0.98
+ */
+DiaImage *
+dia_image_new_shared (GdkPixbuf *pixbuf)
+{
+  const char *mime_type = g_object_get_data (G_OBJECT (pixbuf), "mime-type");
+  GChecksum *checksum = g_checksum_new (G_CHECKSUM_SHA256);
+  int size[4] = {
+    gdk_pixbuf_get_width (pixbuf),
+    gdk_pixbuf_get_height (pixbuf),
+    gdk_pixbuf_get_n_channels (pixbuf),
+    gdk_pixbuf_get_rowstride (pixbuf),
+  };
+  DiaImage *image;
+  char *key;
+
+  g_checksum_update (checksum, (const guchar *) size, sizeof (size));
+  g_checksum_update (checksum,
+                     gdk_pixbuf_read_pixels (pixbuf),
+                     gdk_pixbuf_get_byte_length (pixbuf));
+  key = g_strdup_printf ("pixels:%s:%s",
+                         mime_type ? mime_type : "",
+                         g_checksum_get_string (checksum));
+  g_checksum_free (checksum);
+
+  image = dia_image_cache_lookup (key);
+  if (!image) {
+    image = dia_image_new_from_pixbuf (pixbuf);
+    dia_image_cache_add (image, key);
+  }
+
+  g_clear_pointer (&key, g_free);
+
+  return image;
+}
+
 /**
  * dia_image_add_ref:
  * @image: Image that we want a reference to.
@@ -222,18 +740,20 @@ dia_image_unref (DiaImage *image)
 GdkPixbuf *
 dia_image_get_scaled_pixbuf (DiaImage *image, int width, int height)
 {
+  GdkPixbuf *pixbuf;
   GdkPixbuf *scaled;
 
   if (width < 1 || height < 1) {
     return NULL;
   }
-  if (gdk_pixbuf_get_width (image->image) > width ||
-      gdk_pixbuf_get_height (image->image) > height) {
+  pixbuf = _pixbuf (image);
+  if (gdk_pixbuf_get_width (pixbuf) > width ||
+      gdk_pixbuf_get_height (pixbuf) > height) {
     /* Using TILES to make it look more like PostScript */
     if (image->scaled == NULL ||
         image->scaled_width != width || image->scaled_height != height) {
       g_clear_object (&image->scaled);
-      image->scaled = gdk_pixbuf_scale_simple (image->image,
+      image->scaled = gdk_pixbuf_scale_simple (pixbuf,
                                                width,
                                                height,
                                                /* dont waste interpolation time if it wont be seen anyway */
@@ -243,7 +763,7 @@ dia_image_get_scaled_pixbuf (DiaImage *image, int width, int height)
     }
     scaled = image->scaled;
   } else {
-    scaled = image->image;
+    scaled = pixbuf;
   }
   /* always adding a reference */
   return g_object_ref (scaled);
@@ -290,31 +810,30 @@ _guess_format (const gchar *filename)
 
 /*!
  * \brief Save an image under the given filename
- * If saving was successful the internal filename is updated to the
- * given one. Otherwise FALSE will be returned.
+ * The image itself isn't changed, it may be shared through the cache.
+ * Load the file again for an image that refers to it.
+ * \return FALSE if the file couldn't be written
  * \memberof _DiaImage
  */
 gboolean
 dia_image_save (DiaImage *image, const gchar *filename)
 {
+  GdkPixbuf *pixbuf = _pixbuf (image);
   gboolean saved = FALSE;
 
-  if (image->image) {
+  if (pixbuf) {
     GError *error = NULL;
     gchar *type = _guess_format (filename);
 
     if (type) {
       /* XXX: consider image->mime_type */
-      saved = gdk_pixbuf_save (image->image, filename, type, &error, NULL);
+      saved = gdk_pixbuf_save (pixbuf, filename, type, &error, NULL);
     }
-    if (saved) {
-      g_clear_pointer (&image->filename, g_free);
-      image->filename = g_strdup (filename);
-    } else if (!type) {
+    if (!type) {
       /* pathologic case - pixbuf not even supporting PNG? */
       message_error (_("Unsupported file format for saving:\n%s\n"),
                      dia_message_filename (filename));
-    } else {
+    } else if (!saved) {
       message_warning (_("Could not save file:\n%s\n%s\n"),
                        dia_message_filename(filename),
                        error->message);
@@ -337,7 +856,7 @@ dia_image_width (const DiaImage *image)
 {
   g_return_val_if_fail (image != NULL, 0);
 
-  return gdk_pixbuf_get_width (image->image);
+  return image->width;
 }
 
 /*!
@@ -351,7 +870,7 @@ dia_image_height (const DiaImage *image)
 {
   g_return_val_if_fail (image != NULL, 0);
 
-  return gdk_pixbuf_get_height (image->image);
+  return image->height;
 }
 
 /*!
@@ -365,7 +884,7 @@ dia_image_rowstride (const DiaImage *image)
 {
   g_return_val_if_fail (image != NULL, 0);
 
-  return gdk_pixbuf_get_rowstride (image->image);
+  return gdk_pixbuf_get_rowstride (_pixbuf (image));
 }
 /*!
  * \brief Direct const access to the underlying GdkPixbuf
@@ -380,7 +899,7 @@ dia_image_pixbuf (const DiaImage *image)
     return NULL;
   }
 
-  return image->image;
+  return _pixbuf (image);
 }
 
 /*!
@@ -429,14 +948,15 @@ dia_image_rgb_data (const DiaImage *image)
   int rowstride = dia_image_rowstride (image);
   int size = height * rowstride;
   guint8 *rgb_pixels = g_try_new (guint8, size);
+  GdkPixbuf *pixbuf = _pixbuf (image);
 
   if (!rgb_pixels) {
     return NULL;
   }
 
   g_return_val_if_fail (image != NULL, NULL);
-  if (gdk_pixbuf_get_has_alpha (image->image)) {
-    guint8 *pixels = gdk_pixbuf_get_pixels (image->image);
+  if (gdk_pixbuf_get_has_alpha (pixbuf)) {
+    guint8 *pixels = gdk_pixbuf_get_pixels (pixbuf);
     int i, j;
     for (i = 0; i < height; i++) {
       for (j = 0; j < width; j++) {
@@ -447,7 +967,7 @@ dia_image_rgb_data (const DiaImage *image)
     }
     return rgb_pixels;
   } else {
-    guint8 *pixels = gdk_pixbuf_get_pixels (image->image);
+    guint8 *pixels = gdk_pixbuf_get_pixels (pixbuf);
 
     memmove (rgb_pixels, pixels, height*rowstride);
 
@@ -465,18 +985,19 @@ dia_image_rgb_data (const DiaImage *image)
 guint8 *
 dia_image_mask_data (const DiaImage *image)
 {
+  GdkPixbuf *pixbuf = _pixbuf (image);
   guint8 *pixels;
   guint8 *mask;
   int i, size;
 
-  if (!gdk_pixbuf_get_has_alpha (image->image)) {
+  if (!gdk_pixbuf_get_has_alpha (pixbuf)) {
     return NULL;
   }
 
-  pixels = gdk_pixbuf_get_pixels (image->image);
+  pixels = gdk_pixbuf_get_pixels (pixbuf);
 
-  size = gdk_pixbuf_get_width (image->image) *
-                                       gdk_pixbuf_get_height(image->image);
+  size = gdk_pixbuf_get_width (pixbuf) *
+                                       gdk_pixbuf_get_height(pixbuf);
 
   mask = g_try_new (guint8, size);
   if (!mask) {
@@ -501,9 +1022,12 @@ dia_image_mask_data (const DiaImage *image)
 const guint8 *
 dia_image_rgba_data (const DiaImage *image)
 {
+  GdkPixbuf *pixbuf;
+
   g_return_val_if_fail (image != NULL, 0);
-  if (gdk_pixbuf_get_has_alpha (image->image)) {
-    const guint8 *pixels = gdk_pixbuf_get_pixels (image->image);
+  pixbuf = _pixbuf (image);
+  if (gdk_pixbuf_get_has_alpha (pixbuf)) {
+    const guint8 *pixels = gdk_pixbuf_get_pixels (pixbuf);
 
     return pixels;
   } else {
@@ -528,26 +1052,119 @@ dia_image_filename (const DiaImage *image)
   return image->filename;
 }
 
-cairo_surface_t *
-dia_image_get_surface (DiaImage *self)
+/* The full size one, call with the lock held */
+static cairo_surface_t *
+_get_surface (DiaImage *self)
 {
+  GdkPixbuf *pixbuf;
   cairo_t *ctx = NULL;
 
-  g_return_val_if_fail (self != NULL, NULL);
-  g_return_val_if_fail (DIA_IS_IMAGE (self), NULL);
-
   if (self->surface != NULL) {
     return self->surface;
   }
 
+  pixbuf = _pixbuf_locked (self);
   self->surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
-                                              dia_image_width (self),
-                                              dia_image_height (self));
+                                              gdk_pixbuf_get_width (pixbuf),
+                                              gdk_pixbuf_get_height (pixbuf));
   ctx = cairo_create (self->surface);
 
-  gdk_cairo_set_source_pixbuf (ctx, dia_image_pixbuf (self), 0.0, 0.0);
+  gdk_cairo_set_source_pixbuf (ctx, pixbuf, 0.0, 0.0);
 
   cairo_paint (ctx);
+  cairo_destroy (ctx);
 
   return self->surface;
 }
+
+
+cairo_surface_t *
+dia_image_get_surface (DiaImage *self)
+{
+  cairo_surface_t *surface;
+
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (DIA_IS_IMAGE (self), NULL);
+
+  g_mutex_lock (&self->lock);
+  surface = _get_surface (self);
+  g_mutex_unlock (&self->lock);
+
+  return surface;
+}
+
+
+/* Half the size, rounding up */
+static cairo_surface_t *
+_halve_surface (cairo_surface_t *surface)
+{
+  int width = cairo_image_surface_get_width (surface);
+  int height = cairo_image_surface_get_height (surface);
+  int half_width = (width + 1) / 2;
+  int half_height = (height + 1) / 2;
+  cairo_surface_t *half = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+                                                      half_width,
+                                                      half_height);
+  cairo_t *ctx = cairo_create (half);
+
+  cairo_scale (ctx,
+               (double) half_width / width,
+               (double) half_height / height);
+  cairo_set_source_surface (ctx, surface, 0.0, 0.0);
+  /* averages when scaling down */
+  cairo_pattern_set_filter (cairo_get_source (ctx), CAIRO_FILTER_GOOD);
+  cairo_paint (ctx);
+  cairo_destroy (ctx);
+
+  return half;
+}
+
+
+/**
+ * dia_image_get_surface_for_size:
+ * @self: the #DiaImage
+ * @width: how wide it is drawn, in device units
+ * @height: how high it is drawn, in device units
+ *
+ * Zoomed out a big image would be filtered down from its full size on
+ * every paint.  Instead this picks the smallest of a row of copies, each
+ * half the size of the one before, that still has at least @width x
+ * @height pixels.  The copies are made when first needed and kept with
+ * the image.
+ *
+ * Returns: (transfer none): the surface to paint
+ *
+ * Since: 0.98
+ */
+cairo_surface_t *
+dia_image_get_surface_for_size (DiaImage *self, double width, double height)
+{
+  cairo_surface_t *surface;
+
+  g_return_val_if_fail (DIA_IS_IMAGE (self), NULL);
+
+  g_mutex_lock (&self->lock);
+
+  surface = _get_surface (self);
+  for (guint level = 0; ; level++) {
+    int w = cairo_image_surface_get_width (surface);
+    int h = cairo_image_surface_get_height (surface);
+
+    /* the next one would have to be scaled up */
+    if ((w + 1) / 2 < width || (h + 1) / 2 < height || (w <= 1 && h <= 1)) {
+      break;
+    }
+
+    if (!self->mipmaps) {
+      self->mipmaps = g_ptr_array_new_with_free_func ((GDestroyNotify) cairo_surface_destroy);
+    }
+    if (level >= self->mipmaps->len) {
+      g_ptr_array_add (self->mipmaps, _halve_surface (surface));
+    }
+    surface = g_ptr_array_index (self->mipmaps, level);
+  }
+
+  g_mutex_unlock (&self->lock);
+
+  return surface;
+}
@@ -33,7 +33,16 @@ G_DECLARE_FINAL_TYPE (DiaImage, dia_image, DIA, IMAGE, GObject)
 DiaImage        *dia_image_get_broken        (void);
 
 DiaImage        *dia_image_load              (const gchar    *filename);
+DiaImage        *dia_image_load_deferred     (const char     *filename);
+DiaImage        *dia_image_new_deferred      (GBytes         *data);
+GBytes          *dia_image_get_data          (DiaImage       *self);
+GBytes          *dia_image_get_encoded       (DiaImage       *self,
+                                              const char    **mime_type);
 DiaImage        *dia_image_new_from_pixbuf   (GdkPixbuf      *pixbuf);
+DiaImage        *dia_image_new_shared        (GdkPixbuf      *pixbuf);
+DiaImage        *dia_image_cache_lookup      (const char     *key);
+void             dia_image_cache_add         (DiaImage       *self,
+                                              const char     *key);
 void             dia_image_add_ref           (DiaImage       *image);
 void             dia_image_unref             (DiaImage       *image);
 
@@ -79,6 +88,10 @@ GdkPixbuf       *dia_image_get_scaled_pixbuf (DiaImage       *image,
                                               int             width,
                                               int             height);
 cairo_surface_t *dia_image_get_surface       (DiaImage       *self);
+cairo_surface_t *dia_image_get_surface_for_size
+                                             (DiaImage       *self,
+                                              double          width,
+                                              double          height);
 
 G_END_DECLS
 
@@ -39,7 +39,9 @@
 #endif
 
 #include "dia_xml.h"
+#include "dia-number.h"
 #include "message.h"
+#include "prefs.h"
 
 
 /*!
@@ -294,7 +296,7 @@ data_real(DataNode data, DiaContext *ctx)
   }
 
   val = xmlGetProp(data, (const xmlChar *)"val");
-  res = g_ascii_strtod((char *) val, NULL);
+  res = val ? dia_number_parse ((char *) val, NULL) : 0.0;
   if (val) xmlFree(val);
 
   return res;
@@ -418,7 +420,7 @@ data_point(DataNode data, Point *point, DiaContext *ctx)
   }
 
   val = xmlGetProp(data, (const xmlChar *)"val");
-  point->x = g_ascii_strtod((char *)val, &str);
+  point->x = dia_number_parse ((char *)val, &str);
   ax = fabs(point->x);
   if ((ax > 1e9) || ((ax < 1e-9) && (ax != 0.0)) || isnan(ax) || isinf(ax)) {
     /* there is no provision to keep values larger when saving,
@@ -435,7 +437,7 @@ data_point(DataNode data, Point *point, DiaContext *ctx)
     xmlFree(val);
     return;
   }
-  point->y = g_ascii_strtod(str+1, NULL);
+  point->y = dia_number_parse (str+1, NULL);
   ay = fabs(point->y);
   if ((ay > 1e9) || ((ay < 1e-9) && (ay != 0.0)) || isnan(ay) || isinf(ay)) {
     if (!(ay < 1e-9)) /* don't bother with useless warnings (see above) */
@@ -474,12 +476,12 @@ data_bezpoint(DataNode data, BezPoint *point, DiaContext *ctx)
   }
   val = xmlGetProp(data, (const xmlChar *)"p1");
   if (val) {
-    point->p1.x = g_ascii_strtod((char *)val, &str);
+    point->p1.x = dia_number_parse ((char *)val, &str);
     if (*str==0) {
       point->p1.y = 0;
       g_warning(_("Error parsing bezpoint p1."));
     } else {
-      point->p1.y = g_ascii_strtod(str+1, NULL);
+      point->p1.y = dia_number_parse (str+1, NULL);
     }
     xmlFree(val);
   } else {
@@ -488,12 +490,12 @@ data_bezpoint(DataNode data, BezPoint *point, DiaContext *ctx)
   }
   val = xmlGetProp(data, (const xmlChar *)"p2");
   if (val) {
-    point->p2.x = g_ascii_strtod((char *)val, &str);
+    point->p2.x = dia_number_parse ((char *)val, &str);
     if (*str==0) {
       point->p2.y = 0;
       g_warning(_("Error parsing bezpoint p2."));
     } else {
-      point->p2.y = g_ascii_strtod(str+1, NULL);
+      point->p2.y = dia_number_parse (str+1, NULL);
     }
     xmlFree(val);
   } else {
@@ -502,12 +504,12 @@ data_bezpoint(DataNode data, BezPoint *point, DiaContext *ctx)
   }
   val = xmlGetProp(data, (const xmlChar *)"p3");
   if (val) {
-    point->p3.x = g_ascii_strtod((char *)val, &str);
+    point->p3.x = dia_number_parse ((char *)val, &str);
     if (*str==0) {
       point->p3.y = 0;
       g_warning(_("Error parsing bezpoint p3."));
     } else {
-      point->p3.y = g_ascii_strtod(str+1, NULL);
+      point->p3.y = dia_number_parse (str+1, NULL);
     }
     xmlFree(val);
   } else {
@@ -538,7 +540,7 @@ data_rectangle(DataNode data, DiaRectangle *rect, DiaContext *ctx)
 
   val = xmlGetProp(data, (const xmlChar *)"val");
 
-  rect->left = g_ascii_strtod((char *)val, &str);
+  rect->left = dia_number_parse ((char *)val, &str);
 
   while ((*str != ',') && (*str!=0))
     str++;
@@ -549,7 +551,7 @@ data_rectangle(DataNode data, DiaRectangle *rect, DiaContext *ctx)
     return;
   }
 
-  rect->top = g_ascii_strtod(str+1, &str);
+  rect->top = dia_number_parse (str+1, &str);
 
   while ((*str != ';') && (*str!=0))
     str++;
@@ -560,7 +562,7 @@ data_rectangle(DataNode data, DiaRectangle *rect, DiaContext *ctx)
     return;
   }
 
-  rect->right = g_ascii_strtod(str+1, &str);
+  rect->right = dia_number_parse (str+1, &str);
 
   while ((*str != ',') && (*str!=0))
     str++;
@@ -571,7 +573,7 @@ data_rectangle(DataNode data, DiaRectangle *rect, DiaContext *ctx)
     return;
   }
 
-  rect->bottom = g_ascii_strtod(str+1, NULL);
+  rect->bottom = dia_number_parse (str+1, NULL);
 
   xmlFree(val);
 }
@@ -820,9 +822,10 @@ void
 data_add_real(AttributeNode attr, real data, DiaContext *ctx)
 {
   DataNode data_node;
-  char buffer[G_ASCII_DTOSTR_BUF_SIZE]; /* Large enought */
+  char buffer[DIA_NUMBER_BUF_SIZE];
 
-  g_ascii_dtostr(buffer, G_ASCII_DTOSTR_BUF_SIZE, data);
+  /* Not necessarily a length, so never rounded */
+  dia_number_format (buffer, sizeof (buffer), data, DIA_NUMBER_EXACT);
 
   data_node = xmlNewChild(attr, NULL, (const xmlChar *)"real", NULL);
   xmlSetProp(data_node, (const xmlChar *)"val", (xmlChar *)buffer);
@@ -897,18 +900,27 @@ data_add_color(AttributeNode attr, const Color *col, DiaContext *ctx)
   xmlSetProp(data_node, (const xmlChar *)"val", (xmlChar *)buffer);
 }
 
-static gchar *
-_str_point (const Point *point)
+/*
+ * Coordinates are lengths in cm, the only numbers the save precision
+ * rounds; by default they read back exactly
+ */
+static void
+_str_coord (char *buffer, gsize len, double value)
 {
-  gchar *buffer;
-  gchar px_buf[G_ASCII_DTOSTR_BUF_SIZE];
-  gchar py_buf[G_ASCII_DTOSTR_BUF_SIZE];
+  dia_number_format (buffer, len, value, prefs_get_save_precision ());
+}
 
-  g_ascii_formatd(px_buf, sizeof(px_buf), "%g", point->x);
-  g_ascii_formatd(py_buf, sizeof(py_buf), "%g", point->y);
-  buffer = g_strconcat(px_buf, ",", py_buf, NULL);
+#define POINT_BUF_SIZE (2 * DIA_NUMBER_BUF_SIZE)
 
-  return buffer;
+static void
+_str_point (char *buffer, const Point *point)
+{
+  gsize len;
+
+  _str_coord (buffer, DIA_NUMBER_BUF_SIZE, point->x);
+  len = strlen (buffer);
+  buffer[len++] = ',';
+  _str_coord (buffer + len, POINT_BUF_SIZE - len, point->y);
 }
 
 /*!
@@ -922,11 +934,12 @@ void
 data_add_point(AttributeNode attr, const Point *point, DiaContext *ctx)
 {
   DataNode data_node;
-  gchar *buffer = _str_point (point);
+  char buffer[POINT_BUF_SIZE];
+
+  _str_point (buffer, point);
 
   data_node = xmlNewChild(attr, NULL, (const xmlChar *)"point", NULL);
   xmlSetProp(data_node, (const xmlChar *)"val", (xmlChar *)buffer);
-  g_clear_pointer (&buffer, g_free);
 }
 
 /*!
@@ -937,7 +950,7 @@ void
 data_add_bezpoint(AttributeNode attr, const BezPoint *point, DiaContext *ctx)
 {
   DataNode data_node;
-  gchar *buffer;
+  char buffer[POINT_BUF_SIZE];
 
   data_node = xmlNewChild(attr, NULL, (const xmlChar *)"bezpoint", NULL);
   switch (point->type) {
@@ -954,16 +967,13 @@ data_add_bezpoint(AttributeNode attr, const BezPoint *point, DiaContext *ctx)
     g_assert_not_reached();
   }
 
-  buffer = _str_point (&point->p1);
+  _str_point (buffer, &point->p1);
   xmlSetProp(data_node, (const xmlChar *)"p1", (xmlChar *)buffer);
-  g_clear_pointer (&buffer, g_free);
   if (point->type == BEZ_CURVE_TO) {
-    buffer = _str_point (&point->p2);
+    _str_point (buffer, &point->p2);
     xmlSetProp(data_node, (const xmlChar *)"p2", (xmlChar *)buffer);
-    g_clear_pointer (&buffer, g_free);
-    buffer = _str_point (&point->p3);
+    _str_point (buffer, &point->p3);
     xmlSetProp(data_node, (const xmlChar *)"p3", (xmlChar *)buffer);
-    g_clear_pointer (&buffer, g_free);
   }
 }
 
@@ -984,10 +994,10 @@ data_add_rectangle(AttributeNode attr, const DiaRectangle *rect, DiaContext *ctx
   gchar rt_buf[G_ASCII_DTOSTR_BUF_SIZE];
   gchar rb_buf[G_ASCII_DTOSTR_BUF_SIZE];
 
-  g_ascii_formatd(rl_buf, sizeof(rl_buf), "%g", rect->left);
-  g_ascii_formatd(rr_buf, sizeof(rr_buf), "%g", rect->right);
-  g_ascii_formatd(rt_buf, sizeof(rt_buf), "%g", rect->top);
-  g_ascii_formatd(rb_buf, sizeof(rb_buf), "%g", rect->bottom);
+  _str_coord (rl_buf, sizeof (rl_buf), rect->left);
+  _str_coord (rr_buf, sizeof (rr_buf), rect->right);
+  _str_coord (rt_buf, sizeof (rt_buf), rect->top);
+  _str_coord (rb_buf, sizeof (rb_buf), rect->bottom);
 
   buffer = g_strconcat(rl_buf, ",", rt_buf, ";", rr_buf, ",", rb_buf, NULL);
 
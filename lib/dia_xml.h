@@ -109,7 +109,10 @@ GHashTable *data_dict (DataNode data, DiaContext *ctx);
 void data_add_dict (AttributeNode attr, GHashTable *data, DiaContext *ctx);
 
 GdkPixbuf *data_pixbuf (DataNode data, DiaContext *ctx);
+DiaImage *data_image (DataNode data, DiaContext *ctx);
 void data_add_pixbuf (AttributeNode attr, GdkPixbuf *pixbuf, DiaContext *ctx);
+void data_add_image (AttributeNode attr, DiaImage *image, DiaContext *ctx);
+void data_adopt_blobs (xmlNodePtr node, xmlDocPtr from, DiaContext *ctx);
 
 DiaMatrix *data_matrix(DataNode data);
 void data_add_matrix(AttributeNode attr, DiaMatrix *matrix, DiaContext *ctx);
@@ -35,6 +35,7 @@
 #include "paper.h"
 #include "persistence.h"
 #include "dia-layer.h"
+#include "dia-render-profile.h"
 
 #include "dynamic_obj.h"
 #include "diamarshal.h"
@@ -663,6 +664,10 @@ data_highlight_add (DiagramData *data, DiaObject *obj, DiaHighlightType type)
   oh->obj = obj;
   oh->type = type;
   data->highlighted = g_list_prepend (data->highlighted, oh);
+
+  if (dia_object_get_parent_layer (obj)) {
+    dia_layer_changed (dia_object_get_parent_layer (obj));
+  }
 }
 
 
@@ -678,6 +683,10 @@ data_highlight_remove (DiagramData *data, DiaObject *obj)
   data->highlighted = g_list_remove (data->highlighted, oh);
 
   g_clear_pointer (&oh, g_free);
+
+  if (dia_object_get_parent_layer (obj)) {
+    dia_layer_changed (dia_object_get_parent_layer (obj));
+  }
 }
 
 
@@ -1011,11 +1020,24 @@ data_render (DiagramData    *data,
   DIA_FOR_LAYER_IN_DIAGRAM (data, layer, i, {
     active_layer = (layer == active);
     if (dia_layer_is_visible (layer)) {
-      if (obj_renderer) {
+      gint64 start = dia_render_profile_start ();
+
+      if (obj_renderer && !active_layer && DIA_IS_INTERACTIVE_RENDERER (renderer)) {
+        /* Only the active layer is edited, the others hardly change */
+        dia_interactive_renderer_draw_layer_cached (DIA_INTERACTIVE_RENDERER (renderer),
+                                                    layer,
+                                                    update,
+                                                    obj_renderer,
+                                                    gdata);
+      } else if (obj_renderer) {
         dia_layer_render (layer, renderer, update, obj_renderer, gdata, active_layer);
       } else {
         dia_renderer_draw_layer (renderer, layer, active_layer, update);
       }
+
+      dia_render_profile_add (DIA_RENDER_PROFILE_LAYER,
+                              dia_layer_get_name (layer),
+                              start);
     }
   });
 
@@ -1024,20 +1046,24 @@ data_render (DiagramData    *data,
   }
 }
 
-/*!
- * \brief Calls data_render() for paginated formats
+/**
+ * data_get_page_bounds:
+ * @data: the diagram
  *
- * Call data_render() for every used page in the diagram
+ * The pages a paginated export of @data has, row by row
  *
- * \memberof _DiagramData
+ * Returns: (transfer full) (element-type DiaRectangle): the area of the
+ *          diagram on each page
+ *
+ * Since: 0.98
  */
-void
-data_render_paginated (DiagramData *data, DiaRenderer *renderer, gpointer user_data)
+GArray *
+data_get_page_bounds (DiagramData *data)
 {
+  GArray *pages = g_array_new (FALSE, FALSE, sizeof (DiaRectangle));
   DiaRectangle *extents;
   gdouble width, height;
   gdouble x, y, initx, inity;
-  gint xpos, ypos;
 
   /* the usable area of the page */
   width = data->paper.width;
@@ -1054,12 +1080,12 @@ data_render_paginated (DiagramData *data, DiaRenderer *renderer, gpointer user_d
   }
 
   /* iterate through all the pages in the diagram */
-  for (y = inity, ypos = 0; y < extents->bottom; y += height, ypos++) {
+  for (y = inity; y < extents->bottom; y += height) {
     /* ensure we are not producing pages for epsilon */
     if ((extents->bottom - y) < 1e-6)
       break;
 
-    for (x = initx, xpos = 0; x < extents->right; x += width, xpos++) {
+    for (x = initx; x < extents->right; x += width) {
       DiaRectangle page_bounds;
 
       if ((extents->right - x) < 1e-6)
@@ -1070,9 +1096,36 @@ data_render_paginated (DiagramData *data, DiaRenderer *renderer, gpointer user_d
       page_bounds.top = y;
       page_bounds.bottom = y + height;
 
-      data_render (data, renderer, &page_bounds, NULL, user_data);
+      g_array_append_val (pages, page_bounds);
     }
   }
+
+  return pages;
+}
+
+
+/*!
+ * \brief Calls data_render() for paginated formats
+ *
+ * Call data_render() for every used page in the diagram, see
+ * data_get_page_bounds()
+ *
+ * \memberof _DiagramData
+ */
+void
+data_render_paginated (DiagramData *data, DiaRenderer *renderer, gpointer user_data)
+{
+  GArray *pages = data_get_page_bounds (data);
+
+  for (guint i = 0; i < pages->len; i++) {
+    data_render (data,
+                 renderer,
+                 &g_array_index (pages, DiaRectangle, i),
+                 NULL,
+                 user_data);
+  }
+
+  g_array_unref (pages);
 }
 
 
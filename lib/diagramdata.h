@@ -154,6 +154,7 @@ void data_render(DiagramData *data, DiaRenderer *renderer, DiaRectangle *update,
 		 ObjectRenderer obj_renderer /* Can be NULL */,
 		 gpointer gdata);
 void data_render_paginated(DiagramData *data, DiaRenderer *renderer, gpointer user_data);
+GArray *data_get_page_bounds (DiagramData *data);
 
 DiagramData *diagram_data_clone (DiagramData *data);
 DiagramData *diagram_data_clone_selected (DiagramData *data);
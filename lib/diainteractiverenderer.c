@@ -22,6 +22,7 @@
 
 #include "diarenderer.h"
 #include "diainteractiverenderer.h"
+#include "dia-layer.h"
 
 G_DEFINE_INTERFACE (DiaInteractiveRenderer, dia_interactive_renderer, DIA_TYPE_RENDERER)
 
@@ -72,6 +73,9 @@ dia_interactive_renderer_default_init (DiaInteractiveRendererInterface *iface)
   iface->paint = NULL;
   iface->set_size = NULL;
   iface->draw_object_highlighted = NULL;
+  iface->draw_layer_cached = NULL;
+  iface->invalidate_layers = NULL;
+  iface->scroll = NULL;
 }
 
 
@@ -352,3 +356,129 @@ dia_interactive_renderer_set_selection (DiaInteractiveRenderer *self,
 
   irenderer->set_selection (self, has_selection, x, y, width, height);
 }
+
+
+/**
+ * dia_interactive_renderer_draw_layer_cached:
+ * @self: the #DiaInteractiveRenderer
+ * @layer: the #DiaLayer to draw
+ * @update: the area to draw
+ * @obj_renderer: how to draw an object of @layer
+ * @data: user data for @obj_renderer
+ *
+ * Like dia_layer_render() for a layer that isn't the active one.  The
+ * renderer may keep the result around, and draw @layer again from that
+ * until dia_layer_get_changes() differs.  Changes not told with
+ * dia_layer_changed() need dia_interactive_renderer_invalidate_layers().
+ *
+ * Since: 0.98
+ */
+void
+dia_interactive_renderer_draw_layer_cached (DiaInteractiveRenderer *self,
+                                            DiaLayer               *layer,
+                                            DiaRectangle           *update,
+                                            ObjectRenderer          obj_renderer,
+                                            gpointer                data)
+{
+  DiaInteractiveRendererInterface *irenderer =
+    DIA_INTERACTIVE_RENDERER_GET_IFACE (self);
+
+  g_return_if_fail (irenderer != NULL);
+
+  if (irenderer->draw_layer_cached) {
+    irenderer->draw_layer_cached (self, layer, update, obj_renderer, data);
+  } else {
+    dia_layer_render (layer, DIA_RENDERER (self), update, obj_renderer, data, FALSE);
+  }
+}
+
+
+/**
+ * dia_interactive_renderer_invalidate_layers:
+ * @self: the #DiaInteractiveRenderer
+ *
+ * Drop everything kept by dia_interactive_renderer_draw_layer_cached()
+ *
+ * Since: 0.98
+ */
+void
+dia_interactive_renderer_invalidate_layers (DiaInteractiveRenderer *self)
+{
+  DiaInteractiveRendererInterface *irenderer =
+    DIA_INTERACTIVE_RENDERER_GET_IFACE (self);
+
+  g_return_if_fail (irenderer != NULL);
+
+  if (irenderer->invalidate_layers) {
+    irenderer->invalidate_layers (self);
+  }
+}
+
+
+/**
+ * dia_interactive_renderer_scroll:
+ * @self: the #DiaInteractiveRenderer
+ * @dx: horizontal distance in pixels
+ * @dy: vertical distance in pixels
+ *
+ * The visible area was moved by @dx, @dy, move what's drawn along with it.
+ * The uncovered parts still need to be drawn.
+ *
+ * Returns: %FALSE if not supported, everything needs drawing again
+ *
+ * Since: 0.98
+ */
+gboolean
+dia_interactive_renderer_scroll (DiaInteractiveRenderer *self,
+                                 int                     dx,
+                                 int                     dy)
+{
+  DiaInteractiveRendererInterface *irenderer =
+    DIA_INTERACTIVE_RENDERER_GET_IFACE (self);
+
+  g_return_val_if_fail (irenderer != NULL, FALSE);
+
+  if (irenderer->scroll) {
+    return irenderer->scroll (self, dx, dy);
+  }
+
+  return FALSE;
+}
+
+
+/**
+ * dia_interactive_renderer_fill_pixel_pattern:
+ * @self: the #DiaInteractiveRenderer
+ * @x: horizontal pixel position
+ * @y: vertical pixel position
+ * @width: width in pixels
+ * @height: height in pixels
+ * @pattern: the #cairo_pattern_t to fill with, in pixel coordinates
+ *
+ * Fills the rectangle with @pattern, e.g. a tile repeated over it
+ *
+ * Returns: %FALSE if not supported, nothing was drawn
+ *
+ * Since: 0.98
+ */
+gboolean
+dia_interactive_renderer_fill_pixel_pattern (DiaInteractiveRenderer *self,
+                                             int                     x,
+                                             int                     y,
+                                             int                     width,
+                                             int                     height,
+                                             cairo_pattern_t        *pattern)
+{
+  DiaInteractiveRendererInterface *irenderer =
+    DIA_INTERACTIVE_RENDERER_GET_IFACE (self);
+
+  g_return_val_if_fail (irenderer != NULL, FALSE);
+
+  if (irenderer->fill_pixel_pattern) {
+    irenderer->fill_pixel_pattern (self, x, y, width, height, pattern);
+
+    return TRUE;
+  }
+
+  return FALSE;
+}
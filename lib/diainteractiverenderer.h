@@ -49,6 +49,10 @@ G_DECLARE_INTERFACE (DiaInteractiveRenderer, dia_interactive_renderer, DIA, INTE
  * @paint: Copy already rendered content to the given context
  * @draw_object_highlighted: Support for drawing selected objects highlighted
  * @set_selection: Set the current selection box
+ * @draw_layer_cached: Draw a layer that's not edited, possibly from a cache
+ * @invalidate_layers: Forget any layers drawn by @draw_layer_cached
+ * @scroll: Move what's drawn already, the visible area has moved
+ * @fill_pixel_pattern: Fill a rectangle in pixels with a cairo pattern
  */
 struct _DiaInteractiveRendererInterface
 {
@@ -96,6 +100,21 @@ struct _DiaInteractiveRendererInterface
                                    double                  y,
                                    double                  width,
                                    double                  height);
+  void (*draw_layer_cached)       (DiaInteractiveRenderer *self,
+                                   DiaLayer               *layer,
+                                   DiaRectangle           *update,
+                                   ObjectRenderer          obj_renderer,
+                                   gpointer                data);
+  void (*invalidate_layers)       (DiaInteractiveRenderer *self);
+  gboolean (*scroll)              (DiaInteractiveRenderer *self,
+                                   int                     dx,
+                                   int                     dy);
+  void (*fill_pixel_pattern)      (DiaInteractiveRenderer *self,
+                                   int                     x,
+                                   int                     y,
+                                   int                     width,
+                                   int                     height,
+                                   cairo_pattern_t        *pattern);
 };
 
 
@@ -139,6 +158,21 @@ void dia_interactive_renderer_set_selection           (DiaInteractiveRenderer *s
                                                        double                  y,
                                                        double                  width,
                                                        double                  height);
+void dia_interactive_renderer_draw_layer_cached       (DiaInteractiveRenderer *self,
+                                                       DiaLayer               *layer,
+                                                       DiaRectangle           *update,
+                                                       ObjectRenderer          obj_renderer,
+                                                       gpointer                data);
+void dia_interactive_renderer_invalidate_layers       (DiaInteractiveRenderer *self);
+gboolean dia_interactive_renderer_scroll              (DiaInteractiveRenderer *self,
+                                                       int                     dx,
+                                                       int                     dy);
+gboolean dia_interactive_renderer_fill_pixel_pattern  (DiaInteractiveRenderer *self,
+                                                       int                     x,
+                                                       int                     y,
+                                                       int                     width,
+                                                       int                     height,
+                                                       cairo_pattern_t        *pattern);
 
 
 G_END_DECLS
@@ -38,8 +38,11 @@
 #include <unistd.h>
 #endif
 
+#include <gio/gio.h>
+
 #include <libxml/entities.h>
 #include <libxml/tree.h>
+#include <libxml/xmlIO.h>
 #include <libxml/xmlmemory.h>
 
 #include "geometry.h"
@@ -48,7 +51,6 @@
 
 #include "diasvgrenderer.h"
 #include "textline.h"
-#include "prop_pixbuf.h" /* pixbuf_encode_base64() */
 #include "pattern.h"
 #include "dia-io.h"
 
@@ -65,6 +67,9 @@ G_DEFINE_TYPE (DiaSvgRenderer, dia_svg_renderer, DIA_TYPE_RENDERER)
 #define DTOSTR_BUF_SIZE G_ASCII_DTOSTR_BUF_SIZE
 #define dia_svg_dtostr(buf,d)                                  \
   g_ascii_formatd(buf,sizeof(buf),"%g",(d)*renderer->scale)
+/* positions, relative to DiaSvgRenderer::offset */
+#define dia_svg_xtostr(buf,x) dia_svg_dtostr(buf,(x)-renderer->offset.x)
+#define dia_svg_ytostr(buf,y) dia_svg_dtostr(buf,(y)-renderer->offset.y)
 
 
 static void  draw_text_line      (DiaRenderer  *self,
@@ -72,6 +77,7 @@ static void  draw_text_line      (DiaRenderer  *self,
                                   Point        *pos,
                                   DiaAlignment  alignment,
                                   Color        *colour);
+static void  _image_defs_free    (DiaSvgImageDefs *image_defs);
 
 /*!
  * \brief Initialize to SVG rendering defaults
@@ -186,27 +192,747 @@ _gradient_do (gpointer key,
 }
 
 
+/*
+ * Streaming
+ *
+ * Without it every element stays in renderer->doc until end_render, which
+ * for big diagrams costs several times the size of the file.  With it, the
+ * subclass tells us when a group is complete and it's written to a spool
+ * file and freed right away.  The <defs> have to come first but are only
+ * known at the end, so the real file is assembled in end_render from the
+ * prologue, the <defs> and the spool.
+ *
+ * Everything is written with the same libxml2 serialiser and indentation
+ * dia_io_save_document() uses, so the result is the same file.
+ */
+
+typedef struct _StreamSink StreamSink;
+struct _StreamSink {
+  GOutputStream *stream;
+  GError        *error;
+};
+
+struct _DiaSvgStream {
+  GFile              *spool;
+  GFileIOStream      *spool_stream;
+  StreamSink          sink;
+  xmlOutputBufferPtr  body;
+  /* anything in body at all */
+  gboolean            written;
+  /* groups with their start tag in body, innermost last */
+  GQueue              open;
+};
+
+
+static int
+_sink_write (void *context, const char *buffer, int len)
+{
+  StreamSink *sink = context;
+
+  if (sink->error) {
+    return -1;
+  }
+
+  if (!g_output_stream_write_all (sink->stream, buffer, len, NULL, NULL, &sink->error)) {
+    return -1;
+  }
+
+  return len;
+}
+
+
+static int
+_sink_close (void *context)
+{
+  /* the stream belongs to the caller */
+  return 0;
+}
+
+
+static void
+_stream_free (DiaSvgStream *stream)
+{
+  g_clear_pointer (&stream->body, xmlOutputBufferClose);
+  g_clear_error (&stream->sink.error);
+  if (stream->spool_stream) {
+    g_io_stream_close (G_IO_STREAM (stream->spool_stream), NULL, NULL);
+  }
+  g_clear_object (&stream->spool_stream);
+  if (stream->spool) {
+    g_file_delete (stream->spool, NULL, NULL);
+  }
+  g_clear_object (&stream->spool);
+  g_queue_clear (&stream->open);
+
+  g_free (stream);
+}
+
+
+static void
+_write_indent (xmlOutputBufferPtr out, int level)
+{
+  for (int i = 0; i < level; i++) {
+    xmlOutputBufferWrite (out, 2, "  ");
+  }
+}
+
+
+/* What xmlSaveDoc() does for each child of a formatted element */
+static void
+_write_child (xmlOutputBufferPtr out, xmlNodePtr node, int level)
+{
+  _write_indent (out, level);
+  xmlNodeDumpOutput (out, node->doc, node, level, 1, "UTF-8");
+  xmlOutputBufferWrite (out, 1, "\n");
+}
+
+
+static void
+_write_start_tag (xmlOutputBufferPtr out, xmlNodePtr node, int level)
+{
+  /* Let libxml2 do the attributes and namespaces: a copy without the
+   * children comes out as <name .../>, of which we take all but the end */
+  xmlNodePtr copy = xmlDocCopyNode (node, node->doc, 2);
+  xmlOutputBufferPtr tag = xmlAllocOutputBuffer (NULL);
+  const xmlChar *content;
+  size_t len;
+
+  xmlNodeDumpOutput (tag, node->doc, copy, level, 1, "UTF-8");
+  content = xmlOutputBufferGetContent (tag);
+  len = xmlOutputBufferGetSize (tag);
+
+  if (len > 2 && strncmp ((const char *) content + len - 2, "/>", 2) == 0) {
+    _write_indent (out, level);
+    xmlOutputBufferWrite (out, len - 2, (const char *) content);
+    xmlOutputBufferWrite (out, 2, ">\n");
+  } else {
+    g_warning ("%s: unexpected start tag for <%s>", G_STRLOC, node->name);
+  }
+
+  xmlOutputBufferClose (tag);
+  xmlFreeNode (copy);
+}
+
+
+static void
+_write_end_tag (xmlOutputBufferPtr out, xmlNodePtr node, int level)
+{
+  _write_indent (out, level);
+  xmlOutputBufferWrite (out, 2, "</");
+  if (node->ns && node->ns->prefix) {
+    xmlOutputBufferWriteString (out, (const char *) node->ns->prefix);
+    xmlOutputBufferWrite (out, 1, ":");
+  }
+  xmlOutputBufferWriteString (out, (const char *) node->name);
+  xmlOutputBufferWrite (out, 1, ">");
+}
+
+
+/**
+ * dia_svg_renderer_begin_stream:
+ * @self: the #DiaSvgRenderer
+ * @error: return location for a #GError
+ *
+ * Write groups out as soon as they are complete instead of keeping the
+ * whole document until end_render.  Needs @self->doc with its root element
+ * and only makes a difference if the subclass calls
+ * dia_svg_renderer_flush() and dia_svg_renderer_close_group() while
+ * rendering.  The file written is the same.
+ *
+ * Returns: %FALSE if there is no place to spool to, the renderer then
+ *          keeps working on the tree in memory
+ *
+ * Since: 0.98
+ */
+gboolean
+dia_svg_renderer_begin_stream (DiaSvgRenderer *self, GError **error)
+{
+  DiaSvgStream *stream;
+
+  g_return_val_if_fail (DIA_IS_SVG_RENDERER (self), FALSE);
+  g_return_val_if_fail (self->doc && xmlDocGetRootElement (self->doc), FALSE);
+  g_return_val_if_fail (self->stream == NULL, FALSE);
+
+  stream = g_new0 (DiaSvgStream, 1);
+  g_queue_init (&stream->open);
+
+  stream->spool = g_file_new_tmp ("dia-svg-XXXXXX", &stream->spool_stream, error);
+  if (!stream->spool) {
+    _stream_free (stream);
+
+    return FALSE;
+  }
+
+  stream->sink.stream = g_io_stream_get_output_stream (G_IO_STREAM (stream->spool_stream));
+  stream->body = xmlOutputBufferCreateIO (_sink_write, _sink_close, &stream->sink, NULL);
+
+  self->stream = stream;
+
+  return TRUE;
+}
+
+
+/**
+ * dia_svg_renderer_flush:
+ * @self: the #DiaSvgRenderer
+ * @parent: the root element or a group
+ *
+ * Write all children of @parent and free them.  @parent is either the root
+ * element, the group last written by this function or a new group going
+ * into that, in which case its start tag is written first.  Only call it
+ * with complete children, nothing can be added to them later.
+ *
+ * Does nothing if dia_svg_renderer_begin_stream() wasn't called.
+ *
+ * Since: 0.98
+ */
+void
+dia_svg_renderer_flush (DiaSvgRenderer *self, xmlNodePtr parent)
+{
+  DiaSvgStream *stream = self->stream;
+  xmlNodePtr child;
+  int level;
+
+  if (!stream || !parent->children) {
+    return;
+  }
+
+  if (g_queue_peek_tail (&stream->open) != parent &&
+      parent != xmlDocGetRootElement (self->doc)) {
+    _write_start_tag (stream->body, parent, g_queue_get_length (&stream->open) + 1);
+    g_queue_push_tail (&stream->open, parent);
+  }
+
+  level = g_queue_get_length (&stream->open) + 1;
+  while ((child = parent->children) != NULL) {
+    _write_child (stream->body, child, level);
+    xmlUnlinkNode (child);
+    xmlFreeNode (child);
+  }
+
+  stream->written = TRUE;
+}
+
+
+/**
+ * dia_svg_renderer_close_group:
+ * @self: the #DiaSvgRenderer
+ * @group: the complete group
+ * @parent: where @group belongs
+ *
+ * If @group was already started by dia_svg_renderer_flush() finish and free
+ * it, otherwise add it to @parent like xmlAddChild() does
+ *
+ * Since: 0.98
+ */
+void
+dia_svg_renderer_close_group (DiaSvgRenderer *self,
+                              xmlNodePtr      group,
+                              xmlNodePtr      parent)
+{
+  DiaSvgStream *stream = self->stream;
+
+  if (!stream || g_queue_peek_tail (&stream->open) != group) {
+    xmlAddChild (parent, group);
+
+    return;
+  }
+
+  dia_svg_renderer_flush (self, group);
+  g_queue_pop_tail (&stream->open);
+
+  _write_end_tag (stream->body, group, g_queue_get_length (&stream->open) + 1);
+  xmlOutputBufferWrite (stream->body, 1, "\n");
+
+  xmlFreeNode (group);
+}
+
+
+/* The xmlSaveDoc() part of dia_io_save_document(), with @head and the
+ * spool in place of the root element's children */
+static gboolean
+_stream_save (DiaSvgRenderer *renderer,
+              xmlNodePtr     *head,
+              int             n_head,
+              DiaContext     *ctx)
+{
+  DiaSvgStream *stream = renderer->stream;
+  xmlDocPtr doc = renderer->doc;
+  xmlNodePtr root = xmlDocGetRootElement (doc);
+  GFile *file = g_file_new_for_path (renderer->filename);
+  GFileOutputStream *file_stream = NULL;
+  /* cancelled on errors, so the old file stays */
+  GCancellable *cancellable = g_cancellable_new ();
+  StreamSink sink = { NULL, NULL };
+  xmlOutputBufferPtr out = NULL;
+  GError *error = NULL;
+  gboolean result = FALSE;
+
+  /* whatever was drawn outside of any group */
+  dia_svg_renderer_flush (renderer, root);
+  g_warn_if_fail (g_queue_is_empty (&stream->open));
+
+  if (xmlOutputBufferFlush (stream->body) < 0 || stream->sink.error) {
+    dia_context_add_message (ctx,
+                             _("Unable to write: %s"),
+                             stream->sink.error ? stream->sink.error->message : "");
+    goto out;
+  }
+
+  file_stream = g_file_replace (file,
+                                NULL,
+                                TRUE,
+                                G_FILE_CREATE_PRIVATE,
+                                cancellable,
+                                &error);
+  if (!file_stream) {
+    dia_context_add_message (ctx, _("Unable to open: %s"), error->message);
+    goto out;
+  }
+
+  sink.stream = G_OUTPUT_STREAM (file_stream);
+  out = xmlOutputBufferCreateIO (_sink_write, _sink_close, &sink, NULL);
+
+  xmlOutputBufferWriteString (out, "<?xml version=\"");
+  xmlOutputBufferWriteString (out, doc->version ? (const char *) doc->version : "1.0");
+  xmlOutputBufferWriteString (out, "\" encoding=\"UTF-8\"");
+  if (doc->standalone == 0) {
+    xmlOutputBufferWriteString (out, " standalone=\"no\"");
+  } else if (doc->standalone == 1) {
+    xmlOutputBufferWriteString (out, " standalone=\"yes\"");
+  }
+  xmlOutputBufferWriteString (out, "?>\n");
+
+  for (xmlNodePtr node = doc->children; node; node = node->next) {
+    if (node != root) {
+      xmlNodeDumpOutput (out, doc, node, 0, 1, "UTF-8");
+    } else if (n_head == 0 && !stream->written) {
+      /* nothing drawn, <svg .../> */
+      xmlNodeDumpOutput (out, doc, root, 0, 1, "UTF-8");
+    } else {
+      GInputStream *spool = g_io_stream_get_input_stream (G_IO_STREAM (stream->spool_stream));
+
+      _write_start_tag (out, root, 0);
+      for (int i = 0; i < n_head; i++) {
+        _write_child (out, head[i], 1);
+      }
+
+      if (xmlOutputBufferFlush (out) < 0 ||
+          !g_seekable_seek (G_SEEKABLE (stream->spool_stream), 0, G_SEEK_SET, NULL, &error) ||
+          g_output_stream_splice (sink.stream, spool, G_OUTPUT_STREAM_SPLICE_NONE, NULL, &error) < 0) {
+        break;
+      }
+
+      _write_end_tag (out, root, 0);
+    }
+    xmlOutputBufferWrite (out, 1, "\n");
+  }
+
+  if (xmlOutputBufferFlush (out) < 0 || sink.error || error) {
+    dia_context_add_message (ctx,
+                             _("Unable to write: %s"),
+                             sink.error ? sink.error->message : error ? error->message : "");
+    goto out;
+  }
+
+  if (!g_output_stream_close (sink.stream, cancellable, &error)) {
+    dia_context_add_message (ctx, _("Unable to close: %s"), error->message);
+    goto out;
+  }
+
+  result = TRUE;
+
+out:
+  g_clear_pointer (&out, xmlOutputBufferClose);
+  if (file_stream && !g_output_stream_is_closed (G_OUTPUT_STREAM (file_stream))) {
+    /* don't replace the file with what we have so far */
+    g_cancellable_cancel (cancellable);
+    g_output_stream_close (G_OUTPUT_STREAM (file_stream), cancellable, NULL);
+  }
+  g_clear_error (&sink.error);
+  g_clear_error (&error);
+  g_clear_object (&file_stream);
+  g_clear_object (&cancellable);
+  g_clear_object (&file);
+  g_clear_pointer (&renderer->stream, _stream_free);
+
+  return result;
+}
+
+
+/*
+ * Style classes
+ *
+ * Most diagrams only use a handful of different styles, so instead of
+ * repeating them inline on every element each one goes once into a
+ * <style> block and the elements refer to it by class.  The style of a
+ * primitive only depends on the colours and the line settings, with those
+ * as the key it isn't even formatted again.
+ */
+
+typedef struct _StyleKey StyleKey;
+struct _StyleKey {
+  gboolean    has_fill;
+  gboolean    has_stroke;
+  Color       fill;
+  Color       stroke;
+  /* the rest only matters with a stroke */
+  double      linewidth;
+  const char *linecap;
+  const char *linejoin;
+  char       *linestyle;
+};
+
+struct _DiaSvgStyleClasses {
+  /* StyleKey -> class name */
+  GHashTable *keys;
+  /* style string -> class name */
+  GHashTable *classes;
+  /* style strings in order of the class number */
+  GPtrArray  *styles;
+};
+
+
+static guint
+_colour_hash (const Color *colour)
+{
+  guint hash = g_double_hash (&(double) { colour->red });
+
+  hash = hash * 31 + g_double_hash (&(double) { colour->green });
+  hash = hash * 31 + g_double_hash (&(double) { colour->blue });
+  hash = hash * 31 + g_double_hash (&(double) { colour->alpha });
+
+  return hash;
+}
+
+
+static guint
+_style_key_hash (gconstpointer p)
+{
+  const StyleKey *key = p;
+  guint hash = key->has_fill | key->has_stroke << 1;
+
+  if (key->has_fill) {
+    hash = hash * 31 + _colour_hash (&key->fill);
+  }
+  if (key->has_stroke) {
+    hash = hash * 31 + _colour_hash (&key->stroke);
+    hash = hash * 31 + g_double_hash (&key->linewidth);
+    hash = hash * 31 + g_str_hash (key->linecap);
+    hash = hash * 31 + g_str_hash (key->linejoin);
+    if (key->linestyle) {
+      hash = hash * 31 + g_str_hash (key->linestyle);
+    }
+  }
+
+  return hash;
+}
+
+
+static gboolean
+_colour_equal (const Color *a, const Color *b)
+{
+  return a->red == b->red && a->green == b->green &&
+         a->blue == b->blue && a->alpha == b->alpha;
+}
+
+
+static gboolean
+_style_key_equal (gconstpointer pa, gconstpointer pb)
+{
+  const StyleKey *a = pa;
+  const StyleKey *b = pb;
+
+  if (a->has_fill != b->has_fill || a->has_stroke != b->has_stroke) {
+    return FALSE;
+  }
+  if (a->has_fill && !_colour_equal (&a->fill, &b->fill)) {
+    return FALSE;
+  }
+  if (a->has_stroke) {
+    return _colour_equal (&a->stroke, &b->stroke) &&
+           a->linewidth == b->linewidth &&
+           g_str_equal (a->linecap, b->linecap) &&
+           g_str_equal (a->linejoin, b->linejoin) &&
+           g_strcmp0 (a->linestyle, b->linestyle) == 0;
+  }
+
+  return TRUE;
+}
+
+
+static void
+_style_key_free (gpointer p)
+{
+  StyleKey *key = p;
+
+  g_clear_pointer (&key->linestyle, g_free);
+  g_free (key);
+}
+
+
+static void
+_style_classes_free (DiaSvgStyleClasses *style_classes)
+{
+  g_clear_pointer (&style_classes->keys, g_hash_table_destroy);
+  g_clear_pointer (&style_classes->classes, g_hash_table_destroy);
+  g_clear_pointer (&style_classes->styles, g_ptr_array_unref);
+
+  g_free (style_classes);
+}
+
+
+/* The class for @style, a new one if it wasn't seen before */
+static const char *
+_style_class (DiaSvgStyleClasses *style_classes, const char *style)
+{
+  const char *klass = g_hash_table_lookup (style_classes->classes, style);
+
+  if (!klass) {
+    char *copy = g_strdup (style);
+    char *name = g_strdup_printf ("s%u", style_classes->styles->len);
+
+    g_ptr_array_add (style_classes->styles, copy);
+    g_hash_table_insert (style_classes->classes, copy, name);
+    klass = name;
+  }
+
+  return klass;
+}
+
+
+/* <style> with all classes used, or %NULL */
+static xmlNodePtr
+_style_classes_node (DiaSvgRenderer *renderer)
+{
+  DiaSvgStyleClasses *style_classes = renderer->style_classes;
+  xmlNodePtr node;
+  GString *css;
+
+  if (!style_classes || style_classes->styles->len == 0) {
+    return NULL;
+  }
+
+  css = g_string_new ("\n");
+  for (guint i = 0; i < style_classes->styles->len; i++) {
+    const char *style = g_ptr_array_index (style_classes->styles, i);
+
+    g_string_append_printf (css,
+                            ".%s { %s }\n",
+                            (const char *) g_hash_table_lookup (style_classes->classes, style),
+                            style);
+  }
+
+  node = xmlNewNode (renderer->svg_name_space, (const xmlChar *) "style");
+  xmlSetProp (node, (const xmlChar *) "type", (const xmlChar *) "text/css");
+  xmlNodeAddContentLen (node, (const xmlChar *) css->str, css->len);
+
+  g_string_free (css, TRUE);
+
+  return node;
+}
+
+
+/**
+ * dia_svg_renderer_use_style_classes:
+ * @self: the #DiaSvgRenderer
+ *
+ * From now on put each distinct style once into a <style> block and only
+ * refer to it from the elements, see dia_svg_renderer_set_style()
+ *
+ * Since: 0.98
+ */
+void
+dia_svg_renderer_use_style_classes (DiaSvgRenderer *self)
+{
+  g_return_if_fail (DIA_IS_SVG_RENDERER (self));
+
+  if (self->style_classes) {
+    return;
+  }
+
+  self->style_classes = g_new0 (DiaSvgStyleClasses, 1);
+  self->style_classes->keys = g_hash_table_new_full (_style_key_hash,
+                                                     _style_key_equal,
+                                                     _style_key_free,
+                                                     NULL);
+  self->style_classes->classes = g_hash_table_new_full (g_str_hash,
+                                                        g_str_equal,
+                                                        NULL,
+                                                        g_free);
+  self->style_classes->styles = g_ptr_array_new_with_free_func (g_free);
+}
+
+
+/**
+ * dia_svg_renderer_set_style:
+ * @self: the #DiaSvgRenderer
+ * @node: the element to style
+ * @style: CSS declarations
+ *
+ * Set the style attribute of @node, or with
+ * dia_svg_renderer_use_style_classes() its class
+ *
+ * Since: 0.98
+ */
+void
+dia_svg_renderer_set_style (DiaSvgRenderer *self,
+                            xmlNodePtr      node,
+                            const char     *style)
+{
+  /* braces would end the rule early */
+  if (!self->style_classes || strpbrk (style, "{}")) {
+    xmlSetProp (node, (const xmlChar *) "style", (const xmlChar *) style);
+
+    return;
+  }
+
+  xmlSetProp (node,
+              (const xmlChar *) "class",
+              (const xmlChar *) _style_class (self->style_classes, style));
+}
+
+
+/**
+ * dia_svg_renderer_set_draw_style:
+ * @self: the #DiaSvgRenderer
+ * @node: the element to style
+ * @fill: (nullable): the fill colour
+ * @stroke: (nullable): the line colour
+ *
+ * Style @node with the current line settings, pattern and the given
+ * colours, see #DiaSvgRendererClass.get_draw_style
+ *
+ * Since: 0.98
+ */
+void
+dia_svg_renderer_set_draw_style (DiaSvgRenderer *self,
+                                 xmlNodePtr      node,
+                                 Color          *fill,
+                                 Color          *stroke)
+{
+  DiaSvgRendererClass *klass = DIA_SVG_RENDERER_GET_CLASS (self);
+  StyleKey key = { 0, };
+  const char *class_name;
+
+  /* The SVG import only finds patterns in the style attribute */
+  if (!self->style_classes || (fill && self->active_pattern)) {
+    xmlSetProp (node,
+                (const xmlChar *) "style",
+                (const xmlChar *) klass->get_draw_style (self, fill, stroke));
+
+    return;
+  }
+
+  key.has_fill = fill != NULL;
+  key.has_stroke = stroke != NULL;
+  if (fill) {
+    key.fill = *fill;
+  }
+  if (stroke) {
+    key.stroke = *stroke;
+    key.linewidth = self->linewidth;
+    key.linecap = self->linecap;
+    key.linejoin = self->linejoin;
+    key.linestyle = self->linestyle;
+  }
+
+  class_name = g_hash_table_lookup (self->style_classes->keys, &key);
+  if (!class_name) {
+    StyleKey *copy = g_new (StyleKey, 1);
+
+    class_name = _style_class (self->style_classes,
+                               klass->get_draw_style (self, fill, stroke));
+
+    *copy = key;
+    copy->linestyle = g_strdup (key.linestyle);
+    g_hash_table_insert (self->style_classes->keys, copy, (gpointer) class_name);
+  }
+
+  xmlSetProp (node, (const xmlChar *) "class", (const xmlChar *) class_name);
+}
+
+
+/**
+ * dia_svg_renderer_add_def:
+ * @self: the #DiaSvgRenderer
+ * @node: (transfer full): an unlinked element
+ *
+ * Put @node into the <defs> in front of the drawing, after the gradients
+ *
+ * Since: 0.98
+ */
+void
+dia_svg_renderer_add_def (DiaSvgRenderer *self, xmlNodePtr node)
+{
+  g_return_if_fail (DIA_IS_SVG_RENDERER (self));
+  g_return_if_fail (node != NULL && node->parent == NULL);
+
+  if (!self->defs) {
+    self->defs = g_ptr_array_new_with_free_func ((GDestroyNotify) xmlFreeNode);
+  }
+
+  g_ptr_array_add (self->defs, node);
+}
+
+
 static void
 end_render (DiaRenderer *self)
 {
   DiaSvgRenderer *renderer = DIA_SVG_RENDERER (self);
   DiaContext *ctx = dia_context_new (_("SVG Export"));
+  /* what goes in front of everything drawn */
+  xmlNodePtr head[2];
+  int n_head = 0;
 
   g_clear_pointer (&renderer->linestyle, g_free);
 
-  /* handle potential patterns */
-  if (renderer->patterns) {
-    xmlNodePtr root = xmlDocGetRootElement (renderer->doc);
+  if ((head[n_head] = _style_classes_node (renderer)) != NULL) {
+    n_head++;
+  }
+  g_clear_pointer (&renderer->style_classes, _style_classes_free);
+  /* the <symbol>s are in ->defs already */
+  g_clear_pointer (&renderer->image_defs, _image_defs_free);
+
+  /* handle potential patterns and whatever else was added */
+  if (renderer->patterns || renderer->defs) {
     xmlNodePtr defs = xmlNewNode (renderer->svg_name_space, (const xmlChar *) "defs");
     GradientData gd = { renderer, defs };
-    g_hash_table_foreach (renderer->patterns, _gradient_do, &gd);
-    xmlAddPrevSibling (root->children, defs);
-    g_hash_table_destroy (renderer->patterns);
-    renderer->patterns = NULL;
+
+    if (renderer->patterns) {
+      g_hash_table_foreach (renderer->patterns, _gradient_do, &gd);
+      g_hash_table_destroy (renderer->patterns);
+      renderer->patterns = NULL;
+    }
+    if (renderer->defs) {
+      for (guint i = 0; i < renderer->defs->len; i++) {
+        xmlAddChild (defs, g_ptr_array_index (renderer->defs, i));
+      }
+      /* the nodes belong to defs now */
+      g_ptr_array_set_free_func (renderer->defs, NULL);
+      g_clear_pointer (&renderer->defs, g_ptr_array_unref);
+    }
+    head[n_head++] = defs;
   }
 
   dia_context_set_filename (ctx, renderer->filename);
-  dia_io_save_document (renderer->filename, renderer->doc, FALSE, ctx);
+  if (renderer->stream) {
+    _stream_save (renderer, head, n_head, ctx);
+    for (int i = 0; i < n_head; i++) {
+      xmlFreeNode (head[i]);
+    }
+  } else {
+    xmlNodePtr root = xmlDocGetRootElement (renderer->doc);
+
+    for (int i = n_head - 1; i >= 0; i--) {
+      if (root->children) {
+        xmlAddPrevSibling (root->children, head[i]);
+      } else {
+        xmlAddChild (root, head[i]);
+      }
+    }
+    dia_io_save_document (renderer->filename, renderer->doc, FALSE, ctx);
+  }
 
   g_clear_pointer (&renderer->filename, g_free);
   g_clear_pointer (&renderer->doc, xmlFreeDoc);
@@ -407,7 +1133,8 @@ set_pattern(DiaRenderer *self, DiaPattern *pattern)
 /*!
  * \brief Get the draw style for given fill/stroke
  *
- * The return value of this function should not be saved anywhere
+ * The return value of this function should not be saved anywhere, the
+ * next call on the same renderer overwrites it
  *
  * \protected \memberof _DiaSvgRenderer
  */
@@ -416,12 +1143,13 @@ get_draw_style(DiaSvgRenderer *renderer,
 	       Color *fill,
 	       Color *stroke)
 {
-  static GString *str = NULL;
+  GString *str;
   gchar linewidth_buf[DTOSTR_BUF_SIZE];
   gchar alpha_buf[DTOSTR_BUF_SIZE];
 
-  if (!str)
-    str = g_string_new(NULL);
+  if (!renderer->draw_style)
+    renderer->draw_style = g_string_new(NULL);
+  str = renderer->draw_style;
   g_string_truncate(str, 0);
 
   /* we only append a semicolon with the second attribute */
@@ -476,15 +1204,15 @@ draw_line(DiaRenderer *self,
 
   node = xmlNewChild(renderer->root, renderer->svg_name_space, (const xmlChar *)"line", NULL);
 
-  xmlSetProp(node, (const xmlChar *)"style", (xmlChar *) get_draw_style(renderer, NULL, line_colour));
+  dia_svg_renderer_set_draw_style (renderer, node, NULL, line_colour);
 
-  dia_svg_dtostr(d_buf, start->x);
+  dia_svg_xtostr(d_buf, start->x);
   xmlSetProp(node, (const xmlChar *)"x1", (xmlChar *) d_buf);
-  dia_svg_dtostr(d_buf, start->y);
+  dia_svg_ytostr(d_buf, start->y);
   xmlSetProp(node, (const xmlChar *)"y1", (xmlChar *) d_buf);
-  dia_svg_dtostr(d_buf, end->x);
+  dia_svg_xtostr(d_buf, end->x);
   xmlSetProp(node, (const xmlChar *)"x2", (xmlChar *) d_buf);
-  dia_svg_dtostr(d_buf, end->y);
+  dia_svg_ytostr(d_buf, end->y);
   xmlSetProp(node, (const xmlChar *)"y2", (xmlChar *) d_buf);
 }
 
@@ -506,13 +1234,13 @@ draw_polyline(DiaRenderer *self,
 
   node = xmlNewChild(renderer->root, renderer->svg_name_space, (const xmlChar *)"polyline", NULL);
 
-  xmlSetProp(node, (const xmlChar *)"style", (xmlChar *) get_draw_style(renderer, NULL, line_colour));
+  dia_svg_renderer_set_draw_style (renderer, node, NULL, line_colour);
 
   str = g_string_new(NULL);
   for (i = 0; i < num_points; i++)
     g_string_append_printf(str, "%s,%s ",
-		      dia_svg_dtostr(px_buf, points[i].x),
-		      dia_svg_dtostr(py_buf, points[i].y) );
+		      dia_svg_xtostr(px_buf, points[i].x),
+		      dia_svg_ytostr(py_buf, points[i].y) );
   xmlSetProp(node, (const xmlChar *)"points", (xmlChar *) str->str);
   g_string_free(str, TRUE);
 }
@@ -535,7 +1263,7 @@ draw_polygon (DiaRenderer *self,
 
   node = xmlNewChild(renderer->root, renderer->svg_name_space, (const xmlChar *)"polygon", NULL);
 
-  xmlSetProp(node, (const xmlChar *)"style", (xmlChar *) get_draw_style (renderer, fill, stroke));
+  dia_svg_renderer_set_draw_style (renderer, node, fill, stroke);
 
   if (fill)
     xmlSetProp(node, (const xmlChar *)"fill-rule", (const xmlChar *) "evenodd");
@@ -543,8 +1271,8 @@ draw_polygon (DiaRenderer *self,
   str = g_string_new(NULL);
   for (i = 0; i < num_points; i++)
     g_string_append_printf(str, "%s,%s ",
-		      dia_svg_dtostr(px_buf, points[i].x),
-		      dia_svg_dtostr(py_buf, points[i].y) );
+		      dia_svg_xtostr(px_buf, points[i].x),
+		      dia_svg_ytostr(py_buf, points[i].y) );
   xmlSetProp(node, (const xmlChar *)"points", (xmlChar *) str->str);
   g_string_free(str, TRUE);
 }
@@ -564,11 +1292,11 @@ draw_rect(DiaRenderer *self,
 
   node = xmlNewChild(renderer->root, NULL, (const xmlChar *)"rect", NULL);
 
-  xmlSetProp(node, (const xmlChar *)"style", (xmlChar *) get_draw_style (renderer, fill, stroke));
+  dia_svg_renderer_set_draw_style (renderer, node, fill, stroke);
 
-  dia_svg_dtostr(d_buf, ul_corner->x);
+  dia_svg_xtostr(d_buf, ul_corner->x);
   xmlSetProp(node, (const xmlChar *)"x", (xmlChar *) d_buf);
-  dia_svg_dtostr(d_buf, ul_corner->y);
+  dia_svg_ytostr(d_buf, ul_corner->y);
   xmlSetProp(node, (const xmlChar *)"y", (xmlChar *) d_buf);
   dia_svg_dtostr(d_buf, lr_corner->x - ul_corner->x);
   xmlSetProp(node, (const xmlChar *)"width", (xmlChar *) d_buf);
@@ -608,13 +1336,13 @@ draw_arc(DiaRenderer *self,
 
   node = xmlNewChild(renderer->root, renderer->svg_name_space, (const xmlChar *)"path", NULL);
 
-  xmlSetProp(node, (const xmlChar *)"style", (xmlChar *) get_draw_style(renderer, NULL, colour));
+  dia_svg_renderer_set_draw_style (renderer, node, NULL, colour);
 
   g_snprintf(buf, sizeof(buf), "M %s,%s A %s,%s 0 %d %d %s,%s",
-	     dia_svg_dtostr(sx_buf, sx), dia_svg_dtostr(sy_buf, sy),
+	     dia_svg_xtostr(sx_buf, sx), dia_svg_ytostr(sy_buf, sy),
 	     dia_svg_dtostr(rx_buf, rx), dia_svg_dtostr(ry_buf, ry),
 	     large_arc, swp,
-	     dia_svg_dtostr(ex_buf, ex), dia_svg_dtostr(ey_buf, ey) );
+	     dia_svg_xtostr(ex_buf, ex), dia_svg_ytostr(ey_buf, ey) );
 
   xmlSetProp(node, (const xmlChar *)"d", (xmlChar *) buf);
 }
@@ -651,15 +1379,15 @@ fill_arc(DiaRenderer *self,
 
   node = xmlNewChild(renderer->root, NULL, (const xmlChar *)"path", NULL);
 
-  xmlSetProp(node, (const xmlChar *)"style", (xmlChar *)get_draw_style(renderer, colour, NULL));
+  dia_svg_renderer_set_draw_style (renderer, node, colour, NULL);
 
   g_snprintf(buf, sizeof(buf), "M %s,%s A %s,%s 0 %d %d %s,%s L %s,%s z",
-	     dia_svg_dtostr(sx_buf, sx), dia_svg_dtostr(sy_buf, sy),
+	     dia_svg_xtostr(sx_buf, sx), dia_svg_ytostr(sy_buf, sy),
 	     dia_svg_dtostr(rx_buf, rx), dia_svg_dtostr(ry_buf, ry),
 	     large_arc, swp,
-	     dia_svg_dtostr(ex_buf, ex), dia_svg_dtostr(ey_buf, ey),
-	     dia_svg_dtostr(cx_buf, center->x),
-	     dia_svg_dtostr(cy_buf, center->y) );
+	     dia_svg_xtostr(ex_buf, ex), dia_svg_ytostr(ey_buf, ey),
+	     dia_svg_xtostr(cx_buf, center->x),
+	     dia_svg_ytostr(cy_buf, center->y) );
 
   xmlSetProp(node, (const xmlChar *)"d", (xmlChar *) buf);
 }
@@ -680,11 +1408,11 @@ draw_ellipse(DiaRenderer *self,
 
   node = xmlNewChild(renderer->root, renderer->svg_name_space, (const xmlChar *)"ellipse", NULL);
 
-  xmlSetProp(node, (const xmlChar *)"style", (xmlChar *) get_draw_style (renderer, fill, stroke));
+  dia_svg_renderer_set_draw_style (renderer, node, fill, stroke);
 
-  dia_svg_dtostr(d_buf, center->x);
+  dia_svg_xtostr(d_buf, center->x);
   xmlSetProp(node, (const xmlChar *)"cx", (xmlChar *) d_buf);
-  dia_svg_dtostr(d_buf, center->y);
+  dia_svg_ytostr(d_buf, center->y);
   xmlSetProp(node, (const xmlChar *)"cy", (xmlChar *) d_buf);
   dia_svg_dtostr(d_buf, width / 2);
   xmlSetProp(node, (const xmlChar *)"rx", (xmlChar *) d_buf);
@@ -714,7 +1442,7 @@ _bezier(DiaRenderer *self,
   node = xmlNewChild(renderer->root, renderer->svg_name_space, (const xmlChar *)"path", NULL);
 
   if (fill || stroke)
-    xmlSetProp(node, (const xmlChar *)"style", (xmlChar *)get_draw_style(renderer, fill, stroke));
+    dia_svg_renderer_set_draw_style (renderer, node, fill, stroke);
 
   str = g_string_new(NULL);
 
@@ -722,8 +1450,8 @@ _bezier(DiaRenderer *self,
     g_warning("first BezPoint must be a BEZ_MOVE_TO");
 
   g_string_printf(str, "M %s %s",
-		   dia_svg_dtostr(p1x_buf, (gdouble) points[0].p1.x),
-		   dia_svg_dtostr(p1y_buf, (gdouble) points[0].p1.y) );
+		   dia_svg_xtostr(p1x_buf, (gdouble) points[0].p1.x),
+		   dia_svg_ytostr(p1y_buf, (gdouble) points[0].p1.y) );
 
   for (i = 1; i < numpoints; i++) {
     switch (points[i].type) {
@@ -731,27 +1459,27 @@ _bezier(DiaRenderer *self,
         if (!dia_renderer_is_capable_of (self, RENDER_HOLES)) {
           g_warning("only first BezPoint should be a BEZ_MOVE_TO");
           g_string_printf (str, "M %s %s",
-                          dia_svg_dtostr (p1x_buf, (gdouble) points[i].p1.x),
-                          dia_svg_dtostr (p1y_buf, (gdouble) points[i].p1.y) );
+                          dia_svg_xtostr (p1x_buf, (gdouble) points[i].p1.x),
+                          dia_svg_ytostr (p1y_buf, (gdouble) points[i].p1.y) );
         } else {
           g_string_append_printf(str, "M %s %s",
-              dia_svg_dtostr(p1x_buf, (gdouble) points[i].p1.x),
-              dia_svg_dtostr(p1y_buf, (gdouble) points[i].p1.y) );
+              dia_svg_xtostr(p1x_buf, (gdouble) points[i].p1.x),
+              dia_svg_ytostr(p1y_buf, (gdouble) points[i].p1.y) );
         }
         break;
       case BEZ_LINE_TO:
         g_string_append_printf(str, " L %s,%s",
-        dia_svg_dtostr(p1x_buf, (gdouble) points[i].p1.x),
-        dia_svg_dtostr(p1y_buf, (gdouble) points[i].p1.y) );
+        dia_svg_xtostr(p1x_buf, (gdouble) points[i].p1.x),
+        dia_svg_ytostr(p1y_buf, (gdouble) points[i].p1.y) );
         break;
       case BEZ_CURVE_TO:
         g_string_append_printf(str, " C %s,%s %s,%s %s,%s",
-        dia_svg_dtostr(p1x_buf, (gdouble) points[i].p1.x),
-        dia_svg_dtostr(p1y_buf, (gdouble) points[i].p1.y),
-        dia_svg_dtostr(p2x_buf, (gdouble) points[i].p2.x),
-        dia_svg_dtostr(p2y_buf, (gdouble) points[i].p2.y),
-        dia_svg_dtostr(p3x_buf, (gdouble) points[i].p3.x),
-        dia_svg_dtostr(p3y_buf, (gdouble) points[i].p3.y) );
+        dia_svg_xtostr(p1x_buf, (gdouble) points[i].p1.x),
+        dia_svg_ytostr(p1y_buf, (gdouble) points[i].p1.y),
+        dia_svg_xtostr(p2x_buf, (gdouble) points[i].p2.x),
+        dia_svg_ytostr(p2y_buf, (gdouble) points[i].p2.y),
+        dia_svg_xtostr(p3x_buf, (gdouble) points[i].p3.x),
+        dia_svg_ytostr(p3y_buf, (gdouble) points[i].p3.y) );
         break;
       default:
         g_return_if_reached ();
@@ -874,12 +1602,12 @@ draw_text_line (DiaRenderer  *self,
 			  dia_font_get_slant_string(font),
 			  dia_font_get_weight_string(font));
 
-  xmlSetProp(node, (const xmlChar *)"style", (xmlChar *) style->str);
+  dia_svg_renderer_set_style (renderer, node, style->str);
   g_string_free (style, TRUE);
 
-  dia_svg_dtostr(d_buf, pos->x);
+  dia_svg_xtostr(d_buf, pos->x);
   xmlSetProp(node, (const xmlChar *)"x", (xmlChar *) d_buf);
-  dia_svg_dtostr(d_buf, pos->y);
+  dia_svg_ytostr(d_buf, pos->y);
   xmlSetProp(node, (const xmlChar *)"y", (xmlChar *) d_buf);
 
   /* font-size as single attribute can work like the other length w/o unit */
@@ -890,6 +1618,179 @@ draw_text_line (DiaRenderer  *self,
   xmlSetProp(node, (const xmlChar*)"textLength", (xmlChar *) d_buf);
 }
 
+/*
+ * Embedded images
+ *
+ * Images without a file are written as data: URIs, which for a logo used
+ * all over the diagram means the same base64 over and over.  Instead each
+ * distinct image goes once into a <symbol> in <defs>, stretched to the
+ * size of the <use> referring to it.
+ */
+
+struct _DiaSvgImageDefs {
+  /* DiaImage (ref) -> id */
+  GHashTable *by_image;
+  /* digest of the pixels -> id */
+  GHashTable *by_digest;
+};
+
+
+static void
+_image_defs_free (DiaSvgImageDefs *image_defs)
+{
+  g_clear_pointer (&image_defs->by_image, g_hash_table_destroy);
+  g_clear_pointer (&image_defs->by_digest, g_hash_table_destroy);
+
+  g_free (image_defs);
+}
+
+
+/* Hashes what gets written, the pixels may not even be decoded yet */
+static char *
+_image_digest (GBytes *encoded, const char *mime_type)
+{
+  GChecksum *checksum = g_checksum_new (G_CHECKSUM_SHA1);
+  gsize len;
+  const guchar *data = g_bytes_get_data (encoded, &len);
+  char *digest;
+
+  g_checksum_update (checksum, (const guchar *) mime_type, strlen (mime_type));
+  g_checksum_update (checksum, data, len);
+  digest = g_strdup (g_checksum_get_string (checksum));
+
+  g_checksum_free (checksum);
+
+  return digest;
+}
+
+
+static char *
+_encoded_data_uri (GBytes *encoded, const char *mime_type)
+{
+  gsize len;
+  const guchar *data = g_bytes_get_data (encoded, &len);
+  char *b64 = g_base64_encode (data, len);
+  char *uri = g_strdup_printf ("data:%s;base64,%s", mime_type, b64);
+
+  g_clear_pointer (&b64, g_free);
+
+  return uri;
+}
+
+
+/* As a data: URI, without encoding it again if that was done before */
+static char *
+_image_data_uri (DiaImage *image)
+{
+  const char *mime_type = NULL;
+  GBytes *encoded = dia_image_get_encoded (image, &mime_type);
+  char *uri;
+
+  if (!encoded) {
+    return NULL;
+  }
+
+  uri = _encoded_data_uri (encoded, mime_type);
+
+  g_clear_pointer (&encoded, g_bytes_unref);
+
+  return uri;
+}
+
+
+/* The id of the <symbol> for @image, %NULL if it can't be encoded */
+static const char *
+_image_def (DiaSvgRenderer *renderer, DiaImage *image)
+{
+  DiaSvgImageDefs *image_defs = renderer->image_defs;
+  const char *id = g_hash_table_lookup (image_defs->by_image, image);
+  const char *mime_type = NULL;
+  GBytes *encoded;
+  char *digest;
+
+  if (id) {
+    return id;
+  }
+
+  encoded = dia_image_get_encoded (image, &mime_type);
+  if (!encoded) {
+    return NULL;
+  }
+
+  digest = _image_digest (encoded, mime_type);
+  id = g_hash_table_lookup (image_defs->by_digest, digest);
+
+  if (!id) {
+    int width = dia_image_width (image);
+    int height = dia_image_height (image);
+    char *uri = _encoded_data_uri (encoded, mime_type);
+    char *new_id, *buf;
+    xmlNodePtr symbol, node;
+
+    new_id = g_strdup_printf ("dia-image-%u", g_hash_table_size (image_defs->by_digest));
+
+    symbol = xmlNewNode (renderer->svg_name_space, (const xmlChar *) "symbol");
+    xmlSetProp (symbol, (const xmlChar *) "id", (xmlChar *) new_id);
+    buf = g_strdup_printf ("0 0 %d %d", width, height);
+    xmlSetProp (symbol, (const xmlChar *) "viewBox", (xmlChar *) buf);
+    g_clear_pointer (&buf, g_free);
+    xmlSetProp (symbol, (const xmlChar *) "preserveAspectRatio", (const xmlChar *) "none");
+
+    node = xmlNewChild (symbol, renderer->svg_name_space, (const xmlChar *) "image", NULL);
+    buf = g_strdup_printf ("%d", width);
+    xmlSetProp (node, (const xmlChar *) "width", (xmlChar *) buf);
+    g_clear_pointer (&buf, g_free);
+    buf = g_strdup_printf ("%d", height);
+    xmlSetProp (node, (const xmlChar *) "height", (xmlChar *) buf);
+    g_clear_pointer (&buf, g_free);
+    xmlSetProp (node, (const xmlChar *) "xlink:href", (xmlChar *) uri);
+    g_clear_pointer (&uri, g_free);
+
+    dia_svg_renderer_add_def (renderer, symbol);
+
+    g_hash_table_insert (image_defs->by_digest, digest, new_id);
+    id = new_id;
+  } else {
+    g_clear_pointer (&digest, g_free);
+  }
+
+  g_clear_pointer (&encoded, g_bytes_unref);
+  g_hash_table_insert (image_defs->by_image, g_object_ref (image), g_strdup (id));
+
+  return id;
+}
+
+
+/**
+ * dia_svg_renderer_use_image_defs:
+ * @self: the #DiaSvgRenderer
+ *
+ * From now on put each distinct image without a file once into the
+ * <defs> and refer to it from every place it's drawn
+ *
+ * Since: 0.98
+ */
+void
+dia_svg_renderer_use_image_defs (DiaSvgRenderer *self)
+{
+  g_return_if_fail (DIA_IS_SVG_RENDERER (self));
+
+  if (self->image_defs) {
+    return;
+  }
+
+  self->image_defs = g_new0 (DiaSvgImageDefs, 1);
+  self->image_defs->by_image = g_hash_table_new_full (g_direct_hash,
+                                                      g_direct_equal,
+                                                      g_object_unref,
+                                                      g_free);
+  self->image_defs->by_digest = g_hash_table_new_full (g_str_hash,
+                                                       g_str_equal,
+                                                       g_free,
+                                                       g_free);
+}
+
+
 /*!
  * \brief Draw an image element
  * \memberof _DiaSvgRenderer
@@ -904,28 +1805,34 @@ draw_image(DiaRenderer *self,
   xmlNodePtr node;
   gchar d_buf[DTOSTR_BUF_SIZE];
   gchar *uri = NULL;
+  const char *id = NULL;
 
-  node = xmlNewChild(renderer->root, NULL, (const xmlChar *)"image", NULL);
+  /* inline data only once, see dia_svg_renderer_use_image_defs() */
+  if (renderer->image_defs && strcmp (dia_image_filename (image), "(null)") == 0)
+    id = _image_def (renderer, image);
 
-  dia_svg_dtostr(d_buf, point->x);
+  node = xmlNewChild(renderer->root, NULL, (const xmlChar *)(id ? "use" : "image"), NULL);
+
+  dia_svg_xtostr(d_buf, point->x);
   xmlSetProp(node, (const xmlChar *)"x", (xmlChar *) d_buf);
-  dia_svg_dtostr(d_buf, point->y);
+  dia_svg_ytostr(d_buf, point->y);
   xmlSetProp(node, (const xmlChar *)"y", (xmlChar *) d_buf);
   dia_svg_dtostr(d_buf, width);
   xmlSetProp(node, (const xmlChar *)"width", (xmlChar *) d_buf);
   dia_svg_dtostr(d_buf, height);
   xmlSetProp(node, (const xmlChar *)"height", (xmlChar *) d_buf);
 
-  /* if the image file location is relative to the SVG file's store
-   * a relative path - if it does not have a path: inline it */
-  if (strcmp (dia_image_filename(image), "(null)") == 0) {
-    gchar *prefix = g_strdup_printf ("data:%s;base64,", dia_image_get_mime_type (image));
-
-    uri = pixbuf_encode_base64 (dia_image_pixbuf (image), prefix);
+  /* refer to the <symbol> holding it, or if the image file location is
+   * relative to the SVG file's store a relative path - if it does not have
+   * a path: inline it */
+  if (id) {
+    uri = g_strconcat ("#", id, NULL);
+    xmlSetProp(node, (const xmlChar *)"xlink:href", (xmlChar *) uri);
+  } else if (strcmp (dia_image_filename(image), "(null)") == 0) {
+    uri = _image_data_uri (image);
     if (!uri)
       uri = g_strdup ("(null)");
     xmlSetProp(node, (const xmlChar *)"xlink:href", (xmlChar *) uri);
-    g_clear_pointer (&prefix, g_free);
   } else if ((uri = dia_relativize_filename (renderer->filename, dia_image_filename(image))) != NULL)
     xmlSetProp(node, (const xmlChar *)"xlink:href", (xmlChar *) uri);
   else if ((uri = g_filename_to_uri(dia_image_filename(image), NULL, NULL)) != NULL)
@@ -950,12 +1857,11 @@ draw_rounded_rect (DiaRenderer *self,
 
   node = xmlNewChild(renderer->root, NULL, (const xmlChar *)"rect", NULL);
 
-  xmlSetProp(node, (const xmlChar *)"style",
-	     (const xmlChar *)DIA_SVG_RENDERER_GET_CLASS(self)->get_draw_style (renderer, fill, stroke));
+  dia_svg_renderer_set_draw_style (renderer, node, fill, stroke);
 
-  g_ascii_formatd(buf, sizeof(buf), "%g", ul_corner->x * renderer->scale);
+  dia_svg_xtostr(buf, ul_corner->x);
   xmlSetProp(node, (const xmlChar *)"x", (xmlChar *) buf);
-  g_ascii_formatd(buf, sizeof(buf), "%g", ul_corner->y * renderer->scale);
+  dia_svg_ytostr(buf, ul_corner->y);
   xmlSetProp(node, (const xmlChar *)"y", (xmlChar *) buf);
   g_ascii_formatd(buf, sizeof(buf), "%g", (lr_corner->x - ul_corner->x) * renderer->scale);
   xmlSetProp(node, (const xmlChar *)"width", (xmlChar *) buf);
@@ -979,6 +1885,17 @@ static gpointer parent_class = NULL;
 static void
 dia_svg_renderer_finalize (GObject *object)
 {
+  DiaSvgRenderer *self = DIA_SVG_RENDERER (object);
+
+  g_clear_pointer (&self->stream, _stream_free);
+  g_clear_pointer (&self->style_classes, _style_classes_free);
+  g_clear_pointer (&self->defs, g_ptr_array_unref);
+  g_clear_pointer (&self->image_defs, _image_defs_free);
+  if (self->draw_style) {
+    g_string_free (self->draw_style, TRUE);
+    self->draw_style = NULL;
+  }
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -1,6 +1,8 @@
 #ifndef DIA_SVG_RENDERER_H
 #define DIA_SVG_RENDERER_H
 
+#include <libxml/tree.h>
+
 #include "diatypes.h"
 #include "diarenderer.h"
 
@@ -14,6 +16,10 @@ G_BEGIN_DECLS
 
 GType dia_svg_renderer_get_type (void) G_GNUC_CONST;
 
+typedef struct _DiaSvgStream DiaSvgStream;
+typedef struct _DiaSvgStyleClasses DiaSvgStyleClasses;
+typedef struct _DiaSvgImageDefs DiaSvgImageDefs;
+
 struct _DiaSvgRenderer
 {
   DiaRenderer parent_instance;
@@ -30,11 +36,24 @@ struct _DiaSvgRenderer
   const char *linejoin;
   char *linestyle; /* not const -- must free */
   real scale;  /*!< scale=1.0 for shape output, more for svg output,  */
+  /*! \protected subtracted from every position written, see draw_object() of the SVG export */
+  Point offset;
 
   /*! \private pattern set by set_pattern */
   DiaPattern *active_pattern;
   /*! \private all patterns seen between begin_render and end_render */
   GHashTable *patterns;
+  /*! \private more for <defs>, see dia_svg_renderer_add_def() */
+  GPtrArray *defs;
+
+  /*! \private elements already written, see dia_svg_renderer_begin_stream() */
+  DiaSvgStream *stream;
+  /*! \private distinct styles, see dia_svg_renderer_use_style_classes() */
+  DiaSvgStyleClasses *style_classes;
+  /*! \private images already in <defs>, see dia_svg_renderer_use_image_defs() */
+  DiaSvgImageDefs *image_defs;
+  /*! \private returned by get_draw_style(), per renderer to allow concurrent exports */
+  GString *draw_style;
 };
 
 struct _DiaSvgRendererClass
@@ -44,6 +63,25 @@ struct _DiaSvgRendererClass
   const gchar* (*get_draw_style) (DiaSvgRenderer*, Color* fill, Color *stroke);
 };
 
+gboolean dia_svg_renderer_begin_stream (DiaSvgRenderer  *self,
+                                        GError         **error);
+void     dia_svg_renderer_flush        (DiaSvgRenderer  *self,
+                                        xmlNodePtr       parent);
+void     dia_svg_renderer_close_group  (DiaSvgRenderer  *self,
+                                        xmlNodePtr       group,
+                                        xmlNodePtr       parent);
+void     dia_svg_renderer_add_def           (DiaSvgRenderer *self,
+                                             xmlNodePtr      node);
+void     dia_svg_renderer_use_style_classes (DiaSvgRenderer *self);
+void     dia_svg_renderer_use_image_defs    (DiaSvgRenderer *self);
+void     dia_svg_renderer_set_style         (DiaSvgRenderer *self,
+                                             xmlNodePtr      node,
+                                             const char     *style);
+void     dia_svg_renderer_set_draw_style    (DiaSvgRenderer *self,
+                                             xmlNodePtr      node,
+                                             Color          *fill,
+                                             Color          *stroke);
+
 G_END_DECLS
 
 #endif /* DIA_SVG_RENDERER_H */
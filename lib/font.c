@@ -41,6 +41,17 @@
 #include "textline.h"
 
 static PangoContext *pango_context = NULL;
+/* The thread pango_context belongs to, others get a copy of their own */
+static GThread *pango_context_thread = NULL;
+static GPrivate thread_context = G_PRIVATE_INIT (g_object_unref);
+G_LOCK_DEFINE_STATIC (pango_context);
+/*
+ * The same DiaFont is drawn from several threads, the pages of an export,
+ * while it may load for another height.  Anything touching ->pfd, ->loaded,
+ * ->metrics, ->height or ->legacy_name holds this.  Recursive, as setters
+ * go through the getters.
+ */
+static GRecMutex font_lock;
 
 /**
  * DiaFont:
@@ -82,14 +93,41 @@ dia_font_push_context (PangoContext *pcontext)
 }
 
 
+/*
+ * A PangoContext must not be used from more than one thread, the pages of an
+ * export are drawn in parallel. So other threads measure with a context of
+ * their own, set up like the main one to get the same sizes.
+ */
+static PangoContext *
+dia_font_copy_context (PangoContext *pcontext)
+{
+  PangoContext *copy;
+
+  copy = pango_font_map_create_context (pango_cairo_font_map_get_default ());
+  pango_cairo_context_set_resolution (copy,
+                                      pango_cairo_context_get_resolution (pcontext));
+  pango_cairo_context_set_font_options (copy,
+                                        pango_cairo_context_get_font_options (pcontext));
+  pango_context_set_language (copy, pango_context_get_language (pcontext));
+
+  return copy;
+}
+
+
 /**
  * dia_font_get_context:
  *
  * Retrieve the current context (used for the font widget)
+ *
+ * Called from another thread than the one which first did, a context of that
+ * thread's own is returned.
  */
 PangoContext *
 dia_font_get_context (void)
 {
+  PangoContext *context;
+
+  G_LOCK (pango_context);
   if (pango_context == NULL) {
 /* Maybe this one with pangocairo
      dia_font_push_context (pango_cairo_font_map_create_context (pango_cairo_font_map_get_default()));
@@ -107,8 +145,21 @@ dia_font_get_context (void)
       g_warning ("dia_font_get_context() : not font context w/o display. Crashing soon.");
 #endif
     }
+    pango_context_thread = g_thread_self ();
+  }
+
+  if (pango_context_thread == g_thread_self ()) {
+    context = pango_context;
+  } else {
+    context = g_private_get (&thread_context);
+    if (!context) {
+      context = dia_font_copy_context (pango_context);
+      g_private_set (&thread_context, context);
+    }
   }
-  return pango_context;
+  G_UNLOCK (pango_context);
+
+  return context;
 }
 
 
@@ -176,6 +227,7 @@ dia_pfd_set_height(PangoFontDescription *pfd, double height)
 static void
 _dia_font_adjust_size (DiaFont *font, double height, gboolean recalc_alwways)
 {
+  g_rec_mutex_lock (&font_lock);
 
   if (font->height != height || !font->metrics || recalc_alwways) {
     PangoFont *loaded;
@@ -194,6 +246,8 @@ _dia_font_adjust_size (DiaFont *font, double height, gboolean recalc_alwways)
     font->metrics = pango_font_get_metrics (font->loaded, NULL);
     font->height = height;
   }
+
+  g_rec_mutex_unlock (&font_lock);
 }
 
 
@@ -208,6 +262,7 @@ dia_font_new (const char *family, DiaFontStyle style, double height)
   DiaFont* font = dia_font_new_from_style(style, height);
   gboolean changed;
 
+  /* Not shared yet */
   changed = family != NULL && g_strcmp0 (pango_font_description_get_family (font->pfd), family) != 0;
   pango_font_description_set_family(font->pfd, family);
 
@@ -354,8 +409,13 @@ dia_font_get_style (DiaFont *font)
     DIA_FONT_BOLD, DIA_FONT_ULTRABOLD, DIA_FONT_HEAVY
   };
 
-  PangoStyle pango_style = pango_font_description_get_style(font->pfd);
-  PangoWeight pango_weight = pango_font_description_get_weight(font->pfd);
+  PangoStyle pango_style;
+  PangoWeight pango_weight;
+
+  g_rec_mutex_lock (&font_lock);
+  pango_style = pango_font_description_get_style (font->pfd);
+  pango_weight = pango_font_description_get_weight (font->pfd);
+  g_rec_mutex_unlock (&font_lock);
 
   g_return_val_if_fail (PANGO_WEIGHT_ULTRALIGHT <= pango_weight &&
                         pango_weight <= PANGO_WEIGHT_HEAVY,
@@ -374,21 +434,29 @@ dia_font_get_style (DiaFont *font)
 /**
  * dia_font_get_family:
  *
- * Retrieves the family of the font. Caller must NOT free.
+ * Retrieves the family of the font. Caller must NOT free.  Valid until
+ * the family of @font changes.
  */
 const char *
 dia_font_get_family (DiaFont *font)
 {
+  const char *family;
+
   g_return_val_if_fail (font != NULL, NULL);
 
-  return pango_font_description_get_family(font->pfd);
+  g_rec_mutex_lock (&font_lock);
+  family = pango_font_description_get_family (font->pfd);
+  g_rec_mutex_unlock (&font_lock);
+
+  return family;
 }
 
 
 /**
  * dia_font_get_description:
  *
- * Acessor for the PangoFontDescription
+ * Acessor for the PangoFontDescription, not to be used while another
+ * thread may change @font.
  */
 const PangoFontDescription *
 dia_font_get_description (DiaFont *font)
@@ -407,9 +475,15 @@ dia_font_get_description (DiaFont *font)
 double
 dia_font_get_height (DiaFont *font)
 {
+  double height;
+
   g_return_val_if_fail (font != NULL, 0.0);
 
-  return font->height;
+  g_rec_mutex_lock (&font_lock);
+  height = font->height;
+  g_rec_mutex_unlock (&font_lock);
+
+  return height;
 }
 
 
@@ -421,13 +495,18 @@ dia_font_get_height (DiaFont *font)
 double
 dia_font_get_size (DiaFont *font)
 {
+  int size;
+
   g_return_val_if_fail (font != NULL, 0.0);
 
+  g_rec_mutex_lock (&font_lock);
   if (!pango_font_description_get_size_is_absolute (font->pfd)) {
     g_warning ("dia_font_get_size() : no absolute size");
   }
+  size = pango_font_description_get_size (font->pfd);
+  g_rec_mutex_unlock (&font_lock);
 
-  return pdu_to_dcm (pango_font_description_get_size (font->pfd));
+  return pdu_to_dcm (size);
 }
 
 
@@ -490,6 +569,7 @@ dia_font_set_any_family (DiaFont *font, const char *family)
 
   g_return_if_fail (font != NULL);
 
+  g_rec_mutex_lock (&font_lock);
   changed = g_strcmp0 (pango_font_description_get_family (font->pfd), family) != 0;
   pango_font_description_set_family (font->pfd, family);
   if (changed) {
@@ -498,6 +578,7 @@ dia_font_set_any_family (DiaFont *font, const char *family)
   }
 
   g_clear_pointer (&font->legacy_name, g_free);
+  g_rec_mutex_unlock (&font_lock);
 }
 
 
@@ -511,9 +592,11 @@ dia_font_set_family (DiaFont *font, DiaFontFamily family)
 {
   g_return_if_fail (font != NULL);
 
+  g_rec_mutex_lock (&font_lock);
   dia_pfd_set_family (font->pfd,family);
 
   g_clear_pointer (&font->legacy_name, g_free);
+  g_rec_mutex_unlock (&font_lock);
 }
 
 
@@ -525,15 +608,19 @@ dia_font_set_family (DiaFont *font, DiaFontFamily family)
 void
 dia_font_set_weight (DiaFont *font, DiaFontWeight weight)
 {
-  DiaFontWeight old_weight = DIA_FONT_STYLE_GET_WEIGHT (dia_font_get_style (font));
+  DiaFontWeight old_weight;
 
   g_return_if_fail (font != NULL);
 
+  g_rec_mutex_lock (&font_lock);
+  old_weight = DIA_FONT_STYLE_GET_WEIGHT (dia_font_get_style (font));
+
   dia_pfd_set_weight(font->pfd,weight);
 
   if (old_weight != weight) {
     _dia_font_adjust_size (font, font->height, TRUE);
   }
+  g_rec_mutex_unlock (&font_lock);
 }
 
 
@@ -545,11 +632,14 @@ dia_font_set_weight (DiaFont *font, DiaFontWeight weight)
 void
 dia_font_set_slant (DiaFont *font, DiaFontSlant slant)
 {
-  DiaFontSlant old_slant = DIA_FONT_STYLE_GET_SLANT(dia_font_get_style(font));
+  DiaFontSlant old_slant;
   g_return_if_fail(font != NULL);
+  g_rec_mutex_lock (&font_lock);
+  old_slant = DIA_FONT_STYLE_GET_SLANT(dia_font_get_style(font));
   dia_pfd_set_slant(font->pfd,slant);
   if (slant != old_slant)
     _dia_font_adjust_size (font, font->height, TRUE);
+  g_rec_mutex_unlock (&font_lock);
 }
 
 
@@ -701,9 +791,17 @@ dia_font_string_width (const char *string, DiaFont *font, double height)
 double
 dia_font_ascent (const char *string, DiaFont *font, double height)
 {
+  double ascent = -1.0;
+
+  g_rec_mutex_lock (&font_lock);
   if (font->metrics) {
-    double ascent = pdu_to_dcm (pango_font_metrics_get_ascent (font->metrics));
-    return ascent * (height / font->height);
+    ascent = pdu_to_dcm (pango_font_metrics_get_ascent (font->metrics));
+    ascent *= height / font->height;
+  }
+  g_rec_mutex_unlock (&font_lock);
+
+  if (ascent >= 0.0) {
+    return ascent;
   } else {
     /* previous, _expensive_ but string specific way */
     TextLine *text_line = text_line_new (string, font, height);
@@ -722,9 +820,17 @@ dia_font_ascent (const char *string, DiaFont *font, double height)
 double
 dia_font_descent (const char *string, DiaFont *font, double height)
 {
+  double descent = -1.0;
+
+  g_rec_mutex_lock (&font_lock);
   if (font->metrics) {
-    double descent = pdu_to_dcm (pango_font_metrics_get_descent (font->metrics));
-    return descent * (height / font->height);
+    descent = pdu_to_dcm (pango_font_metrics_get_descent (font->metrics));
+    descent *= height / font->height;
+  }
+  g_rec_mutex_unlock (&font_lock);
+
+  if (descent >= 0.0) {
+    return descent;
   } else {
     /* previous, _expensive_ but string specific way */
     TextLine *text_line = text_line_new (string, font, height);
@@ -757,9 +863,11 @@ dia_font_build_layout (const char *string, DiaFont *font, double height)
 
   list = pango_attr_list_new ();
 
+  g_rec_mutex_lock (&font_lock);
   pfd = pango_font_description_copy (font->pfd);
   /* account for difference between size and height as well as between font height and given one */
   factor = dia_font_get_size (font) / dia_font_get_height (font);
+  g_rec_mutex_unlock (&font_lock);
   pango_font_description_set_absolute_size (pfd, dcm_to_pdu (height) * factor);
   attr = pango_attr_font_desc_new (pfd);
   pango_font_description_free (pfd);
@@ -1082,8 +1190,11 @@ dia_font_get_legacy_name (DiaFont *font)
   int i;
 
   /* if we have loaded it from an old file, use the old name */
-  if (font->legacy_name) {
-    return font->legacy_name;
+  g_rec_mutex_lock (&font_lock);
+  matched_name = font->legacy_name;
+  g_rec_mutex_unlock (&font_lock);
+  if (matched_name) {
+    return matched_name;
   }
 
   family = dia_font_get_family (font);
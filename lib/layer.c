@@ -25,6 +25,7 @@
 #include "diainteractiverenderer.h"
 #include "dynamic_obj.h"
 #include "dia-layer.h"
+#include "dia-render-profile.h"
 
 static const DiaRectangle invalid_extents = { -1.0,-1.0,-1.0,-1.0 };
 
@@ -49,6 +50,14 @@ struct _DiaLayerPrivate {
                                   must only be set by functions internal
                                   to the diagram, and accessed via
                                   layer_get_parent_diagram() */
+
+  /* Supplies the objects on first use, see dia_layer_defer_objects() */
+  DiaLayerLoadFunc load_func;
+  gpointer         load_data;
+  GBoxedCopyFunc   load_data_copy;
+  GDestroyNotify   load_data_destroy;
+
+  guint64 changes;             /* See dia_layer_changed() */
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE (DiaLayer, dia_layer, G_TYPE_OBJECT)
@@ -83,6 +92,10 @@ dia_layer_finalize (GObject *object)
   g_clear_pointer (&priv->name, g_free);
   destroy_object_list (priv->objects);
 
+  if (priv->load_data_destroy) {
+    priv->load_data_destroy (priv->load_data);
+  }
+
   g_clear_weak_pointer (&priv->parent_diagram);
 
   G_OBJECT_CLASS (dia_layer_parent_class)->finalize (object);
@@ -225,6 +238,38 @@ dia_layer_init (DiaLayer *self)
 }
 
 
+/*
+ * Materialise the objects of a layer set up with dia_layer_defer_objects(),
+ * every function touching priv->objects has to call this first.
+ */
+static void
+load_deferred_objects (DiaLayer *layer)
+{
+  DiaLayerPrivate *priv = dia_layer_get_instance_private (layer);
+  DiaLayerLoadFunc load_func = priv->load_func;
+  gpointer load_data = priv->load_data;
+  GDestroyNotify load_data_destroy = priv->load_data_destroy;
+
+  if (G_LIKELY (load_func == NULL)) {
+    return;
+  }
+
+  /* Cleared first, so the loader can use the layer like any other */
+  priv->load_func = NULL;
+  priv->load_data = NULL;
+  priv->load_data_copy = NULL;
+  priv->load_data_destroy = NULL;
+
+  dia_layer_add_objects (layer, load_func (layer, load_data));
+
+  if (load_data_destroy) {
+    load_data_destroy (load_data);
+  }
+
+  dia_layer_update_extents (layer);
+}
+
+
 /*! The default object renderer.
  * @param obj An object to render.
  * @param renderer The renderer to render on.
@@ -288,10 +333,14 @@ dia_layer_render (DiaLayer       *layer,
   GList *list;
   DiaObject *obj;
   DiaLayerPrivate *priv = dia_layer_get_instance_private (layer);
+  gboolean profile = dia_render_profile_enabled () &&
+                     DIA_IS_INTERACTIVE_RENDERER (renderer);
 
   if (obj_renderer == NULL)
     obj_renderer = normal_render;
 
+  load_deferred_objects (layer);
+
   /* Draw all objects: */
   list = priv->objects;
   while (list != NULL) {
@@ -313,7 +362,15 @@ dia_layer_render (DiaLayer       *layer,
         dia_renderer_set_linewidth (renderer,0.01);
         dia_renderer_draw_rect (renderer, &p1, &p2, NULL, &col);
       }
-      (*obj_renderer) (obj, renderer, active_layer, data);
+      if (profile) {
+        gint64 start = dia_render_profile_start ();
+
+        (*obj_renderer) (obj, renderer, active_layer, data);
+
+        dia_render_profile_add (DIA_RENDER_PROFILE_OBJECT, obj->type->name, start);
+      } else {
+        (*obj_renderer) (obj, renderer, active_layer, data);
+      }
     }
 
     list = g_list_next (list);
@@ -363,6 +420,11 @@ dia_layer_new_from_layer (DiaLayer *old)
 
   old_priv = dia_layer_get_instance_private (old);
 
+  /* Without a way to share the loader both need the objects */
+  if (!old_priv->load_data_copy) {
+    load_deferred_objects (old);
+  }
+
   layer = g_object_new (DIA_TYPE_LAYER,
                         "name", dia_layer_get_name (old),
                         "visible", old_priv->visible,
@@ -373,7 +435,16 @@ dia_layer_new_from_layer (DiaLayer *old)
   priv = dia_layer_get_instance_private (layer);
 
   priv->extents = old_priv->extents;
-  priv->objects = object_copy_list (priv->objects);
+  if (old_priv->load_func) {
+    /* Still not looked at, neither is the copy */
+    dia_layer_defer_objects (layer,
+                             old_priv->load_func,
+                             old_priv->load_data_copy (old_priv->load_data),
+                             old_priv->load_data_copy,
+                             old_priv->load_data_destroy);
+  } else {
+    priv->objects = object_copy_list (old_priv->objects);
+  }
 
   return layer;
 }
@@ -412,6 +483,8 @@ dia_layer_object_get_index (DiaLayer *layer, DiaObject *obj)
 {
   DiaLayerPrivate *priv = dia_layer_get_instance_private (layer);
 
+  load_deferred_objects (layer);
+
   return (int) g_list_index (priv->objects, (gpointer) obj);
 }
 
@@ -429,6 +502,8 @@ dia_layer_object_get_nth (DiaLayer *layer, guint index)
 {
   DiaLayerPrivate *priv = dia_layer_get_instance_private (layer);
 
+  load_deferred_objects (layer);
+
   if (g_list_length (priv->objects) > index) {
     g_assert (g_list_nth (priv->objects, index));
     return (DiaObject *) g_list_nth (priv->objects, index)->data;
@@ -447,6 +522,8 @@ dia_layer_object_count (DiaLayer *layer)
 {
   DiaLayerPrivate *priv = dia_layer_get_instance_private (layer);
 
+  load_deferred_objects (layer);
+
   return g_list_length (priv->objects);
 }
 
@@ -478,8 +555,11 @@ dia_layer_add_object (DiaLayer *layer, DiaObject *obj)
 {
   DiaLayerPrivate *priv = dia_layer_get_instance_private (layer);
 
+  load_deferred_objects (layer);
+
   priv->objects = g_list_append (priv->objects, (gpointer) obj);
   set_parent_layer (obj, layer);
+  priv->changes++;
 
   /* send a signal that we have added a object to the diagram */
   data_emit (dia_layer_get_parent_diagram (layer), layer, obj, "object_add");
@@ -500,8 +580,11 @@ dia_layer_add_object_at (DiaLayer *layer, DiaObject *obj, int pos)
 {
   DiaLayerPrivate *priv = dia_layer_get_instance_private (layer);
 
+  load_deferred_objects (layer);
+
   priv->objects = g_list_insert (priv->objects, (gpointer) obj, pos);
   set_parent_layer (obj, layer);
+  priv->changes++;
 
   /* send a signal that we have added a object to the diagram */
   data_emit (dia_layer_get_parent_diagram (layer), layer, obj, "object_add");
@@ -523,8 +606,11 @@ dia_layer_add_objects (DiaLayer *layer, GList *obj_list)
   GList *list = obj_list;
   DiaLayerPrivate *priv = dia_layer_get_instance_private (layer);
 
+  load_deferred_objects (layer);
+
   priv->objects = g_list_concat (priv->objects, obj_list);
   g_list_foreach (obj_list, set_parent_layer, layer);
+  priv->changes++;
 
   while (list != NULL) {
     DiaObject *obj = (DiaObject *)list->data;
@@ -550,8 +636,11 @@ dia_layer_add_objects_first (DiaLayer *layer, GList *obj_list) {
   GList *list = obj_list;
   DiaLayerPrivate *priv = dia_layer_get_instance_private (layer);
 
+  load_deferred_objects (layer);
+
   priv->objects = g_list_concat (obj_list, priv->objects);
   g_list_foreach (obj_list, set_parent_layer, layer);
+  priv->changes++;
 
   /* Send one signal per object added */
   while (list != NULL) {
@@ -577,10 +666,13 @@ dia_layer_remove_object (DiaLayer *layer, DiaObject *obj)
 {
   DiaLayerPrivate *priv = dia_layer_get_instance_private (layer);
 
+  load_deferred_objects (layer);
+
   /* send a signal that we'll remove a object from the diagram */
   data_emit (dia_layer_get_parent_diagram (layer), layer, obj, "object_remove");
 
   priv->objects = g_list_remove (priv->objects, obj);
+  priv->changes++;
   dynobj_list_remove_object (obj);
   set_parent_layer (obj, NULL);
 }
@@ -628,6 +720,8 @@ dia_layer_find_objects_intersecting_rectangle (DiaLayer     *layer,
   DiaObject *obj;
   DiaLayerPrivate *priv = dia_layer_get_instance_private (layer);
 
+  load_deferred_objects (layer);
+
   selected_list = NULL;
   list = priv->objects;
   while (list != NULL) {
@@ -668,6 +762,8 @@ dia_layer_find_objects_in_rectangle (DiaLayer *layer, DiaRectangle *rect)
   DiaObject *obj;
   DiaLayerPrivate *priv = dia_layer_get_instance_private (layer);
 
+  load_deferred_objects (layer);
+
   selected_list = NULL;
   list = priv->objects;
   while (list != NULL) {
@@ -707,6 +803,8 @@ dia_layer_find_objects_containing_rectangle (DiaLayer *layer, DiaRectangle *rect
 
   g_return_val_if_fail  (layer != NULL, NULL);
 
+  load_deferred_objects (layer);
+
   selected_list = NULL;
   list = priv->objects;
   while (list != NULL) {
@@ -755,6 +853,8 @@ dia_layer_find_closest_object_except (DiaLayer *layer,
   GList *avoid_tmp;
   DiaLayerPrivate *priv = dia_layer_get_instance_private (layer);
 
+  load_deferred_objects (layer);
+
   closest = NULL;
 
   for (l = priv->objects; l!=NULL; l = g_list_next(l)) {
@@ -824,6 +924,8 @@ dia_layer_find_closest_connectionpoint (DiaLayer         *layer,
   int i;
   DiaLayerPrivate *priv = dia_layer_get_instance_private (layer);
 
+  load_deferred_objects (layer);
+
   mindist = 1000000.0; /* Realy big value... */
 
   *closest = NULL;
@@ -864,6 +966,11 @@ dia_layer_update_extents (DiaLayer *layer)
   DiaRectangle new_extents;
   DiaLayerPrivate *priv = dia_layer_get_instance_private (layer);
 
+  /* Not worth loading for, deferred layers are hidden */
+  if (priv->load_func) {
+    return FALSE;
+  }
+
   l = priv->objects;
   if (l!=NULL) {
     obj = (DiaObject *) l->data;
@@ -911,6 +1018,8 @@ dia_layer_replace_object_with_list (DiaLayer  *layer,
   GList *list, *il;
   DiaLayerPrivate *priv = dia_layer_get_instance_private (layer);
 
+  load_deferred_objects (layer);
+
   list = g_list_find (priv->objects, remove_obj);
 
   g_assert (list!=NULL);
@@ -937,6 +1046,7 @@ dia_layer_replace_object_with_list (DiaLayer  *layer,
     il = g_list_next (il);
   }
   g_list_free_1 (list);
+  priv->changes++;
 
   /* with transformed groups the list and the single object are not necessarily
    * of the same size */
@@ -962,6 +1072,8 @@ dia_layer_set_object_list (DiaLayer *layer, GList *list)
   GList *ol;
   DiaLayerPrivate *priv = dia_layer_get_instance_private (layer);
 
+  load_deferred_objects (layer);
+
   /* signal removal on all objects */
   ol = priv->objects;
   while (ol) {
@@ -976,6 +1088,7 @@ dia_layer_set_object_list (DiaLayer *layer, GList *list)
 
   priv->objects = list;
   g_list_foreach (priv->objects, set_parent_layer, layer);
+  priv->changes++;
   /* signal addition on all objects */
   list = priv->objects;
   while (list) {
@@ -1002,6 +1115,8 @@ dia_layer_get_object_list (DiaLayer *layer)
 
   priv = dia_layer_get_instance_private (layer);
 
+  load_deferred_objects (layer);
+
   return priv->objects;
 }
 
@@ -1126,6 +1241,10 @@ dia_layer_set_visible (DiaLayer *self,
 
   priv = dia_layer_get_instance_private (self);
 
+  if (visible) {
+    load_deferred_objects (self);
+  }
+
   priv->visible = visible;
 
   g_object_notify_by_pspec (G_OBJECT (self), pspecs[PROP_VISIBLE]);
@@ -1152,3 +1271,135 @@ dia_layer_get_extents (DiaLayer     *self,
 
   *rect = priv->extents;
 }
+
+
+/**
+ * dia_layer_defer_objects:
+ * @self: the #DiaLayer, still empty
+ * @load_func: provides the objects of @self
+ * @load_data: passed to @load_func
+ * @load_data_copy: (nullable): duplicates @load_data
+ * @load_data_destroy: frees @load_data once it is no longer needed
+ *
+ * Postpone reading the objects of @self until they are first needed,
+ * either through any of the object accessors or by making @self visible.
+ * Meant for hidden layers of big diagrams, which many sessions never look
+ * at.  Until then the extents of @self aren't updated.
+ *
+ * With @load_data_copy dia_layer_new_from_layer() defers the copy as well,
+ * instead of loading both.
+ *
+ * Since: 0.98
+ */
+void
+dia_layer_defer_objects (DiaLayer         *self,
+                         DiaLayerLoadFunc  load_func,
+                         gpointer          load_data,
+                         GBoxedCopyFunc    load_data_copy,
+                         GDestroyNotify    load_data_destroy)
+{
+  DiaLayerPrivate *priv;
+
+  g_return_if_fail (DIA_IS_LAYER (self));
+  g_return_if_fail (load_func != NULL);
+
+  priv = dia_layer_get_instance_private (self);
+
+  g_return_if_fail (priv->objects == NULL && priv->load_func == NULL);
+
+  priv->load_func = load_func;
+  priv->load_data = load_data;
+  priv->load_data_copy = load_data_copy;
+  priv->load_data_destroy = load_data_destroy;
+}
+
+
+/**
+ * dia_layer_is_loaded:
+ * @self: the #DiaLayer
+ *
+ * Returns: %FALSE while the objects of @self are still deferred
+ *
+ * Since: 0.98
+ */
+gboolean
+dia_layer_is_loaded (DiaLayer *self)
+{
+  DiaLayerPrivate *priv;
+
+  g_return_val_if_fail (DIA_IS_LAYER (self), FALSE);
+
+  priv = dia_layer_get_instance_private (self);
+
+  return priv->load_func == NULL;
+}
+
+
+/**
+ * dia_layer_get_load_data:
+ * @self: the #DiaLayer
+ * @load_func: the loader @self may be waiting for
+ *
+ * Lets the owner of @load_func work with the data of a layer that is
+ * still deferred, like saving it without creating the objects.
+ *
+ * Returns: (transfer none) (nullable): the data given to
+ *          dia_layer_defer_objects() while @self waits for @load_func
+ *
+ * Since: 0.98
+ */
+gpointer
+dia_layer_get_load_data (DiaLayer *self, DiaLayerLoadFunc load_func)
+{
+  DiaLayerPrivate *priv;
+
+  g_return_val_if_fail (DIA_IS_LAYER (self), NULL);
+
+  priv = dia_layer_get_instance_private (self);
+
+  return priv->load_func == load_func ? priv->load_data : NULL;
+}
+
+
+/**
+ * dia_layer_changed:
+ * @self: the #DiaLayer
+ *
+ * Tell that an object of @self moved, changed size or highlighting.  Adding
+ * and removing objects counts by itself.
+ *
+ * Since: 0.98
+ */
+void
+dia_layer_changed (DiaLayer *self)
+{
+  DiaLayerPrivate *priv;
+
+  g_return_if_fail (DIA_IS_LAYER (self));
+
+  priv = dia_layer_get_instance_private (self);
+
+  priv->changes++;
+}
+
+
+/**
+ * dia_layer_get_changes:
+ * @self: the #DiaLayer
+ *
+ * Returns: a counter that's different whenever @self changed, see
+ *          dia_layer_changed()
+ *
+ * Since: 0.98
+ */
+guint64
+dia_layer_get_changes (DiaLayer *self)
+{
+  DiaLayerPrivate *priv;
+
+  g_return_val_if_fail (DIA_IS_LAYER (self), 0);
+
+  priv = dia_layer_get_instance_private (self);
+
+  return priv->changes;
+}
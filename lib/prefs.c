@@ -20,9 +20,12 @@
 #include <string.h>
 
 #include "prefs.h"
+#include "dia-number.h"
 
 DiaUnit length_unit = DIA_UNIT_CENTIMETER;
 DiaUnit fontsize_unit = DIA_UNIT_POINT;
+/* Fractional digits of centimetres kept in saved coordinates, -1 is lossless */
+int save_precision = DIA_NUMBER_EXACT;
 
 
 void
@@ -49,3 +52,17 @@ prefs_get_fontsize_unit(void)
   return fontsize_unit;
 }
 
+
+
+void
+prefs_set_save_precision (int decimals)
+{
+  save_precision = decimals < 0 ? DIA_NUMBER_EXACT : decimals;
+}
+
+
+int
+prefs_get_save_precision (void)
+{
+  return save_precision;
+}
@@ -26,3 +26,5 @@ void    prefs_set_length_unit   (DiaUnit unit);
 void    prefs_set_fontsize_unit (DiaUnit unit);
 DiaUnit prefs_get_length_unit   (void);
 DiaUnit prefs_get_fontsize_unit (void);
+void    prefs_set_save_precision (int decimals);
+int     prefs_get_save_precision (void);
@@ -32,6 +32,8 @@
 #include "properties.h"
 #include "propinternals.h"
 #include "message.h"
+#include "dia_image.h"
+#include "dia-binary.h"
 
 static PixbufProperty *
 pixbufprop_new(const PropDescription *pdesc, PropDescToPropPredicate reason)
@@ -126,16 +128,57 @@ pixbuf_decode_base64 (const char *b64)
 }
 
 
+/* The GBytes a pixbuf was decoded from, or last encoded to */
+#define ENCODED_KEY "dia-encoded"
+
+
+/* Stored out of line, see dia_binary_doc_use_blobs() */
+static GBytes *
+data_blob (DataNode data, char **name, DiaContext *ctx)
+{
+  AttributeNode attr = composite_find_attribute (data, "blob");
+  GBytes *blob;
+
+  if (!attr) {
+    return NULL;
+  }
+
+  *name = data_string (attribute_first_data (attr), ctx);
+  blob = *name ? dia_binary_doc_get_blob (data->doc, *name) : NULL;
+  if (!blob) {
+    dia_context_add_message (ctx,
+                             _("The image ‘%s’ is missing from the diagram."),
+                             *name ? *name : "");
+  }
+
+  return blob;
+}
+
+
 GdkPixbuf *
 data_pixbuf (DataNode data, DiaContext *ctx)
 {
   GdkPixbuf *pixbuf = NULL;
   GdkPixbufLoader *loader;
   GError *error = NULL;
+  char *name = NULL;
+  GBytes *blob = data_blob (data, &name, ctx);
   AttributeNode attr = composite_find_attribute(data, "data");
+  GByteArray *encoded = NULL;
+
+  g_clear_pointer (&name, g_free);
+  if (!blob && !attr) {
+    return NULL;
+  }
 
   loader = gdk_pixbuf_loader_new ();
-  if (loader) {
+  if (loader && blob) {
+    gdk_pixbuf_loader_write_bytes (loader, blob, &error);
+    encoded = g_byte_array_sized_new (g_bytes_get_size (blob));
+    g_byte_array_append (encoded,
+                         g_bytes_get_data (blob, NULL),
+                         g_bytes_get_size (blob));
+  } else if (loader) {
     xmlNode *node = attribute_first_data (attr);
     gint state = 0;
     guint save = 0;
@@ -149,20 +192,29 @@ data_pixbuf (DataNode data, DiaContext *ctx)
       len = strlen ((char *)in);
     }
 
+    encoded = g_byte_array_sized_new (len / 4 * 3);
     do {
       gsize step = g_base64_decode_step (in,
 					 len > BUF_SIZE ? BUF_SIZE : len,
 					 buf, &state, &save);
 
+      g_byte_array_append (encoded, buf, step);
       if (!gdk_pixbuf_loader_write (loader, buf, step, &error))
 	break;
 
       in += BUF_SIZE;
       len -= BUF_SIZE;
     } while (len > 0);
+  }
 
+  if (loader) {
     if (gdk_pixbuf_loader_close (loader, error ? NULL : &error)) {
       pixbuf = g_object_ref (gdk_pixbuf_loader_get_pixbuf (loader));
+      /* saved again as it was, see data_add_pixbuf() */
+      g_object_set_data_full (G_OBJECT (pixbuf),
+                              ENCODED_KEY,
+                              g_byte_array_free_to_bytes (g_steal_pointer (&encoded)),
+                              (GDestroyNotify) g_bytes_unref);
     } else {
       message_warning (_("Failed to load image form diagram:\n%s"), error->message);
       g_clear_error (&error);
@@ -170,10 +222,90 @@ data_pixbuf (DataNode data, DiaContext *ctx)
 
     g_clear_object (&loader);
   }
+  g_clear_pointer (&encoded, g_byte_array_unref);
 #  undef BUF_SIZE
   return pixbuf;
 }
 
+/**
+ * data_image:
+ * @data: the pixbuf composite, as written by data_add_pixbuf()
+ * @ctx: the #DiaContext
+ *
+ * Like data_pixbuf(), but the same data gives the same #DiaImage and the
+ * pixels are only decoded when first needed
+ *
+ * Returns: (transfer full) (nullable): the image
+ *
+ * Since: 0.98
+ */
+DiaImage *
+data_image (DataNode data, DiaContext *ctx)
+{
+  AttributeNode attr = composite_find_attribute (data, "data");
+  xmlNode *node = attr ? attribute_first_data (attr) : NULL;
+  DiaImage *image = NULL;
+  GdkPixbuf *pixbuf;
+  char *name = NULL;
+  GBytes *blob = data_blob (data, &name, ctx);
+
+  if (blob) {
+    /* not by its name, a damaged file could give anything any name */
+    char *digest = g_compute_checksum_for_bytes (G_CHECKSUM_SHA256, blob);
+    char *key = g_strdup_printf ("blob:%s", digest);
+
+    g_clear_pointer (&digest, g_free);
+
+    image = dia_image_cache_lookup (key);
+    if (!image) {
+      /* the file may only be mapped, don't keep it pinned */
+      GBytes *copy = g_bytes_new (g_bytes_get_data (blob, NULL),
+                                  g_bytes_get_size (blob));
+
+      image = dia_image_new_deferred (copy);
+      if (image) {
+        dia_image_cache_add (image, key);
+      }
+      g_clear_pointer (&copy, g_bytes_unref);
+    }
+
+    g_clear_pointer (&key, g_free);
+  } else if (node && node->children &&
+      xmlStrcmp (node->children->name, (const xmlChar*)"text") == 0) {
+    const char *text = (const char *) node->children->content;
+    char *digest = g_compute_checksum_for_string (G_CHECKSUM_SHA256, text, -1);
+    char *key = g_strdup_printf ("data:%s", digest);
+
+    image = dia_image_cache_lookup (key);
+    if (!image) {
+      gsize len = 0;
+      guchar *bytes = g_base64_decode (text, &len);
+      GBytes *encoded = g_bytes_new_take (bytes, len);
+
+      /* only the size for now */
+      image = dia_image_new_deferred (encoded);
+      if (image) {
+        dia_image_cache_add (image, key);
+      }
+      g_clear_pointer (&encoded, g_bytes_unref);
+    }
+
+    g_clear_pointer (&digest, g_free);
+    g_clear_pointer (&key, g_free);
+  }
+
+  /* tells what went wrong, unless data_blob() did */
+  if (!image && (!name || blob) && (pixbuf = data_pixbuf (data, ctx)) != NULL) {
+    image = dia_image_new_from_pixbuf (pixbuf);
+    g_clear_object (&pixbuf);
+  }
+
+  g_clear_pointer (&name, g_free);
+
+  return image;
+}
+
+
 static void
 pixbufprop_load(PixbufProperty *prop, AttributeNode attr, DataNode data, DiaContext *ctx)
 {
@@ -220,6 +352,20 @@ _make_pixbuf_type_name (const char *p)
 }
 
 
+static char *
+_encode_close (EncodeData *ed)
+{
+  /* g_base64_encode_close ... [needs] up to 5 bytes if line-breaking is enabled */
+  /* also make the array 0-terminated */
+  g_byte_array_append (ed->array, (guint8 *)"\0\0\0\0\0", 6);
+  ed->size += g_base64_encode_close (FALSE, (gchar *)&ed->array->data[ed->size],
+				     &ed->state, &ed->save);
+  ed->array->data[ed->size] = '\0';
+
+  return (gchar *)g_byte_array_free (ed->array, FALSE);
+}
+
+
 /**
  * pixbuf_encode_base64:
  * @pixbuf: the #GdkPixbuf to encode
@@ -243,33 +389,158 @@ pixbuf_encode_base64 (const GdkPixbuf *pixbuf, const char *prefix)
   if (!gdk_pixbuf_save_to_callback ((GdkPixbuf *)pixbuf, _pixbuf_encode, &ed, type, &error, NULL)) {
     message_error (_("Saving inline pixbuf failed:\n%s"), error->message);
     g_clear_error (&error);
+    g_byte_array_unref (ed.array);
     return NULL;
   }
 
-  /* g_base64_encode_close ... [needs] up to 5 bytes if line-breaking is enabled */
-  /* also make the array 0-terminated */
-  g_byte_array_append (ed.array, (guint8 *)"\0\0\0\0\0", 6);
-  ed.size += g_base64_encode_close (FALSE, (gchar *)&ed.array->data[ed.size],
-				    &ed.state, &ed.save);
-  ed.array->data[ed.size] = '\0';
+  return _encode_close (&ed);
+}
 
-  return (gchar *)g_byte_array_free (ed.array, FALSE);
+
+/* Like pixbuf_encode_base64(), for an image that already is encoded */
+static char *
+_bytes_encode_base64 (GBytes *bytes)
+{
+  EncodeData ed = { 0, };
+  gsize len;
+  const gchar *data = g_bytes_get_data (bytes, &len);
+
+  ed.array = g_byte_array_new ();
+  _pixbuf_encode (data, len, NULL, &ed);
+
+  return _encode_close (&ed);
+}
+
+
+static void
+data_add_encoded (ObjectNode composite, GBytes *bytes, DiaContext *ctx)
+{
+  if (dia_binary_doc_has_blobs (composite->doc)) {
+    /* stored out of line, the same content only once */
+    char *name = dia_binary_doc_add_blob (composite->doc, bytes);
+
+    data_add_string (composite_add_attribute (composite, "blob"), name, ctx);
+
+    g_clear_pointer (&name, g_free);
+  } else {
+    AttributeNode comp_attr = composite_add_attribute (composite, "data");
+    char *b64 = _bytes_encode_base64 (bytes);
+
+    (void)xmlNewChild (comp_attr, NULL, (const xmlChar *)"data", (xmlChar *)b64);
+
+    g_clear_pointer (&b64, g_free);
+  }
 }
+
+
 void
 data_add_pixbuf (AttributeNode attr, GdkPixbuf *pixbuf, DiaContext *ctx)
 {
   ObjectNode composite = data_add_composite(attr, "pixbuf", ctx);
-  AttributeNode comp_attr = composite_add_attribute (composite, "data");
-  gchar *b64;
+  GBytes *encoded = g_object_get_data (G_OBJECT (pixbuf), ENCODED_KEY);
 
-  b64 = pixbuf_encode_base64 (pixbuf, NULL);
+  /* unchanged since loaded or last saved, pixbufs are not edited in place */
+  if (!encoded) {
+    GError *error = NULL;
+    gchar *buffer = NULL;
+    gsize len = 0;
 
-  if (b64)
-    (void)xmlNewChild (comp_attr, NULL, (const xmlChar *)"data", (xmlChar *)b64);
+    if (!gdk_pixbuf_save_to_buffer (pixbuf, &buffer, &len, "png", &error, NULL)) {
+      message_error (_("Saving inline pixbuf failed:\n%s"), error->message);
+      g_clear_error (&error);
+
+      return;
+    }
+
+    encoded = g_bytes_new_take (buffer, len);
+    g_object_set_data_full (G_OBJECT (pixbuf),
+                            ENCODED_KEY,
+                            encoded,
+                            (GDestroyNotify) g_bytes_unref);
+  }
+
+  data_add_encoded (composite, encoded, ctx);
+}
+
+
+/**
+ * data_add_image:
+ * @attr: the attribute to add to
+ * @image: the #DiaImage
+ * @ctx: the current #DiaContext
+ *
+ * Like data_add_pixbuf(), but writes the data @image was read from, or
+ * encoded to before, instead of encoding the pixels again
+ *
+ * Since: 0.98
+ */
+void
+data_add_image (AttributeNode attr, DiaImage *image, DiaContext *ctx)
+{
+  GBytes *encoded = dia_image_get_encoded (image, NULL);
+
+  if (encoded) {
+    data_add_encoded (data_add_composite (attr, "pixbuf", ctx), encoded, ctx);
+  }
+
+  g_clear_pointer (&encoded, g_bytes_unref);
+}
+
+
+/**
+ * data_adopt_blobs:
+ * @node: copied from @from into another document
+ * @from: the document @node was read from
+ * @ctx: the current #DiaContext
+ *
+ * Images stored out of line only live in the document they were written
+ * to, see dia_binary_doc_use_blobs().  Make the ones below @node part of
+ * its new document, as blobs if that has them, otherwise inline.
+ *
+ * Since: 0.98
+ */
+void
+data_adopt_blobs (xmlNodePtr node, xmlDocPtr from, DiaContext *ctx)
+{
+  xmlNodePtr child = node->children;
+
+  while (child != NULL) {
+    xmlNodePtr next = child->next;
+    xmlChar *name = NULL;
+
+    if (child->type == XML_ELEMENT_NODE &&
+        xmlStrcmp (child->name, (const xmlChar *) "attribute") == 0 &&
+        (name = xmlGetProp (child, (const xmlChar *) "name")) != NULL &&
+        xmlStrcmp (name, (const xmlChar *) "blob") == 0) {
+      char *blob_name = data_string (attribute_first_data (child), ctx);
+      GBytes *blob = blob_name ? dia_binary_doc_get_blob (from, blob_name) : NULL;
+
+      if (!blob) {
+        dia_context_add_message (ctx,
+                                 _("The image ‘%s’ is missing from the diagram."),
+                                 blob_name ? blob_name : "");
+      } else if (dia_binary_doc_has_blobs (node->doc)) {
+        /* named by its content, so the name stays */
+        char *added = dia_binary_doc_add_blob (node->doc, blob);
+
+        g_clear_pointer (&added, g_free);
+      } else {
+        xmlUnlinkNode (child);
+        xmlFreeNode (child);
+        data_add_encoded (node, blob, ctx);
+      }
+
+      g_clear_pointer (&blob_name, g_free);
+    } else if (child->type == XML_ELEMENT_NODE) {
+      data_adopt_blobs (child, from, ctx);
+    }
 
-  g_clear_pointer (&b64, g_free);
+    dia_clear_xml_string (&name);
+    child = next;
+  }
 }
 
+
 static void
 pixbufprop_save(PixbufProperty *prop, AttributeNode attr, DiaContext *ctx)
 {
@@ -24,11 +24,14 @@
 
 #include <glib/gi18n-lib.h>
 
+#include <math.h>
+
 #include "diacairo.h"
 
 #include <gdk/gdk.h>
 
 #include "dia-colour.h"
+#include "dia-layer.h"
 #include "diatransform.h"
 #include "object.h"
 #include "textline.h"
@@ -55,6 +58,65 @@ struct _DiaCairoInteractiveRenderer {
 
   /** If non-NULL, this rendering is a highlighting with the given color. */
   Color *highlight_color;
+
+  /* DiaLayer -> LayerCache, for the layers not edited */
+  GHashTable *layer_caches;
+
+  /* Level of detail, in pixels, 0 to always draw everything */
+  double min_object_size;
+  double min_text_size;
+
+  /* TextLayout -> TextLayout, laid out text kept from frame to frame */
+  GHashTable *text_layouts;
+  PangoContext *text_context;
+  double text_zoom;
+  guint frame;
+  guint64 text_layouts_created;
+  guint64 text_layouts_reused;
+};
+
+/* Beyond this many, layouts not used in the last frame are dropped */
+#define MAX_TEXT_LAYOUTS 2048
+
+/* As in diacairo-renderer.c, Pango gets huge fonts scaled down by cairo */
+#define FONT_SIZE_TWEAK (72.0)
+
+typedef struct _TextLayout TextLayout;
+struct _TextLayout {
+  /* The key */
+  DiaFont      *font;
+  double        height;
+  DiaAlignment  alignment;
+  char         *text;
+
+  PangoLayout  *layout;
+  int           shift;            /* From the alignment, scaled down */
+  int           baseline;         /* Scaled down as well */
+  guint         frame;            /* When it was last drawn */
+};
+
+/* What's drawn instead of details too small to see */
+static Color lod_color = { 0.5, 0.5, 0.5, 0.6 };
+
+/*
+ * What all layer caches of a display may take together, layers beyond
+ * that are drawn directly.  Each is as big as the window in device
+ * pixels, so that's eight at 1080p but a single one at 4K.
+ */
+#define MAX_LAYER_CACHE_BYTES (64 * 1024 * 1024)
+
+typedef struct _LayerCache LayerCache;
+struct _LayerCache {
+  cairo_surface_t *surface;
+  cairo_region_t  *valid;         /* What's drawn already, in window units */
+  int              width;         /* In units of the window */
+  int              height;
+  double           x_scale;       /* Pixels per unit */
+  double           y_scale;
+  gsize            size;          /* Of @surface, in bytes */
+  guint64          changes;       /* dia_layer_get_changes() when drawn */
+  double           zoom_factor;
+  DiaRectangle     visible;
 };
 
 static void dia_cairo_interactive_renderer_iface_init (DiaInteractiveRendererInterface* iface);
@@ -65,9 +127,112 @@ G_DEFINE_TYPE_WITH_CODE (DiaCairoInteractiveRenderer, dia_cairo_interactive_rend
 enum {
   PROP_0,
   PROP_ZOOM,
-  PROP_RECT
+  PROP_RECT,
+  PROP_MIN_OBJECT_SIZE,
+  PROP_MIN_TEXT_SIZE,
+  PROP_TEXT_LAYOUTS_CREATED,
+  PROP_TEXT_LAYOUTS_REUSED,
 };
 
+static void
+layer_cache_free (gpointer data)
+{
+  LayerCache *cache = data;
+
+  g_clear_pointer (&cache->surface, cairo_surface_destroy);
+  g_clear_pointer (&cache->valid, cairo_region_destroy);
+  g_free (cache);
+}
+
+
+static guint
+text_layout_hash (gconstpointer key)
+{
+  const TextLayout *text_layout = key;
+
+  return g_str_hash (text_layout->text) ^
+         g_direct_hash (text_layout->font) ^
+         g_double_hash (&text_layout->height) ^
+         (guint) text_layout->alignment;
+}
+
+
+static gboolean
+text_layout_equal (gconstpointer a, gconstpointer b)
+{
+  const TextLayout *text_layout_a = a;
+  const TextLayout *text_layout_b = b;
+
+  return text_layout_a->font == text_layout_b->font &&
+         text_layout_a->height == text_layout_b->height &&
+         text_layout_a->alignment == text_layout_b->alignment &&
+         g_str_equal (text_layout_a->text, text_layout_b->text);
+}
+
+
+static void
+text_layout_free (gpointer data)
+{
+  TextLayout *text_layout = data;
+
+  g_clear_object (&text_layout->font);
+  g_clear_pointer (&text_layout->text, g_free);
+  g_clear_object (&text_layout->layout);
+  g_free (text_layout);
+}
+
+
+static void
+layer_cache_layer_gone (gpointer data, GObject *where_the_layer_was)
+{
+  DiaCairoInteractiveRenderer *renderer = data;
+
+  g_hash_table_remove (renderer->layer_caches, where_the_layer_was);
+}
+
+
+static void
+layer_cache_remove (DiaCairoInteractiveRenderer *renderer, DiaLayer *layer)
+{
+  g_object_weak_unref (G_OBJECT (layer), layer_cache_layer_gone, renderer);
+  g_hash_table_remove (renderer->layer_caches, layer);
+}
+
+
+/* The memory taken by all the caches but @except */
+static gsize
+layer_caches_size (DiaCairoInteractiveRenderer *renderer, LayerCache *except)
+{
+  GHashTableIter iter;
+  LayerCache *cache;
+  gsize size = 0;
+
+  g_hash_table_iter_init (&iter, renderer->layer_caches);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &cache)) {
+    if (cache != except && cache->surface) {
+      size += cache->size;
+    }
+  }
+
+  return size;
+}
+
+
+static void
+dia_cairo_interactive_renderer_invalidate_layers (DiaInteractiveRenderer *object)
+{
+  DiaCairoInteractiveRenderer *renderer = DIA_CAIRO_INTERACTIVE_RENDERER (object);
+  GHashTableIter iter;
+  gpointer layer;
+
+  g_hash_table_iter_init (&iter, renderer->layer_caches);
+  while (g_hash_table_iter_next (&iter, &layer, NULL)) {
+    g_object_weak_unref (G_OBJECT (layer), layer_cache_layer_gone, renderer);
+    g_hash_table_iter_remove (&iter);
+  }
+}
+
+
 static void
 dia_cairo_interactive_renderer_init (DiaCairoInteractiveRenderer *object)
 {
@@ -76,6 +241,13 @@ dia_cairo_interactive_renderer_init (DiaCairoInteractiveRenderer *object)
   renderer->surface = NULL;
 
   renderer->highlight_color = NULL;
+
+  renderer->layer_caches = g_hash_table_new_full (NULL, NULL, NULL, layer_cache_free);
+
+  renderer->text_layouts = g_hash_table_new_full (text_layout_hash,
+                                                  text_layout_equal,
+                                                  NULL,
+                                                  text_layout_free);
 }
 
 static void
@@ -87,6 +259,17 @@ dia_cairo_interactive_renderer_finalize (GObject *object)
   g_clear_pointer (&base_renderer->cr, cairo_destroy);
   g_clear_pointer (&renderer->surface, cairo_surface_destroy);
 
+  dia_cairo_interactive_renderer_invalidate_layers (DIA_INTERACTIVE_RENDERER (object));
+  g_clear_pointer (&renderer->layer_caches, g_hash_table_destroy);
+
+  g_debug ("%s: %" G_GUINT64_FORMAT " text layouts created, %"
+           G_GUINT64_FORMAT " reused",
+           G_STRFUNC,
+           renderer->text_layouts_created,
+           renderer->text_layouts_reused);
+  g_clear_pointer (&renderer->text_layouts, g_hash_table_destroy);
+  g_clear_object (&renderer->text_context);
+
   G_OBJECT_CLASS (dia_cairo_interactive_renderer_parent_class)->finalize (object);
 }
 
@@ -105,6 +288,18 @@ dia_cairo_interactive_renderer_set_property (GObject      *object,
     case PROP_RECT:
       renderer->visible = g_value_get_pointer (value);
       break;
+    case PROP_MIN_OBJECT_SIZE:
+      if (renderer->min_object_size != g_value_get_double (value)) {
+        renderer->min_object_size = g_value_get_double (value);
+        dia_cairo_interactive_renderer_invalidate_layers (DIA_INTERACTIVE_RENDERER (object));
+      }
+      break;
+    case PROP_MIN_TEXT_SIZE:
+      if (renderer->min_text_size != g_value_get_double (value)) {
+        renderer->min_text_size = g_value_get_double (value);
+        dia_cairo_interactive_renderer_invalidate_layers (DIA_INTERACTIVE_RENDERER (object));
+      }
+      break;
     default:
       break;
   }
@@ -125,6 +320,18 @@ dia_cairo_interactive_renderer_get_property (GObject    *object,
     case PROP_RECT:
       g_value_set_pointer (value, renderer->visible);
       break;
+    case PROP_MIN_OBJECT_SIZE:
+      g_value_set_double (value, renderer->min_object_size);
+      break;
+    case PROP_MIN_TEXT_SIZE:
+      g_value_set_double (value, renderer->min_text_size);
+      break;
+    case PROP_TEXT_LAYOUTS_CREATED:
+      g_value_set_uint64 (value, renderer->text_layouts_created);
+      break;
+    case PROP_TEXT_LAYOUTS_REUSED:
+      g_value_set_uint64 (value, renderer->text_layouts_reused);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -198,27 +405,111 @@ dia_cairo_interactive_renderer_begin_render (DiaRenderer        *self,
     cairo_rectangle (base_renderer->cr, update->left, update->top, width, height);
     cairo_clip (base_renderer->cr);
   }
-  g_clear_object (&base_renderer->layout);
-  base_renderer->layout = pango_cairo_create_layout (base_renderer->cr);
+
+  /* Kept over frames, draw_string() updates it to the new cairo_t */
+  if (!base_renderer->layout) {
+    base_renderer->layout = pango_cairo_create_layout (base_renderer->cr);
+  }
+
+  /* The laid out text only fits the zoom it was made for */
+  if (renderer->text_zoom != *renderer->zoom_factor) {
+    g_hash_table_remove_all (renderer->text_layouts);
+    renderer->text_zoom = *renderer->zoom_factor;
+  }
+  renderer->frame++;
 
   cairo_set_fill_rule (base_renderer->cr, CAIRO_FILL_RULE_EVEN_ODD);
 
-  /* should we set the background color? Or do nothing at all? */
-  /* if this is drawn you can see 'clipping in action', outside of the clip it gets yellow ;) */
-  cairo_set_source_rgba (base_renderer->cr, 1.0, 1.0, .8, 1.0);
-  cairo_set_operator (base_renderer->cr, CAIRO_OPERATOR_OVER);
-  cairo_rectangle (base_renderer->cr, 0, 0, renderer->width, renderer->height);
-  cairo_fill (base_renderer->cr);
+  /* No background, whoever draws fills it in the first place */
 }
 
 static void
 dia_cairo_interactive_renderer_end_render (DiaRenderer *self)
 {
+  DiaCairoInteractiveRenderer *renderer = DIA_CAIRO_INTERACTIVE_RENDERER (self);
   DiaCairoRenderer *base_renderer = DIA_CAIRO_RENDERER (self);
 
   cairo_show_page (base_renderer->cr);
 
   g_clear_pointer (&base_renderer->cr, cairo_destroy);
+
+  if (g_hash_table_size (renderer->text_layouts) > MAX_TEXT_LAYOUTS) {
+    GHashTableIter iter;
+    TextLayout *text_layout;
+
+    g_hash_table_iter_init (&iter, renderer->text_layouts);
+    while (g_hash_table_iter_next (&iter, (gpointer *) &text_layout, NULL)) {
+      if (text_layout->frame != renderer->frame) {
+        g_hash_table_iter_remove (&iter);
+      }
+    }
+  }
+}
+
+
+/*
+ * Finds the layout for @text_line, or lays it out for the current
+ * transformation of the cairo_t
+ */
+static TextLayout *
+text_layout_lookup (DiaCairoInteractiveRenderer *renderer,
+                    TextLine                    *text_line,
+                    DiaAlignment                 alignment)
+{
+  TextLayout key = {
+    .font = text_line_get_font (text_line),
+    .height = text_line_get_height (text_line),
+    .alignment = alignment,
+    .text = (char *) text_line_get_string (text_line),
+  };
+  TextLayout *text_layout = g_hash_table_lookup (renderer->text_layouts, &key);
+  PangoFontDescription *pfd;
+  PangoLayoutIter *iter;
+  PangoRectangle extents;
+  double size;
+
+  if (text_layout) {
+    text_layout->frame = renderer->frame;
+    renderer->text_layouts_reused++;
+
+    return text_layout;
+  }
+
+  text_layout = g_new0 (TextLayout, 1);
+  text_layout->font = g_object_ref (key.font);
+  text_layout->height = key.height;
+  text_layout->alignment = alignment;
+  text_layout->text = g_strdup (key.text);
+  text_layout->frame = renderer->frame;
+  text_layout->layout = pango_layout_new (renderer->text_context);
+
+  /* pango/cairo wants the font size, not the (line-) height */
+  size = dia_font_get_size (key.font) * (key.height / dia_font_get_height (key.font));
+  pfd = pango_font_description_copy (dia_font_get_description (key.font));
+  pango_font_description_set_absolute_size (pfd,
+                                            (int) (size * FONT_SIZE_TWEAK * PANGO_SCALE));
+  pango_layout_set_font_description (text_layout->layout, pfd);
+  pango_font_description_free (pfd);
+
+  pango_layout_set_alignment (text_layout->layout,
+                              alignment == DIA_ALIGN_CENTRE ?
+                                PANGO_ALIGN_CENTER : alignment == DIA_ALIGN_RIGHT ?
+                                  PANGO_ALIGN_RIGHT : PANGO_ALIGN_LEFT);
+  pango_layout_set_text (text_layout->layout, text_layout->text, -1);
+
+  /* although we give the alignment above we need to adjust the start point */
+  iter = pango_layout_get_iter (text_layout->layout);
+  pango_layout_iter_get_line_extents (iter, NULL, &extents);
+  text_layout->baseline = pango_layout_iter_get_baseline (iter) / FONT_SIZE_TWEAK;
+  text_layout->shift = (alignment == DIA_ALIGN_CENTRE ?
+                          PANGO_RBEARING (extents) / 2 : alignment == DIA_ALIGN_RIGHT ?
+                            PANGO_RBEARING (extents) : 0) / FONT_SIZE_TWEAK;
+  pango_layout_iter_free (iter);
+
+  g_hash_table_add (renderer->text_layouts, text_layout);
+  renderer->text_layouts_created++;
+
+  return text_layout;
 }
 
 /* Get the width of the given text in cm */
@@ -265,6 +556,50 @@ calculate_relative_luminance (const Color *c)
   return 0.2126 * R + 0.7152 * G + 0.0722 * B;
 }
 
+/*
+ * Like dia_cairo_renderer_draw_string(), but with the layout from
+ * the previous frames if there is one
+ */
+static void
+draw_text_layout (DiaCairoInteractiveRenderer *interactive,
+                  TextLine                    *text_line,
+                  Point                       *pos,
+                  DiaAlignment                 alignment,
+                  Color                       *color)
+{
+  DiaCairoRenderer *renderer = DIA_CAIRO_RENDERER (interactive);
+  TextLayout *text_layout;
+  double x, y;
+
+  if (text_line_get_string (text_line)[0] == '\0') {
+    return;
+  }
+
+  cairo_set_source_rgba (renderer->cr,
+                         color->red,
+                         color->green,
+                         color->blue,
+                         color->alpha);
+  cairo_save (renderer->cr);
+  cairo_scale (renderer->cr, 1.0 / FONT_SIZE_TWEAK, 1.0 / FONT_SIZE_TWEAK);
+
+  /* Only changes, and so lays the text out again, if the font options did */
+  if (!interactive->text_context) {
+    interactive->text_context = pango_cairo_create_context (renderer->cr);
+  } else {
+    pango_cairo_update_context (renderer->cr, interactive->text_context);
+  }
+  text_layout = text_layout_lookup (interactive, text_line, alignment);
+
+  x = pos->x - (double) text_layout->shift / PANGO_SCALE;
+  y = pos->y - (double) text_layout->baseline / PANGO_SCALE;
+  cairo_move_to (renderer->cr, x * FONT_SIZE_TWEAK, y * FONT_SIZE_TWEAK);
+  pango_cairo_show_layout (renderer->cr, text_layout->layout);
+
+  cairo_restore (renderer->cr);
+}
+
+
 static void
 dia_cairo_interactive_renderer_draw_text_line (DiaRenderer  *self,
                                                TextLine     *text_line,
@@ -275,6 +610,24 @@ dia_cairo_interactive_renderer_draw_text_line (DiaRenderer  *self,
   DiaCairoRenderer *renderer = DIA_CAIRO_RENDERER (self);
   DiaCairoInteractiveRenderer *interactive = DIA_CAIRO_INTERACTIVE_RENDERER (self);
 
+  if (interactive->min_text_size > 0.0 &&
+      !interactive->highlight_color &&
+      text_line_get_height (text_line) * *interactive->zoom_factor < interactive->min_text_size) {
+    /* Unreadable anyway, just hint where the text is without laying it out */
+    double h = text_line_get_height (text_line);
+    double width, ascent, adjustment;
+
+    text_line_get_rough_extents (text_line, alignment, &width, &ascent, &adjustment);
+
+    cairo_set_source_rgba (renderer->cr, color->red, color->green, color->blue, 0.3);
+    cairo_rectangle (renderer->cr,
+                     pos->x - adjustment, pos->y - ascent + h / 4,
+                     width, h / 2);
+    cairo_fill (renderer->cr);
+
+    return;
+  }
+
   if (interactive->highlight_color) {
     /* the high_light color is just taken as a hint, alternative needs
      * to have some contrast to cursor color (curently hard coded black)
@@ -318,7 +671,32 @@ dia_cairo_interactive_renderer_draw_text_line (DiaRenderer  *self,
     cairo_fill (renderer->cr);
   }
 
-  DIA_RENDERER_CLASS (dia_cairo_interactive_renderer_parent_class)->draw_text_line (self, text_line, pos, alignment, color);
+  draw_text_layout (interactive, text_line, pos, alignment, color);
+}
+
+static void
+dia_cairo_interactive_renderer_draw_object (DiaRenderer *self,
+                                            DiaObject   *object,
+                                            DiaMatrix   *matrix)
+{
+  DiaCairoInteractiveRenderer *interactive = DIA_CAIRO_INTERACTIVE_RENDERER (self);
+  const DiaRectangle *box = dia_object_get_enclosing_box (object);
+  double size = MAX (box->right - box->left, box->bottom - box->top);
+
+  if (interactive->min_object_size > 0.0 &&
+      matrix == NULL &&
+      !interactive->highlight_color &&
+      size * *interactive->zoom_factor < interactive->min_object_size) {
+    /* A few pixels, no need to go through all of the object's drawing */
+    Point ul = { box->left, box->top };
+    Point lr = { box->right, box->bottom };
+
+    dia_renderer_draw_rect (self, &ul, &lr, &lod_color, NULL);
+
+    return;
+  }
+
+  DIA_RENDERER_CLASS (dia_cairo_interactive_renderer_parent_class)->draw_object (self, object, matrix);
 }
 
 static void
@@ -346,9 +724,70 @@ dia_cairo_interactive_renderer_class_init (DiaCairoInteractiveRendererClass *kla
                                                          _("Visible rect pointer"),
                                                          G_PARAM_READWRITE));
 
+  /**
+   * DiaCairoInteractiveRenderer:min-object-size:
+   *
+   * Objects smaller than this many pixels are drawn as a box
+   *
+   * Since: 0.98
+   */
+  g_object_class_install_property (gobject_class,
+                                   PROP_MIN_OBJECT_SIZE,
+                                   g_param_spec_double ("min-object-size",
+                                                        _("Minimum object size"),
+                                                        _("Objects smaller than this are drawn as a box"),
+                                                        0.0, G_MAXDOUBLE, 0.0,
+                                                        G_PARAM_READWRITE));
+
+  /**
+   * DiaCairoInteractiveRenderer:min-text-size:
+   *
+   * Text lines lower than this many pixels are drawn as a bar
+   *
+   * Since: 0.98
+   */
+  g_object_class_install_property (gobject_class,
+                                   PROP_MIN_TEXT_SIZE,
+                                   g_param_spec_double ("min-text-size",
+                                                        _("Minimum text size"),
+                                                        _("Text lower than this is drawn as a bar"),
+                                                        0.0, G_MAXDOUBLE, 0.0,
+                                                        G_PARAM_READWRITE));
+
+  /**
+   * DiaCairoInteractiveRenderer:text-layouts-created:
+   *
+   * How often text had to be laid out
+   *
+   * Since: 0.98
+   */
+  g_object_class_install_property (gobject_class,
+                                   PROP_TEXT_LAYOUTS_CREATED,
+                                   g_param_spec_uint64 ("text-layouts-created",
+                                                        _("Text layouts created"),
+                                                        _("How often text had to be laid out"),
+                                                        0, G_MAXUINT64, 0,
+                                                        G_PARAM_READABLE));
+
+  /**
+   * DiaCairoInteractiveRenderer:text-layouts-reused:
+   *
+   * How often text was drawn with the layout of an earlier frame
+   *
+   * Since: 0.98
+   */
+  g_object_class_install_property (gobject_class,
+                                   PROP_TEXT_LAYOUTS_REUSED,
+                                   g_param_spec_uint64 ("text-layouts-reused",
+                                                        _("Text layouts reused"),
+                                                        _("How often text was drawn with an earlier layout"),
+                                                        0, G_MAXUINT64, 0,
+                                                        G_PARAM_READABLE));
+
   /* renderer members */
   renderer_class->begin_render = dia_cairo_interactive_renderer_begin_render;
   renderer_class->end_render   = dia_cairo_interactive_renderer_end_render;
+  renderer_class->draw_object  = dia_cairo_interactive_renderer_draw_object;
 
   /* mostly for cursor placement */
   renderer_class->get_text_width = dia_cairo_interactive_renderer_get_text_width;
@@ -465,6 +904,25 @@ dia_cairo_interactive_renderer_fill_pixel_rect (DiaInteractiveRenderer *object,
   cairo_fill (renderer->cr);
 }
 
+static void
+dia_cairo_interactive_renderer_fill_pixel_pattern (DiaInteractiveRenderer *object,
+                                                   int                     x,
+                                                   int                     y,
+                                                   int                     width,
+                                                   int                     height,
+                                                   cairo_pattern_t        *pattern)
+{
+  DiaCairoRenderer *renderer = DIA_CAIRO_RENDERER (object);
+
+  /* Both the rectangle and the pattern are in pixels */
+  cairo_save (renderer->cr);
+  cairo_identity_matrix (renderer->cr);
+  cairo_rectangle (renderer->cr, x, y, width, height);
+  cairo_set_source (renderer->cr, pattern);
+  cairo_fill (renderer->cr);
+  cairo_restore (renderer->cr);
+}
+
 static void
 dia_cairo_interactive_renderer_paint (DiaInteractiveRenderer *object,
                                       cairo_t                *ctx,
@@ -517,9 +975,15 @@ dia_cairo_interactive_renderer_set_size (DiaInteractiveRenderer *object,
   renderer->width = width;
   renderer->height = height;
   g_clear_pointer (&renderer->surface, cairo_surface_destroy);
-  renderer->surface = gdk_window_create_similar_surface (GDK_WINDOW (window),
-                                                         CAIRO_CONTENT_COLOR,
-                                                         width, height);
+  if (window) {
+    renderer->surface = gdk_window_create_similar_surface (GDK_WINDOW (window),
+                                                           CAIRO_CONTENT_COLOR,
+                                                           width, height);
+  } else {
+    /* Without a display, e.g. for benchmarks */
+    renderer->surface = cairo_image_surface_create (CAIRO_FORMAT_RGB24,
+                                                    width, height);
+  }
 
   g_clear_pointer (&base_renderer->surface, cairo_surface_destroy);
 }
@@ -572,6 +1036,210 @@ dia_cairo_interactive_renderer_set_selection (DiaInteractiveRenderer *renderer,
   self->selection_height = height;
 }
 
+/* Draws @missing of @layer into it's cache */
+static void
+layer_cache_render (DiaCairoInteractiveRenderer *renderer,
+                    LayerCache                  *cache,
+                    DiaLayer                    *layer,
+                    cairo_region_t              *missing,
+                    ObjectRenderer               obj_renderer,
+                    gpointer                     data)
+{
+  DiaCairoRenderer *base_renderer = DIA_CAIRO_RENDERER (renderer);
+  cairo_rectangle_int_t extents;
+  DiaRectangle update;
+  double zoom = *renderer->zoom_factor;
+  cairo_t *cr;
+
+  cairo_region_get_extents (missing, &extents);
+  update.left = renderer->visible->left + extents.x / zoom;
+  update.top = renderer->visible->top + extents.y / zoom;
+  update.right = renderer->visible->left + (extents.x + extents.width) / zoom;
+  update.bottom = renderer->visible->top + (extents.y + extents.height) / zoom;
+
+  /* Same as begin_render(), but on the cache */
+  cr = base_renderer->cr;
+  base_renderer->cr = cairo_create (cache->surface);
+
+  _gdk_cairo_region (base_renderer->cr, missing);
+  cairo_clip (base_renderer->cr);
+  cairo_set_operator (base_renderer->cr, CAIRO_OPERATOR_CLEAR);
+  cairo_paint (base_renderer->cr);
+  cairo_set_operator (base_renderer->cr, CAIRO_OPERATOR_OVER);
+
+  cairo_scale (base_renderer->cr, zoom, zoom);
+  cairo_translate (base_renderer->cr, -renderer->visible->left, -renderer->visible->top);
+  cairo_set_fill_rule (base_renderer->cr, CAIRO_FILL_RULE_EVEN_ODD);
+
+  dia_layer_render (layer,
+                    DIA_RENDERER (renderer),
+                    &update,
+                    obj_renderer,
+                    data,
+                    FALSE);
+
+  g_clear_pointer (&base_renderer->cr, cairo_destroy);
+  base_renderer->cr = cr;
+
+  cairo_region_union (cache->valid, missing);
+}
+
+
+static void
+dia_cairo_interactive_renderer_draw_layer_cached (DiaInteractiveRenderer *object,
+                                                  DiaLayer               *layer,
+                                                  DiaRectangle           *update,
+                                                  ObjectRenderer          obj_renderer,
+                                                  gpointer                data)
+{
+  DiaCairoInteractiveRenderer *renderer = DIA_CAIRO_INTERACTIVE_RENDERER (object);
+  DiaCairoRenderer *base_renderer = DIA_CAIRO_RENDERER (object);
+  LayerCache *cache = g_hash_table_lookup (renderer->layer_caches, layer);
+  cairo_rectangle_int_t viewport = { 0, 0, renderer->width, renderer->height };
+  cairo_region_t *missing;
+  guint64 changes;
+  double x_scale, y_scale;
+  int pixel_width, pixel_height;
+  gsize size;
+
+  g_return_if_fail (base_renderer->cr != NULL);
+
+  /* As sharp as the window, which may have more than a pixel per unit */
+  cairo_surface_get_device_scale (renderer->surface, &x_scale, &y_scale);
+  pixel_width = ceil (renderer->width * x_scale);
+  pixel_height = ceil (renderer->height * y_scale);
+  size = (gsize) cairo_format_stride_for_width (CAIRO_FORMAT_ARGB32, pixel_width) *
+           pixel_height;
+
+  if (layer_caches_size (renderer, cache) + size > MAX_LAYER_CACHE_BYTES) {
+    /* No room next to the others, e.g. after the window grew */
+    if (cache) {
+      layer_cache_remove (renderer, layer);
+    }
+
+    dia_layer_render (layer, DIA_RENDERER (object), update, obj_renderer, data, FALSE);
+    return;
+  }
+
+  if (cache == NULL) {
+    cache = g_new0 (LayerCache, 1);
+    cache->valid = cairo_region_create ();
+    g_hash_table_insert (renderer->layer_caches, layer, cache);
+    g_object_weak_ref (G_OBJECT (layer), layer_cache_layer_gone, renderer);
+  }
+
+  changes = dia_layer_get_changes (layer);
+
+  if (cache->surface == NULL ||
+      cache->width != renderer->width ||
+      cache->height != renderer->height ||
+      cache->x_scale != x_scale ||
+      cache->y_scale != y_scale) {
+    g_clear_pointer (&cache->surface, cairo_surface_destroy);
+    cache->surface = cairo_surface_create_similar_image (renderer->surface,
+                                                         CAIRO_FORMAT_ARGB32,
+                                                         pixel_width,
+                                                         pixel_height);
+    cairo_surface_set_device_scale (cache->surface, x_scale, y_scale);
+    cache->size = size;
+    cache->width = renderer->width;
+    cache->height = renderer->height;
+    cache->x_scale = x_scale;
+    cache->y_scale = y_scale;
+    g_clear_pointer (&cache->valid, cairo_region_destroy);
+    cache->valid = cairo_region_create ();
+  } else if (cache->changes != changes ||
+             cache->zoom_factor != *renderer->zoom_factor ||
+             !rectangle_equals (&cache->visible, renderer->visible)) {
+    g_clear_pointer (&cache->valid, cairo_region_destroy);
+    cache->valid = cairo_region_create ();
+  }
+
+  cache->changes = changes;
+  cache->zoom_factor = *renderer->zoom_factor;
+  cache->visible = *renderer->visible;
+
+  /* Only draw what's needed now, the rest may never be looked at */
+  missing = cairo_region_create_rectangle (&viewport);
+  if (renderer->clip_region) {
+    cairo_region_intersect (missing, renderer->clip_region);
+  }
+  cairo_region_subtract (missing, cache->valid);
+
+  if (!cairo_region_is_empty (missing)) {
+    layer_cache_render (renderer, cache, layer, missing, obj_renderer, data);
+  }
+
+  cairo_region_destroy (missing);
+
+  /* Still clipped to what is updated */
+  cairo_save (base_renderer->cr);
+  cairo_identity_matrix (base_renderer->cr);
+  cairo_set_source_surface (base_renderer->cr, cache->surface, 0, 0);
+  cairo_paint (base_renderer->cr);
+  cairo_restore (base_renderer->cr);
+}
+
+
+/* Moves the content of @surface by @dx, @dy pixels, what's uncovered is cleared */
+static void
+shift_surface (cairo_surface_t *surface, int dx, int dy)
+{
+  cairo_t *cr = cairo_create (surface);
+
+  /* Drawing a surface onto itself isn't supported, go through a group */
+  cairo_push_group_with_content (cr, cairo_surface_get_content (surface));
+  cairo_set_source_surface (cr, surface, dx, dy);
+  cairo_paint (cr);
+  cairo_pop_group_to_source (cr);
+  cairo_set_operator (cr, CAIRO_OPERATOR_SOURCE);
+  cairo_paint (cr);
+
+  cairo_destroy (cr);
+}
+
+
+static gboolean
+dia_cairo_interactive_renderer_scroll (DiaInteractiveRenderer *object,
+                                       int                     dx,
+                                       int                     dy)
+{
+  DiaCairoInteractiveRenderer *renderer = DIA_CAIRO_INTERACTIVE_RENDERER (object);
+  cairo_rectangle_int_t viewport = { 0, 0, renderer->width, renderer->height };
+  double zoom = *renderer->zoom_factor;
+  GHashTableIter iter;
+  LayerCache *cache;
+
+  if (renderer->surface == NULL || DIA_CAIRO_RENDERER (object)->cr != NULL) {
+    return FALSE;
+  }
+
+  shift_surface (renderer->surface, -dx, -dy);
+
+  /* The caches keep what is still visible, too */
+  g_hash_table_iter_init (&iter, renderer->layer_caches);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &cache)) {
+    if (cache->surface == NULL || cache->zoom_factor != zoom) {
+      continue;
+    }
+
+    /* Only if it was drawn for where we scrolled from */
+    if (fabs (cache->visible.left + dx / zoom - renderer->visible->left) < 0.01 / zoom &&
+        fabs (cache->visible.top + dy / zoom - renderer->visible->top) < 0.01 / zoom) {
+      shift_surface (cache->surface, -dx, -dy);
+      cairo_region_translate (cache->valid, -dx, -dy);
+      cairo_region_intersect_rectangle (cache->valid, &viewport);
+    } else {
+      g_clear_pointer (&cache->valid, cairo_region_destroy);
+      cache->valid = cairo_region_create ();
+    }
+    cache->visible = *renderer->visible;
+  }
+
+  return TRUE;
+}
+
+
 static void
 dia_cairo_interactive_renderer_iface_init (DiaInteractiveRendererInterface* iface)
 {
@@ -586,6 +1254,10 @@ dia_cairo_interactive_renderer_iface_init (DiaInteractiveRendererInterface* ifac
   iface->set_size                = dia_cairo_interactive_renderer_set_size;
   iface->draw_object_highlighted = dia_cairo_interactive_renderer_draw_object_highlighted;
   iface->set_selection           = dia_cairo_interactive_renderer_set_selection;
+  iface->draw_layer_cached       = dia_cairo_interactive_renderer_draw_layer_cached;
+  iface->invalidate_layers       = dia_cairo_interactive_renderer_invalidate_layers;
+  iface->scroll                  = dia_cairo_interactive_renderer_scroll;
+  iface->fill_pixel_pattern      = dia_cairo_interactive_renderer_fill_pixel_pattern;
 }
 
 
@@ -79,8 +79,10 @@ dia_cairo_renderer_begin_render (DiaRenderer *self, const DiaRectangle *update)
   DiaCairoRenderer *renderer = DIA_CAIRO_RENDERER (self);
   real onedu = 0.0;
   real lmargin = 0.0, tmargin = 0.0;
-  gboolean paginated = renderer->surface && /* only with our own pagination, not GtkPrint */
-    cairo_surface_get_type (renderer->surface) == CAIRO_SURFACE_TYPE_PDF && !renderer->skip_show_page;
+  gboolean pdf = renderer->surface &&
+    cairo_surface_get_type (renderer->surface) == CAIRO_SURFACE_TYPE_PDF;
+  /* only with our own pagination, not GtkPrint */
+  gboolean paginated = (pdf && !renderer->skip_show_page) || renderer->page_recording;
   DiaColour background = DIA_COLOUR_WHITE;
 
   if (renderer->surface && !renderer->cr) {
@@ -103,7 +105,9 @@ dia_cairo_renderer_begin_render (DiaRenderer *self, const DiaRectangle *update)
            * (72.0 / 2.54) + 0.5;
     /* "Changes the size of a PDF surface for the current (and
      * subsequent) pages." Pagination setup? */
-    cairo_pdf_surface_set_size (renderer->surface, width, height);
+    if (pdf) {
+      cairo_pdf_surface_set_size (renderer->surface, width, height);
+    }
     lmargin = data->paper.lmargin / data->paper.scaling;
     tmargin = data->paper.tmargin / data->paper.scaling;
   }
@@ -355,11 +359,20 @@ dia_cairo_renderer_draw_object (DiaRenderer *self,
 {
   DiaCairoRenderer *renderer = DIA_CAIRO_RENDERER (self);
   cairo_matrix_t before;
+  /* other pages are drawn at the same time, the object must not change */
+  GRecMutex *lock = renderer->shared_lock &&
+                    !rectangle_in_rectangle (&renderer->page,
+                                             dia_object_get_enclosing_box (object)) ?
+                      renderer->shared_lock : NULL;
+
+  if (lock) {
+    g_rec_mutex_lock (lock);
+  }
 
   if (matrix) {
     /* at least in SVG the intent of an invalid matrix is not rendering */
     if (!dia_matrix_is_invertible (matrix)) {
-      return;
+      goto out;
     }
     cairo_get_matrix (renderer->cr, &before);
     g_assert (sizeof (cairo_matrix_t) == sizeof (DiaMatrix));
@@ -369,6 +382,11 @@ dia_cairo_renderer_draw_object (DiaRenderer *self,
   if (matrix) {
     cairo_set_matrix (renderer->cr, &before);
   }
+
+out:
+  if (lock) {
+    g_rec_mutex_unlock (lock);
+  }
 }
 
 /*!
@@ -1067,6 +1085,23 @@ dia_cairo_renderer_draw_string (DiaRenderer  *self,
   DIAG_STATE (renderer->cr)
 }
 
+/* Drawing to pixels, rather than recording for a document */
+static gboolean
+_is_raster_target (cairo_t *cr)
+{
+  switch (cairo_surface_get_type (cairo_get_target (cr))) {
+    case CAIRO_SURFACE_TYPE_PDF:
+    case CAIRO_SURFACE_TYPE_PS:
+    case CAIRO_SURFACE_TYPE_SVG:
+    case CAIRO_SURFACE_TYPE_WIN32_PRINTING:
+    case CAIRO_SURFACE_TYPE_SCRIPT:
+    case CAIRO_SURFACE_TYPE_RECORDING:
+      return FALSE;
+    default:
+      return TRUE;
+  }
+}
+
 static void
 dia_cairo_renderer_draw_rotated_image (DiaRenderer *self,
                                        Point       *point,
@@ -1076,17 +1111,32 @@ dia_cairo_renderer_draw_rotated_image (DiaRenderer *self,
                                        DiaImage    *image)
 {
   DiaCairoRenderer *renderer = DIA_CAIRO_RENDERER (self);
-  int w = dia_image_width (image);
-  int h = dia_image_height (image);
+  double dev_wx = width, dev_wy = 0.0, dev_hx = 0.0, dev_hy = height;
+  cairo_surface_t *surface;
+  int w, h;
+
+  if (_is_raster_target (renderer->cr)) {
+    /* no more pixels than it's going to cover */
+    cairo_user_to_device_distance (renderer->cr, &dev_wx, &dev_wy);
+    cairo_user_to_device_distance (renderer->cr, &dev_hx, &dev_hy);
+    surface = dia_image_get_surface_for_size (image,
+                                              hypot (dev_wx, dev_wy),
+                                              hypot (dev_hx, dev_hy));
+  } else {
+    /* a document keeps all of it, to be printed or zoomed into */
+    surface = dia_image_get_surface (image);
+  }
+  w = cairo_image_surface_get_width (surface);
+  h = cairo_image_surface_get_height (surface);
 
-  DIAG_NOTE (g_message ("draw_image %fx%f [%d(%d),%d] @%f,%f",
-                        width, height, w, rs, h, point->x, point->y));
+  DIAG_NOTE (g_message ("draw_image %fx%f [%d,%d] @%f,%f",
+                        width, height, w, h, point->x, point->y));
 
   cairo_save (renderer->cr);
   cairo_translate (renderer->cr, point->x, point->y);
   cairo_scale (renderer->cr, width / w, height / h);
   cairo_move_to (renderer->cr, 0.0, 0.0);
-  cairo_set_source_surface (renderer->cr, dia_image_get_surface (image), 0.0, 0.0);
+  cairo_set_source_surface (renderer->cr, surface, 0.0, 0.0);
 
   if (angle != 0.0) {
     DiaMatrix rotate;
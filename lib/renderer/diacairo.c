@@ -56,6 +56,7 @@
 #include "geometry.h"
 #include "dia_image.h"
 #include "diarenderer.h"
+#include "dia-layer.h"
 #include "filter.h"
 #include "plug-ins.h"
 
@@ -68,6 +69,160 @@
 #endif
 
 
+#ifdef CAIRO_HAS_PDF_SURFACE
+/*
+ * The pages of a PDF are independent, so they are drawn in parallel each
+ * into a recording surface of their own.  Only writing them to the file,
+ * in order, is left to the calling thread.
+ */
+typedef struct _PageJob PageJob;
+struct _PageJob {
+  DiagramData          *data;
+  GArray               *pages;
+  real                  scale;
+  cairo_rectangle_t     extents;
+  cairo_font_options_t *font_options;
+  /* for objects drawn on more than one page */
+  GRecMutex             shared_lock;
+  /* filled by the workers, in any order */
+  cairo_surface_t     **recordings;
+  GMutex                lock;
+  GCond                 done;
+};
+
+
+static void
+_render_page (gpointer page, gpointer user_data)
+{
+  PageJob *job = user_data;
+  guint i = GPOINTER_TO_UINT (page) - 1;
+  cairo_surface_t *recording;
+  DiaCairoRenderer *renderer;
+
+  recording = cairo_recording_surface_create (CAIRO_CONTENT_COLOR_ALPHA,
+                                              &job->extents);
+
+  renderer = g_object_new (DIA_CAIRO_TYPE_RENDERER, NULL);
+  renderer->dia = job->data;
+  renderer->scale = job->scale;
+  renderer->surface = cairo_surface_reference (recording);
+  renderer->cr = cairo_create (recording);
+  renderer->skip_show_page = TRUE;
+  renderer->page_recording = TRUE;
+  renderer->page = g_array_index (job->pages, DiaRectangle, i);
+  renderer->shared_lock = &job->shared_lock;
+  /* lay out the text as the PDF surface would */
+  cairo_set_font_options (renderer->cr, job->font_options);
+
+  data_render (job->data,
+               DIA_RENDERER (renderer),
+               &g_array_index (job->pages, DiaRectangle, i),
+               NULL,
+               NULL);
+
+  g_clear_object (&renderer);
+
+  g_mutex_lock (&job->lock);
+  job->recordings[i] = recording;
+  g_cond_broadcast (&job->done);
+  g_mutex_unlock (&job->lock);
+}
+
+
+/**
+ * cairo_export_pages:
+ * @data: the diagram
+ * @renderer: a #DiaCairoRenderer with a PDF surface
+ * @width: the page width, in points
+ * @height: the page height, in points
+ * @n_threads: how many pages to draw at once
+ *
+ * data_render_paginated() for @renderer's surface, drawing each page into a
+ * recording surface first.  The result does not depend on @n_threads.
+ *
+ * Since: 0.98
+ */
+void
+cairo_export_pages (DiagramData      *data,
+                    DiaCairoRenderer *renderer,
+                    double            width,
+                    double            height,
+                    guint             n_threads)
+{
+  PageJob job = { NULL, };
+  GThreadPool *pool = NULL;
+  cairo_t *cr;
+
+  g_return_if_fail (cairo_surface_get_type (renderer->surface) == CAIRO_SURFACE_TYPE_PDF);
+
+  job.pages = data_get_page_bounds (data);
+  job.data = data;
+  job.scale = renderer->scale;
+  job.extents.width = width;
+  job.extents.height = height;
+  job.font_options = cairo_font_options_create ();
+  cairo_surface_get_font_options (renderer->surface, job.font_options);
+  job.recordings = g_new0 (cairo_surface_t *, job.pages->len);
+  g_rec_mutex_init (&job.shared_lock);
+  g_mutex_init (&job.lock);
+  g_cond_init (&job.done);
+
+  /* Loading deferred objects changes the layer, not while drawing */
+  DIA_FOR_LAYER_IN_DIAGRAM (data, layer, i, {
+    if (dia_layer_is_visible (layer)) {
+      dia_layer_get_object_list (layer);
+    }
+  });
+
+  n_threads = MIN (n_threads, job.pages->len);
+  if (n_threads > 1) {
+    /* not exclusive, so it can't fail */
+    pool = g_thread_pool_new (_render_page, &job, n_threads, FALSE, NULL);
+    for (guint i = 0; i < job.pages->len; i++) {
+      /* not NULL */
+      g_thread_pool_push (pool, GUINT_TO_POINTER (i + 1), NULL);
+    }
+  }
+
+  cr = cairo_create (renderer->surface);
+  for (guint i = 0; i < job.pages->len; i++) {
+    cairo_surface_t *recording;
+
+    if (!pool) {
+      _render_page (GUINT_TO_POINTER (i + 1), &job);
+    }
+
+    g_mutex_lock (&job.lock);
+    while (!job.recordings[i]) {
+      g_cond_wait (&job.done, &job.lock);
+    }
+    recording = g_steal_pointer (&job.recordings[i]);
+    g_mutex_unlock (&job.lock);
+
+    cairo_pdf_surface_set_size (renderer->surface, width, height);
+    cairo_set_source_surface (cr, recording, 0, 0);
+    cairo_paint (cr);
+    cairo_show_page (cr);
+
+    cairo_surface_destroy (recording);
+  }
+  DIAG_STATE (cr)
+  cairo_destroy (cr);
+
+  if (pool) {
+    g_thread_pool_free (pool, FALSE, TRUE);
+  }
+
+  g_cond_clear (&job.done);
+  g_mutex_clear (&job.lock);
+  g_rec_mutex_clear (&job.shared_lock);
+  g_clear_pointer (&job.recordings, g_free);
+  g_clear_pointer (&job.font_options, cairo_font_options_destroy);
+  g_array_unref (job.pages);
+}
+#endif
+
+
 /* dia export funtion */
 gboolean
 cairo_export_data (DiagramData *data,
@@ -262,7 +417,11 @@ cairo_export_data (DiagramData *data,
             data->extents.left, data->extents.top, data->extents.right, data->extents.bottom));
 
   if (OUTPUT_PDF == kind)
+#ifdef CAIRO_HAS_PDF_SURFACE
+    cairo_export_pages (data, renderer, width, height, g_get_num_processors ());
+#else
     data_render_paginated(data, DIA_RENDERER(renderer), NULL);
+#endif
   else
     data_render(data, DIA_RENDERER(renderer), NULL, NULL, NULL);
 
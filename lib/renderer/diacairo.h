@@ -70,6 +70,9 @@ struct _DiaCairoRenderer
   real scale;
   gboolean with_alpha; /*!< define to TRUE for transparent background */
   gboolean skip_show_page; /*!< when using for print avoid the internal show_page */
+  gboolean page_recording; /*!< drawing a single page to replay later, see cairo_export_pages() */
+  DiaRectangle page; /*!< the page drawn when page_recording */
+  GRecMutex *shared_lock; /*!< held to draw objects not only on this page */
   gboolean stroke_pending; /*!< to delay call to cairo_stroke */
 
   /** caching the font description from set_font */
@@ -107,5 +110,10 @@ gboolean cairo_export_data (DiagramData *data,
                             const gchar *filename,
                             const gchar *diafilename,
                             void        *user_data);
+void     cairo_export_pages (DiagramData      *data,
+                             DiaCairoRenderer *renderer,
+                             double            width,
+                             double            height,
+                             guint             n_threads);
 
 G_END_DECLS
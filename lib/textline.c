@@ -239,6 +239,66 @@ text_line_get_alignment_adjustment (TextLine *text_line, DiaAlignment alignment)
   }
 }
 
+/* Pages of an export may be drawn in parallel, see cairo_export_data(),
+ * an object on a page boundary by more than one thread at once.
+ */
+G_LOCK_DEFINE_STATIC (cache_values);
+
+
+/**
+ * text_line_get_rough_extents:
+ * @text_line: a line of text
+ * @alignment: how to align it
+ * @width: (out): where to store the width
+ * @ascent: (out): where to store the ascent
+ * @adjustment: (out): where to store the alignment adjustment
+ *
+ * Like text_line_get_width() and friends but never lays the text out. The
+ * measured values are used if they are already known, otherwise they are
+ * guessed from the number of characters and the height.
+ *
+ * Good enough for text too small to be read.
+ *
+ * Since: 0.98
+ */
+void
+text_line_get_rough_extents (TextLine     *text_line,
+                             DiaAlignment  alignment,
+                             double       *width,
+                             double       *ascent,
+                             double       *adjustment)
+{
+  /* Measured by another thread meanwhile, see text_line_cache_values() */
+  G_LOCK (cache_values);
+  if (text_line->clean &&
+      text_line->chars == text_line->chars_cache &&
+      text_line->font == text_line->font_cache &&
+      text_line->height == text_line->height_cache) {
+    *width = text_line->width;
+    *ascent = text_line->ascent;
+  } else {
+    /* Typical proportions, a character is about half as wide as high */
+    *width = text_line->chars ?
+               g_utf8_strlen (text_line->chars, -1) * text_line->height * 0.5 :
+               0.0;
+    *ascent = text_line->height * 0.8;
+  }
+  G_UNLOCK (cache_values);
+
+  switch (alignment) {
+    case DIA_ALIGN_CENTRE:
+      *adjustment = *width / 2;
+      break;
+    case DIA_ALIGN_RIGHT:
+      *adjustment = *width;
+      break;
+    case DIA_ALIGN_LEFT:
+    default:
+      *adjustment = 0.0;
+      break;
+  }
+}
+
 /* **** Private functions **** */
 
 /**
@@ -276,39 +336,68 @@ clear_layout_offset (TextLine *text_line)
 static void
 text_line_cache_values(TextLine *text_line)
 {
-  if (!text_line->clean ||
-      text_line->chars != text_line->chars_cache ||
-      text_line->font != text_line->font_cache ||
-      text_line->height != text_line->height_cache) {
-    int n_offsets;
+  TextLine measured = { NULL, };
+  gboolean dirty;
+  int n_offsets;
+
+  G_LOCK (cache_values);
+  dirty = !text_line->clean ||
+          text_line->chars != text_line->chars_cache ||
+          text_line->font != text_line->font_cache ||
+          text_line->height != text_line->height_cache;
+  measured.chars = text_line->chars;
+  measured.font = text_line->font;
+  measured.height = text_line->height;
+  G_UNLOCK (cache_values);
+
+  if (!dirty) {
+    return;
+  }
+
+  /* Measure without holding the lock, every thread has its own PangoContext */
+  if (measured.chars == NULL ||
+      measured.chars[0] == '\0') {
+    /* caclculate reasonable ascent/decent even for empty string */
+    measured.offsets =
+      dia_font_get_sizes("XjgM149", measured.font, measured.height,
+                         &measured.width, &measured.ascent,
+                         &measured.descent, &n_offsets,
+                         &measured.layout_offsets);
+    clear_layout_offset (&measured);
+    g_clear_pointer (&measured.offsets, g_free);
+    measured.offsets = g_new (real,0); /* another way to assign NULL;) */
+    measured.width = 0;
+  } else {
+    measured.offsets =
+      dia_font_get_sizes(measured.chars, measured.font, measured.height,
+                         &measured.width, &measured.ascent,
+                         &measured.descent, &n_offsets,
+                         &measured.layout_offsets);
+  }
 
+  G_LOCK (cache_values);
+  /* Another thread drawing the same object may have been faster */
+  if (!text_line->clean ||
+      text_line->chars_cache != measured.chars ||
+      text_line->font_cache != measured.font ||
+      text_line->height_cache != measured.height) {
     g_clear_pointer (&text_line->offsets, g_free);
     clear_layout_offset (text_line);
 
-    if (text_line->chars == NULL ||
-	text_line->chars[0] == '\0') {
-      /* caclculate reasonable ascent/decent even for empty string */
-      text_line->offsets =
-        dia_font_get_sizes("XjgM149", text_line->font, text_line->height,
-			   &text_line->width, &text_line->ascent,
-			   &text_line->descent, &n_offsets,
-			   &text_line->layout_offsets);
-      clear_layout_offset (text_line);
-      g_clear_pointer (&text_line->offsets, g_free);
-      text_line->offsets = g_new (real,0); /* another way to assign NULL;) */
-      text_line->width = 0;
-    } else {
-      text_line->offsets =
-	dia_font_get_sizes(text_line->chars, text_line->font, text_line->height,
-			   &text_line->width, &text_line->ascent,
-			   &text_line->descent, &n_offsets,
-			   &text_line->layout_offsets);
-    }
+    text_line->offsets = g_steal_pointer (&measured.offsets);
+    text_line->layout_offsets = g_steal_pointer (&measured.layout_offsets);
+    text_line->width = measured.width;
+    text_line->ascent = measured.ascent;
+    text_line->descent = measured.descent;
     text_line->clean = TRUE;
-    text_line->chars_cache = text_line->chars;
-    text_line->font_cache = text_line->font;
-    text_line->height_cache = text_line->height;
+    text_line->chars_cache = measured.chars;
+    text_line->font_cache = measured.font;
+    text_line->height_cache = measured.height;
   }
+  G_UNLOCK (cache_values);
+
+  g_clear_pointer (&measured.offsets, g_free);
+  clear_layout_offset (&measured);
 }
 
 /*!
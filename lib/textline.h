@@ -93,5 +93,10 @@ void          text_line_adjust_layout_line           (TextLine         *line,
                                                       double            scale);
 double        text_line_get_alignment_adjustment     (TextLine         *text_line,
                                                       DiaAlignment      alignment);
+void          text_line_get_rough_extents            (TextLine         *text_line,
+                                                      DiaAlignment      alignment,
+                                                      double           *width,
+                                                      double           *ascent,
+                                                      double           *adjustment);
 
 G_END_DECLS
@@ -572,19 +572,16 @@ transform_rect(Custom *custom, const DiaRectangle *r1, DiaRectangle *out)
 static double
 custom_distance_from (Custom *custom, Point *point)
 {
-  static GArray *arr = NULL, *barr = NULL;
+  GArray *arr, *barr;
   Point p1, p2;
   DiaRectangle rect;
   gint i;
   GList *tmp;
   real min_dist = G_MAXFLOAT, dist = G_MAXFLOAT;
 
-  if (!arr) {
-    arr = g_array_new (FALSE, FALSE, sizeof(Point));
-  }
-  if (!barr) {
-    barr = g_array_new (FALSE, FALSE, sizeof(BezPoint));
-  }
+  /* not static, objects may be drawn from several threads */
+  arr = g_array_new (FALSE, FALSE, sizeof (Point));
+  barr = g_array_new (FALSE, FALSE, sizeof (BezPoint));
 
   for (tmp = custom->info->display_list; tmp != NULL; tmp = tmp->next) {
     GraphicElement *el = tmp->data;
@@ -729,6 +726,9 @@ custom_distance_from (Custom *custom, Point *point)
     min_dist = MIN (min_dist, dist);
   }
 
+  g_array_unref (arr);
+  g_array_unref (barr);
+
   return min_dist;
 }
 
@@ -921,7 +921,7 @@ get_colour (Custom *custom, DiaColour *colour, gint32 c, double opacity)
 static void
 custom_draw (Custom *custom, DiaRenderer *renderer)
 {
-  static GArray *arr = NULL, *barr = NULL;
+  GArray *arr, *barr;
   double cur_line = 1.0, cur_dash = 1.0;
   DiaLineCaps cur_caps = DIA_LINE_CAPS_BUTT;
   DiaLineJoin cur_join = DIA_LINE_JOIN_MITER;
@@ -930,12 +930,9 @@ custom_draw (Custom *custom, DiaRenderer *renderer)
   g_return_if_fail (custom != NULL);
   g_return_if_fail (renderer != NULL);
 
-  if (!arr) {
-    arr = g_array_new (FALSE, FALSE, sizeof(Point));
-  }
-  if (!barr) {
-    barr = g_array_new (FALSE, FALSE, sizeof(BezPoint));
-  }
+  /* not static, the pages of an export may be drawn in parallel */
+  arr = g_array_new (FALSE, FALSE, sizeof (Point));
+  barr = g_array_new (FALSE, FALSE, sizeof (BezPoint));
 
   dia_renderer_set_fillstyle (renderer, DIA_FILL_STYLE_SOLID);
   dia_renderer_set_linewidth (renderer, custom->border_width);
@@ -961,6 +958,9 @@ custom_draw (Custom *custom, DiaRenderer *renderer)
   if (custom->info->has_text) {
     dia_text_draw (custom->text, renderer);
   }
+
+  g_array_unref (arr);
+  g_array_unref (barr);
 }
 
 
@@ -1111,7 +1111,12 @@ custom_draw_element (GraphicElement *el,
       break;
     case GE_TEXT:
       {
+        /* el->text is shared by all objects of this shape, which may be
+         * drawn from several threads at once */
+        static GMutex text_lock;
         DiaColour text_colour;
+
+        g_mutex_lock (&text_lock);
         dia_text_set_height (el->text.object,
                              custom_transform_length (custom, el->text.s.font_height));
         custom_reposition_text (custom, &el->text);
@@ -1122,6 +1127,7 @@ custom_draw_element (GraphicElement *el,
         dia_text_set_colour (el->text.object, &text_colour);
         dia_text_draw (el->text.object, renderer);
         dia_text_set_position (el->text.object, &el->text.anchor);
+        g_mutex_unlock (&text_lock);
       }
       break;
     case GE_ELLIPSE:
@@ -1321,7 +1327,7 @@ custom_update_data(Custom *custom, AnchorShape horiz, AnchorShape vert)
   DiaObject *obj = &elem->object;
   Point center, bottom_right;
   Point p;
-  static GArray *arr = NULL, *barr = NULL;
+  GArray *arr, *barr;
 
   int i;
   GList *tmp;
@@ -1498,10 +1504,8 @@ custom_update_data(Custom *custom, AnchorShape horiz, AnchorShape vert)
   element_update_boundingbox(elem);
 
   /* Merge in the bounding box of every individual element */
-  if (!arr)
-    arr = g_array_new(FALSE, FALSE, sizeof(Point));
-  if (!barr)
-    barr = g_array_new(FALSE, FALSE, sizeof(BezPoint));
+  arr = g_array_new (FALSE, FALSE, sizeof (Point));
+  barr = g_array_new (FALSE, FALSE, sizeof (BezPoint));
 
   for (tmp = custom->info->display_list; tmp != NULL; tmp = tmp->next) {
     GraphicElement *el = tmp->data;
@@ -1631,6 +1635,8 @@ custom_update_data(Custom *custom, AnchorShape horiz, AnchorShape vert)
     }
     rectangle_union(&obj->bounding_box,&rect);
   }
+  g_array_unref (arr);
+  g_array_unref (barr);
 
   /* extend bounding box to include text bounds ... */
   if (info->has_text) {
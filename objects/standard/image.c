@@ -241,7 +241,8 @@ image_set_props (Image *image, GPtrArray *props)
       image->inline_data = TRUE;
     } else if (old_pixbuf != image->pixbuf && image->pixbuf) { /* substitute the image and pixbuf */
       DiaImage *old_image = image->image;
-      image->image = dia_image_new_from_pixbuf (image->pixbuf);
+      /* pasting the same picture again and again keeps one copy */
+      image->image = dia_image_new_shared (image->pixbuf);
       image->pixbuf = g_object_ref ((GdkPixbuf *)dia_image_pixbuf (image->image));
       g_clear_object (&old_image);
       image->inline_data = TRUE;
@@ -252,7 +253,17 @@ image_set_props (Image *image, GPtrArray *props)
   } else if (was_inline && !image->inline_data) { /* switch off inline */
     if (old_file && image->file && strcmp (old_file, image->file) != 0) {
        /* export inline data, if saving fails we keep it inline */
-       image->inline_data = !dia_image_save (image->image, image->file);
+       DiaImage *img = NULL;
+
+       if (dia_image_save (image->image, image->file)) {
+         /* the saved one may be shared, only this object refers to the file */
+         img = dia_image_load (image->file);
+       }
+       if (img) {
+         g_clear_object (&image->image);
+         image->image = img;
+       }
+       image->inline_data = img == NULL;
     } else if (!image->file) {
        message_warning (_("Can't save image without filename"));
        image->inline_data = TRUE; /* keep inline */
@@ -759,16 +770,16 @@ image_save (Image *image, ObjectNode obj_node, DiaContext *ctx)
   }
   /* only save image_data inline if told to do so */
   if (image->inline_data) {
-    GdkPixbuf *pixbuf;
     data_add_boolean (new_attribute(obj_node, "inline_data"),
 		      image->inline_data, ctx);
 
-    /* just to be sure to get the currently visible */
-    pixbuf = (GdkPixbuf *)dia_image_pixbuf (image->image);
-    if (pixbuf != image->pixbuf && image->pixbuf != NULL)
+    /* just to be sure to get the currently visible, but without decoding
+     * it, data_add_image() only needs the encoded image */
+    if (image->pixbuf != NULL &&
+        image->pixbuf != dia_image_pixbuf (image->image))
       message_warning (_("Inconsistent pixbuf during image save."));
-    if (pixbuf)
-      data_add_pixbuf (new_attribute(obj_node, "pixbuf"), pixbuf, ctx);
+    if (image->image)
+      data_add_image (new_attribute(obj_node, "pixbuf"), image->image, ctx);
   }
 }
 
@@ -852,16 +863,17 @@ image_load (ObjectNode obj_node, int version, DiaContext *ctx)
 
   image->image = NULL;
 
+  /* only the size, the pixels are decoded when first drawn */
   if (strcmp (image->file, "") != 0) {
     if (   g_path_is_absolute (image->file)
         && g_file_test (image->file, G_FILE_TEST_IS_REGULAR)) {
       /* Absolute pathname */
-      image->image = dia_image_load (image->file);
+      image->image = dia_image_load_deferred (image->file);
     } else { /* build from relative pathname */
       char *image_filename = dia_absolutize_filename (dia_context_get_filename (ctx),
                                                       image->file);
 
-      image->image = dia_image_load (image_filename);
+      image->image = dia_image_load_deferred (image_filename);
       if (image->image != NULL) {
         /* Found file in same directory as diagram. */
         g_clear_pointer (&image->file, g_free);
@@ -870,7 +882,7 @@ image_load (ObjectNode obj_node, int version, DiaContext *ctx)
         /* not found as relative path, try literally */
         g_clear_pointer (&image_filename, g_free);
 
-        image->image = dia_image_load (image->file);
+        image->image = dia_image_load_deferred (image->file);
         if (image->image == NULL) {
           /* Didn't find file in current directory. */
           dia_context_add_message (ctx,
@@ -885,13 +897,12 @@ image_load (ObjectNode obj_node, int version, DiaContext *ctx)
   if (!image->image) {
     attr = object_find_attribute (obj_node, "pixbuf");
     if (attr != NULL) {
-      GdkPixbuf *pixbuf = data_pixbuf (attribute_first_data (attr), ctx);
+      /* shared with every other object inlining the same data */
+      image->image = data_image (attribute_first_data (attr), ctx);
 
-      if (pixbuf) {
-        image->image = dia_image_new_from_pixbuf (pixbuf);
+      if (image->image) {
         image->inline_data = TRUE; /* avoid loosing it */
         /* FIXME: should we reset the filename? */
-        g_clear_object (&pixbuf);
       }
     }
   } else {
@@ -171,11 +171,16 @@ static GHashTable *fonthash;
 #define FONT_NUM(font) GPOINTER_TO_INT(g_hash_table_lookup(fonthash, \
      dia_font_get_family(font)))
 
+/*
+ * The font list is made once for all exports, which may run in worker
+ * threads, so it takes the font context of the calling thread rather
+ * than asking GDK for one.
+ */
 static void
 init_fonts(void)
 {
         /* PANGO FIXME: this is probably broken to some extent now */
-    static gboolean alreadyrun = FALSE;
+    static gsize initialised = 0;
     GString *str;
     gint i;
     PangoContext *context;
@@ -183,10 +188,9 @@ init_fonts(void)
     int n_families;
     const char *familyname;
 
-    if (alreadyrun) return;
-    alreadyrun = TRUE;
+    if (!g_once_init_enter (&initialised)) return;
 
-    context = gdk_pango_context_get();
+    context = dia_font_get_context ();
     pango_context_list_families(context,&families,&n_families);
 
     fonthash = g_hash_table_new(g_str_hash, g_str_equal);
@@ -196,14 +200,18 @@ init_fonts(void)
 
         g_string_append_c(str, strlen(familyname));
         g_string_append(str, familyname);
-        g_hash_table_insert(fonthash, (gpointer)familyname,
+        g_hash_table_insert(fonthash, g_strdup (familyname),
                             GINT_TO_POINTER(i+1));
     }
     fontlist = str->str;
     fontlistlen = str->len;
     g_string_free(str, FALSE);
+    g_free (families);
+
+    g_once_init_leave (&initialised, 1);
 }
 
+
 /* --- CGM line attributes --- */
 typedef struct _LineAttrCGM
 {
@@ -22,7 +22,6 @@
 #include <glib/gi18n-lib.h>
 
 #include <Python.h>
-#include <locale.h>
 
 #include "pydia.h"
 #include "pydia-diagram.h"
@@ -303,7 +302,6 @@ static gboolean
 PyDia_import_data (const gchar* filename, DiagramData *dia, DiaContext *ctx, void *user_data)
 {
     PyObject *diaobj, *arg, *func = user_data;
-    char* old_locale;
     gboolean bRet = FALSE;
 
     if (!func || !PyCallable_Check (func)) {
@@ -319,9 +317,6 @@ PyDia_import_data (const gchar* filename, DiagramData *dia, DiaContext *ctx, voi
 
     Py_INCREF(func);
 
-    /* Python tries to guarantee this, make it work for these plugins too */
-    old_locale = setlocale(LC_NUMERIC, "C");
-
     arg = Py_BuildValue ("(sO)", filename, diaobj);
     if (arg) {
       PyObject *res = PyObject_CallObject (func, arg);
@@ -333,8 +328,6 @@ PyDia_import_data (const gchar* filename, DiagramData *dia, DiaContext *ctx, voi
     Py_DECREF(func);
     Py_XDECREF(diaobj);
 
-    setlocale(LC_NUMERIC, old_locale);
-
     return bRet;
 }
 
@@ -36,7 +36,6 @@
 #include <glib.h>
 #include <glib/gstdio.h>
 
-#include <locale.h>
 
 #include "geometry.h"
 
@@ -83,7 +82,6 @@ struct _DiaPyRenderer
   char*     filename;
   PyObject* self;
   PyObject* diagram_data;
-  char*     old_locale;
 };
 
 struct _DiaPyRendererClass
@@ -114,8 +112,6 @@ begin_render (DiaRenderer *renderer, const DiaRectangle *update)
 {
   PyObject *func, *res, *arg, *self = PYDIA_RENDERER (renderer);
 
-  DIA_PY_RENDERER (renderer)->old_locale = setlocale (LC_NUMERIC, "C");
-
   func = PyObject_GetAttrString (self, "begin_render");
   if (func && PyCallable_Check (func)) {
     Py_INCREF (self);
@@ -157,8 +153,6 @@ end_render (DiaRenderer *renderer)
 
   Py_DECREF (DIA_PY_RENDERER (renderer)->diagram_data);
   g_clear_pointer (&(DIA_PY_RENDERER (renderer)->filename), g_free);
-
-  setlocale (LC_NUMERIC, DIA_PY_RENDERER (renderer)->old_locale);
 }
 
 
@@ -0,0 +1,213 @@
+/* Dia -- an diagram creation/manipulation program
+ *
+ * stress-diagram.c -- fill a diagram with lots of objects
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Also built into tests/dia-benchmark, so it must not depend on app/
+ */
+
+#include "config.h"
+
+#include <glib/gi18n-lib.h>
+
+#include <math.h>
+
+#include "create.h"
+#include "dia-layer.h"
+#include "object.h"
+
+#include "stress-diagram.h"
+
+#define CELL_WIDTH 6.0
+#define CELL_HEIGHT 5.0
+
+
+static DiaObject *
+create_node (DiaObjectType *type, int cell, int columns)
+{
+  Point pos = { (cell % columns) * CELL_WIDTH, (cell / columns) * CELL_HEIGHT };
+  Handle *h1, *h2;
+
+  return dia_object_default_create (type, &pos, type->default_user_data, &h1, &h2);
+}
+
+
+static void
+connect_nodes (DiaLayer  *layer,
+               DiaObject *from,
+               DiaObject *to,
+               GRand     *rand)
+{
+  int n_from = dia_object_get_num_connections (from);
+  int n_to = dia_object_get_num_connections (to);
+  ConnectionPoint *start, *end;
+  DiaObject *line;
+  Point points[2];
+
+  if (n_from == 0 || n_to == 0) {
+    return;
+  }
+
+  start = from->connections[g_rand_int_range (rand, 0, n_from)];
+  end = to->connections[g_rand_int_range (rand, 0, n_to)];
+
+  points[0] = start->pos;
+  points[1] = end->pos;
+  line = create_standard_zigzagline (2, points, NULL, NULL);
+  dia_layer_add_object (layer, line);
+
+  for (int i = 0; i < line->num_handles; i++) {
+    Handle *handle = line->handles[i];
+
+    if (handle->id == HANDLE_MOVE_STARTPOINT) {
+      object_connect (line, handle, start);
+    } else if (handle->id == HANDLE_MOVE_ENDPOINT) {
+      object_connect (line, handle, end);
+    }
+  }
+}
+
+
+/**
+ * stress_populate:
+ * @data: the diagram to fill
+ * @options: what to put in
+ * @nodes: (nullable): gets the objects created, without the connectors
+ *
+ * Add @options->n_layers new layers to @data holding @options->n_objects
+ * objects, with the types in @options->types taking turns, on a grid.
+ * Connectors only join objects on the same layer.  The same options and
+ * seed always give the same diagram.
+ *
+ * Returns: (transfer container): the new layers, %NULL if none of the
+ *          types is known
+ */
+GList *
+stress_populate (DiagramData         *data,
+                 const StressOptions *options,
+                 GPtrArray           *nodes)
+{
+  GPtrArray *types = g_ptr_array_new ();
+  GPtrArray *layer_nodes = g_ptr_array_new ();
+  GRand *rand = g_rand_new_with_seed (options->seed);
+  GList *layers = NULL;
+  int n_layers = MAX (1, options->n_layers);
+  int columns = MAX (1, (int) ceil (sqrt (options->n_objects)));
+  int cell = 0;
+
+  for (int i = 0; options->types && options->types[i]; i++) {
+    DiaObjectType *type = object_get_type (options->types[i]);
+
+    if (type) {
+      g_ptr_array_add (types, type);
+    } else {
+      g_warning ("%s: no object type '%s'", G_STRLOC, options->types[i]);
+    }
+  }
+
+  if (types->len == 0) {
+    goto out;
+  }
+
+  for (int l = 0; l < n_layers; l++) {
+    char *name = g_strdup_printf (_("Stress %d"), l + 1);
+    DiaLayer *layer = dia_layer_new (name, data);
+    /* The last layer takes the remainder */
+    int n_objects = l < n_layers - 1 ?
+                      options->n_objects / n_layers :
+                      options->n_objects - cell;
+    int first = cell;
+    int n_connectors;
+
+    /* @data keeps the layer */
+    data_add_layer (data, layer);
+    layers = g_list_append (layers, layer);
+    g_object_unref (layer);
+
+    g_ptr_array_set_size (layer_nodes, 0);
+    for (int i = 0; i < n_objects; i++, cell++) {
+      DiaObject *obj = create_node (g_ptr_array_index (types, cell % types->len),
+                                    cell,
+                                    columns);
+
+      dia_layer_add_object (layer, obj);
+      g_ptr_array_add (layer_nodes, obj);
+      if (nodes) {
+        g_ptr_array_add (nodes, obj);
+      }
+    }
+
+    switch (options->topology) {
+      case STRESS_TOPOLOGY_GRID:
+        /* To the right and downwards, as long as it's on this layer */
+        for (int i = 0; i < n_objects; i++) {
+          int c = first + i;
+
+          if ((c + 1) % columns != 0 && i + 1 < n_objects) {
+            connect_nodes (layer,
+                           g_ptr_array_index (layer_nodes, i),
+                           g_ptr_array_index (layer_nodes, i + 1),
+                           rand);
+          }
+          if (i + columns < n_objects) {
+            connect_nodes (layer,
+                           g_ptr_array_index (layer_nodes, i),
+                           g_ptr_array_index (layer_nodes, i + columns),
+                           rand);
+          }
+        }
+        break;
+      case STRESS_TOPOLOGY_RANDOM:
+        n_connectors = options->n_objects > 0 ?
+                         (gint64) options->n_connectors * n_objects / options->n_objects :
+                         0;
+
+        for (int i = 0; i < n_connectors && n_objects > 1; i++) {
+          int from = g_rand_int_range (rand, 0, n_objects);
+          int to = g_rand_int_range (rand, 0, n_objects - 1);
+
+          /* never to itself */
+          if (to >= from) {
+            to++;
+          }
+
+          connect_nodes (layer,
+                         g_ptr_array_index (layer_nodes, from),
+                         g_ptr_array_index (layer_nodes, to),
+                         rand);
+        }
+        break;
+      case STRESS_TOPOLOGY_NONE:
+      default:
+        break;
+    }
+
+    g_clear_pointer (&name, g_free);
+  }
+
+  data_update_extents (data);
+
+out:
+  g_rand_free (rand);
+  g_ptr_array_free (layer_nodes, TRUE);
+  g_ptr_array_free (types, TRUE);
+
+  return layers;
+}
@@ -0,0 +1,46 @@
+/* Dia -- an diagram creation/manipulation program
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#pragma once
+
+#include "diagramdata.h"
+
+G_BEGIN_DECLS
+
+typedef enum {
+  STRESS_TOPOLOGY_NONE,
+  STRESS_TOPOLOGY_GRID,
+  STRESS_TOPOLOGY_RANDOM,
+} StressTopology;
+
+typedef struct _StressOptions StressOptions;
+struct _StressOptions {
+  char           **types;        /* object types to cycle through */
+  int              n_objects;    /* in total, over all layers */
+  int              n_layers;
+  StressTopology   topology;
+  int              n_connectors; /* for STRESS_TOPOLOGY_RANDOM */
+  guint32          seed;
+};
+
+GList *stress_populate (DiagramData         *data,
+                        const StressOptions *options,
+                        GPtrArray           *nodes);
+
+G_END_DECLS
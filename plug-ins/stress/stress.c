@@ -23,13 +23,21 @@
 
 #include <glib/gi18n-lib.h>
 
+#include <gtk/gtk.h>
+
 #include "message.h"
 #include "filter.h"
 #include "plug-ins.h"
+#include "dia-layer.h"
+#include "dia-object-change.h"
+#include "dia-render-profile.h"
 
+#include "stress-diagram.h"
 #include "stress-memory.h"
 
 
+/* vmem_avail() only knows about Windows */
+#ifdef G_OS_WIN32
 static DiaObjectChange *
 stress_memory_callback (DiagramData *data,
                         const char  *filename,
@@ -65,18 +73,272 @@ static DiaCallbackFilter cb_stress_memory = {
     stress_memory_callback,
     NULL
 };
+#endif
+
+#define STRESS_TYPE_POPULATE_CHANGE stress_populate_change_get_type ()
+G_DECLARE_FINAL_TYPE (StressPopulateChange,
+                      stress_populate_change,
+                      STRESS, POPULATE_CHANGE,
+                      DiaObjectChange)
+
+struct _StressPopulateChange {
+  DiaObjectChange  obj_change;
+
+  DiagramData     *data;
+  GList           *layers;
+};
+
+DIA_DEFINE_OBJECT_CHANGE (StressPopulateChange, stress_populate_change)
+
+
+static void
+stress_populate_change_apply (DiaObjectChange *self, DiaObject *obj)
+{
+  StressPopulateChange *change = STRESS_POPULATE_CHANGE (self);
+
+  for (GList *l = change->layers; l != NULL; l = l->next) {
+    if (data_layer_get_index (change->data, l->data) < 0) {
+      data_add_layer (change->data, l->data);
+    }
+  }
+  data_update_extents (change->data);
+}
+
+
+static void
+stress_populate_change_revert (DiaObjectChange *self, DiaObject *obj)
+{
+  StressPopulateChange *change = STRESS_POPULATE_CHANGE (self);
+
+  for (GList *l = change->layers; l != NULL; l = l->next) {
+    data_remove_layer (change->data, l->data);
+  }
+  data_update_extents (change->data);
+}
+
+
+static void
+stress_populate_change_free (DiaObjectChange *self)
+{
+  StressPopulateChange *change = STRESS_POPULATE_CHANGE (self);
+
+  g_list_free_full (change->layers, g_object_unref);
+}
+
+
+/* Remembered between runs */
+static char *populate_types = NULL;
+static StressOptions populate_options = {
+  NULL, 1000, 1, STRESS_TOPOLOGY_RANDOM, 1000, 42
+};
+
+
+static GtkWidget *
+add_spin (GtkGrid *grid, int row, const char *label, int value, int max)
+{
+  GtkWidget *spin = gtk_spin_button_new_with_range (0, max, 1);
+  GtkWidget *lbl = gtk_label_new_with_mnemonic (label);
+
+  gtk_spin_button_set_value (GTK_SPIN_BUTTON (spin), value);
+  gtk_label_set_mnemonic_widget (GTK_LABEL (lbl), spin);
+  gtk_widget_set_halign (lbl, GTK_ALIGN_END);
+  gtk_grid_attach (grid, lbl, 0, row, 1, 1);
+  gtk_grid_attach (grid, spin, 1, row, 1, 1);
+
+  return spin;
+}
+
+
+static gboolean
+populate_options_run (void)
+{
+  GtkWidget *dialog = gtk_dialog_new_with_buttons (_("Populate Diagram"),
+                                                   NULL,
+                                                   GTK_DIALOG_MODAL,
+                                                   _("_Cancel"), GTK_RESPONSE_CANCEL,
+                                                   _("_Populate"), GTK_RESPONSE_OK,
+                                                   NULL);
+  GtkWidget *grid = gtk_grid_new ();
+  GtkWidget *types = gtk_combo_box_text_new_with_entry ();
+  GtkWidget *topology = gtk_combo_box_text_new ();
+  GtkWidget *label, *objects, *layers, *connectors, *seed;
+  gboolean res;
+
+  gtk_grid_set_row_spacing (GTK_GRID (grid), 6);
+  gtk_grid_set_column_spacing (GTK_GRID (grid), 6);
+  gtk_container_set_border_width (GTK_CONTAINER (grid), 6);
+
+  /* Comma separated, the types take turns */
+  gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (types), "Standard - Box");
+  gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (types), "UML - Class");
+  gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (types), "Flowchart - Box");
+  gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (types),
+                                  "Standard - Box, UML - Class, Flowchart - Box");
+  gtk_entry_set_text (GTK_ENTRY (gtk_bin_get_child (GTK_BIN (types))),
+                      populate_types ? populate_types : "Standard - Box");
+  label = gtk_label_new_with_mnemonic (_("Object _types:"));
+  gtk_label_set_mnemonic_widget (GTK_LABEL (label), types);
+  gtk_widget_set_halign (label, GTK_ALIGN_END);
+  gtk_widget_set_hexpand (types, TRUE);
+  gtk_grid_attach (GTK_GRID (grid), label, 0, 0, 1, 1);
+  gtk_grid_attach (GTK_GRID (grid), types, 1, 0, 1, 1);
+
+  objects = add_spin (GTK_GRID (grid), 1, _("_Objects:"), populate_options.n_objects, 1000000);
+  layers = add_spin (GTK_GRID (grid), 2, _("_Layers:"), populate_options.n_layers, 100);
+
+  gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (topology), _("Not connected"));
+  gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (topology), _("Grid"));
+  gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (topology), _("Random"));
+  gtk_combo_box_set_active (GTK_COMBO_BOX (topology), populate_options.topology);
+  label = gtk_label_new_with_mnemonic (_("Con_nections:"));
+  gtk_label_set_mnemonic_widget (GTK_LABEL (label), topology);
+  gtk_widget_set_halign (label, GTK_ALIGN_END);
+  gtk_grid_attach (GTK_GRID (grid), label, 0, 3, 1, 1);
+  gtk_grid_attach (GTK_GRID (grid), topology, 1, 3, 1, 1);
+
+  connectors = add_spin (GTK_GRID (grid), 4, _("_Random connectors:"), populate_options.n_connectors, 1000000);
+  seed = add_spin (GTK_GRID (grid), 5, _("_Seed:"), populate_options.seed, G_MAXINT);
+
+  gtk_container_add (GTK_CONTAINER (gtk_dialog_get_content_area (GTK_DIALOG (dialog))), grid);
+  gtk_widget_show_all (dialog);
+
+  res = gtk_dialog_run (GTK_DIALOG (dialog)) == GTK_RESPONSE_OK;
+  if (res) {
+    g_clear_pointer (&populate_types, g_free);
+    populate_types = gtk_combo_box_text_get_active_text (GTK_COMBO_BOX_TEXT (types));
+    populate_options.n_objects = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (objects));
+    populate_options.n_layers = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (layers));
+    populate_options.topology = gtk_combo_box_get_active (GTK_COMBO_BOX (topology));
+    populate_options.n_connectors = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (connectors));
+    populate_options.seed = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (seed));
+  }
+
+  gtk_widget_destroy (dialog);
+
+  return res;
+}
+
+
+static DiaObjectChange *
+stress_populate_callback (DiagramData *data,
+                          const char  *filename,
+                          guint        flags,
+                          void        *user_data)
+{
+  StressPopulateChange *change;
+  GList *layers;
+  char **types;
+
+  if (!data || !populate_options_run ()) {
+    return NULL;
+  }
+
+  types = g_strsplit (populate_types ? populate_types : "", ",", -1);
+  for (int i = 0; types[i]; i++) {
+    g_strstrip (types[i]);
+  }
+  populate_options.types = types;
+
+  layers = stress_populate (data, &populate_options, NULL);
+
+  populate_options.types = NULL;
+  g_strfreev (types);
+
+  if (!layers) {
+    message_error (_("None of the object types '%s' is known."), populate_types);
+    return NULL;
+  }
+
+  /* Already applied */
+  change = dia_object_change_new (STRESS_TYPE_POPULATE_CHANGE);
+  change->data = data;
+  change->layers = g_list_copy_deep (layers, (GCopyFunc) g_object_ref, NULL);
+
+  g_list_free (layers);
+
+  return DIA_OBJECT_CHANGE (change);
+}
+
+static DiaCallbackFilter cb_stress_populate = {
+    "StressPopulate",
+    N_("Populate diagram"),
+    "/DisplayMenu/Debug/StressPopulate",
+    stress_populate_callback,
+    NULL
+};
+
+static DiaObjectChange *
+render_profile_callback (DiagramData *data,
+                         const char  *filename,
+                         guint        flags,
+                         void        *user_data)
+{
+  gboolean enable = !dia_render_profile_enabled ();
+
+  if (enable) {
+    dia_render_profile_reset ();
+  }
+  dia_render_profile_set_enabled (enable);
+
+  message_notice ("%s", enable ? _("Render profiling started.") : _("Render profiling stopped."));
+
+  return NULL;
+}
+
+static DiaCallbackFilter cb_render_profile = {
+    "RenderProfile",
+    N_("Profile rendering"),
+    "/ToolboxMenu/Debug/RenderProfile",
+    render_profile_callback,
+    NULL
+};
+
+static DiaObjectChange *
+render_profile_save_callback (DiagramData *data,
+                              const char  *filename,
+                              guint        flags,
+                              void        *user_data)
+{
+  char *path = g_build_filename (g_get_tmp_dir (), "dia-render-profile.csv", NULL);
+  GError *error = NULL;
+
+  if (dia_render_profile_save_csv (path, &error)) {
+    message_notice (_("Render profile saved to %s"), path);
+  } else {
+    message_error (_("Failed to save the render profile: %s"), error->message);
+  }
+
+  g_clear_error (&error);
+  g_clear_pointer (&path, g_free);
+
+  return NULL;
+}
+
+static DiaCallbackFilter cb_render_profile_save = {
+    "RenderProfileSave",
+    N_("Save render profile"),
+    "/ToolboxMenu/Debug/RenderProfileSave",
+    render_profile_save_callback,
+    NULL
+};
 
 static gboolean
 _plugin_can_unload (PluginInfo *info)
 {
-  return TRUE;
+  /* StressPopulateChange can't be unregistered */
+  return FALSE;
 }
 
 static void
 _plugin_unload (PluginInfo *info)
 {
+#ifdef G_OS_WIN32
   filter_unregister_callback (&cb_stress_memory);
   vmem_release ();
+#endif
+  filter_unregister_callback (&cb_stress_populate);
+  filter_unregister_callback (&cb_render_profile);
+  filter_unregister_callback (&cb_render_profile_save);
 }
 
 /* --- dia plug-in interface --- */
@@ -87,12 +349,17 @@ PluginInitResult
 dia_plugin_init(PluginInfo *info)
 {
   if (!dia_plugin_info_init(info, "Stress",
-                            _("Stress memory (development tool)"),
+                            _("Stress memory, populate diagrams and profile rendering (development tool)"),
                             _plugin_can_unload,
                             _plugin_unload))
     return DIA_PLUGIN_INIT_ERROR;
 
+#ifdef G_OS_WIN32
   filter_register_callback (&cb_stress_memory);
+#endif
+  filter_register_callback (&cb_stress_populate);
+  filter_register_callback (&cb_render_profile);
+  filter_register_callback (&cb_render_profile_save);
 
   return DIA_PLUGIN_INIT_OK;
 }
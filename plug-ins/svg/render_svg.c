@@ -88,6 +88,13 @@ struct _SvgRenderer
 
   /*! track the parents while grouping in draw_object() */
   GQueue *parents;
+
+  /*! digest of the drawing to symbol id, %NULL while only seen once,
+   *  see draw_object_as_symbol() */
+  GHashTable *symbols;
+  guint n_symbols;
+  /*! set_pattern() was called for the current object */
+  gboolean pattern_used;
 };
 
 struct _SvgRendererClass
@@ -128,6 +135,8 @@ static void draw_rotated_text  (DiaRenderer  *self,
 static void draw_rotated_image (DiaRenderer *self, Point *point,
 				real width, real height,
 				real angle, DiaImage *image);
+static gboolean draw_object_as_symbol (DiaSvgRenderer *renderer,
+                                       DiaObject      *object);
 
 static void svg_renderer_class_init (SvgRendererClass *klass);
 
@@ -140,6 +149,7 @@ svg_renderer_init (GTypeInstance *self, gpointer g_class)
   SvgRenderer *renderer = SVG_RENDERER (self);
 
   renderer->parents = g_queue_new ();
+  renderer->symbols = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
 }
 
 GType
@@ -210,6 +220,21 @@ is_capable_to (DiaRenderer *renderer, RenderCapability cap)
   return FALSE;
 }
 
+/*!
+ * \brief Notice patterns, they don't move with draw_object_as_symbol()
+ * \memberof _SvgRenderer
+ */
+static void
+set_pattern (DiaRenderer *self, DiaPattern *pattern)
+{
+  SvgRenderer *svg_renderer = SVG_RENDERER (self);
+
+  if (pattern)
+    svg_renderer->pattern_used = TRUE;
+
+  DIA_RENDERER_CLASS (parent_class)->set_pattern (self, pattern);
+}
+
 /* destructor */
 static void
 svg_renderer_finalize (GObject *object)
@@ -217,6 +242,7 @@ svg_renderer_finalize (GObject *object)
   SvgRenderer *svg_renderer = SVG_RENDERER (object);
 
   g_queue_free (svg_renderer->parents);
+  g_clear_pointer (&svg_renderer->symbols, g_hash_table_destroy);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -241,6 +267,7 @@ svg_renderer_class_init (SvgRendererClass *klass)
   renderer_class->draw_rotated_text  = draw_rotated_text;
   renderer_class->draw_rotated_image  = draw_rotated_image;
   renderer_class->is_capable_to = is_capable_to;
+  renderer_class->set_pattern = set_pattern;
 }
 
 /*!
@@ -259,6 +286,7 @@ new_svg_renderer(DiagramData *data, const char *filename)
   gchar buf[512];
   DiaRectangle *extent;
   xmlDtdPtr dtd;
+  GError *error = NULL;
 
   /* we need access to our base object */
   renderer = DIA_SVG_RENDERER (g_object_new(SVG_TYPE_RENDERER, NULL));
@@ -295,6 +323,17 @@ new_svg_renderer(DiagramData *data, const char *filename)
   xmlSetProp(renderer->root,(const xmlChar *)"xmlns", (const xmlChar *)"http://www.w3.org/2000/svg");
   xmlSetProp(renderer->root,(const xmlChar *)"xmlns:xlink", (const xmlChar *)"http://www.w3.org/1999/xlink");
 
+  /* each distinct style only once, in a <style> block */
+  dia_svg_renderer_use_style_classes (renderer);
+  /* and each embedded image once, in <defs> */
+  dia_svg_renderer_use_image_defs (renderer);
+
+  /* write objects as they are done instead of keeping the whole tree */
+  if (!dia_svg_renderer_begin_stream (renderer, &error)) {
+    g_debug ("SVG export without streaming: %s", error->message);
+    g_clear_error (&error);
+  }
+
   return renderer;
 }
 
@@ -329,7 +368,8 @@ draw_layer (DiaRenderer  *self,
   DIA_RENDERER_CLASS (parent_class)->draw_layer (self, layer, active, update);
 
   renderer->root = g_queue_pop_tail (svg_renderer->parents);
-  xmlAddChild (renderer->root, layer_group);
+  dia_svg_renderer_close_group (renderer, layer_group, renderer->root);
+  dia_svg_renderer_flush (renderer, renderer->root);
 }
 /*!
  * \brief Wrap every object in \<g\>\</g\> and apply transformation
@@ -349,6 +389,14 @@ draw_object(DiaRenderer *self,
   int n_children = 0;
   xmlNodePtr child, group;
 
+  /* directly in a layer, see if it's just like an earlier one */
+  if (!matrix && !IS_GROUP (object) &&
+      g_queue_get_length (svg_renderer->parents) == 1 &&
+      draw_object_as_symbol (renderer, object)) {
+    dia_svg_renderer_flush (renderer, renderer->root);
+    return;
+  }
+
   g_queue_push_tail (svg_renderer->parents, renderer->root);
 
   /* modifying the root pointer so everything below us gets into the new node */
@@ -414,10 +462,107 @@ draw_object(DiaRenderer *self,
       xmlAddChild (renderer->root, group);
     }
   }
+
+  /* directly in a layer, it's complete */
+  if (g_queue_get_length (svg_renderer->parents) <= 1)
+    dia_svg_renderer_flush (renderer, renderer->root);
 }
 
 #define dia_svg_dtostr(buf,d) \
   g_ascii_formatd(buf,sizeof(buf),"%g",(d)*renderer->scale)
+#define dia_svg_xtostr(buf,x) dia_svg_dtostr(buf,(x)-renderer->offset.x)
+#define dia_svg_ytostr(buf,y) dia_svg_dtostr(buf,(y)-renderer->offset.y)
+
+
+/*!
+ * \brief Draw repeated objects only once
+ *
+ * Diagrams built from a few stencils draw the same thing over and over in
+ * different places.  Objects are drawn relative to their position and
+ * compared by digest.  The first drawing of a kind stays inline, moved into
+ * place.  When the same drawing comes again it goes into a \<symbol\>,
+ * and this and every later instance is a \<use\> with the position.  So
+ * one of a kind objects don't cost a \<symbol\>.
+ *
+ * \return %FALSE if the object is not drawn yet
+ *
+ * \memberof _SvgRenderer
+ */
+static gboolean
+draw_object_as_symbol (DiaSvgRenderer *renderer,
+                       DiaObject      *object)
+{
+  SvgRenderer *svg_renderer = SVG_RENDERER (renderer);
+  Point pos = object->position;
+  xmlNodePtr group, child, use;
+  xmlBufferPtr content;
+  char *key, *digest, *id = NULL;
+  char x_buf[G_ASCII_DTOSTR_BUF_SIZE];
+  char y_buf[G_ASCII_DTOSTR_BUF_SIZE];
+
+  group = xmlNewNode (renderer->svg_name_space, (const xmlChar *)"g");
+
+  g_queue_push_tail (svg_renderer->parents, renderer->root);
+  renderer->root = group;
+  renderer->offset = pos;
+  svg_renderer->pattern_used = FALSE;
+
+  dia_object_draw (object, DIA_RENDERER (renderer));
+
+  renderer->offset.x = renderer->offset.y = 0.0;
+  renderer->root = g_queue_pop_tail (svg_renderer->parents);
+
+  /* gradients in user space stay where they are */
+  if (svg_renderer->pattern_used || !group->children) {
+    xmlFreeNode (group);
+    return FALSE;
+  }
+
+  content = xmlBufferCreate ();
+  for (child = group->children; child != NULL; child = child->next)
+    xmlNodeDump (content, NULL, child, 0, 0);
+  digest = g_compute_checksum_for_data (G_CHECKSUM_SHA1,
+                                        xmlBufferContent (content),
+                                        xmlBufferLength (content));
+  xmlBufferFree (content);
+
+  dia_svg_dtostr (x_buf, pos.x);
+  dia_svg_dtostr (y_buf, pos.y);
+
+  if (!g_hash_table_lookup_extended (svg_renderer->symbols, digest, NULL, (gpointer *) &id)) {
+    /* the first one, maybe the only one */
+    char *trans = g_strdup_printf ("translate(%s,%s)", x_buf, y_buf);
+
+    xmlSetProp (group, (const xmlChar *)"transform", (xmlChar *) trans);
+    xmlAddChild (renderer->root, group);
+    g_hash_table_insert (svg_renderer->symbols, digest, NULL);
+
+    g_clear_pointer (&trans, g_free);
+
+    return TRUE;
+  } else if (!id) {
+    /* seen once before, from now on shared */
+    id = g_strdup_printf ("dia-symbol-%u", svg_renderer->n_symbols++);
+    xmlNodeSetName (group, (const xmlChar *)"symbol");
+    xmlSetProp (group, (const xmlChar *)"id", (xmlChar *) id);
+    /* without a viewBox nothing should be clipped */
+    xmlSetProp (group, (const xmlChar *)"overflow", (const xmlChar *)"visible");
+    dia_svg_renderer_add_def (renderer, group);
+    g_hash_table_insert (svg_renderer->symbols, digest, id);
+  } else {
+    xmlFreeNode (group);
+    g_clear_pointer (&digest, g_free);
+  }
+
+  use = xmlNewChild (renderer->root, renderer->svg_name_space, (const xmlChar *)"use", NULL);
+  key = g_strconcat ("#", id, NULL);
+  xmlSetProp (use, (const xmlChar *)"xlink:href", (xmlChar *) key);
+  xmlSetProp (use, (const xmlChar *)"x", (xmlChar *) x_buf);
+  xmlSetProp (use, (const xmlChar *)"y", (xmlChar *) y_buf);
+  g_clear_pointer (&key, g_free);
+
+  return TRUE;
+}
 
 
 static void
@@ -479,7 +624,7 @@ node_set_text_style (xmlNodePtr      node,
                              dia_font_get_slant_string (font),
                              dia_font_get_weight_string (font));
   }
-  xmlSetProp (node, (xmlChar *) "style", (xmlChar *) style->str);
+  dia_svg_renderer_set_style (renderer, node, style->str);
   g_string_free (style, TRUE);
 }
 
@@ -532,9 +677,9 @@ draw_string (DiaRenderer  *self,
 
   node_set_text_style (node, renderer, font, font_height, alignment, colour);
 
-  dia_svg_dtostr (d_buf, pos->x);
+  dia_svg_xtostr (d_buf, pos->x);
   xmlSetProp (node, (xmlChar *) "x", (xmlChar *)d_buf);
-  dia_svg_dtostr (d_buf, pos->y);
+  dia_svg_ytostr (d_buf, pos->y);
   xmlSetProp (node, (xmlChar *) "y", (xmlChar *)d_buf);
 }
 
@@ -562,9 +707,9 @@ draw_text_line (DiaRenderer  *self,
   /* not using the renderers font but the textlines */
   node_set_text_style(node, renderer, font, font_height, alignment, colour);
 
-  dia_svg_dtostr(d_buf, pos->x);
+  dia_svg_xtostr(d_buf, pos->x);
   xmlSetProp(node, (const xmlChar *)"x", (xmlChar *) d_buf);
-  dia_svg_dtostr(d_buf, pos->y);
+  dia_svg_ytostr(d_buf, pos->y);
   xmlSetProp(node, (const xmlChar *)"y", (xmlChar *) d_buf);
   dia_svg_dtostr(d_buf, text_line_get_width(text_line));
   xmlSetProp(node, (const xmlChar*)"textLength", (xmlChar *) d_buf);
@@ -624,18 +769,18 @@ draw_rotated_text (DiaRenderer *self,
      if (center)
        pos = *center;
      g_ascii_formatd (d_buf, sizeof(d_buf), "%g", angle);
-     dia_svg_dtostr(x_buf0, pos.x);
-     dia_svg_dtostr(y_buf0, pos.y);
-     dia_svg_dtostr(x_buf1, -pos.x);
-     dia_svg_dtostr(y_buf1, -pos.y);
+     dia_svg_xtostr(x_buf0, pos.x);
+     dia_svg_ytostr(y_buf0, pos.y);
+     dia_svg_dtostr(x_buf1, -(pos.x - renderer->offset.x));
+     dia_svg_dtostr(y_buf1, -(pos.y - renderer->offset.y));
      trans = g_strdup_printf ("translate(%s,%s) rotate(%s) translate(%s,%s)",
 			      x_buf0, y_buf0, d_buf, x_buf1, y_buf1);
      xmlSetProp(node_text, (const xmlChar *)"transform", (xmlChar *) trans);
      g_clear_pointer (&trans, g_free);
   } else {
-    dia_svg_dtostr(d_buf, pos.x);
+    dia_svg_xtostr(d_buf, pos.x);
     xmlSetProp(node_text, (const xmlChar *)"x", (xmlChar *) d_buf);
-    dia_svg_dtostr(d_buf, pos.y);
+    dia_svg_ytostr(d_buf, pos.y);
     xmlSetProp(node_text, (const xmlChar *)"y", (xmlChar *) d_buf);
   }
 
@@ -647,9 +792,9 @@ draw_rotated_text (DiaRenderer *self,
                                   (const xmlChar *) "tspan",
                                   (const xmlChar *) text_line_get_string (lines[i]));
     _adjust_space_preserve (node_tspan, text_line_get_string (lines[i]));
-    dia_svg_dtostr(d_buf, pos.x);
+    dia_svg_xtostr(d_buf, pos.x);
     xmlSetProp(node_tspan, (const xmlChar *)"x", (xmlChar *) d_buf);
-    dia_svg_dtostr(d_buf, pos.y);
+    dia_svg_ytostr(d_buf, pos.y);
     xmlSetProp(node_tspan, (const xmlChar *)"y", (xmlChar *) d_buf);
 
     pos.y += dia_text_get_height (text);
@@ -670,7 +815,8 @@ draw_rotated_image (DiaRenderer *self,
   DIA_RENDERER_CLASS (parent_class)->draw_image (self, point, width, height, image);
   /* ... and modify the image node to transform */
   if (angle != 0.0) {
-    xmlNodePtr node = xmlFirstElementChild (renderer->root);
+    /* just appended, an <image> or a <use> of one in <defs> */
+    xmlNodePtr node = xmlLastElementChild (renderer->root);
     gchar d_buf[G_ASCII_DTOSTR_BUF_SIZE];
     gchar x_buf0[G_ASCII_DTOSTR_BUF_SIZE];
     gchar y_buf0[G_ASCII_DTOSTR_BUF_SIZE];
@@ -679,13 +825,15 @@ draw_rotated_image (DiaRenderer *self,
     gchar *trans;
     Point pos = { point->x + width/2, point->y + height/2 }; /* center */
 
-    g_return_if_fail (node != NULL && xmlStrcmp (node->name, (const xmlChar *)"image") == 0);
+    g_return_if_fail (node != NULL &&
+                      (xmlStrcmp (node->name, (const xmlChar *)"image") == 0 ||
+                       xmlStrcmp (node->name, (const xmlChar *)"use") == 0));
 
     g_ascii_formatd (d_buf, sizeof(d_buf), "%g", angle);
-    dia_svg_dtostr(x_buf0, pos.x);
-    dia_svg_dtostr(y_buf0, pos.y);
-    dia_svg_dtostr(x_buf1, -pos.x);
-    dia_svg_dtostr(y_buf1, -pos.y);
+    dia_svg_xtostr(x_buf0, pos.x);
+    dia_svg_ytostr(y_buf0, pos.y);
+    dia_svg_dtostr(x_buf1, -(pos.x - renderer->offset.x));
+    dia_svg_dtostr(y_buf1, -(pos.y - renderer->offset.y));
     trans = g_strdup_printf ("translate(%s,%s) rotate(%s) translate(%s,%s)",
                              x_buf0, y_buf0, d_buf, x_buf1, y_buf1);
     xmlSetProp (node, (const xmlChar *)"transform", (xmlChar *) trans);
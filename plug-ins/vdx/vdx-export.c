@@ -35,7 +35,6 @@
 #include <glib.h>
 #include <stdlib.h>
 #include <errno.h>
-#include <locale.h>
 #include <glib/gstdio.h>
 
 #include "geometry.h"
@@ -1488,12 +1487,18 @@ static void draw_image(DiaRenderer *self,
 /** Convert Dia colour to hex string
  * @param c a colour
  * @returns string in form #000000
- * @note static buffer overwritten with next call; not thread-safe
+ * @note per-thread buffer overwritten with next call
  */
 const char *
 vdx_string_color (const Color c)
 {
-    static char buf[8];
+    static GPrivate buf_key = G_PRIVATE_INIT (g_free);
+    char *buf = g_private_get (&buf_key);
+
+    if (!buf) {
+        buf = g_new (char, 8);
+        g_private_set (&buf_key, buf);
+    }
     sprintf(buf, "#%.2X%.2X%.2X",
             (int)(c.red*255), (int)(c.green*255), (int)(c.blue*255));
     return buf;
@@ -1502,13 +1507,14 @@ vdx_string_color (const Color c)
 /** Return string XML-encoded
  * @param s a string
  * @returns encoded string
- * @note uses static buffer so can be used as inline filter in printf
+ * @note uses a per-thread buffer so can be used as inline filter in printf
  */
 
 const char *
 vdx_convert_xml_string(const char *s)
 {
-    static char *out = 0;
+    static GPrivate out_key = G_PRIVATE_INIT (g_free);
+    char *out = g_private_get (&out_key);
     char *c;
 
     /* If (as almost always) no change required, return intact */
@@ -1516,6 +1522,7 @@ vdx_convert_xml_string(const char *s)
 
     /* Ensure we have enough space, even if all the string is quotes */
     out = g_renew (char, out, 6 * strlen (s) + 1);
+    g_private_set (&out_key, out);
     c = out;
 
     while(*s)
@@ -1566,6 +1573,8 @@ write_header(DiagramData *data, VDXRenderer *renderer)
     struct vdx_Char Char;
     struct vdx_Para Para;
     struct vdx_Tabs Tabs;
+    char width[G_ASCII_DTOSTR_BUF_SIZE];
+    char height[G_ASCII_DTOSTR_BUF_SIZE];
 
     g_debug("write_header");
 
@@ -1728,12 +1737,14 @@ write_header(DiagramData *data, VDXRenderer *renderer)
     /* Write a single page size defintion - Visio Viewer does not care, but LibreOffice does. */
     fprintf(file, "      <PageSheet ID='0'>\n"
 		  "        <PageProps>\n"
-		  "          <PageWidth>%f</PageWidth>\n"
-		  "          <PageHeight>%f</PageHeight>\n"
+		  "          <PageWidth>%s</PageWidth>\n"
+		  "          <PageHeight>%s</PageHeight>\n"
 		  "        </PageProps>\n"
 		  "      </PageSheet>\n",
-		  visio_length(data->extents.right - data->extents.left),
-		  visio_length(data->extents.bottom - data->extents.top));
+		  g_ascii_formatd(width, sizeof(width), "%f",
+				  visio_length(data->extents.right - data->extents.left)),
+		  g_ascii_formatd(height, sizeof(height), "%f",
+				  visio_length(data->extents.bottom - data->extents.top)));
     fprintf(file, "      <Shapes>\n");
     renderer->xml_depth = 4;
     renderer->shapeid = 1;
@@ -1780,7 +1791,6 @@ export_vdx (DiagramData *data,
     VDXRenderer *renderer;
     int i;
     DiaLayer *layer;
-    char* old_locale;
 
     file = g_fopen(filename, "w");
 
@@ -1790,9 +1800,6 @@ export_vdx (DiagramData *data,
 	return FALSE;
     }
 
-    /* ugly, but still better than creatin corrupt files */
-    old_locale = setlocale(LC_NUMERIC, "C");
-
     /* Create and initialise our renderer */
     renderer = g_object_new(VDX_TYPE_RENDERER, NULL);
 
@@ -1839,9 +1846,6 @@ export_vdx (DiagramData *data,
 
   g_clear_object (&renderer);
 
-  /* dont screw Dia's global state */
-  setlocale (LC_NUMERIC, old_locale);
-
   if (fclose (file) != 0) {
     dia_context_add_message_with_errno (ctx, errno,
                                         _("Saving file '%s' failed."),
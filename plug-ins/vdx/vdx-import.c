@@ -35,7 +35,6 @@
 #include <libxml/parser.h>
 #include <libxml/xmlmemory.h>
 #include <float.h>
-#include <locale.h>
 
 #include "geometry.h"
 #include "filter.h"
@@ -1775,7 +1774,7 @@ plot_nurbs(const struct vdx_Geom *Geom, const struct vdx_XForm *XForm,
         c = NURBSTo->E;
         c += strlen("NURBS(");
 
-        knotLast = atof(c);
+        knotLast = g_ascii_strtod(c, NULL);
         c = strchr(c, ',');
         if (!c) { return 0; }
 
@@ -1811,25 +1810,25 @@ plot_nurbs(const struct vdx_Geom *Geom, const struct vdx_XForm *XForm,
         while(c && *c && i < n)
         {
             if (!c) break;
-            control[i].x = atof(++c);
+            control[i].x = g_ascii_strtod(++c, NULL);
             current->x = control[i].x;
             /* xType = 0 means X is proportion of Width */
             if (xType == 0) control[i].x *= XForm->Width;
             c = strchr(c, ',');
 
             if (!c) break;
-            control[i].y = atof(++c);
+            control[i].y = g_ascii_strtod(++c, NULL);
             current->y = control[i].y;
             /* yType = 0 means Y is proportion of Height */
             if (yType == 0) control[i].y *= XForm->Height;
             c = strchr(c, ',');
 
             if (!c) break;
-            knot[i] = atof(++c);
+            knot[i] = g_ascii_strtod(++c, NULL);
             c = strchr(c, ',');
 
             if (!c) break;
-            weight[i] = atof(++c);
+            weight[i] = g_ascii_strtod(++c, NULL);
             c = strchr(c, ',');
             i++;
         }
@@ -2959,7 +2958,6 @@ import_vdx (const char  *filename,
   int visio_version = 0;
   const char *debug = 0;
   unsigned int debug_shapes = 0;
-  char *old_locale;
 
   if (!doc) {
     dia_context_add_message (ctx,
@@ -2999,10 +2997,6 @@ import_vdx (const char  *filename,
     theDoc = g_new0(struct VDXDocument, 1);
     theDoc->ok = TRUE;
 
-
-    /* ugly, but still better than bogus sizes */
-    old_locale = setlocale(LC_NUMERIC, "C");
-
     /* VDX_DEBUG sets verbose per-shape debugging on */
     if (g_getenv("VDX_DEBUG")) theDoc->debug_comments = TRUE;
 
@@ -3055,9 +3049,6 @@ import_vdx (const char  *filename,
     vdx_free(theDoc);
     xmlFreeDoc(doc);
 
-    /* dont screw Dia's global state */
-    setlocale(LC_NUMERIC, old_locale);
-
     return TRUE;
 }
 
@@ -78,7 +78,7 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
             if (xmlIsBlankNode(child)) { continue; }
             if (!strcmp((char *)child->name, "Action"))
             { if (child->children && child->children->content)
-                s->Action = atof((char *)child->children->content); }
+                s->Action = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "BeginGroup"))
             { if (child->children && child->children->content)
                 s->BeginGroup = atoi((char *)child->children->content); }
@@ -125,10 +125,10 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
             if (xmlIsBlankNode(child)) { continue; }
             if (!strcmp((char *)child->name, "AlignBottom"))
             { if (child->children && child->children->content)
-                s->AlignBottom = atof((char *)child->children->content); }
+                s->AlignBottom = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "AlignCenter"))
             { if (child->children && child->children->content)
-                s->AlignCenter = atof((char *)child->children->content); }
+                s->AlignCenter = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "AlignLeft"))
             { if (child->children && child->children->content)
                 s->AlignLeft = atoi((char *)child->children->content); }
@@ -140,7 +140,7 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->AlignRight = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "AlignTop"))
             { if (child->children && child->children->content)
-                s->AlignTop = atof((char *)child->children->content); }
+                s->AlignTop = g_ascii_strtod((char *)child->children->content, NULL); }
             else s->any.children =
                      g_slist_append(s->any.children,
                                     vdx_read_object(child, theDoc, 0, ctx));
@@ -166,13 +166,13 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
             if (xmlIsBlankNode(child)) { continue; }
             if (!strcmp((char *)child->name, "A"))
             { if (child->children && child->children->content)
-                s->A = atof((char *)child->children->content); }
+                s->A = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "X"))
             { if (child->children && child->children->content)
-                s->X = atof((char *)child->children->content); }
+                s->X = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "Y"))
             { if (child->children && child->children->content)
-                s->Y = atof((char *)child->children->content); }
+                s->Y = g_ascii_strtod((char *)child->children->content, NULL); }
             else s->any.children =
                      g_slist_append(s->any.children,
                                     vdx_read_object(child, theDoc, 0, ctx));
@@ -207,13 +207,13 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->Color = vdx_parse_color((char *)child->children->content, theDoc, ctx); }
             else if (!strcmp((char *)child->name, "ColorTrans"))
             { if (child->children && child->children->content)
-                s->ColorTrans = atof((char *)child->children->content); }
+                s->ColorTrans = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "ComplexScriptFont"))
             { if (child->children && child->children->content)
                 s->ComplexScriptFont = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "ComplexScriptSize"))
             { if (child->children && child->children->content)
-                s->ComplexScriptSize = atof((char *)child->children->content); }
+                s->ComplexScriptSize = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "DblUnderline"))
             { if (child->children && child->children->content)
                 s->DblUnderline = atoi((char *)child->children->content); }
@@ -225,7 +225,7 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->Font = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "FontScale"))
             { if (child->children && child->children->content)
-                s->FontScale = atof((char *)child->children->content); }
+                s->FontScale = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "Highlight"))
             { if (child->children && child->children->content)
                 s->Highlight = atoi((char *)child->children->content); }
@@ -234,7 +234,7 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->LangID = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "Letterspace"))
             { if (child->children && child->children->content)
-                s->Letterspace = atof((char *)child->children->content); }
+                s->Letterspace = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "Locale"))
             { if (child->children && child->children->content)
                 s->Locale = atoi((char *)child->children->content); }
@@ -255,7 +255,7 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->RTLText = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "Size"))
             { if (child->children && child->children->content)
-                s->Size = atof((char *)child->children->content); }
+                s->Size = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "Strikethru"))
             { if (child->children && child->children->content)
                 s->Strikethru = atoi((char *)child->children->content); }
@@ -378,10 +378,10 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->AutoGen = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "DirX"))
             { if (child->children && child->children->content)
-                s->DirX = atof((char *)child->children->content); }
+                s->DirX = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "DirY"))
             { if (child->children && child->children->content)
-                s->DirY = atof((char *)child->children->content); }
+                s->DirY = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "Prompt"))
             { if (child->children && child->children->content)
                 s->Prompt = (char *)child->children->content; }
@@ -390,10 +390,10 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->Type = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "X"))
             { if (child->children && child->children->content)
-                s->X = atof((char *)child->children->content); }
+                s->X = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "Y"))
             { if (child->children && child->children->content)
-                s->Y = atof((char *)child->children->content); }
+                s->Y = g_ascii_strtod((char *)child->children->content, NULL); }
             else s->any.children =
                      g_slist_append(s->any.children,
                                     vdx_read_object(child, theDoc, 0, ctx));
@@ -448,22 +448,22 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->Prompt = (char *)child->children->content; }
             else if (!strcmp((char *)child->name, "X"))
             { if (child->children && child->children->content)
-                s->X = atof((char *)child->children->content); }
+                s->X = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "XCon"))
             { if (child->children && child->children->content)
-                s->XCon = atof((char *)child->children->content); }
+                s->XCon = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "XDyn"))
             { if (child->children && child->children->content)
-                s->XDyn = atof((char *)child->children->content); }
+                s->XDyn = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "Y"))
             { if (child->children && child->children->content)
-                s->Y = atof((char *)child->children->content); }
+                s->Y = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "YCon"))
             { if (child->children && child->children->content)
-                s->YCon = atof((char *)child->children->content); }
+                s->YCon = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "YDyn"))
             { if (child->children && child->children->content)
-                s->YDyn = atof((char *)child->children->content); }
+                s->YDyn = g_ascii_strtod((char *)child->children->content, NULL); }
             else s->any.children =
                      g_slist_append(s->any.children,
                                     vdx_read_object(child, theDoc, 0, ctx));
@@ -719,22 +719,22 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
             if (xmlIsBlankNode(child)) { continue; }
             if (!strcmp((char *)child->name, "A"))
             { if (child->children && child->children->content)
-                s->A = atof((char *)child->children->content); }
+                s->A = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "B"))
             { if (child->children && child->children->content)
-                s->B = atof((char *)child->children->content); }
+                s->B = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "C"))
             { if (child->children && child->children->content)
-                s->C = atof((char *)child->children->content); }
+                s->C = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "D"))
             { if (child->children && child->children->content)
-                s->D = atof((char *)child->children->content); }
+                s->D = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "X"))
             { if (child->children && child->children->content)
-                s->X = atof((char *)child->children->content); }
+                s->X = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "Y"))
             { if (child->children && child->children->content)
-                s->Y = atof((char *)child->children->content); }
+                s->Y = g_ascii_strtod((char *)child->children->content, NULL); }
             else s->any.children =
                      g_slist_append(s->any.children,
                                     vdx_read_object(child, theDoc, 0, ctx));
@@ -757,22 +757,22 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
             if (xmlIsBlankNode(child)) { continue; }
             if (!strcmp((char *)child->name, "A"))
             { if (child->children && child->children->content)
-                s->A = atof((char *)child->children->content); }
+                s->A = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "B"))
             { if (child->children && child->children->content)
-                s->B = atof((char *)child->children->content); }
+                s->B = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "C"))
             { if (child->children && child->children->content)
-                s->C = atof((char *)child->children->content); }
+                s->C = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "D"))
             { if (child->children && child->children->content)
-                s->D = atof((char *)child->children->content); }
+                s->D = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "X"))
             { if (child->children && child->children->content)
-                s->X = atof((char *)child->children->content); }
+                s->X = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "Y"))
             { if (child->children && child->children->content)
-                s->Y = atof((char *)child->children->content); }
+                s->Y = g_ascii_strtod((char *)child->children->content, NULL); }
             else s->any.children =
                      g_slist_append(s->any.children,
                                     vdx_read_object(child, theDoc, 0, ctx));
@@ -795,7 +795,7 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->EventDblClick = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "EventDrop"))
             { if (child->children && child->children->content)
-                s->EventDrop = atof((char *)child->children->content); }
+                s->EventDrop = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "EventXFMod"))
             { if (child->children && child->children->content)
                 s->EventXFMod = atoi((char *)child->children->content); }
@@ -948,7 +948,7 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->EditMode = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "Format"))
             { if (child->children && child->children->content)
-                s->Format = atof((char *)child->children->content); }
+                s->Format = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "ObjectKind"))
             { if (child->children && child->children->content)
                 s->ObjectKind = atoi((char *)child->children->content); }
@@ -966,7 +966,7 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->UIFmt = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "Value"))
             { if (child->children && child->children->content)
-                s->Value = atof((char *)child->children->content); }
+                s->Value = g_ascii_strtod((char *)child->children->content, NULL); }
             else s->any.children =
                      g_slist_append(s->any.children,
                                     vdx_read_object(child, theDoc, 0, ctx));
@@ -989,28 +989,28 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->FillBkgnd = vdx_parse_color((char *)child->children->content, theDoc, ctx); }
             else if (!strcmp((char *)child->name, "FillBkgndTrans"))
             { if (child->children && child->children->content)
-                s->FillBkgndTrans = atof((char *)child->children->content); }
+                s->FillBkgndTrans = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "FillForegnd"))
             { if (child->children && child->children->content)
                 s->FillForegnd = vdx_parse_color((char *)child->children->content, theDoc, ctx); }
             else if (!strcmp((char *)child->name, "FillForegndTrans"))
             { if (child->children && child->children->content)
-                s->FillForegndTrans = atof((char *)child->children->content); }
+                s->FillForegndTrans = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "FillPattern"))
             { if (child->children && child->children->content)
                 s->FillPattern = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "ShapeShdwObliqueAngle"))
             { if (child->children && child->children->content)
-                s->ShapeShdwObliqueAngle = atof((char *)child->children->content); }
+                s->ShapeShdwObliqueAngle = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "ShapeShdwOffsetX"))
             { if (child->children && child->children->content)
-                s->ShapeShdwOffsetX = atof((char *)child->children->content); }
+                s->ShapeShdwOffsetX = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "ShapeShdwOffsetY"))
             { if (child->children && child->children->content)
-                s->ShapeShdwOffsetY = atof((char *)child->children->content); }
+                s->ShapeShdwOffsetY = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "ShapeShdwScaleFactor"))
             { if (child->children && child->children->content)
-                s->ShapeShdwScaleFactor = atof((char *)child->children->content); }
+                s->ShapeShdwScaleFactor = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "ShapeShdwType"))
             { if (child->children && child->children->content)
                 s->ShapeShdwType = atoi((char *)child->children->content); }
@@ -1019,13 +1019,13 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->ShdwBkgnd = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "ShdwBkgndTrans"))
             { if (child->children && child->children->content)
-                s->ShdwBkgndTrans = atof((char *)child->children->content); }
+                s->ShdwBkgndTrans = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "ShdwForegnd"))
             { if (child->children && child->children->content)
                 s->ShdwForegnd = vdx_parse_color((char *)child->children->content, theDoc, ctx); }
             else if (!strcmp((char *)child->name, "ShdwForegndTrans"))
             { if (child->children && child->children->content)
-                s->ShdwForegndTrans = atof((char *)child->children->content); }
+                s->ShdwForegndTrans = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "ShdwPattern"))
             { if (child->children && child->children->content)
                 s->ShdwPattern = atoi((char *)child->children->content); }
@@ -1109,16 +1109,16 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
             if (xmlIsBlankNode(child)) { continue; }
             if (!strcmp((char *)child->name, "ImgHeight"))
             { if (child->children && child->children->content)
-                s->ImgHeight = atof((char *)child->children->content); }
+                s->ImgHeight = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "ImgOffsetX"))
             { if (child->children && child->children->content)
-                s->ImgOffsetX = atof((char *)child->children->content); }
+                s->ImgOffsetX = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "ImgOffsetY"))
             { if (child->children && child->children->content)
-                s->ImgOffsetY = atof((char *)child->children->content); }
+                s->ImgOffsetY = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "ImgWidth"))
             { if (child->children && child->children->content)
-                s->ImgWidth = atof((char *)child->children->content); }
+                s->ImgWidth = g_ascii_strtod((char *)child->children->content, NULL); }
             else s->any.children =
                      g_slist_append(s->any.children,
                                     vdx_read_object(child, theDoc, 0, ctx));
@@ -1135,7 +1135,7 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
         for (attr = cur->properties; attr; attr = attr->next) {
             if (!strcmp((char *)attr->name, "CompressionLevel") &&
                      attr->children && attr->children->content)
-                s->CompressionLevel = atof((char *)attr->children->content);
+                s->CompressionLevel = g_ascii_strtod((char *)attr->children->content, NULL);
             else if (!strcmp((char *)attr->name, "CompressionType") &&
                      attr->children && attr->children->content)
                 s->CompressionType = (char *)attr->children->content;
@@ -1156,14 +1156,14 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->MappingMode_exists = TRUE; }
             else if (!strcmp((char *)attr->name, "ObjectHeight") &&
                      attr->children && attr->children->content)
-                s->ObjectHeight = atof((char *)attr->children->content);
+                s->ObjectHeight = g_ascii_strtod((char *)attr->children->content, NULL);
             else if (!strcmp((char *)attr->name, "ObjectType") &&
                      attr->children && attr->children->content)
             {    s->ObjectType = atoi((char *)attr->children->content);
                 s->ObjectType_exists = TRUE; }
             else if (!strcmp((char *)attr->name, "ObjectWidth") &&
                      attr->children && attr->children->content)
-                s->ObjectWidth = atof((char *)attr->children->content);
+                s->ObjectWidth = g_ascii_strtod((char *)attr->children->content, NULL);
             else if (!strcmp((char *)attr->name, "ShowAsIcon") &&
                      attr->children && attr->children->content)
                 s->ShowAsIcon = atoi((char *)attr->children->content);
@@ -1262,7 +1262,7 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->FooterLeft = (char *)child->children->content; }
             else if (!strcmp((char *)child->name, "FooterMargin"))
             { if (child->children && child->children->content)
-                s->FooterMargin = atof((char *)child->children->content); }
+                s->FooterMargin = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "HeaderFooterFont"))
             { if (child->children && child->children->content)
                 s->HeaderFooterFont = atoi((char *)child->children->content); }
@@ -1271,7 +1271,7 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->HeaderLeft = (char *)child->children->content; }
             else if (!strcmp((char *)child->name, "HeaderMargin"))
             { if (child->children && child->children->content)
-                s->HeaderMargin = atof((char *)child->children->content); }
+                s->HeaderMargin = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "HeaderRight"))
             { if (child->children && child->children->content)
                 s->HeaderRight = (char *)child->children->content; }
@@ -1451,25 +1451,25 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
             if (xmlIsBlankNode(child)) { continue; }
             if (!strcmp((char *)child->name, "Blur"))
             { if (child->children && child->children->content)
-                s->Blur = atof((char *)child->children->content); }
+                s->Blur = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "Brightness"))
             { if (child->children && child->children->content)
-                s->Brightness = atof((char *)child->children->content); }
+                s->Brightness = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "Contrast"))
             { if (child->children && child->children->content)
-                s->Contrast = atof((char *)child->children->content); }
+                s->Contrast = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "Denoise"))
             { if (child->children && child->children->content)
-                s->Denoise = atof((char *)child->children->content); }
+                s->Denoise = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "Gamma"))
             { if (child->children && child->children->content)
                 s->Gamma = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "Sharpen"))
             { if (child->children && child->children->content)
-                s->Sharpen = atof((char *)child->children->content); }
+                s->Sharpen = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "Transparency"))
             { if (child->children && child->children->content)
-                s->Transparency = atof((char *)child->children->content); }
+                s->Transparency = g_ascii_strtod((char *)child->children->content, NULL); }
             else s->any.children =
                      g_slist_append(s->any.children,
                                     vdx_read_object(child, theDoc, 0, ctx));
@@ -1492,16 +1492,16 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
             if (xmlIsBlankNode(child)) { continue; }
             if (!strcmp((char *)child->name, "A"))
             { if (child->children && child->children->content)
-                s->A = atof((char *)child->children->content); }
+                s->A = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "B"))
             { if (child->children && child->children->content)
-                s->B = atof((char *)child->children->content); }
+                s->B = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "X"))
             { if (child->children && child->children->content)
-                s->X = atof((char *)child->children->content); }
+                s->X = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "Y"))
             { if (child->children && child->children->content)
-                s->Y = atof((char *)child->children->content); }
+                s->Y = g_ascii_strtod((char *)child->children->content, NULL); }
             else s->any.children =
                      g_slist_append(s->any.children,
                                     vdx_read_object(child, theDoc, 0, ctx));
@@ -1530,7 +1530,7 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->Color = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "ColorTrans"))
             { if (child->children && child->children->content)
-                s->ColorTrans = atof((char *)child->children->content); }
+                s->ColorTrans = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "Glue"))
             { if (child->children && child->children->content)
                 s->Glue = atoi((char *)child->children->content); }
@@ -1674,16 +1674,16 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->LineColor = vdx_parse_color((char *)child->children->content, theDoc, ctx); }
             else if (!strcmp((char *)child->name, "LineColorTrans"))
             { if (child->children && child->children->content)
-                s->LineColorTrans = atof((char *)child->children->content); }
+                s->LineColorTrans = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "LinePattern"))
             { if (child->children && child->children->content)
                 s->LinePattern = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "LineWeight"))
             { if (child->children && child->children->content)
-                s->LineWeight = atof((char *)child->children->content); }
+                s->LineWeight = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "Rounding"))
             { if (child->children && child->children->content)
-                s->Rounding = atof((char *)child->children->content); }
+                s->Rounding = g_ascii_strtod((char *)child->children->content, NULL); }
             else s->any.children =
                      g_slist_append(s->any.children,
                                     vdx_read_object(child, theDoc, 0, ctx));
@@ -1709,10 +1709,10 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
             if (xmlIsBlankNode(child)) { continue; }
             if (!strcmp((char *)child->name, "X"))
             { if (child->children && child->children->content)
-                s->X = atof((char *)child->children->content); }
+                s->X = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "Y"))
             { if (child->children && child->children->content)
-                s->Y = atof((char *)child->children->content); }
+                s->Y = g_ascii_strtod((char *)child->children->content, NULL); }
             else s->any.children =
                      g_slist_append(s->any.children,
                                     vdx_read_object(child, theDoc, 0, ctx));
@@ -1868,10 +1868,10 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
             if (xmlIsBlankNode(child)) { continue; }
             if (!strcmp((char *)child->name, "X"))
             { if (child->children && child->children->content)
-                s->X = atof((char *)child->children->content); }
+                s->X = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "Y"))
             { if (child->children && child->children->content)
-                s->Y = atof((char *)child->children->content); }
+                s->Y = g_ascii_strtod((char *)child->children->content, NULL); }
             else s->any.children =
                      g_slist_append(s->any.children,
                                     vdx_read_object(child, theDoc, 0, ctx));
@@ -1894,25 +1894,25 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
             if (xmlIsBlankNode(child)) { continue; }
             if (!strcmp((char *)child->name, "A"))
             { if (child->children && child->children->content)
-                s->A = atof((char *)child->children->content); }
+                s->A = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "B"))
             { if (child->children && child->children->content)
-                s->B = atof((char *)child->children->content); }
+                s->B = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "C"))
             { if (child->children && child->children->content)
-                s->C = atof((char *)child->children->content); }
+                s->C = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "D"))
             { if (child->children && child->children->content)
-                s->D = atof((char *)child->children->content); }
+                s->D = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "E"))
             { if (child->children && child->children->content)
                 s->E = (char *)child->children->content; }
             else if (!strcmp((char *)child->name, "X"))
             { if (child->children && child->children->content)
-                s->X = atof((char *)child->children->content); }
+                s->X = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "Y"))
             { if (child->children && child->children->content)
-                s->Y = atof((char *)child->children->content); }
+                s->Y = g_ascii_strtod((char *)child->children->content, NULL); }
             else s->any.children =
                      g_slist_append(s->any.children,
                                     vdx_read_object(child, theDoc, 0, ctx));
@@ -1945,13 +1945,13 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->NameU = (char *)attr->children->content;
             else if (!strcmp((char *)attr->name, "ViewCenterX") &&
                      attr->children && attr->children->content)
-                s->ViewCenterX = atof((char *)attr->children->content);
+                s->ViewCenterX = g_ascii_strtod((char *)attr->children->content, NULL);
             else if (!strcmp((char *)attr->name, "ViewCenterY") &&
                      attr->children && attr->children->content)
-                s->ViewCenterY = atof((char *)attr->children->content);
+                s->ViewCenterY = g_ascii_strtod((char *)attr->children->content, NULL);
             else if (!strcmp((char *)attr->name, "ViewScale") &&
                      attr->children && attr->children->content)
-                s->ViewScale = atof((char *)attr->children->content);
+                s->ViewScale = g_ascii_strtod((char *)attr->children->content, NULL);
         }
         for (child = cur->xmlChildrenNode; child; child = child->next) {
             if (xmlIsBlankNode(child)) { continue; }
@@ -1974,16 +1974,16 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
             if (xmlIsBlankNode(child)) { continue; }
             if (!strcmp((char *)child->name, "AvenueSizeX"))
             { if (child->children && child->children->content)
-                s->AvenueSizeX = atof((char *)child->children->content); }
+                s->AvenueSizeX = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "AvenueSizeY"))
             { if (child->children && child->children->content)
-                s->AvenueSizeY = atof((char *)child->children->content); }
+                s->AvenueSizeY = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "BlockSizeX"))
             { if (child->children && child->children->content)
-                s->BlockSizeX = atof((char *)child->children->content); }
+                s->BlockSizeX = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "BlockSizeY"))
             { if (child->children && child->children->content)
-                s->BlockSizeY = atof((char *)child->children->content); }
+                s->BlockSizeY = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "CtrlAsInput"))
             { if (child->children && child->children->content)
                 s->CtrlAsInput = atoi((char *)child->children->content); }
@@ -2004,10 +2004,10 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->LineJumpCode = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "LineJumpFactorX"))
             { if (child->children && child->children->content)
-                s->LineJumpFactorX = atof((char *)child->children->content); }
+                s->LineJumpFactorX = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "LineJumpFactorY"))
             { if (child->children && child->children->content)
-                s->LineJumpFactorY = atof((char *)child->children->content); }
+                s->LineJumpFactorY = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "LineJumpStyle"))
             { if (child->children && child->children->content)
                 s->LineJumpStyle = atoi((char *)child->children->content); }
@@ -2016,16 +2016,16 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->LineRouteExt = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "LineToLineX"))
             { if (child->children && child->children->content)
-                s->LineToLineX = atof((char *)child->children->content); }
+                s->LineToLineX = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "LineToLineY"))
             { if (child->children && child->children->content)
-                s->LineToLineY = atof((char *)child->children->content); }
+                s->LineToLineY = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "LineToNodeX"))
             { if (child->children && child->children->content)
-                s->LineToNodeX = atof((char *)child->children->content); }
+                s->LineToNodeX = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "LineToNodeY"))
             { if (child->children && child->children->content)
-                s->LineToNodeY = atof((char *)child->children->content); }
+                s->LineToNodeY = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "PageLineJumpDirX"))
             { if (child->children && child->children->content)
                 s->PageLineJumpDirX = atoi((char *)child->children->content); }
@@ -2072,7 +2072,7 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
             if (xmlIsBlankNode(child)) { continue; }
             if (!strcmp((char *)child->name, "DrawingScale"))
             { if (child->children && child->children->content)
-                s->DrawingScale = atof((char *)child->children->content); }
+                s->DrawingScale = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "DrawingScaleType"))
             { if (child->children && child->children->content)
                 s->DrawingScaleType = atoi((char *)child->children->content); }
@@ -2084,25 +2084,25 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->InhibitSnap = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "PageHeight"))
             { if (child->children && child->children->content)
-                s->PageHeight = atof((char *)child->children->content); }
+                s->PageHeight = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "PageScale"))
             { if (child->children && child->children->content)
-                s->PageScale = atof((char *)child->children->content); }
+                s->PageScale = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "PageWidth"))
             { if (child->children && child->children->content)
-                s->PageWidth = atof((char *)child->children->content); }
+                s->PageWidth = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "ShdwObliqueAngle"))
             { if (child->children && child->children->content)
-                s->ShdwObliqueAngle = atof((char *)child->children->content); }
+                s->ShdwObliqueAngle = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "ShdwOffsetX"))
             { if (child->children && child->children->content)
-                s->ShdwOffsetX = atof((char *)child->children->content); }
+                s->ShdwOffsetX = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "ShdwOffsetY"))
             { if (child->children && child->children->content)
-                s->ShdwOffsetY = atof((char *)child->children->content); }
+                s->ShdwOffsetY = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "ShdwScaleFactor"))
             { if (child->children && child->children->content)
-                s->ShdwScaleFactor = atof((char *)child->children->content); }
+                s->ShdwScaleFactor = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "ShdwType"))
             { if (child->children && child->children->content)
                 s->ShdwType = atoi((char *)child->children->content); }
@@ -2181,25 +2181,25 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->HorzAlign = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "IndFirst"))
             { if (child->children && child->children->content)
-                s->IndFirst = atof((char *)child->children->content); }
+                s->IndFirst = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "IndLeft"))
             { if (child->children && child->children->content)
-                s->IndLeft = atof((char *)child->children->content); }
+                s->IndLeft = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "IndRight"))
             { if (child->children && child->children->content)
-                s->IndRight = atof((char *)child->children->content); }
+                s->IndRight = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "LocalizeBulletFont"))
             { if (child->children && child->children->content)
                 s->LocalizeBulletFont = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "SpAfter"))
             { if (child->children && child->children->content)
-                s->SpAfter = atof((char *)child->children->content); }
+                s->SpAfter = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "SpBefore"))
             { if (child->children && child->children->content)
-                s->SpBefore = atof((char *)child->children->content); }
+                s->SpBefore = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "SpLine"))
             { if (child->children && child->children->content)
-                s->SpLine = atof((char *)child->children->content); }
+                s->SpLine = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "TextPosAfterBullet"))
             { if (child->children && child->children->content)
                 s->TextPosAfterBullet = atoi((char *)child->children->content); }
@@ -2225,13 +2225,13 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
             if (xmlIsBlankNode(child)) { continue; }
             if (!strcmp((char *)child->name, "A"))
             { if (child->children && child->children->content)
-                s->A = atof((char *)child->children->content); }
+                s->A = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "X"))
             { if (child->children && child->children->content)
-                s->X = atof((char *)child->children->content); }
+                s->X = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "Y"))
             { if (child->children && child->children->content)
-                s->Y = atof((char *)child->children->content); }
+                s->Y = g_ascii_strtod((char *)child->children->content, NULL); }
             else s->any.children =
                      g_slist_append(s->any.children,
                                     vdx_read_object(child, theDoc, 0, ctx));
@@ -2281,16 +2281,16 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->OnPage = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "PageBottomMargin"))
             { if (child->children && child->children->content)
-                s->PageBottomMargin = atof((char *)child->children->content); }
+                s->PageBottomMargin = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "PageLeftMargin"))
             { if (child->children && child->children->content)
-                s->PageLeftMargin = atof((char *)child->children->content); }
+                s->PageLeftMargin = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "PageRightMargin"))
             { if (child->children && child->children->content)
-                s->PageRightMargin = atof((char *)child->children->content); }
+                s->PageRightMargin = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "PageTopMargin"))
             { if (child->children && child->children->content)
-                s->PageTopMargin = atof((char *)child->children->content); }
+                s->PageTopMargin = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "PagesX"))
             { if (child->children && child->children->content)
                 s->PagesX = atoi((char *)child->children->content); }
@@ -2311,7 +2311,7 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->PrintPageOrientation = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "ScaleX"))
             { if (child->children && child->children->content)
-                s->ScaleX = atof((char *)child->children->content); }
+                s->ScaleX = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "ScaleY"))
             { if (child->children && child->children->content)
                 s->ScaleY = atoi((char *)child->children->content); }
@@ -2334,16 +2334,16 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
             if (xmlIsBlankNode(child)) { continue; }
             if (!strcmp((char *)child->name, "PageBottomMargin"))
             { if (child->children && child->children->content)
-                s->PageBottomMargin = atof((char *)child->children->content); }
+                s->PageBottomMargin = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "PageLeftMargin"))
             { if (child->children && child->children->content)
-                s->PageLeftMargin = atof((char *)child->children->content); }
+                s->PageLeftMargin = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "PageRightMargin"))
             { if (child->children && child->children->content)
-                s->PageRightMargin = atof((char *)child->children->content); }
+                s->PageRightMargin = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "PageTopMargin"))
             { if (child->children && child->children->content)
-                s->PageTopMargin = atof((char *)child->children->content); }
+                s->PageTopMargin = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "PaperSize"))
             { if (child->children && child->children->content)
                 s->PaperSize = atoi((char *)child->children->content); }
@@ -2420,7 +2420,7 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->Type = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "Value"))
             { if (child->children && child->children->content)
-                s->Value = atof((char *)child->children->content); }
+                s->Value = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "Verify"))
             { if (child->children && child->children->content)
                 s->Verify = atoi((char *)child->children->content); }
@@ -2514,31 +2514,31 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->XGridDensity = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "XGridOrigin"))
             { if (child->children && child->children->content)
-                s->XGridOrigin = atof((char *)child->children->content); }
+                s->XGridOrigin = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "XGridSpacing"))
             { if (child->children && child->children->content)
-                s->XGridSpacing = atof((char *)child->children->content); }
+                s->XGridSpacing = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "XRulerDensity"))
             { if (child->children && child->children->content)
                 s->XRulerDensity = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "XRulerOrigin"))
             { if (child->children && child->children->content)
-                s->XRulerOrigin = atof((char *)child->children->content); }
+                s->XRulerOrigin = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "YGridDensity"))
             { if (child->children && child->children->content)
                 s->YGridDensity = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "YGridOrigin"))
             { if (child->children && child->children->content)
-                s->YGridOrigin = atof((char *)child->children->content); }
+                s->YGridOrigin = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "YGridSpacing"))
             { if (child->children && child->children->content)
-                s->YGridSpacing = atof((char *)child->children->content); }
+                s->YGridSpacing = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "YRulerDensity"))
             { if (child->children && child->children->content)
                 s->YRulerDensity = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "YRulerOrigin"))
             { if (child->children && child->children->content)
-                s->YRulerOrigin = atof((char *)child->children->content); }
+                s->YRulerOrigin = g_ascii_strtod((char *)child->children->content, NULL); }
             else s->any.children =
                      g_slist_append(s->any.children,
                                     vdx_read_object(child, theDoc, 0, ctx));
@@ -2561,22 +2561,22 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
             if (xmlIsBlankNode(child)) { continue; }
             if (!strcmp((char *)child->name, "A"))
             { if (child->children && child->children->content)
-                s->A = atof((char *)child->children->content); }
+                s->A = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "B"))
             { if (child->children && child->children->content)
-                s->B = atof((char *)child->children->content); }
+                s->B = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "C"))
             { if (child->children && child->children->content)
-                s->C = atof((char *)child->children->content); }
+                s->C = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "D"))
             { if (child->children && child->children->content)
-                s->D = atof((char *)child->children->content); }
+                s->D = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "X"))
             { if (child->children && child->children->content)
-                s->X = atof((char *)child->children->content); }
+                s->X = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "Y"))
             { if (child->children && child->children->content)
-                s->Y = atof((char *)child->children->content); }
+                s->Y = g_ascii_strtod((char *)child->children->content, NULL); }
             else s->any.children =
                      g_slist_append(s->any.children,
                                     vdx_read_object(child, theDoc, 0, ctx));
@@ -2680,13 +2680,13 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
             if (xmlIsBlankNode(child)) { continue; }
             if (!strcmp((char *)child->name, "A"))
             { if (child->children && child->children->content)
-                s->A = atof((char *)child->children->content); }
+                s->A = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "X"))
             { if (child->children && child->children->content)
-                s->X = atof((char *)child->children->content); }
+                s->X = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "Y"))
             { if (child->children && child->children->content)
-                s->Y = atof((char *)child->children->content); }
+                s->Y = g_ascii_strtod((char *)child->children->content, NULL); }
             else s->any.children =
                      g_slist_append(s->any.children,
                                     vdx_read_object(child, theDoc, 0, ctx));
@@ -2709,22 +2709,22 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
             if (xmlIsBlankNode(child)) { continue; }
             if (!strcmp((char *)child->name, "A"))
             { if (child->children && child->children->content)
-                s->A = atof((char *)child->children->content); }
+                s->A = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "B"))
             { if (child->children && child->children->content)
-                s->B = atof((char *)child->children->content); }
+                s->B = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "C"))
             { if (child->children && child->children->content)
-                s->C = atof((char *)child->children->content); }
+                s->C = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "D"))
             { if (child->children && child->children->content)
-                s->D = atof((char *)child->children->content); }
+                s->D = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "X"))
             { if (child->children && child->children->content)
-                s->X = atof((char *)child->children->content); }
+                s->X = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "Y"))
             { if (child->children && child->children->content)
-                s->Y = atof((char *)child->children->content); }
+                s->Y = g_ascii_strtod((char *)child->children->content, NULL); }
             else s->any.children =
                      g_slist_append(s->any.children,
                                     vdx_read_object(child, theDoc, 0, ctx));
@@ -2817,7 +2817,7 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->Alignment = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "Position"))
             { if (child->children && child->children->content)
-                s->Position = atof((char *)child->children->content); }
+                s->Position = g_ascii_strtod((char *)child->children->content, NULL); }
             else s->any.children =
                      g_slist_append(s->any.children,
                                     vdx_read_object(child, theDoc, 0, ctx));
@@ -2863,7 +2863,7 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->cp = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "fld"))
             { if (child->children && child->children->content)
-                s->fld = atof((char *)child->children->content); }
+                s->fld = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "pp"))
             { if (child->children && child->children->content)
                 s->pp = atoi((char *)child->children->content); }
@@ -2889,28 +2889,28 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
             if (xmlIsBlankNode(child)) { continue; }
             if (!strcmp((char *)child->name, "BottomMargin"))
             { if (child->children && child->children->content)
-                s->BottomMargin = atof((char *)child->children->content); }
+                s->BottomMargin = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "DefaultTabStop"))
             { if (child->children && child->children->content)
-                s->DefaultTabStop = atof((char *)child->children->content); }
+                s->DefaultTabStop = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "LeftMargin"))
             { if (child->children && child->children->content)
-                s->LeftMargin = atof((char *)child->children->content); }
+                s->LeftMargin = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "RightMargin"))
             { if (child->children && child->children->content)
-                s->RightMargin = atof((char *)child->children->content); }
+                s->RightMargin = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "TextBkgnd"))
             { if (child->children && child->children->content)
                 s->TextBkgnd = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "TextBkgndTrans"))
             { if (child->children && child->children->content)
-                s->TextBkgndTrans = atof((char *)child->children->content); }
+                s->TextBkgndTrans = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "TextDirection"))
             { if (child->children && child->children->content)
                 s->TextDirection = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "TopMargin"))
             { if (child->children && child->children->content)
-                s->TopMargin = atof((char *)child->children->content); }
+                s->TopMargin = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "VerticalAlign"))
             { if (child->children && child->children->content)
                 s->VerticalAlign = atoi((char *)child->children->content); }
@@ -2933,25 +2933,25 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
             if (xmlIsBlankNode(child)) { continue; }
             if (!strcmp((char *)child->name, "TxtAngle"))
             { if (child->children && child->children->content)
-                s->TxtAngle = atof((char *)child->children->content); }
+                s->TxtAngle = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "TxtHeight"))
             { if (child->children && child->children->content)
-                s->TxtHeight = atof((char *)child->children->content); }
+                s->TxtHeight = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "TxtLocPinX"))
             { if (child->children && child->children->content)
-                s->TxtLocPinX = atof((char *)child->children->content); }
+                s->TxtLocPinX = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "TxtLocPinY"))
             { if (child->children && child->children->content)
-                s->TxtLocPinY = atof((char *)child->children->content); }
+                s->TxtLocPinY = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "TxtPinX"))
             { if (child->children && child->children->content)
-                s->TxtPinX = atof((char *)child->children->content); }
+                s->TxtPinX = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "TxtPinY"))
             { if (child->children && child->children->content)
-                s->TxtPinY = atof((char *)child->children->content); }
+                s->TxtPinY = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "TxtWidth"))
             { if (child->children && child->children->content)
-                s->TxtWidth = atof((char *)child->children->content); }
+                s->TxtWidth = g_ascii_strtod((char *)child->children->content, NULL); }
             else s->any.children =
                      g_slist_append(s->any.children,
                                     vdx_read_object(child, theDoc, 0, ctx));
@@ -2983,7 +2983,7 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->Prompt = (char *)child->children->content; }
             else if (!strcmp((char *)child->name, "Value"))
             { if (child->children && child->children->content)
-                s->Value = atof((char *)child->children->content); }
+                s->Value = g_ascii_strtod((char *)child->children->content, NULL); }
             else s->any.children =
                      g_slist_append(s->any.children,
                                     vdx_read_object(child, theDoc, 0, ctx));
@@ -3071,13 +3071,13 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->Sheet_exists = TRUE; }
             else if (!strcmp((char *)attr->name, "ViewCenterX") &&
                      attr->children && attr->children->content)
-                s->ViewCenterX = atof((char *)attr->children->content);
+                s->ViewCenterX = g_ascii_strtod((char *)attr->children->content, NULL);
             else if (!strcmp((char *)attr->name, "ViewCenterY") &&
                      attr->children && attr->children->content)
-                s->ViewCenterY = atof((char *)attr->children->content);
+                s->ViewCenterY = g_ascii_strtod((char *)attr->children->content, NULL);
             else if (!strcmp((char *)attr->name, "ViewScale") &&
                      attr->children && attr->children->content)
-                s->ViewScale = atof((char *)attr->children->content);
+                s->ViewScale = g_ascii_strtod((char *)attr->children->content, NULL);
             else if (!strcmp((char *)attr->name, "WindowHeight") &&
                      attr->children && attr->children->content)
             {    s->WindowHeight = atoi((char *)attr->children->content);
@@ -3139,7 +3139,7 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->StencilGroupPos = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "TabSplitterPos"))
             { if (child->children && child->children->content)
-                s->TabSplitterPos = atof((char *)child->children->content); }
+                s->TabSplitterPos = g_ascii_strtod((char *)child->children->content, NULL); }
             else s->any.children =
                      g_slist_append(s->any.children,
                                     vdx_read_object(child, theDoc, 0, ctx));
@@ -3187,7 +3187,7 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
             if (xmlIsBlankNode(child)) { continue; }
             if (!strcmp((char *)child->name, "Angle"))
             { if (child->children && child->children->content)
-                s->Angle = atof((char *)child->children->content); }
+                s->Angle = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "FlipX"))
             { if (child->children && child->children->content)
                 s->FlipX = atoi((char *)child->children->content); }
@@ -3196,25 +3196,25 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
                 s->FlipY = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "Height"))
             { if (child->children && child->children->content)
-                s->Height = atof((char *)child->children->content); }
+                s->Height = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "LocPinX"))
             { if (child->children && child->children->content)
-                s->LocPinX = atof((char *)child->children->content); }
+                s->LocPinX = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "LocPinY"))
             { if (child->children && child->children->content)
-                s->LocPinY = atof((char *)child->children->content); }
+                s->LocPinY = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "PinX"))
             { if (child->children && child->children->content)
-                s->PinX = atof((char *)child->children->content); }
+                s->PinX = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "PinY"))
             { if (child->children && child->children->content)
-                s->PinY = atof((char *)child->children->content); }
+                s->PinY = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "ResizeMode"))
             { if (child->children && child->children->content)
                 s->ResizeMode = atoi((char *)child->children->content); }
             else if (!strcmp((char *)child->name, "Width"))
             { if (child->children && child->children->content)
-                s->Width = atof((char *)child->children->content); }
+                s->Width = g_ascii_strtod((char *)child->children->content, NULL); }
             else s->any.children =
                      g_slist_append(s->any.children,
                                     vdx_read_object(child, theDoc, 0, ctx));
@@ -3234,16 +3234,16 @@ vdx_read_object(xmlNodePtr cur, VDXDocument *theDoc, void *p, DiaContext *ctx)
             if (xmlIsBlankNode(child)) { continue; }
             if (!strcmp((char *)child->name, "BeginX"))
             { if (child->children && child->children->content)
-                s->BeginX = atof((char *)child->children->content); }
+                s->BeginX = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "BeginY"))
             { if (child->children && child->children->content)
-                s->BeginY = atof((char *)child->children->content); }
+                s->BeginY = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "EndX"))
             { if (child->children && child->children->content)
-                s->EndX = atof((char *)child->children->content); }
+                s->EndX = g_ascii_strtod((char *)child->children->content, NULL); }
             else if (!strcmp((char *)child->name, "EndY"))
             { if (child->children && child->children->content)
-                s->EndY = atof((char *)child->children->content); }
+                s->EndY = g_ascii_strtod((char *)child->children->content, NULL); }
             else s->any.children =
                      g_slist_append(s->any.children,
                                     vdx_read_object(child, theDoc, 0, ctx));
@@ -3356,6 +3356,8 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
 {
     const struct vdx_any *Any = (const struct vdx_any*)p;
     const GSList *child = Any->children;
+    /* Locale independent numbers, at most three per line */
+    char buf[3][G_ASCII_DTOSTR_BUF_SIZE];
 
     const struct vdx_Act *Act;
     const struct vdx_Align *Align;
@@ -3456,8 +3458,8 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
             fprintf(file, " NameU='%s'",
                     vdx_convert_xml_string(Act->NameU));
         fprintf(file, ">\n");
-        fprintf(file, "%s  <Action>%f</Action>\n", pad,
-                Act->Action);
+        fprintf(file, "%s  <Action>%s</Action>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Act->Action));
         fprintf(file, "%s  <BeginGroup>%u</BeginGroup>\n", pad,
                 Act->BeginGroup);
         fprintf(file, "%s  <ButtonFace>%u</ButtonFace>\n", pad,
@@ -3481,18 +3483,18 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
     case vdx_types_Align:
         Align = (const struct vdx_Align *)(p);
         fprintf(file, "%s<Align>\n", pad);
-        fprintf(file, "%s  <AlignBottom>%f</AlignBottom>\n", pad,
-                Align->AlignBottom);
-        fprintf(file, "%s  <AlignCenter>%f</AlignCenter>\n", pad,
-                Align->AlignCenter);
+        fprintf(file, "%s  <AlignBottom>%s</AlignBottom>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Align->AlignBottom));
+        fprintf(file, "%s  <AlignCenter>%s</AlignCenter>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Align->AlignCenter));
         fprintf(file, "%s  <AlignLeft>%u</AlignLeft>\n", pad,
                 Align->AlignLeft);
         fprintf(file, "%s  <AlignMiddle>%u</AlignMiddle>\n", pad,
                 Align->AlignMiddle);
         fprintf(file, "%s  <AlignRight>%u</AlignRight>\n", pad,
                 Align->AlignRight);
-        fprintf(file, "%s  <AlignTop>%f</AlignTop>\n", pad,
-                Align->AlignTop);
+        fprintf(file, "%s  <AlignTop>%s</AlignTop>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Align->AlignTop));
         break;
 
     case vdx_types_ArcTo:
@@ -3502,12 +3504,12 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
             fprintf(file, " Del='%u'",
                     ArcTo->Del);
         fprintf(file, ">\n");
-        fprintf(file, "%s  <A>%f</A>\n", pad,
-                ArcTo->A);
-        fprintf(file, "%s  <X>%f</X>\n", pad,
-                ArcTo->X);
-        fprintf(file, "%s  <Y>%f</Y>\n", pad,
-                ArcTo->Y);
+        fprintf(file, "%s  <A>%s</A>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", ArcTo->A));
+        fprintf(file, "%s  <X>%s</X>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", ArcTo->X));
+        fprintf(file, "%s  <Y>%s</Y>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", ArcTo->Y));
         break;
 
     case vdx_types_Char:
@@ -3526,14 +3528,14 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
         fprintf(file, "%s  <Color>%s</Color>\n", pad,
                 vdx_string_color(Char->Color));
 	if (Char->ColorTrans)
-          fprintf(file, "%s  <ColorTrans>%f</ColorTrans>\n", pad,
-                  Char->ColorTrans);
+          fprintf(file, "%s  <ColorTrans>%s</ColorTrans>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Char->ColorTrans));
 	if (Char->ComplexScriptFont)
           fprintf(file, "%s  <ComplexScriptFont>%u</ComplexScriptFont>\n", pad,
                   Char->ComplexScriptFont);
 	if (Char->ComplexScriptSize)
-          fprintf(file, "%s  <ComplexScriptSize>%f</ComplexScriptSize>\n", pad,
-                  Char->ComplexScriptSize);
+          fprintf(file, "%s  <ComplexScriptSize>%s</ComplexScriptSize>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Char->ComplexScriptSize));
 	if (Char->DblUnderline)
           fprintf(file, "%s  <DblUnderline>%u</DblUnderline>\n", pad,
                   Char->DblUnderline);
@@ -3544,8 +3546,8 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
         fprintf(file, "%s  <Font>%u</Font>\n", pad,
                 Char->Font);
 	if (Char->FontScale)
-          fprintf(file, "%s  <FontScale>%f</FontScale>\n", pad,
-                  Char->FontScale);
+          fprintf(file, "%s  <FontScale>%s</FontScale>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Char->FontScale));
 	if (Char->Highlight)
           fprintf(file, "%s  <Highlight>%u</Highlight>\n", pad,
                   Char->Highlight);
@@ -3553,8 +3555,8 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
           fprintf(file, "%s  <LangID>%u</LangID>\n", pad,
                   Char->LangID);
 	if (Char->Letterspace)
-          fprintf(file, "%s  <Letterspace>%f</Letterspace>\n", pad,
-                  Char->Letterspace);
+          fprintf(file, "%s  <Letterspace>%s</Letterspace>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Char->Letterspace));
 	if (Char->Locale)
           fprintf(file, "%s  <Locale>%u</Locale>\n", pad,
                   Char->Locale);
@@ -3574,8 +3576,8 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
           fprintf(file, "%s  <RTLText>%u</RTLText>\n", pad,
                   Char->RTLText);
 	if (Char->Size)
-          fprintf(file, "%s  <Size>%f</Size>\n", pad,
-                  Char->Size);
+          fprintf(file, "%s  <Size>%s</Size>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Char->Size));
 	if (Char->Strikethru)
           fprintf(file, "%s  <Strikethru>%u</Strikethru>\n", pad,
                   Char->Strikethru);
@@ -3637,18 +3639,18 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
         fprintf(file, ">\n");
         fprintf(file, "%s  <AutoGen>%u</AutoGen>\n", pad,
                 vdxConnection->AutoGen);
-        fprintf(file, "%s  <DirX>%f</DirX>\n", pad,
-                vdxConnection->DirX);
-        fprintf(file, "%s  <DirY>%f</DirY>\n", pad,
-                vdxConnection->DirY);
+        fprintf(file, "%s  <DirX>%s</DirX>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", vdxConnection->DirX));
+        fprintf(file, "%s  <DirY>%s</DirY>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", vdxConnection->DirY));
         fprintf(file, "%s  <Prompt>%s</Prompt>\n", pad,
                 vdx_convert_xml_string(vdxConnection->Prompt));
         fprintf(file, "%s  <Type>%u</Type>\n", pad,
                 vdxConnection->Type);
-        fprintf(file, "%s  <X>%f</X>\n", pad,
-                vdxConnection->X);
-        fprintf(file, "%s  <Y>%f</Y>\n", pad,
-                vdxConnection->Y);
+        fprintf(file, "%s  <X>%s</X>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", vdxConnection->X));
+        fprintf(file, "%s  <Y>%s</Y>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", vdxConnection->Y));
         break;
 
     case vdx_types_Connects:
@@ -3669,18 +3671,18 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
                 Control->CanGlue);
         fprintf(file, "%s  <Prompt>%s</Prompt>\n", pad,
                 vdx_convert_xml_string(Control->Prompt));
-        fprintf(file, "%s  <X>%f</X>\n", pad,
-                Control->X);
-        fprintf(file, "%s  <XCon>%f</XCon>\n", pad,
-                Control->XCon);
-        fprintf(file, "%s  <XDyn>%f</XDyn>\n", pad,
-                Control->XDyn);
-        fprintf(file, "%s  <Y>%f</Y>\n", pad,
-                Control->Y);
-        fprintf(file, "%s  <YCon>%f</YCon>\n", pad,
-                Control->YCon);
-        fprintf(file, "%s  <YDyn>%f</YDyn>\n", pad,
-                Control->YDyn);
+        fprintf(file, "%s  <X>%s</X>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Control->X));
+        fprintf(file, "%s  <XCon>%s</XCon>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Control->XCon));
+        fprintf(file, "%s  <XDyn>%s</XDyn>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Control->XDyn));
+        fprintf(file, "%s  <Y>%s</Y>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Control->Y));
+        fprintf(file, "%s  <YCon>%s</YCon>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Control->YCon));
+        fprintf(file, "%s  <YDyn>%s</YDyn>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Control->YDyn));
         break;
 
     case vdx_types_CustomProp:
@@ -3820,35 +3822,35 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
     case vdx_types_Ellipse:
         Ellipse = (const struct vdx_Ellipse *)(p);
         fprintf(file, "%s<Ellipse IX='%u'>\n", pad, Ellipse->IX);
-        fprintf(file, "%s  <A>%f</A>\n", pad,
-                Ellipse->A);
-        fprintf(file, "%s  <B>%f</B>\n", pad,
-                Ellipse->B);
-        fprintf(file, "%s  <C>%f</C>\n", pad,
-                Ellipse->C);
-        fprintf(file, "%s  <D>%f</D>\n", pad,
-                Ellipse->D);
-        fprintf(file, "%s  <X>%f</X>\n", pad,
-                Ellipse->X);
-        fprintf(file, "%s  <Y>%f</Y>\n", pad,
-                Ellipse->Y);
+        fprintf(file, "%s  <A>%s</A>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Ellipse->A));
+        fprintf(file, "%s  <B>%s</B>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Ellipse->B));
+        fprintf(file, "%s  <C>%s</C>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Ellipse->C));
+        fprintf(file, "%s  <D>%s</D>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Ellipse->D));
+        fprintf(file, "%s  <X>%s</X>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Ellipse->X));
+        fprintf(file, "%s  <Y>%s</Y>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Ellipse->Y));
         break;
 
     case vdx_types_EllipticalArcTo:
         EllipticalArcTo = (const struct vdx_EllipticalArcTo *)(p);
         fprintf(file, "%s<EllipticalArcTo IX='%u'>\n", pad, EllipticalArcTo->IX);
-        fprintf(file, "%s  <A>%f</A>\n", pad,
-                EllipticalArcTo->A);
-        fprintf(file, "%s  <B>%f</B>\n", pad,
-                EllipticalArcTo->B);
-        fprintf(file, "%s  <C>%f</C>\n", pad,
-                EllipticalArcTo->C);
-        fprintf(file, "%s  <D>%f</D>\n", pad,
-                EllipticalArcTo->D);
-        fprintf(file, "%s  <X>%f</X>\n", pad,
-                EllipticalArcTo->X);
-        fprintf(file, "%s  <Y>%f</Y>\n", pad,
-                EllipticalArcTo->Y);
+        fprintf(file, "%s  <A>%s</A>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", EllipticalArcTo->A));
+        fprintf(file, "%s  <B>%s</B>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", EllipticalArcTo->B));
+        fprintf(file, "%s  <C>%s</C>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", EllipticalArcTo->C));
+        fprintf(file, "%s  <D>%s</D>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", EllipticalArcTo->D));
+        fprintf(file, "%s  <X>%s</X>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", EllipticalArcTo->X));
+        fprintf(file, "%s  <Y>%s</Y>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", EllipticalArcTo->Y));
         break;
 
     case vdx_types_Event:
@@ -3856,8 +3858,8 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
         fprintf(file, "%s<Event>\n", pad);
         fprintf(file, "%s  <EventDblClick>%u</EventDblClick>\n", pad,
                 Event->EventDblClick);
-        fprintf(file, "%s  <EventDrop>%f</EventDrop>\n", pad,
-                Event->EventDrop);
+        fprintf(file, "%s  <EventDrop>%s</EventDrop>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Event->EventDrop));
         fprintf(file, "%s  <EventXFMod>%u</EventXFMod>\n", pad,
                 Event->EventXFMod);
         fprintf(file, "%s  <TheData>%u</TheData>\n", pad,
@@ -3922,8 +3924,8 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
                 Field->Calendar);
         fprintf(file, "%s  <EditMode>%u</EditMode>\n", pad,
                 Field->EditMode);
-        fprintf(file, "%s  <Format>%f</Format>\n", pad,
-                Field->Format);
+        fprintf(file, "%s  <Format>%s</Format>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Field->Format));
         fprintf(file, "%s  <ObjectKind>%u</ObjectKind>\n", pad,
                 Field->ObjectKind);
         fprintf(file, "%s  <Type>%u</Type>\n", pad,
@@ -3934,8 +3936,8 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
                 Field->UICod);
         fprintf(file, "%s  <UIFmt>%u</UIFmt>\n", pad,
                 Field->UIFmt);
-        fprintf(file, "%s  <Value>%f</Value>\n", pad,
-                Field->Value);
+        fprintf(file, "%s  <Value>%s</Value>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Field->Value));
         break;
 
     case vdx_types_Fill:
@@ -3944,28 +3946,28 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
         fprintf(file, "%s  <FillBkgnd>%s</FillBkgnd>\n", pad,
                 vdx_string_color(Fill->FillBkgnd));
 	if (Fill->FillBkgndTrans)
-          fprintf(file, "%s  <FillBkgndTrans>%f</FillBkgndTrans>\n", pad,
-                  Fill->FillBkgndTrans);
+          fprintf(file, "%s  <FillBkgndTrans>%s</FillBkgndTrans>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Fill->FillBkgndTrans));
         fprintf(file, "%s  <FillForegnd>%s</FillForegnd>\n", pad,
                 vdx_string_color(Fill->FillForegnd));
 	if (Fill->FillForegndTrans)
-          fprintf(file, "%s  <FillForegndTrans>%f</FillForegndTrans>\n", pad,
-                  Fill->FillForegndTrans);
+          fprintf(file, "%s  <FillForegndTrans>%s</FillForegndTrans>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Fill->FillForegndTrans));
 	if (Fill->FillPattern)
           fprintf(file, "%s  <FillPattern>%u</FillPattern>\n", pad,
                   Fill->FillPattern);
 	if (Fill->ShapeShdwObliqueAngle)
-          fprintf(file, "%s  <ShapeShdwObliqueAngle>%f</ShapeShdwObliqueAngle>\n", pad,
-                  Fill->ShapeShdwObliqueAngle);
+          fprintf(file, "%s  <ShapeShdwObliqueAngle>%s</ShapeShdwObliqueAngle>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Fill->ShapeShdwObliqueAngle));
 	if (Fill->ShapeShdwOffsetX)
-          fprintf(file, "%s  <ShapeShdwOffsetX>%f</ShapeShdwOffsetX>\n", pad,
-                  Fill->ShapeShdwOffsetX);
+          fprintf(file, "%s  <ShapeShdwOffsetX>%s</ShapeShdwOffsetX>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Fill->ShapeShdwOffsetX));
 	if (Fill->ShapeShdwOffsetY)
-          fprintf(file, "%s  <ShapeShdwOffsetY>%f</ShapeShdwOffsetY>\n", pad,
-                  Fill->ShapeShdwOffsetY);
+          fprintf(file, "%s  <ShapeShdwOffsetY>%s</ShapeShdwOffsetY>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Fill->ShapeShdwOffsetY));
 	if (Fill->ShapeShdwScaleFactor)
-          fprintf(file, "%s  <ShapeShdwScaleFactor>%f</ShapeShdwScaleFactor>\n", pad,
-                  Fill->ShapeShdwScaleFactor);
+          fprintf(file, "%s  <ShapeShdwScaleFactor>%s</ShapeShdwScaleFactor>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Fill->ShapeShdwScaleFactor));
 	if (Fill->ShapeShdwType)
           fprintf(file, "%s  <ShapeShdwType>%u</ShapeShdwType>\n", pad,
                   Fill->ShapeShdwType);
@@ -3973,13 +3975,13 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
           fprintf(file, "%s  <ShdwBkgnd>%u</ShdwBkgnd>\n", pad,
                   Fill->ShdwBkgnd);
 	if (Fill->ShdwBkgndTrans)
-          fprintf(file, "%s  <ShdwBkgndTrans>%f</ShdwBkgndTrans>\n", pad,
-                  Fill->ShdwBkgndTrans);
+          fprintf(file, "%s  <ShdwBkgndTrans>%s</ShdwBkgndTrans>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Fill->ShdwBkgndTrans));
         fprintf(file, "%s  <ShdwForegnd>%s</ShdwForegnd>\n", pad,
                 vdx_string_color(Fill->ShdwForegnd));
 	if (Fill->ShdwForegndTrans)
-          fprintf(file, "%s  <ShdwForegndTrans>%f</ShdwForegndTrans>\n", pad,
-                  Fill->ShdwForegndTrans);
+          fprintf(file, "%s  <ShdwForegndTrans>%s</ShdwForegndTrans>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Fill->ShdwForegndTrans));
 	if (Fill->ShdwPattern)
           fprintf(file, "%s  <ShdwPattern>%u</ShdwPattern>\n", pad,
                   Fill->ShdwPattern);
@@ -4018,22 +4020,22 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
     case vdx_types_Foreign:
         Foreign = (const struct vdx_Foreign *)(p);
         fprintf(file, "%s<Foreign>\n", pad);
-        fprintf(file, "%s  <ImgHeight>%f</ImgHeight>\n", pad,
-                Foreign->ImgHeight);
-        fprintf(file, "%s  <ImgOffsetX>%f</ImgOffsetX>\n", pad,
-                Foreign->ImgOffsetX);
-        fprintf(file, "%s  <ImgOffsetY>%f</ImgOffsetY>\n", pad,
-                Foreign->ImgOffsetY);
-        fprintf(file, "%s  <ImgWidth>%f</ImgWidth>\n", pad,
-                Foreign->ImgWidth);
+        fprintf(file, "%s  <ImgHeight>%s</ImgHeight>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Foreign->ImgHeight));
+        fprintf(file, "%s  <ImgOffsetX>%s</ImgOffsetX>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Foreign->ImgOffsetX));
+        fprintf(file, "%s  <ImgOffsetY>%s</ImgOffsetY>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Foreign->ImgOffsetY));
+        fprintf(file, "%s  <ImgWidth>%s</ImgWidth>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Foreign->ImgWidth));
         break;
 
     case vdx_types_ForeignData:
         ForeignData = (const struct vdx_ForeignData *)(p);
 #if 0
-        fprintf(file, "%s<ForeignData CompressionLevel='%f' CompressionType='%s' ForeignType='%s' ObjectHeight='%f' ObjectWidth='%f' ShowAsIcon='%u'",
-		pad, ForeignData->CompressionLevel, vdx_convert_xml_string(ForeignData->CompressionType), vdx_convert_xml_string(ForeignData->ForeignType),
-		ForeignData->ObjectHeight, ForeignData->ObjectWidth, ForeignData->ShowAsIcon);
+        fprintf(file, "%s<ForeignData CompressionLevel='%s' CompressionType='%s' ForeignType='%s' ObjectHeight='%s' ObjectWidth='%s' ShowAsIcon='%u'",
+		pad, g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", ForeignData->CompressionLevel), vdx_convert_xml_string(ForeignData->CompressionType), vdx_convert_xml_string(ForeignData->ForeignType),
+		g_ascii_formatd(buf[1], sizeof(buf[1]), "%f", ForeignData->ObjectHeight), g_ascii_formatd(buf[2], sizeof(buf[2]), "%f", ForeignData->ObjectWidth), ForeignData->ShowAsIcon);
 #else
 	/* avoid writing optional values which are almost certainly meaningless */
         fprintf(file, "%s<ForeignData CompressionType='%s' ForeignType='%s' ",
@@ -4094,14 +4096,14 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
         fprintf(file, "%s<HeaderFooter HeaderFooterColor='%s'>\n", pad, vdx_convert_xml_string(HeaderFooter->HeaderFooterColor));
         fprintf(file, "%s  <FooterLeft>%s</FooterLeft>\n", pad,
                 vdx_convert_xml_string(HeaderFooter->FooterLeft));
-        fprintf(file, "%s  <FooterMargin>%f</FooterMargin>\n", pad,
-                HeaderFooter->FooterMargin);
+        fprintf(file, "%s  <FooterMargin>%s</FooterMargin>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", HeaderFooter->FooterMargin));
         fprintf(file, "%s  <HeaderFooterFont>%u</HeaderFooterFont>\n", pad,
                 HeaderFooter->HeaderFooterFont);
         fprintf(file, "%s  <HeaderLeft>%s</HeaderLeft>\n", pad,
                 vdx_convert_xml_string(HeaderFooter->HeaderLeft));
-        fprintf(file, "%s  <HeaderMargin>%f</HeaderMargin>\n", pad,
-                HeaderFooter->HeaderMargin);
+        fprintf(file, "%s  <HeaderMargin>%s</HeaderMargin>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", HeaderFooter->HeaderMargin));
         fprintf(file, "%s  <HeaderRight>%s</HeaderRight>\n", pad,
                 vdx_convert_xml_string(HeaderFooter->HeaderRight));
         break;
@@ -4182,33 +4184,33 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
     case vdx_types_Image:
         Image = (const struct vdx_Image *)(p);
         fprintf(file, "%s<Image>\n", pad);
-        fprintf(file, "%s  <Blur>%f</Blur>\n", pad,
-                Image->Blur);
-        fprintf(file, "%s  <Brightness>%f</Brightness>\n", pad,
-                Image->Brightness);
-        fprintf(file, "%s  <Contrast>%f</Contrast>\n", pad,
-                Image->Contrast);
-        fprintf(file, "%s  <Denoise>%f</Denoise>\n", pad,
-                Image->Denoise);
+        fprintf(file, "%s  <Blur>%s</Blur>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Image->Blur));
+        fprintf(file, "%s  <Brightness>%s</Brightness>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Image->Brightness));
+        fprintf(file, "%s  <Contrast>%s</Contrast>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Image->Contrast));
+        fprintf(file, "%s  <Denoise>%s</Denoise>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Image->Denoise));
         fprintf(file, "%s  <Gamma>%u</Gamma>\n", pad,
                 Image->Gamma);
-        fprintf(file, "%s  <Sharpen>%f</Sharpen>\n", pad,
-                Image->Sharpen);
-        fprintf(file, "%s  <Transparency>%f</Transparency>\n", pad,
-                Image->Transparency);
+        fprintf(file, "%s  <Sharpen>%s</Sharpen>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Image->Sharpen));
+        fprintf(file, "%s  <Transparency>%s</Transparency>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Image->Transparency));
         break;
 
     case vdx_types_InfiniteLine:
         InfiniteLine = (const struct vdx_InfiniteLine *)(p);
         fprintf(file, "%s<InfiniteLine IX='%u'>\n", pad, InfiniteLine->IX);
-        fprintf(file, "%s  <A>%f</A>\n", pad,
-                InfiniteLine->A);
-        fprintf(file, "%s  <B>%f</B>\n", pad,
-                InfiniteLine->B);
-        fprintf(file, "%s  <X>%f</X>\n", pad,
-                InfiniteLine->X);
-        fprintf(file, "%s  <Y>%f</Y>\n", pad,
-                InfiniteLine->Y);
+        fprintf(file, "%s  <A>%s</A>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", InfiniteLine->A));
+        fprintf(file, "%s  <B>%s</B>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", InfiniteLine->B));
+        fprintf(file, "%s  <X>%s</X>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", InfiniteLine->X));
+        fprintf(file, "%s  <Y>%s</Y>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", InfiniteLine->Y));
         break;
 
     case vdx_types_Layer:
@@ -4218,8 +4220,8 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
                 Layer->Active);
         fprintf(file, "%s  <Color>%u</Color>\n", pad,
                 Layer->Color);
-        fprintf(file, "%s  <ColorTrans>%f</ColorTrans>\n", pad,
-                Layer->ColorTrans);
+        fprintf(file, "%s  <ColorTrans>%s</ColorTrans>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Layer->ColorTrans));
         fprintf(file, "%s  <Glue>%u</Glue>\n", pad,
                 Layer->Glue);
         fprintf(file, "%s  <Lock>%u</Lock>\n", pad,
@@ -4301,17 +4303,17 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
         fprintf(file, "%s  <LineColor>%s</LineColor>\n", pad,
                 vdx_string_color(Line->LineColor));
 	if (Line->LineColorTrans)
-          fprintf(file, "%s  <LineColorTrans>%f</LineColorTrans>\n", pad,
-                  Line->LineColorTrans);
+          fprintf(file, "%s  <LineColorTrans>%s</LineColorTrans>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Line->LineColorTrans));
 	if (Line->LinePattern)
           fprintf(file, "%s  <LinePattern>%u</LinePattern>\n", pad,
                   Line->LinePattern);
 	if (Line->LineWeight)
-          fprintf(file, "%s  <LineWeight>%f</LineWeight>\n", pad,
-                  Line->LineWeight);
+          fprintf(file, "%s  <LineWeight>%s</LineWeight>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Line->LineWeight));
 	if (Line->Rounding)
-          fprintf(file, "%s  <Rounding>%f</Rounding>\n", pad,
-                  Line->Rounding);
+          fprintf(file, "%s  <Rounding>%s</Rounding>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Line->Rounding));
         break;
 
     case vdx_types_LineTo:
@@ -4321,10 +4323,10 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
             fprintf(file, " Del='%u'",
                     LineTo->Del);
         fprintf(file, ">\n");
-        fprintf(file, "%s  <X>%f</X>\n", pad,
-                LineTo->X);
-        fprintf(file, "%s  <Y>%f</Y>\n", pad,
-                LineTo->Y);
+        fprintf(file, "%s  <X>%s</X>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", LineTo->X));
+        fprintf(file, "%s  <Y>%s</Y>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", LineTo->Y));
         break;
 
     case vdx_types_Master:
@@ -4404,34 +4406,34 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
     case vdx_types_MoveTo:
         MoveTo = (const struct vdx_MoveTo *)(p);
         fprintf(file, "%s<MoveTo IX='%u'>\n", pad, MoveTo->IX);
-        fprintf(file, "%s  <X>%f</X>\n", pad,
-                MoveTo->X);
-        fprintf(file, "%s  <Y>%f</Y>\n", pad,
-                MoveTo->Y);
+        fprintf(file, "%s  <X>%s</X>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", MoveTo->X));
+        fprintf(file, "%s  <Y>%s</Y>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", MoveTo->Y));
         break;
 
     case vdx_types_NURBSTo:
         NURBSTo = (const struct vdx_NURBSTo *)(p);
         fprintf(file, "%s<NURBSTo IX='%u'>\n", pad, NURBSTo->IX);
-        fprintf(file, "%s  <A>%f</A>\n", pad,
-                NURBSTo->A);
-        fprintf(file, "%s  <B>%f</B>\n", pad,
-                NURBSTo->B);
-        fprintf(file, "%s  <C>%f</C>\n", pad,
-                NURBSTo->C);
-        fprintf(file, "%s  <D>%f</D>\n", pad,
-                NURBSTo->D);
+        fprintf(file, "%s  <A>%s</A>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", NURBSTo->A));
+        fprintf(file, "%s  <B>%s</B>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", NURBSTo->B));
+        fprintf(file, "%s  <C>%s</C>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", NURBSTo->C));
+        fprintf(file, "%s  <D>%s</D>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", NURBSTo->D));
         fprintf(file, "%s  <E>%s</E>\n", pad,
                 vdx_convert_xml_string(NURBSTo->E));
-        fprintf(file, "%s  <X>%f</X>\n", pad,
-                NURBSTo->X);
-        fprintf(file, "%s  <Y>%f</Y>\n", pad,
-                NURBSTo->Y);
+        fprintf(file, "%s  <X>%s</X>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", NURBSTo->X));
+        fprintf(file, "%s  <Y>%s</Y>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", NURBSTo->Y));
         break;
 
     case vdx_types_Page:
         Page = (const struct vdx_Page *)(p);
-        fprintf(file, "%s<Page Background='%u' ID='%u' ViewCenterX='%f' ViewCenterY='%f' ViewScale='%f'", pad, Page->Background, Page->ID, Page->ViewCenterX, Page->ViewCenterY, Page->ViewScale);
+        fprintf(file, "%s<Page Background='%u' ID='%u' ViewCenterX='%s' ViewCenterY='%s' ViewScale='%s'", pad, Page->Background, Page->ID, g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Page->ViewCenterX), g_ascii_formatd(buf[1], sizeof(buf[1]), "%f", Page->ViewCenterY), g_ascii_formatd(buf[2], sizeof(buf[2]), "%f", Page->ViewScale));
         if (Page->BackPage_exists)
             fprintf(file, " BackPage='%u'",
                     Page->BackPage);
@@ -4452,14 +4454,14 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
     case vdx_types_PageLayout:
         PageLayout = (const struct vdx_PageLayout *)(p);
         fprintf(file, "%s<PageLayout>\n", pad);
-        fprintf(file, "%s  <AvenueSizeX>%f</AvenueSizeX>\n", pad,
-                PageLayout->AvenueSizeX);
-        fprintf(file, "%s  <AvenueSizeY>%f</AvenueSizeY>\n", pad,
-                PageLayout->AvenueSizeY);
-        fprintf(file, "%s  <BlockSizeX>%f</BlockSizeX>\n", pad,
-                PageLayout->BlockSizeX);
-        fprintf(file, "%s  <BlockSizeY>%f</BlockSizeY>\n", pad,
-                PageLayout->BlockSizeY);
+        fprintf(file, "%s  <AvenueSizeX>%s</AvenueSizeX>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PageLayout->AvenueSizeX));
+        fprintf(file, "%s  <AvenueSizeY>%s</AvenueSizeY>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PageLayout->AvenueSizeY));
+        fprintf(file, "%s  <BlockSizeX>%s</BlockSizeX>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PageLayout->BlockSizeX));
+        fprintf(file, "%s  <BlockSizeY>%s</BlockSizeY>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PageLayout->BlockSizeY));
         fprintf(file, "%s  <CtrlAsInput>%u</CtrlAsInput>\n", pad,
                 PageLayout->CtrlAsInput);
         fprintf(file, "%s  <DynamicsOff>%u</DynamicsOff>\n", pad,
@@ -4472,22 +4474,22 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
                 PageLayout->LineAdjustTo);
         fprintf(file, "%s  <LineJumpCode>%u</LineJumpCode>\n", pad,
                 PageLayout->LineJumpCode);
-        fprintf(file, "%s  <LineJumpFactorX>%f</LineJumpFactorX>\n", pad,
-                PageLayout->LineJumpFactorX);
-        fprintf(file, "%s  <LineJumpFactorY>%f</LineJumpFactorY>\n", pad,
-                PageLayout->LineJumpFactorY);
+        fprintf(file, "%s  <LineJumpFactorX>%s</LineJumpFactorX>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PageLayout->LineJumpFactorX));
+        fprintf(file, "%s  <LineJumpFactorY>%s</LineJumpFactorY>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PageLayout->LineJumpFactorY));
         fprintf(file, "%s  <LineJumpStyle>%u</LineJumpStyle>\n", pad,
                 PageLayout->LineJumpStyle);
         fprintf(file, "%s  <LineRouteExt>%u</LineRouteExt>\n", pad,
                 PageLayout->LineRouteExt);
-        fprintf(file, "%s  <LineToLineX>%f</LineToLineX>\n", pad,
-                PageLayout->LineToLineX);
-        fprintf(file, "%s  <LineToLineY>%f</LineToLineY>\n", pad,
-                PageLayout->LineToLineY);
-        fprintf(file, "%s  <LineToNodeX>%f</LineToNodeX>\n", pad,
-                PageLayout->LineToNodeX);
-        fprintf(file, "%s  <LineToNodeY>%f</LineToNodeY>\n", pad,
-                PageLayout->LineToNodeY);
+        fprintf(file, "%s  <LineToLineX>%s</LineToLineX>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PageLayout->LineToLineX));
+        fprintf(file, "%s  <LineToLineY>%s</LineToLineY>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PageLayout->LineToLineY));
+        fprintf(file, "%s  <LineToNodeX>%s</LineToNodeX>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PageLayout->LineToNodeX));
+        fprintf(file, "%s  <LineToNodeY>%s</LineToNodeY>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PageLayout->LineToNodeY));
         fprintf(file, "%s  <PageLineJumpDirX>%u</PageLineJumpDirX>\n", pad,
                 PageLayout->PageLineJumpDirX);
         fprintf(file, "%s  <PageLineJumpDirY>%u</PageLineJumpDirY>\n", pad,
@@ -4511,28 +4513,28 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
     case vdx_types_PageProps:
         PageProps = (const struct vdx_PageProps *)(p);
         fprintf(file, "%s<PageProps>\n", pad);
-        fprintf(file, "%s  <DrawingScale>%f</DrawingScale>\n", pad,
-                PageProps->DrawingScale);
+        fprintf(file, "%s  <DrawingScale>%s</DrawingScale>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PageProps->DrawingScale));
         fprintf(file, "%s  <DrawingScaleType>%u</DrawingScaleType>\n", pad,
                 PageProps->DrawingScaleType);
         fprintf(file, "%s  <DrawingSizeType>%u</DrawingSizeType>\n", pad,
                 PageProps->DrawingSizeType);
         fprintf(file, "%s  <InhibitSnap>%u</InhibitSnap>\n", pad,
                 PageProps->InhibitSnap);
-        fprintf(file, "%s  <PageHeight>%f</PageHeight>\n", pad,
-                PageProps->PageHeight);
-        fprintf(file, "%s  <PageScale>%f</PageScale>\n", pad,
-                PageProps->PageScale);
-        fprintf(file, "%s  <PageWidth>%f</PageWidth>\n", pad,
-                PageProps->PageWidth);
-        fprintf(file, "%s  <ShdwObliqueAngle>%f</ShdwObliqueAngle>\n", pad,
-                PageProps->ShdwObliqueAngle);
-        fprintf(file, "%s  <ShdwOffsetX>%f</ShdwOffsetX>\n", pad,
-                PageProps->ShdwOffsetX);
-        fprintf(file, "%s  <ShdwOffsetY>%f</ShdwOffsetY>\n", pad,
-                PageProps->ShdwOffsetY);
-        fprintf(file, "%s  <ShdwScaleFactor>%f</ShdwScaleFactor>\n", pad,
-                PageProps->ShdwScaleFactor);
+        fprintf(file, "%s  <PageHeight>%s</PageHeight>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PageProps->PageHeight));
+        fprintf(file, "%s  <PageScale>%s</PageScale>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PageProps->PageScale));
+        fprintf(file, "%s  <PageWidth>%s</PageWidth>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PageProps->PageWidth));
+        fprintf(file, "%s  <ShdwObliqueAngle>%s</ShdwObliqueAngle>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PageProps->ShdwObliqueAngle));
+        fprintf(file, "%s  <ShdwOffsetX>%s</ShdwOffsetX>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PageProps->ShdwOffsetX));
+        fprintf(file, "%s  <ShdwOffsetY>%s</ShdwOffsetY>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PageProps->ShdwOffsetY));
+        fprintf(file, "%s  <ShdwScaleFactor>%s</ShdwScaleFactor>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PageProps->ShdwScaleFactor));
         fprintf(file, "%s  <ShdwType>%u</ShdwType>\n", pad,
                 PageProps->ShdwType);
         fprintf(file, "%s  <UIVisibility>%u</UIVisibility>\n", pad,
@@ -4584,26 +4586,26 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
         fprintf(file, "%s  <HorzAlign>%u</HorzAlign>\n", pad,
                 Para->HorzAlign);
 	if (Para->IndFirst)
-          fprintf(file, "%s  <IndFirst>%f</IndFirst>\n", pad,
-                  Para->IndFirst);
+          fprintf(file, "%s  <IndFirst>%s</IndFirst>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Para->IndFirst));
 	if (Para->IndLeft)
-          fprintf(file, "%s  <IndLeft>%f</IndLeft>\n", pad,
-                  Para->IndLeft);
+          fprintf(file, "%s  <IndLeft>%s</IndLeft>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Para->IndLeft));
 	if (Para->IndRight)
-          fprintf(file, "%s  <IndRight>%f</IndRight>\n", pad,
-                  Para->IndRight);
+          fprintf(file, "%s  <IndRight>%s</IndRight>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Para->IndRight));
 	if (Para->LocalizeBulletFont)
           fprintf(file, "%s  <LocalizeBulletFont>%u</LocalizeBulletFont>\n", pad,
                   Para->LocalizeBulletFont);
 	if (Para->SpAfter)
-          fprintf(file, "%s  <SpAfter>%f</SpAfter>\n", pad,
-                  Para->SpAfter);
+          fprintf(file, "%s  <SpAfter>%s</SpAfter>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Para->SpAfter));
 	if (Para->SpBefore)
-          fprintf(file, "%s  <SpBefore>%f</SpBefore>\n", pad,
-                  Para->SpBefore);
+          fprintf(file, "%s  <SpBefore>%s</SpBefore>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Para->SpBefore));
 	if (Para->SpLine)
-          fprintf(file, "%s  <SpLine>%f</SpLine>\n", pad,
-                Para->SpLine);
+          fprintf(file, "%s  <SpLine>%s</SpLine>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Para->SpLine));
 	if (Para->TextPosAfterBullet)
           fprintf(file, "%s  <TextPosAfterBullet>%u</TextPosAfterBullet>\n", pad,
                 Para->TextPosAfterBullet);
@@ -4612,12 +4614,12 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
     case vdx_types_PolylineTo:
         PolylineTo = (const struct vdx_PolylineTo *)(p);
         fprintf(file, "%s<PolylineTo IX='%u'>\n", pad, PolylineTo->IX);
-        fprintf(file, "%s  <A>%f</A>\n", pad,
-                PolylineTo->A);
-        fprintf(file, "%s  <X>%f</X>\n", pad,
-                PolylineTo->X);
-        fprintf(file, "%s  <Y>%f</Y>\n", pad,
-                PolylineTo->Y);
+        fprintf(file, "%s  <A>%s</A>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PolylineTo->A));
+        fprintf(file, "%s  <X>%s</X>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PolylineTo->X));
+        fprintf(file, "%s  <Y>%s</Y>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PolylineTo->Y));
         break;
 
     case vdx_types_PreviewPicture:
@@ -4643,14 +4645,14 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
                 PrintProps->CenterY);
         fprintf(file, "%s  <OnPage>%u</OnPage>\n", pad,
                 PrintProps->OnPage);
-        fprintf(file, "%s  <PageBottomMargin>%f</PageBottomMargin>\n", pad,
-                PrintProps->PageBottomMargin);
-        fprintf(file, "%s  <PageLeftMargin>%f</PageLeftMargin>\n", pad,
-                PrintProps->PageLeftMargin);
-        fprintf(file, "%s  <PageRightMargin>%f</PageRightMargin>\n", pad,
-                PrintProps->PageRightMargin);
-        fprintf(file, "%s  <PageTopMargin>%f</PageTopMargin>\n", pad,
-                PrintProps->PageTopMargin);
+        fprintf(file, "%s  <PageBottomMargin>%s</PageBottomMargin>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PrintProps->PageBottomMargin));
+        fprintf(file, "%s  <PageLeftMargin>%s</PageLeftMargin>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PrintProps->PageLeftMargin));
+        fprintf(file, "%s  <PageRightMargin>%s</PageRightMargin>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PrintProps->PageRightMargin));
+        fprintf(file, "%s  <PageTopMargin>%s</PageTopMargin>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PrintProps->PageTopMargin));
         fprintf(file, "%s  <PagesX>%u</PagesX>\n", pad,
                 PrintProps->PagesX);
         fprintf(file, "%s  <PagesY>%u</PagesY>\n", pad,
@@ -4663,8 +4665,8 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
                 PrintProps->PrintGrid);
         fprintf(file, "%s  <PrintPageOrientation>%u</PrintPageOrientation>\n", pad,
                 PrintProps->PrintPageOrientation);
-        fprintf(file, "%s  <ScaleX>%f</ScaleX>\n", pad,
-                PrintProps->ScaleX);
+        fprintf(file, "%s  <ScaleX>%s</ScaleX>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PrintProps->ScaleX));
         fprintf(file, "%s  <ScaleY>%u</ScaleY>\n", pad,
                 PrintProps->ScaleY);
         break;
@@ -4672,14 +4674,14 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
     case vdx_types_PrintSetup:
         PrintSetup = (const struct vdx_PrintSetup *)(p);
         fprintf(file, "%s<PrintSetup>\n", pad);
-        fprintf(file, "%s  <PageBottomMargin>%f</PageBottomMargin>\n", pad,
-                PrintSetup->PageBottomMargin);
-        fprintf(file, "%s  <PageLeftMargin>%f</PageLeftMargin>\n", pad,
-                PrintSetup->PageLeftMargin);
-        fprintf(file, "%s  <PageRightMargin>%f</PageRightMargin>\n", pad,
-                PrintSetup->PageRightMargin);
-        fprintf(file, "%s  <PageTopMargin>%f</PageTopMargin>\n", pad,
-                PrintSetup->PageTopMargin);
+        fprintf(file, "%s  <PageBottomMargin>%s</PageBottomMargin>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PrintSetup->PageBottomMargin));
+        fprintf(file, "%s  <PageLeftMargin>%s</PageLeftMargin>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PrintSetup->PageLeftMargin));
+        fprintf(file, "%s  <PageRightMargin>%s</PageRightMargin>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PrintSetup->PageRightMargin));
+        fprintf(file, "%s  <PageTopMargin>%s</PageTopMargin>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", PrintSetup->PageTopMargin));
         fprintf(file, "%s  <PaperSize>%u</PaperSize>\n", pad,
                 PrintSetup->PaperSize);
         fprintf(file, "%s  <PrintCenteredH>%u</PrintCenteredH>\n", pad,
@@ -4724,8 +4726,8 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
                 vdx_convert_xml_string(Prop->SortKey));
         fprintf(file, "%s  <Type>%u</Type>\n", pad,
                 Prop->Type);
-        fprintf(file, "%s  <Value>%f</Value>\n", pad,
-                Prop->Value);
+        fprintf(file, "%s  <Value>%s</Value>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Prop->Value));
         fprintf(file, "%s  <Verify>%u</Verify>\n", pad,
                 Prop->Verify);
         break;
@@ -4774,41 +4776,41 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
         fprintf(file, "%s<RulerGrid>\n", pad);
         fprintf(file, "%s  <XGridDensity>%u</XGridDensity>\n", pad,
                 RulerGrid->XGridDensity);
-        fprintf(file, "%s  <XGridOrigin>%f</XGridOrigin>\n", pad,
-                RulerGrid->XGridOrigin);
-        fprintf(file, "%s  <XGridSpacing>%f</XGridSpacing>\n", pad,
-                RulerGrid->XGridSpacing);
+        fprintf(file, "%s  <XGridOrigin>%s</XGridOrigin>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", RulerGrid->XGridOrigin));
+        fprintf(file, "%s  <XGridSpacing>%s</XGridSpacing>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", RulerGrid->XGridSpacing));
         fprintf(file, "%s  <XRulerDensity>%u</XRulerDensity>\n", pad,
                 RulerGrid->XRulerDensity);
-        fprintf(file, "%s  <XRulerOrigin>%f</XRulerOrigin>\n", pad,
-                RulerGrid->XRulerOrigin);
+        fprintf(file, "%s  <XRulerOrigin>%s</XRulerOrigin>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", RulerGrid->XRulerOrigin));
         fprintf(file, "%s  <YGridDensity>%u</YGridDensity>\n", pad,
                 RulerGrid->YGridDensity);
-        fprintf(file, "%s  <YGridOrigin>%f</YGridOrigin>\n", pad,
-                RulerGrid->YGridOrigin);
-        fprintf(file, "%s  <YGridSpacing>%f</YGridSpacing>\n", pad,
-                RulerGrid->YGridSpacing);
+        fprintf(file, "%s  <YGridOrigin>%s</YGridOrigin>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", RulerGrid->YGridOrigin));
+        fprintf(file, "%s  <YGridSpacing>%s</YGridSpacing>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", RulerGrid->YGridSpacing));
         fprintf(file, "%s  <YRulerDensity>%u</YRulerDensity>\n", pad,
                 RulerGrid->YRulerDensity);
-        fprintf(file, "%s  <YRulerOrigin>%f</YRulerOrigin>\n", pad,
-                RulerGrid->YRulerOrigin);
+        fprintf(file, "%s  <YRulerOrigin>%s</YRulerOrigin>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", RulerGrid->YRulerOrigin));
         break;
 
     case vdx_types_Scratch:
         Scratch = (const struct vdx_Scratch *)(p);
         fprintf(file, "%s<Scratch IX='%u'>\n", pad, Scratch->IX);
-        fprintf(file, "%s  <A>%f</A>\n", pad,
-                Scratch->A);
-        fprintf(file, "%s  <B>%f</B>\n", pad,
-                Scratch->B);
-        fprintf(file, "%s  <C>%f</C>\n", pad,
-                Scratch->C);
-        fprintf(file, "%s  <D>%f</D>\n", pad,
-                Scratch->D);
-        fprintf(file, "%s  <X>%f</X>\n", pad,
-                Scratch->X);
-        fprintf(file, "%s  <Y>%f</Y>\n", pad,
-                Scratch->Y);
+        fprintf(file, "%s  <A>%s</A>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Scratch->A));
+        fprintf(file, "%s  <B>%s</B>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Scratch->B));
+        fprintf(file, "%s  <C>%s</C>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Scratch->C));
+        fprintf(file, "%s  <D>%s</D>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Scratch->D));
+        fprintf(file, "%s  <X>%s</X>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Scratch->X));
+        fprintf(file, "%s  <Y>%s</Y>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Scratch->Y));
         break;
 
     case vdx_types_Shape:
@@ -4864,29 +4866,29 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
     case vdx_types_SplineKnot:
         SplineKnot = (const struct vdx_SplineKnot *)(p);
         fprintf(file, "%s<SplineKnot IX='%u'>\n", pad, SplineKnot->IX);
-        fprintf(file, "%s  <A>%f</A>\n", pad,
-                SplineKnot->A);
-        fprintf(file, "%s  <X>%f</X>\n", pad,
-                SplineKnot->X);
-        fprintf(file, "%s  <Y>%f</Y>\n", pad,
-                SplineKnot->Y);
+        fprintf(file, "%s  <A>%s</A>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", SplineKnot->A));
+        fprintf(file, "%s  <X>%s</X>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", SplineKnot->X));
+        fprintf(file, "%s  <Y>%s</Y>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", SplineKnot->Y));
         break;
 
     case vdx_types_SplineStart:
         SplineStart = (const struct vdx_SplineStart *)(p);
         fprintf(file, "%s<SplineStart IX='%u'>\n", pad, SplineStart->IX);
-        fprintf(file, "%s  <A>%f</A>\n", pad,
-                SplineStart->A);
-        fprintf(file, "%s  <B>%f</B>\n", pad,
-                SplineStart->B);
-        fprintf(file, "%s  <C>%f</C>\n", pad,
-                SplineStart->C);
-        fprintf(file, "%s  <D>%f</D>\n", pad,
-                SplineStart->D);
-        fprintf(file, "%s  <X>%f</X>\n", pad,
-                SplineStart->X);
-        fprintf(file, "%s  <Y>%f</Y>\n", pad,
-                SplineStart->Y);
+        fprintf(file, "%s  <A>%s</A>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", SplineStart->A));
+        fprintf(file, "%s  <B>%s</B>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", SplineStart->B));
+        fprintf(file, "%s  <C>%s</C>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", SplineStart->C));
+        fprintf(file, "%s  <D>%s</D>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", SplineStart->D));
+        fprintf(file, "%s  <X>%s</X>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", SplineStart->X));
+        fprintf(file, "%s  <Y>%s</Y>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", SplineStart->Y));
         break;
 
     case vdx_types_StyleProp:
@@ -4933,8 +4935,8 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
         fprintf(file, "%s<Tab IX='%u'>\n", pad, Tab->IX);
         fprintf(file, "%s  <Alignment>%u</Alignment>\n", pad,
                 Tab->Alignment);
-        fprintf(file, "%s  <Position>%f</Position>\n", pad,
-                Tab->Position);
+        fprintf(file, "%s  <Position>%s</Position>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Tab->Position));
         break;
 
     case vdx_types_Tabs:
@@ -4957,22 +4959,22 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
     case vdx_types_TextBlock:
         TextBlock = (const struct vdx_TextBlock *)(p);
         fprintf(file, "%s<TextBlock>\n", pad);
-        fprintf(file, "%s  <BottomMargin>%f</BottomMargin>\n", pad,
-                TextBlock->BottomMargin);
-        fprintf(file, "%s  <DefaultTabStop>%f</DefaultTabStop>\n", pad,
-                TextBlock->DefaultTabStop);
-        fprintf(file, "%s  <LeftMargin>%f</LeftMargin>\n", pad,
-                TextBlock->LeftMargin);
-        fprintf(file, "%s  <RightMargin>%f</RightMargin>\n", pad,
-                TextBlock->RightMargin);
+        fprintf(file, "%s  <BottomMargin>%s</BottomMargin>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", TextBlock->BottomMargin));
+        fprintf(file, "%s  <DefaultTabStop>%s</DefaultTabStop>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", TextBlock->DefaultTabStop));
+        fprintf(file, "%s  <LeftMargin>%s</LeftMargin>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", TextBlock->LeftMargin));
+        fprintf(file, "%s  <RightMargin>%s</RightMargin>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", TextBlock->RightMargin));
         fprintf(file, "%s  <TextBkgnd>%u</TextBkgnd>\n", pad,
                 TextBlock->TextBkgnd);
-        fprintf(file, "%s  <TextBkgndTrans>%f</TextBkgndTrans>\n", pad,
-                TextBlock->TextBkgndTrans);
+        fprintf(file, "%s  <TextBkgndTrans>%s</TextBkgndTrans>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", TextBlock->TextBkgndTrans));
         fprintf(file, "%s  <TextDirection>%u</TextDirection>\n", pad,
                 TextBlock->TextDirection);
-        fprintf(file, "%s  <TopMargin>%f</TopMargin>\n", pad,
-                TextBlock->TopMargin);
+        fprintf(file, "%s  <TopMargin>%s</TopMargin>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", TextBlock->TopMargin));
         fprintf(file, "%s  <VerticalAlign>%u</VerticalAlign>\n", pad,
                 TextBlock->VerticalAlign);
         break;
@@ -4981,26 +4983,26 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
         TextXForm = (const struct vdx_TextXForm *)(p);
         fprintf(file, "%s<TextXForm>\n", pad);
 	if (TextXForm->TxtAngle)
-          fprintf(file, "%s  <TxtAngle>%f</TxtAngle>\n", pad,
-                  TextXForm->TxtAngle);
+          fprintf(file, "%s  <TxtAngle>%s</TxtAngle>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", TextXForm->TxtAngle));
 	if (TextXForm->TxtHeight)
-          fprintf(file, "%s  <TxtHeight>%f</TxtHeight>\n", pad,
-                  TextXForm->TxtHeight);
+          fprintf(file, "%s  <TxtHeight>%s</TxtHeight>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", TextXForm->TxtHeight));
 	if (TextXForm->TxtLocPinX)
-          fprintf(file, "%s  <TxtLocPinX>%f</TxtLocPinX>\n", pad,
-                  TextXForm->TxtLocPinX);
+          fprintf(file, "%s  <TxtLocPinX>%s</TxtLocPinX>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", TextXForm->TxtLocPinX));
 	if (TextXForm->TxtLocPinY)
-          fprintf(file, "%s  <TxtLocPinY>%f</TxtLocPinY>\n", pad,
-                  TextXForm->TxtLocPinY);
+          fprintf(file, "%s  <TxtLocPinY>%s</TxtLocPinY>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", TextXForm->TxtLocPinY));
 	if (TextXForm->TxtPinX)
-          fprintf(file, "%s  <TxtPinX>%f</TxtPinX>\n", pad,
-                  TextXForm->TxtPinX);
+          fprintf(file, "%s  <TxtPinX>%s</TxtPinX>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", TextXForm->TxtPinX));
 	if (TextXForm->TxtPinY)
-          fprintf(file, "%s  <TxtPinY>%f</TxtPinY>\n", pad,
-                  TextXForm->TxtPinY);
+          fprintf(file, "%s  <TxtPinY>%s</TxtPinY>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", TextXForm->TxtPinY));
 	if (TextXForm->TxtWidth)
-          fprintf(file, "%s  <TxtWidth>%f</TxtWidth>\n", pad,
-                  TextXForm->TxtWidth);
+          fprintf(file, "%s  <TxtWidth>%s</TxtWidth>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", TextXForm->TxtWidth));
         break;
 
     case vdx_types_User:
@@ -5015,8 +5017,8 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
         fprintf(file, ">\n");
         fprintf(file, "%s  <Prompt>%s</Prompt>\n", pad,
                 vdx_convert_xml_string(User->Prompt));
-        fprintf(file, "%s  <Value>%f</Value>\n", pad,
-                User->Value);
+        fprintf(file, "%s  <Value>%s</Value>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", User->Value));
         break;
 
     case vdx_types_VisioDocument:
@@ -5040,7 +5042,7 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
 
     case vdx_types_Window:
         Window = (const struct vdx_Window *)(p);
-        fprintf(file, "%s<Window ContainerType='%s' Document='%s' ID='%u' ReadOnly='%u' ViewCenterX='%f' ViewCenterY='%f' ViewScale='%f' WindowType='%s'", pad, vdx_convert_xml_string(Window->ContainerType), vdx_convert_xml_string(Window->Document), Window->ID, Window->ReadOnly, Window->ViewCenterX, Window->ViewCenterY, Window->ViewScale, vdx_convert_xml_string(Window->WindowType));
+        fprintf(file, "%s<Window ContainerType='%s' Document='%s' ID='%u' ReadOnly='%u' ViewCenterX='%s' ViewCenterY='%s' ViewScale='%s' WindowType='%s'", pad, vdx_convert_xml_string(Window->ContainerType), vdx_convert_xml_string(Window->Document), Window->ID, Window->ReadOnly, g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Window->ViewCenterX), g_ascii_formatd(buf[1], sizeof(buf[1]), "%f", Window->ViewCenterY), g_ascii_formatd(buf[2], sizeof(buf[2]), "%f", Window->ViewScale), vdx_convert_xml_string(Window->WindowType));
         if (Window->Page_exists)
             fprintf(file, " Page='%u'",
                     Window->Page);
@@ -5088,8 +5090,8 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
                 Window->StencilGroup);
         fprintf(file, "%s  <StencilGroupPos>%u</StencilGroupPos>\n", pad,
                 Window->StencilGroupPos);
-        fprintf(file, "%s  <TabSplitterPos>%f</TabSplitterPos>\n", pad,
-                Window->TabSplitterPos);
+        fprintf(file, "%s  <TabSplitterPos>%s</TabSplitterPos>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", Window->TabSplitterPos));
         break;
 
     case vdx_types_Windows:
@@ -5110,8 +5112,8 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
         XForm = (const struct vdx_XForm *)(p);
         fprintf(file, "%s<XForm>\n", pad);
 	if (XForm->Angle)
-          fprintf(file, "%s  <Angle>%f</Angle>\n", pad,
-                  XForm->Angle);
+          fprintf(file, "%s  <Angle>%s</Angle>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", XForm->Angle));
 	if (XForm->FlipX)
           fprintf(file, "%s  <FlipX>%u</FlipX>\n", pad,
                   XForm->FlipX);
@@ -5119,39 +5121,39 @@ vdx_write_object(FILE *file, unsigned int depth, const void *p)
           fprintf(file, "%s  <FlipY>%u</FlipY>\n", pad,
                   XForm->FlipY);
 	if (XForm->Height)
-          fprintf(file, "%s  <Height>%f</Height>\n", pad,
-                  XForm->Height);
+          fprintf(file, "%s  <Height>%s</Height>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", XForm->Height));
 	if (XForm->LocPinX)
-          fprintf(file, "%s  <LocPinX>%f</LocPinX>\n", pad,
-                  XForm->LocPinX);
+          fprintf(file, "%s  <LocPinX>%s</LocPinX>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", XForm->LocPinX));
 	if (XForm->LocPinY)
-          fprintf(file, "%s  <LocPinY>%f</LocPinY>\n", pad,
-                  XForm->LocPinY);
+          fprintf(file, "%s  <LocPinY>%s</LocPinY>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", XForm->LocPinY));
 	if (XForm->PinX)
-          fprintf(file, "%s  <PinX>%f</PinX>\n", pad,
-                  XForm->PinX);
+          fprintf(file, "%s  <PinX>%s</PinX>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", XForm->PinX));
 	if (XForm->PinY)
-          fprintf(file, "%s  <PinY>%f</PinY>\n", pad,
-                  XForm->PinY);
+          fprintf(file, "%s  <PinY>%s</PinY>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", XForm->PinY));
 	if (XForm->ResizeMode)
           fprintf(file, "%s  <ResizeMode>%u</ResizeMode>\n", pad,
                   XForm->ResizeMode);
 	if (XForm->Width)
-          fprintf(file, "%s  <Width>%f</Width>\n", pad,
-                  XForm->Width);
+          fprintf(file, "%s  <Width>%s</Width>\n", pad,
+                  g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", XForm->Width));
         break;
 
     case vdx_types_XForm1D:
         XForm1D = (const struct vdx_XForm1D *)(p);
         fprintf(file, "%s<XForm1D>\n", pad);
-        fprintf(file, "%s  <BeginX>%f</BeginX>\n", pad,
-                XForm1D->BeginX);
-        fprintf(file, "%s  <BeginY>%f</BeginY>\n", pad,
-                XForm1D->BeginY);
-        fprintf(file, "%s  <EndX>%f</EndX>\n", pad,
-                XForm1D->EndX);
-        fprintf(file, "%s  <EndY>%f</EndY>\n", pad,
-                XForm1D->EndY);
+        fprintf(file, "%s  <BeginX>%s</BeginX>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", XForm1D->BeginX));
+        fprintf(file, "%s  <BeginY>%s</BeginY>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", XForm1D->BeginY));
+        fprintf(file, "%s  <EndX>%s</EndX>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", XForm1D->EndX));
+        fprintf(file, "%s  <EndY>%s</EndY>\n", pad,
+                g_ascii_formatd(buf[0], sizeof(buf[0]), "%f", XForm1D->EndY));
         break;
 
     case vdx_types_cp:
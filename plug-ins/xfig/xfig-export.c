@@ -58,6 +58,8 @@
 #define DTOSTR_BUF_SIZE G_ASCII_DTOSTR_BUF_SIZE
 #define xfig_dtostr(buf,d) \
 	g_ascii_formatd(buf, sizeof(buf), "%f", d)
+#define xfig_gtostr(buf,d) \
+	g_ascii_formatd(buf, sizeof(buf), "%g", d)
 
 
 #define DIA_XFIG_TYPE_RENDERER dia_xfig_renderer_get_type ()
@@ -803,6 +805,7 @@ draw_arc (DiaRenderer *self,
   char dl_buf[DTOSTR_BUF_SIZE];
   char cx_buf[DTOSTR_BUF_SIZE];
   char cy_buf[DTOSTR_BUF_SIZE];
+  char c_buf[5][DTOSTR_BUF_SIZE];
 
   if (renderer->color_pass) {
     figCheckColor (renderer, color);
@@ -810,12 +813,12 @@ draw_arc (DiaRenderer *self,
   }
 
   fprintf (renderer->file,
-           "#draw_arc center=(%g,%g) radius=%g angle1=%g° angle2=%g°\n",
-           center->x,
-           center->y,
-           (width + height) / 4.0,
-           angle1,
-           angle2);
+           "#draw_arc center=(%s,%s) radius=%s angle1=%s° angle2=%s°\n",
+           xfig_gtostr (c_buf[0], center->x),
+           xfig_gtostr (c_buf[1], center->y),
+           xfig_gtostr (c_buf[2], (width + height) / 4.0),
+           xfig_gtostr (c_buf[3], angle1),
+           xfig_gtostr (c_buf[4], angle2));
 
   /* adjust to radians */
   angle1 *= (M_PI / 180.0);
@@ -887,6 +890,7 @@ draw_arc_with_arrows (DiaRenderer *self,
   char dl_buf[DTOSTR_BUF_SIZE];
   char cx_buf[DTOSTR_BUF_SIZE];
   char cy_buf[DTOSTR_BUF_SIZE];
+  char c_buf[3][DTOSTR_BUF_SIZE];
 
   if (renderer->color_pass) {
     figCheckColor (renderer, color);
@@ -901,11 +905,11 @@ draw_arc_with_arrows (DiaRenderer *self,
   }
 
   fprintf (renderer->file,
-           "#draw_arc_with_arrows center=(%g,%g) radius=%g\n"
+           "#draw_arc_with_arrows center=(%s,%s) radius=%s\n"
            "5 1 %d %d %d %d %d 0 -1 %s %d %d %d %d %s %s %d %d %d %d %d %d\n",
-           center.x,
-           center.y,
-           radius,
+           xfig_gtostr (c_buf[0], center.x),
+           xfig_gtostr (c_buf[1], center.y),
+           xfig_gtostr (c_buf[2], radius),
            figLineStyle (renderer),
            figLineWidth (renderer),
            figColor (renderer, color),
@@ -949,6 +953,7 @@ fill_arc (DiaRenderer *self,
   char dl_buf[DTOSTR_BUF_SIZE];
   char cx_buf[DTOSTR_BUF_SIZE];
   char cy_buf[DTOSTR_BUF_SIZE];
+  char c_buf[5][DTOSTR_BUF_SIZE];
 
   if (renderer->color_pass) {
     figCheckColor (renderer, color);
@@ -956,12 +961,12 @@ fill_arc (DiaRenderer *self,
   }
 
   fprintf (renderer->file,
-           "#fill_arc center=(%g,%g) radius=%g angle1=%g° angle2=%g°\n",
-           center->x,
-           center->y,
-           (width + height) / 4.0,
-           angle1,
-           angle2);
+           "#fill_arc center=(%s,%s) radius=%s angle1=%s° angle2=%s°\n",
+           xfig_gtostr (c_buf[0], center->x),
+           xfig_gtostr (c_buf[1], center->y),
+           xfig_gtostr (c_buf[2], (width + height) / 4.0),
+           xfig_gtostr (c_buf[3], angle1),
+           xfig_gtostr (c_buf[4], angle2));
   /* adjust to radians */
   angle1 *= (M_PI / 180.0);
   angle2 *= (M_PI / 180.0);
@@ -37,7 +37,7 @@
 #include <math.h>
 #include <stdlib.h>
 #include <errno.h>
-#include <locale.h>
+#include <stdarg.h>
 
 #include <glib.h>
 #include <glib/gstdio.h>
@@ -71,6 +71,52 @@ eat_line(FILE *file) {
     } while (!feof(file));
 }
 
+/** A locale independent fscanf() for the few formats used here.
+ * Only whitespace, "%d" and "%lf" directives are understood; the latter
+ * is read as a whitespace delimited token and converted with
+ * g_ascii_strtod() so no LC_NUMERIC switch is needed.
+ * Returns the number of converted items like fscanf().
+ */
+static int
+fig_scanf(FILE *file, const char *format, ...)
+{
+    va_list args;
+    const char *p;
+    int n_read = 0;
+
+    va_start(args, format);
+    for (p = format; *p != '\0'; p++) {
+	if (g_ascii_isspace(*p)) {
+	    if (fscanf(file, " ") == EOF)
+		break;
+	} else if (strncmp(p, "%d", 2) == 0) {
+	    if (fscanf(file, "%d", va_arg(args, int *)) != 1)
+		break;
+	    n_read++;
+	    p += 1;
+	} else if (strncmp(p, "%lf", 3) == 0) {
+	    char buf[G_ASCII_DTOSTR_BUF_SIZE];
+	    char *end;
+	    double val;
+
+	    if (fscanf(file, "%38s", buf) != 1)
+		break;
+	    val = g_ascii_strtod(buf, &end);
+	    if (end == buf)
+		break;
+	    *va_arg(args, double *) = val;
+	    n_read++;
+	    p += 2;
+	} else {
+	    g_warn_if_reached();
+	    break;
+	}
+    }
+    va_end(args);
+
+    return n_read;
+}
+
 /** Skip past FIG comments (lines starting with #) and empty lines.
  * Returns TRUE if there is more in the file to read.
  */
@@ -269,18 +315,13 @@ fig_read_arrow(FILE *file, DiaContext *ctx)
     int arrow_type, style;
     real thickness, width, height;
     Arrow *arrow;
-    char* old_locale;
-
-    old_locale = setlocale(LC_NUMERIC, "C");
 
-    if (fscanf(file, "%d %d %lf %lf %lf\n",
+    if (fig_scanf(file, "%d %d %lf %lf %lf\n",
 	       &arrow_type, &style, &thickness,
 	       &width, &height) != 5) {
 	dia_context_add_message(ctx, _("Error while reading arrowhead"));
-	setlocale(LC_NUMERIC,old_locale);
 	return NULL;
     }
-    setlocale(LC_NUMERIC,old_locale);
 
     arrow = g_new(Arrow, 1);
 
@@ -432,10 +473,8 @@ fig_read_ellipse(FILE *file, DiaContext *ctx)
     int start_x, start_y;
     int end_x, end_y;
     DiaObject *newobj = NULL;
-    char* old_locale;
 
-    old_locale = setlocale(LC_NUMERIC, "C");
-    if (fscanf(file, "%d %d %d %d %d %d %d %d %lf %d %lf %d %d %d %d %d %d %d %d\n",
+    if (fig_scanf(file, "%d %d %d %d %d %d %d %d %lf %d %lf %d %d %d %d %d %d %d %d\n",
 	       &sub_type,
 	       &line_style,
 	       &thickness,
@@ -452,10 +491,8 @@ fig_read_ellipse(FILE *file, DiaContext *ctx)
 	       &start_x, &start_y,
 	       &end_x, &end_y) < 19) {
 	dia_context_add_message_with_errno(ctx, errno, _("Couldn't read ellipse info."));
-	setlocale(LC_NUMERIC, old_locale);
 	return NULL;
     }
-    setlocale(LC_NUMERIC, old_locale);
 
     /* Curiously, the sub_type doesn't matter, as all info can be
        extracted this way */
@@ -501,10 +538,8 @@ fig_read_polyline(FILE *file, DiaContext *ctx)
     DiaObject *newobj = NULL;
     int flipped = 0;
     char *image_file = NULL;
-    char* old_locale;
 
-    old_locale = setlocale(LC_NUMERIC, "C");
-    if (fscanf(file, "%d %d %d %d %d %d %d %d %lf %d %d %d %d %d %d\n",
+    if (fig_scanf(file, "%d %d %d %d %d %d %d %d %lf %d %d %d %d %d %d\n",
 	       &sub_type,
 	       &line_style,
 	       &thickness,
@@ -610,7 +645,6 @@ fig_read_polyline(FILE *file, DiaContext *ctx)
     /* Depth field */
     add_at_depth(newobj, depth, ctx);
  exit:
-    setlocale(LC_NUMERIC, old_locale);
     prop_list_free(props);
     g_clear_pointer (&points, g_free);
     g_clear_pointer (&forward_arrow_info, g_free);
@@ -732,10 +766,8 @@ fig_read_spline(FILE *file, DiaContext *ctx)
     DiaObject *newobj = NULL;
     BezPoint *bezpoints;
     int i;
-    char* old_locale;
 
-    old_locale = setlocale(LC_NUMERIC, "C");
-    if (fscanf(file, "%d %d %d %d %d %d %d %d %lf %d %d %d %d\n",
+    if (fig_scanf(file, "%d %d %d %d %d %d %d %d %lf %d %d %d %d\n",
 	       &sub_type,
 	       &line_style,
 	       &thickness,
@@ -780,7 +812,7 @@ fig_read_spline(FILE *file, DiaContext *ctx)
 	    double f;
 	    gboolean interpolated = TRUE;
 	    for (i = 0; i < npoints; i++) {
-		if (fscanf(file, " %lf ", &f) != 1) {
+		if (fig_scanf(file, " %lf ", &f) != 1) {
 		    dia_context_add_message_with_errno(ctx, errno,_("Couldn't read spline info."));
 		    goto exit;
 		}
@@ -837,7 +869,6 @@ fig_read_spline(FILE *file, DiaContext *ctx)
     /* Depth field */
     add_at_depth(newobj, depth, ctx);
  exit:
-    setlocale(LC_NUMERIC, old_locale);
     prop_list_free(props);
     g_clear_pointer (&forward_arrow_info, g_free);
     g_clear_pointer (&backward_arrow_info, g_free);
@@ -866,12 +897,10 @@ fig_read_arc(FILE *file, DiaContext *ctx)
     int x1, y1;
     int x2, y2;
     int x3, y3;
-    char* old_locale;
     Point p2, pm;
     real distance;
 
-    old_locale = setlocale(LC_NUMERIC, "C");
-    if (fscanf(file, "%d %d %d %d %d %d %d %d %lf %d %d %d %d %lf %lf %d %d %d %d %d %d\n",
+    if (fig_scanf(file, "%d %d %d %d %d %d %d %d %lf %d %d %d %d %lf %lf %d %d %d %d %d %d\n",
 	       &sub_type,
 	       &line_style,
 	       &thickness,
@@ -937,7 +966,6 @@ fig_read_arc(FILE *file, DiaContext *ctx)
     add_at_depth(newobj, depth, ctx);
 
  exit:
-    setlocale(LC_NUMERIC, old_locale);
     g_clear_pointer (&forward_arrow_info, g_free);
     g_clear_pointer (&backward_arrow_info, g_free);
     return newobj;
@@ -970,10 +998,8 @@ fig_read_text(FILE *file, DiaContext *ctx)
     real length;
     int x, y;
     char *text_buf = NULL;
-    char* old_locale;
 
-    old_locale = setlocale(LC_NUMERIC, "C");
-    if (fscanf(file, " %d %d %d %d %d %lf %lf %d %lf %lf %d %d",
+    if (fig_scanf(file, " %d %d %d %d %d %lf %lf %d %lf %lf %d %d",
 	       &sub_type,
 	       &color,
 	       &depth,
@@ -987,7 +1013,6 @@ fig_read_text(FILE *file, DiaContext *ctx)
 	       &x,
 	       &y) != 12) {
 	dia_context_add_message_with_errno(ctx, errno, _("Couldn't read text info."));
-	setlocale(LC_NUMERIC, old_locale);
 	return NULL;
     }
     /* Skip one space exactly */
@@ -1036,7 +1061,6 @@ fig_read_text(FILE *file, DiaContext *ctx)
     add_at_depth(newobj, depth, ctx);
 
  exit:
-    setlocale (LC_NUMERIC, old_locale);
     g_clear_pointer (&text_buf, g_free);
     g_clear_pointer (&props, prop_list_free);
 
@@ -1246,15 +1270,11 @@ fig_read_meta_data(FILE *file, DiagramData *dia, DiaContext *ctx)
 
     {
 	real mag;
-	char* old_locale;
 
-	old_locale = setlocale(LC_NUMERIC, "C");
-	if (fscanf(file, "%lf\n", &mag) != 1) {
+	if (fig_scanf(file, "%lf\n", &mag) != 1) {
 	    dia_context_add_message_with_errno(ctx, errno, _("Error reading magnification."));
-	    setlocale(LC_NUMERIC, old_locale);
 	    return FALSE;
 	}
-        setlocale(LC_NUMERIC, old_locale);
 
 	dia->paper.scaling = mag/100;
     }
@@ -0,0 +1,418 @@
+/* Dia -- an diagram creation/manipulation program
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Builds a synthetic diagram with the Stress plug-in's generator (boxes,
+ * UML classes and custom shapes joined by connectors) and times the things
+ * that get slow with big diagrams: saving, loading, rendering, hit-testing,
+ * moving with connections, undo/redo and every export filter.  Runs without
+ * a display.  The custom shapes come from DIA_SHAPE_PATH or --shapes.
+ *
+ * Each result is one line of JSON on stdout:
+ *
+ *   {"benchmark": "render", "objects": 4700, "iterations": 1, "seconds": 0.1}
+ *
+ * Run with "meson test --benchmark -v" or directly:
+ *
+ *   dia-benchmark [OPTION...] OBJECTS-DIR PLUG-INS-DIR
+ */
+
+#include "config.h"
+
+#include <math.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include "connectionpoint_ops.h"
+#include "diacontext.h"
+#include "diagram.h"
+#include "diagramdata.h"
+#include "dia-layer.h"
+#include "dialib.h"
+#include "filter.h"
+#include "load_save.h"
+#include "object.h"
+#include "plug-ins.h"
+#include "renderer/diacairo.h"
+#include "undo.h"
+
+#include "stress-diagram.h"
+
+#include "dia-test-utils.h"
+
+/* Used for the size of hit-test rectangles */
+#define CELL_WIDTH 6.0
+#define CELL_HEIGHT 5.0
+
+
+static int n_objects = 2700;
+static char *types = NULL;
+static int n_layers = 1;
+static char *topology = NULL;
+static int n_connectors = 2000;
+static int n_queries = 10000;
+static int n_moves = 20;
+static char *shapes = NULL;
+
+static GOptionEntry entries[] = {
+  { "objects", 'n', 0, G_OPTION_ARG_INT, &n_objects, "Number of objects, without connectors", "N" },
+  { "types", 't', 0, G_OPTION_ARG_STRING, &types, "Comma separated object types, taking turns", "TYPES" },
+  { "layers", 'l', 0, G_OPTION_ARG_INT, &n_layers, "Number of layers", "N" },
+  { "topology", 'g', 0, G_OPTION_ARG_STRING, &topology, "How to connect: none, grid or random", "TOPOLOGY" },
+  { "connectors", 'c', 0, G_OPTION_ARG_INT, &n_connectors, "Number of random connectors", "M" },
+  { "queries", 'q', 0, G_OPTION_ARG_INT, &n_queries, "Number of hit-tests", "N" },
+  { "moves", 'm', 0, G_OPTION_ARG_INT, &n_moves, "Number of moves to undo and redo", "N" },
+  { "shapes", 's', 0, G_OPTION_ARG_FILENAME, &shapes, "Where to load the custom shapes from, instead of DIA_SHAPE_PATH", "DIR" },
+  { NULL }
+};
+
+static char *tmp_dir = NULL;
+
+
+static void
+report (const char *name,
+        guint       n_objects,
+        guint       iterations,
+        double      seconds)
+{
+  char buf[G_ASCII_DTOSTR_BUF_SIZE];
+  char *escaped = g_strescape (name, NULL);
+
+  g_print ("{\"benchmark\": \"%s\", \"objects\": %u, \"iterations\": %u, \"seconds\": %s}\n",
+           escaped,
+           n_objects,
+           iterations,
+           g_ascii_formatd (buf, sizeof (buf), "%.6f", seconds));
+
+  g_clear_pointer (&escaped, g_free);
+}
+
+
+static guint
+count_objects (DiagramData *data)
+{
+  guint count = 0;
+
+  DIA_FOR_LAYER_IN_DIAGRAM (data, layer, i, {
+    count += dia_layer_object_count (layer);
+  });
+
+  return count;
+}
+
+
+static gboolean
+save_load (DiagramData     *data,
+           DiaExportFilter *efilter,
+           DiaImportFilter *ifilter,
+           const char      *name)
+{
+  DiaContext *ctx = dia_context_new ("Benchmark");
+  char *filename = g_strdup_printf ("benchmark.%s", efilter->extensions[0]);
+  char *path = g_build_filename (tmp_dir, filename, NULL);
+  char *label;
+  DiagramData *loaded = g_object_new (DIA_TYPE_DIAGRAM_DATA, NULL);
+  GTimer *timer = g_timer_new ();
+  gboolean ok;
+  guint n_objects = count_objects (data);
+
+  dia_context_set_filename (ctx, path);
+
+  ok = efilter->export_func (data, ctx, path, path, efilter->user_data);
+  label = g_strdup_printf ("save-%s", name);
+  report (label, n_objects, 1, g_timer_elapsed (timer, NULL));
+  g_clear_pointer (&label, g_free);
+
+  if (ok) {
+    g_timer_start (timer);
+    ok = ifilter->import_func (path, loaded, ctx, ifilter->user_data);
+    label = g_strdup_printf ("load-%s", name);
+    report (label, count_objects (loaded), 1, g_timer_elapsed (timer, NULL));
+    g_clear_pointer (&label, g_free);
+  }
+
+  g_timer_destroy (timer);
+  g_clear_object (&loaded);
+  g_unlink (path);
+  g_clear_pointer (&path, g_free);
+  g_clear_pointer (&filename, g_free);
+  dia_context_release (ctx);
+
+  return ok;
+}
+
+
+static void
+bench_render (DiagramData *data)
+{
+  DiaCairoRenderer *renderer = g_object_new (DIA_CAIRO_TYPE_RENDERER, NULL);
+  GTimer *timer = g_timer_new ();
+  int width, height;
+
+  /* Like the PNG export, at 10 pixels/cm to keep the surface sane */
+  renderer->dia = data;
+  renderer->scale = 10.0;
+  width = ceil ((data->extents.right - data->extents.left) * renderer->scale) + 1;
+  height = ceil ((data->extents.bottom - data->extents.top) * renderer->scale) + 1;
+  renderer->surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, width, height);
+
+  data_render (data, DIA_RENDERER (renderer), NULL, NULL, NULL);
+  cairo_surface_flush (renderer->surface);
+
+  report ("render", count_objects (data), 1, g_timer_elapsed (timer, NULL));
+
+  g_timer_destroy (timer);
+  g_clear_object (&renderer);
+}
+
+
+static void
+bench_hit_test (DiagramData *data)
+{
+  GRand *rand = g_rand_new_with_seed (7);
+  GTimer *timer = g_timer_new ();
+  DiaRectangle *extents = &data->extents;
+  int hits = 0;
+
+  for (int i = 0; i < n_queries; i++) {
+    Point pos = {
+      g_rand_double_range (rand, extents->left, extents->right),
+      g_rand_double_range (rand, extents->top, extents->bottom),
+    };
+
+    DIA_FOR_LAYER_IN_DIAGRAM (data, layer, l, {
+      if (dia_layer_find_closest_object (layer, &pos, 0.5)) {
+        hits++;
+      }
+    });
+  }
+  report ("hit-test-point", count_objects (data), n_queries, g_timer_elapsed (timer, NULL));
+
+  g_timer_start (timer);
+  for (int i = 0; i < n_queries; i++) {
+    DiaRectangle rect;
+
+    rect.left = g_rand_double_range (rand, extents->left, extents->right);
+    rect.top = g_rand_double_range (rand, extents->top, extents->bottom);
+    rect.right = rect.left + 2 * CELL_WIDTH;
+    rect.bottom = rect.top + 2 * CELL_HEIGHT;
+
+    DIA_FOR_LAYER_IN_DIAGRAM (data, layer, l, {
+      GList *found = dia_layer_find_objects_intersecting_rectangle (layer, &rect);
+
+      hits += g_list_length (found);
+      g_list_free (found);
+    });
+  }
+  report ("hit-test-rectangle", count_objects (data), n_queries, g_timer_elapsed (timer, NULL));
+
+  g_debug ("%s: %d hits", G_STRFUNC, hits);
+
+  g_timer_destroy (timer);
+  g_rand_free (rand);
+}
+
+
+/* What the modify tool does when a selection is dropped */
+static void
+move_objects (Diagram *dia, GList *objects, Point *delta)
+{
+  int n = g_list_length (objects);
+  Point *orig_pos = g_new (Point, n);
+  Point *dest_pos = g_new (Point, n);
+  DiaObjectChange *change;
+  int i = 0;
+
+  for (GList *l = objects; l != NULL; l = l->next, i++) {
+    orig_pos[i] = DIA_OBJECT (l->data)->position;
+  }
+
+  change = object_list_move_delta (objects, delta);
+  g_clear_pointer (&change, dia_object_change_unref);
+
+  i = 0;
+  for (GList *l = objects; l != NULL; l = l->next, i++) {
+    diagram_update_connections_object (dia, l->data, TRUE);
+    dest_pos[i] = DIA_OBJECT (l->data)->position;
+  }
+
+  dia_move_objects_change_new (dia, orig_pos, dest_pos, g_list_copy (objects));
+  diagram_update_extents (dia);
+  undo_set_transactionpoint (dia->undo);
+}
+
+
+static void
+bench_move_undo (Diagram *dia, GPtrArray *nodes)
+{
+  GList *selection = NULL;
+  GTimer *timer = g_timer_new ();
+  Point delta = { 0.5, 0.25 };
+  guint n_selected;
+
+  /* Every tenth node, so plenty of connectors follow */
+  for (guint i = 0; i < nodes->len; i += 10) {
+    selection = g_list_prepend (selection, g_ptr_array_index (nodes, i));
+  }
+  n_selected = g_list_length (selection);
+
+  for (int i = 0; i < n_moves; i++) {
+    move_objects (dia, selection, &delta);
+  }
+  report ("move-with-connections", n_selected, n_moves, g_timer_elapsed (timer, NULL));
+
+  g_timer_start (timer);
+  for (int i = 0; i < n_moves; i++) {
+    undo_revert_to_last_tp (dia->undo);
+  }
+  report ("undo", n_selected, n_moves, g_timer_elapsed (timer, NULL));
+
+  g_timer_start (timer);
+  for (int i = 0; i < n_moves; i++) {
+    undo_apply_to_next_tp (dia->undo);
+  }
+  report ("redo", n_selected, n_moves, g_timer_elapsed (timer, NULL));
+
+  g_list_free (selection);
+  g_timer_destroy (timer);
+}
+
+
+static void
+bench_exports (DiagramData *data)
+{
+  guint n_objects = count_objects (data);
+
+  for (GList *l = filter_get_export_filters (); l != NULL; l = l->next) {
+    DiaExportFilter *filter = l->data;
+    const char *ext = filter->extensions[0];
+    char *filename, *path, *label;
+    GTimer *timer;
+    gboolean ok;
+
+    /* Needs a dialog to choose the stylesheet */
+    if (g_strcmp0 (ext, "code") == 0) {
+      continue;
+    }
+
+    filename = g_strdup_printf ("export.%s", ext);
+    path = g_build_filename (tmp_dir, filename, NULL);
+
+    timer = g_timer_new ();
+    ok = dia_test_export (data, filter, path, NULL);
+    label = g_strdup_printf ("export-%s", filter->unique_name ? filter->unique_name : ext);
+    if (ok) {
+      report (label, n_objects, 1, g_timer_elapsed (timer, NULL));
+    } else {
+      g_printerr ("%s: '%s' failed\n", label, filter->description);
+    }
+
+    g_clear_pointer (&label, g_free);
+    g_timer_destroy (timer);
+    g_clear_pointer (&path, g_free);
+    g_clear_pointer (&filename, g_free);
+  }
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  GOptionContext *context = g_option_context_new ("OBJECTS-DIR PLUG-INS-DIR");
+  GError *error = NULL;
+  GPtrArray *nodes = g_ptr_array_new ();
+  StressOptions options;
+  GTimer *timer;
+  Diagram *dia;
+
+  g_option_context_add_main_entries (context, entries, NULL);
+  if (!g_option_context_parse (context, &argc, &argv, &error) || argc != 3) {
+    g_printerr ("%s\n", error ? error->message : "Need the objects and plug-ins directories");
+    return 1;
+  }
+  g_option_context_free (context);
+
+  libdia_init (DIA_MESSAGE_STDERR);
+
+  /* Read by the custom objects plug-in when it's registered */
+  if (shapes) {
+    g_setenv ("DIA_SHAPE_PATH", shapes, TRUE);
+  }
+
+  /* objects first, the exports need the standard objects to draw */
+  dia_register_plugins_in_dir (argv[1]);
+  if (!dia_test_register_plugins (argv[2])) {
+    g_printerr ("Can't read the plug-ins from '%s'\n", argv[2]);
+    return 1;
+  }
+
+  tmp_dir = g_dir_make_tmp ("dia-benchmark-XXXXXX", NULL);
+  g_return_val_if_fail (tmp_dir != NULL, 1);
+
+  /* The same generator as the Stress plug-in */
+  /* "Flowchart - Delay" is a custom shape, "Flowchart - Box" is not */
+  options.types = g_strsplit (types ? types : "Standard - Box, UML - Class, Flowchart - Delay", ",", -1);
+  for (int i = 0; options.types[i]; i++) {
+    g_strstrip (options.types[i]);
+
+    /* Otherwise the timings are for fewer kinds of objects than asked for */
+    if (!object_get_type (options.types[i])) {
+      g_printerr ("No object type '%s', are the shapes in DIA_SHAPE_PATH?\n",
+                  options.types[i]);
+      return 1;
+    }
+  }
+  options.n_objects = n_objects;
+  options.n_layers = n_layers;
+  if (!topology || g_strcmp0 (topology, "random") == 0) {
+    options.topology = STRESS_TOPOLOGY_RANDOM;
+  } else if (g_strcmp0 (topology, "none") == 0) {
+    options.topology = STRESS_TOPOLOGY_NONE;
+  } else if (g_strcmp0 (topology, "grid") == 0) {
+    options.topology = STRESS_TOPOLOGY_GRID;
+  } else {
+    g_printerr ("Unknown topology '%s', expected none, grid or random\n", topology);
+    return 1;
+  }
+  options.n_connectors = n_connectors;
+  options.seed = 42;
+
+  timer = g_timer_new ();
+  dia = dia_diagram_new (NULL);
+  g_list_free (stress_populate (DIA_DIAGRAM_DATA (dia), &options, nodes));
+  report ("generate", count_objects (dia->data), 1, g_timer_elapsed (timer, NULL));
+  g_timer_destroy (timer);
+  g_strfreev (options.types);
+
+  save_load (dia->data, &dia_export_filter, &dia_import_filter, "dia");
+  save_load (dia->data, &dia_binary_export_filter, &dia_binary_import_filter, "diab");
+  bench_render (dia->data);
+  bench_hit_test (dia->data);
+  bench_move_undo (dia, nodes);
+  bench_exports (dia->data);
+
+  g_ptr_array_free (nodes, TRUE);
+  diagram_destroy (dia);
+
+  g_rmdir (tmp_dir);
+  g_clear_pointer (&tmp_dir, g_free);
+
+  return 0;
+}
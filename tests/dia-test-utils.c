@@ -8,9 +8,19 @@
 
 #include "config.h"
 
+#include <string.h>
+
 #include <glib-object.h>
+#include <glib/gstdio.h>
 #include <gobject/gvaluecollector.h>
 
+#include "create.h"
+#include "dia-layer.h"
+#include "diainteractiverenderer.h"
+#include "plug-ins.h"
+#include "properties.h"
+#include "renderer/diacairo.h"
+
 #include "dia-test-utils.h"
 
 
@@ -216,3 +226,249 @@ dia_test_property_notify (gpointer object, const char *property, ...)
   g_value_unset (&value_b);
   g_clear_pointer (&error, g_free);
 }
+
+
+/**
+ * dia_test_register_plugins:
+ * @directory: where the plug-ins were built
+ *
+ * Unlike dia_register_plugins_in_dir() only the top level, the plug-ins
+ * in subdirectories need app/.
+ *
+ * Returns: %FALSE if @directory can't be read
+ */
+gboolean
+dia_test_register_plugins (const char *directory)
+{
+  GDir *dir = g_dir_open (directory, 0, NULL);
+  const char *entry;
+
+  if (!dir) {
+    return FALSE;
+  }
+
+  while ((entry = g_dir_read_name (dir)) != NULL) {
+    char *path = g_build_filename (directory, entry, NULL);
+
+    if (g_str_has_suffix (path, G_MODULE_SUFFIX)) {
+      dia_register_plugin (path);
+    }
+
+    g_clear_pointer (&path, g_free);
+  }
+
+  g_dir_close (dir);
+
+  return TRUE;
+}
+
+
+/**
+ * dia_test_export:
+ * @data: the diagram
+ * @filter: the export to run
+ * @path: the file to write, removed again
+ * @contents: (out) (optional): what was written
+ *
+ * Returns: %TRUE if @filter succeeded, and @contents could be read
+ */
+gboolean
+dia_test_export (DiagramData      *data,
+                 DiaExportFilter  *filter,
+                 const char       *path,
+                 GBytes          **contents)
+{
+  DiaContext *ctx = dia_context_new ("Export");
+  char *buffer = NULL;
+  gsize length = 0;
+  gboolean ok;
+
+  if (contents) {
+    *contents = NULL;
+  }
+
+  dia_context_set_filename (ctx, path);
+
+  ok = filter->export_func (data, ctx, path, "test.dia", filter->user_data);
+  if (ok && contents) {
+    ok = g_file_get_contents (path, &buffer, &length, NULL);
+    if (ok) {
+      *contents = g_bytes_new_take (buffer, length);
+    }
+  }
+
+  dia_context_release (ctx);
+  g_unlink (path);
+
+  return ok;
+}
+
+
+/**
+ * dia_test_diagram_new:
+ * @objects: (transfer full): what to put in the diagram
+ *
+ * Returns: (transfer full): a diagram with @objects in its only layer
+ */
+DiagramData *
+dia_test_diagram_new (GList *objects)
+{
+  DiagramData *data = g_object_new (DIA_TYPE_DIAGRAM_DATA, NULL);
+
+  dia_layer_add_objects (dia_diagram_data_get_active_layer (data), objects);
+  data_update_extents (data);
+
+  return data;
+}
+
+
+/**
+ * dia_test_labels_new:
+ * @columns: labels side by side
+ * @rows: labels one below the other
+ * @boxes: whether every label has a box behind it
+ *
+ * A grid of two line labels, with all the alignments in turn.
+ *
+ * Returns: (transfer full): the diagram
+ */
+DiagramData *
+dia_test_labels_new (int columns, int rows, gboolean boxes)
+{
+  GList *objects = NULL;
+
+  for (int y = 0; y < rows; y++) {
+    for (int x = 0; x < columns; x++) {
+      DiaObject *text = create_standard_text (x * 4.0 + 2.0, y * 2.0 + 1.0);
+      GPtrArray *props = g_ptr_array_new ();
+      char *label = g_strdup_printf ("Label %d\nrow %d", x, y);
+
+      if (boxes) {
+        objects = g_list_prepend (objects,
+                                  create_standard_box (x * 4.0, y * 2.0, 3.5, 1.75));
+      }
+
+      prop_list_add_enum (props, "text_alignment", (x + y) % 3);
+      prop_list_add_text (props, "text", label); /* must be last! */
+      dia_object_set_properties (text, props);
+      objects = g_list_prepend (objects, text);
+
+      prop_list_free (props);
+      g_clear_pointer (&label, g_free);
+    }
+  }
+
+  return dia_test_diagram_new (g_list_reverse (objects));
+}
+
+
+/**
+ * dia_test_frame_init:
+ * @frame: the #DiaTestFrame
+ * @zoom: pixels per cm
+ *
+ * A display renderer, showing the diagram from the top left corner.
+ * Free it with dia_test_frame_clear().
+ */
+void
+dia_test_frame_init (DiaTestFrame *frame, double zoom)
+{
+  frame->renderer = dia_cairo_interactive_renderer_new ();
+  frame->zoom = zoom;
+  frame->visible.left = 0.0;
+  frame->visible.top = 0.0;
+  frame->visible.right = DIA_TEST_FRAME_WIDTH / zoom;
+  frame->visible.bottom = DIA_TEST_FRAME_HEIGHT / zoom;
+
+  g_object_set (frame->renderer,
+                "zoom", &frame->zoom,
+                "rect", &frame->visible,
+                NULL);
+  dia_interactive_renderer_set_size (DIA_INTERACTIVE_RENDERER (frame->renderer),
+                                     NULL,
+                                     DIA_TEST_FRAME_WIDTH,
+                                     DIA_TEST_FRAME_HEIGHT);
+}
+
+
+/**
+ * dia_test_frame_render:
+ * @frame: the #DiaTestFrame
+ * @data: what to draw
+ * @zoom: pixels per cm, the display zoomed in or out before
+ *
+ * Draw a frame like the display does.
+ */
+void
+dia_test_frame_render (DiaTestFrame *frame, DiagramData *data, double zoom)
+{
+  DiaInteractiveRenderer *renderer = DIA_INTERACTIVE_RENDERER (frame->renderer);
+  static Color white = { 1.0, 1.0, 1.0, 1.0 };
+
+  frame->zoom = zoom;
+  frame->visible.right = DIA_TEST_FRAME_WIDTH / zoom;
+  frame->visible.bottom = DIA_TEST_FRAME_HEIGHT / zoom;
+
+  dia_interactive_renderer_clip_region_clear (renderer);
+  dia_interactive_renderer_clip_region_add_rect (renderer, &frame->visible);
+
+  dia_renderer_begin_render (frame->renderer, &frame->visible);
+  dia_interactive_renderer_fill_pixel_rect (renderer,
+                                            0, 0,
+                                            DIA_TEST_FRAME_WIDTH,
+                                            DIA_TEST_FRAME_HEIGHT,
+                                            &white);
+  data_render (data, frame->renderer, &frame->visible, NULL, NULL);
+  dia_renderer_end_render (frame->renderer);
+}
+
+
+/**
+ * dia_test_frame_snapshot:
+ * @frame: the #DiaTestFrame
+ *
+ * Returns: (transfer full): what the last frame looks like
+ */
+cairo_surface_t *
+dia_test_frame_snapshot (DiaTestFrame *frame)
+{
+  cairo_surface_t *surface = cairo_image_surface_create (CAIRO_FORMAT_RGB24,
+                                                         DIA_TEST_FRAME_WIDTH,
+                                                         DIA_TEST_FRAME_HEIGHT);
+  cairo_t *cr = cairo_create (surface);
+
+  dia_interactive_renderer_paint (DIA_INTERACTIVE_RENDERER (frame->renderer),
+                                  cr,
+                                  DIA_TEST_FRAME_WIDTH,
+                                  DIA_TEST_FRAME_HEIGHT);
+  cairo_destroy (cr);
+  cairo_surface_flush (surface);
+
+  return surface;
+}
+
+
+void
+dia_test_frame_clear (DiaTestFrame *frame)
+{
+  g_clear_object (&frame->renderer);
+}
+
+
+/**
+ * dia_test_surfaces_equal:
+ * @a: from dia_test_frame_snapshot()
+ * @b: from dia_test_frame_snapshot()
+ *
+ * Returns: %TRUE if @a and @b have the very same pixels
+ */
+gboolean
+dia_test_surfaces_equal (cairo_surface_t *a, cairo_surface_t *b)
+{
+  int stride = cairo_image_surface_get_stride (a);
+
+  return stride == cairo_image_surface_get_stride (b) &&
+         memcmp (cairo_image_surface_get_data (a),
+                 cairo_image_surface_get_data (b),
+                 stride * DIA_TEST_FRAME_HEIGHT) == 0;
+}
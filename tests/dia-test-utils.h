@@ -9,9 +9,26 @@
 #pragma once
 
 #include <glib-object.h>
+#include <cairo.h>
+
+#include "diagramdata.h"
+#include "diarenderer.h"
+#include "filter.h"
 
 G_BEGIN_DECLS
 
+/* The size of a DiaTestFrame, in pixels */
+#define DIA_TEST_FRAME_WIDTH 400
+#define DIA_TEST_FRAME_HEIGHT 300
+
+typedef struct _DiaTestFrame DiaTestFrame;
+struct _DiaTestFrame {
+  DiaRenderer  *renderer;
+  /* Referenced by @renderer, keep the frame in place */
+  DiaRectangle  visible;
+  double        zoom;
+};
+
 void            dia_expect_property_notify               (gpointer      object,
                                                           const char   *property);
 void            dia_expect_no_notify                     (gpointer      object);
@@ -20,4 +37,25 @@ void            dia_test_property_notify                 (gpointer      object,
                                                           const char   *property,
                                                           ...);
 
+gboolean        dia_test_register_plugins                (const char   *directory);
+gboolean        dia_test_export                          (DiagramData     *data,
+                                                          DiaExportFilter *filter,
+                                                          const char      *path,
+                                                          GBytes         **contents);
+
+DiagramData    *dia_test_diagram_new                     (GList        *objects);
+DiagramData    *dia_test_labels_new                      (int           columns,
+                                                          int           rows,
+                                                          gboolean      boxes);
+
+void            dia_test_frame_init                      (DiaTestFrame *frame,
+                                                          double        zoom);
+void            dia_test_frame_render                    (DiaTestFrame *frame,
+                                                          DiagramData  *data,
+                                                          double        zoom);
+cairo_surface_t *dia_test_frame_snapshot                 (DiaTestFrame *frame);
+void            dia_test_frame_clear                     (DiaTestFrame *frame);
+gboolean        dia_test_surfaces_equal                  (cairo_surface_t *a,
+                                                          cairo_surface_t *b);
+
 G_END_DECLS
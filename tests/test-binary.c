@@ -0,0 +1,339 @@
+/* Dia -- an diagram creation/manipulation program
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include <glib/gstdio.h>
+#include <libxml/parser.h>
+
+#include "dia-binary.h"
+
+
+static const char *diagram =
+  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+  "<dia:diagram xmlns:dia=\"http://www.lysator.liu.se/~alla/dia/\">"
+    "<dia:diagramdata>"
+      "<dia:attribute name=\"background\">"
+        "<dia:color val=\"#ffffffff\"/>"
+      "</dia:attribute>"
+    "</dia:diagramdata>"
+    "<dia:layer name=\"Back &amp; ground\" visible=\"true\" active=\"true\">"
+      "<dia:object type=\"Standard - Text\" version=\"1\" id=\"O0\">"
+        "<dia:attribute name=\"text\">"
+          "<dia:string>#a &lt;b&gt; \xc3\xbc#</dia:string>"
+        "</dia:attribute>"
+      "</dia:object>"
+    "</dia:layer>"
+    "<dia:layer name=\"Hidden\" visible=\"false\"/>"
+    "<other xmlns=\"urn:example\"><empty value=\"\"/></other>"
+  "</dia:diagram>";
+
+
+static char *
+doc_to_string (xmlDocPtr doc)
+{
+  xmlChar *mem = NULL;
+  int size = 0;
+  char *result;
+
+  xmlDocDumpFormatMemory (doc, &mem, &size, 1);
+  result = g_strndup ((char *) mem, size);
+  xmlFree (mem);
+
+  return result;
+}
+
+
+static void
+test_binary_round_trip (void)
+{
+  xmlDocPtr doc = xmlReadMemory (diagram, strlen (diagram), NULL, NULL, 0);
+  GBytes *bytes = dia_binary_encode (doc);
+  DiaContext *ctx = dia_context_new ("Test");
+  xmlDocPtr decoded = dia_binary_decode (bytes, ctx);
+  char *expected = doc_to_string (doc);
+  char *result;
+
+  g_assert_nonnull (decoded);
+  result = doc_to_string (decoded);
+  g_assert_cmpstr (result, ==, expected);
+
+  g_clear_pointer (&result, g_free);
+  g_clear_pointer (&expected, g_free);
+  g_clear_pointer (&decoded, xmlFreeDoc);
+  dia_context_release (ctx);
+  g_clear_pointer (&bytes, g_bytes_unref);
+  g_clear_pointer (&doc, xmlFreeDoc);
+}
+
+
+static void
+test_binary_damaged (void)
+{
+  xmlDocPtr doc = xmlReadMemory (diagram, strlen (diagram), NULL, NULL, 0);
+  GBytes *bytes = dia_binary_encode (doc);
+  DiaContext *ctx = dia_context_new ("Test");
+  gsize size;
+  const guint8 *data = g_bytes_get_data (bytes, &size);
+
+  /* No prefix of a file is a valid file */
+  for (gsize i = 0; i < size; i++) {
+    GBytes *truncated = g_bytes_new_static (data, i);
+
+    g_assert_null (dia_binary_decode (truncated, ctx));
+
+    g_clear_pointer (&truncated, g_bytes_unref);
+  }
+
+  dia_context_reset (ctx);
+  dia_context_release (ctx);
+  g_clear_pointer (&bytes, g_bytes_unref);
+  g_clear_pointer (&doc, xmlFreeDoc);
+}
+
+
+static void
+test_binary_blobs (void)
+{
+  xmlDocPtr doc = xmlReadMemory (diagram, strlen (diagram), NULL, NULL, 0);
+  GBytes *image = g_bytes_new_static ("\x89PNG not really", 16);
+  GBytes *same = g_bytes_new ("\x89PNG not really", 16);
+  GBytes *other = g_bytes_new_static ("GIF89a", 6);
+  DiaContext *ctx = dia_context_new ("Test");
+  char *name, *again, *other_name;
+  GBytes *bytes;
+  xmlDocPtr decoded;
+
+  dia_binary_doc_use_blobs (doc);
+  name = dia_binary_doc_add_blob (doc, image);
+  again = dia_binary_doc_add_blob (doc, same);
+  other_name = dia_binary_doc_add_blob (doc, other);
+
+  /* stored once */
+  g_assert_cmpstr (name, ==, again);
+  g_assert_cmpstr (name, !=, other_name);
+
+  bytes = dia_binary_encode (doc);
+  decoded = dia_binary_decode (bytes, ctx);
+  g_assert_nonnull (decoded);
+  g_assert_true (dia_binary_doc_has_blobs (decoded));
+  g_assert_true (g_bytes_equal (dia_binary_doc_get_blob (decoded, name), image));
+  g_assert_true (g_bytes_equal (dia_binary_doc_get_blob (decoded, other_name), other));
+  g_assert_null (dia_binary_doc_get_blob (decoded, "missing"));
+
+  g_clear_pointer (&decoded, dia_binary_free_document);
+  g_clear_pointer (&bytes, g_bytes_unref);
+
+  /* without any blobs it's still the first version */
+  g_clear_pointer (&doc, dia_binary_free_document);
+  doc = xmlReadMemory (diagram, strlen (diagram), NULL, NULL, 0);
+  dia_binary_doc_use_blobs (doc);
+  bytes = dia_binary_encode (doc);
+  g_assert_cmpint (((const guint8 *) g_bytes_get_data (bytes, NULL))[8], ==, 1);
+
+  dia_context_release (ctx);
+  g_clear_pointer (&bytes, g_bytes_unref);
+  g_clear_pointer (&name, g_free);
+  g_clear_pointer (&again, g_free);
+  g_clear_pointer (&other_name, g_free);
+  g_clear_pointer (&image, g_bytes_unref);
+  g_clear_pointer (&same, g_bytes_unref);
+  g_clear_pointer (&other, g_bytes_unref);
+  g_clear_pointer (&doc, dia_binary_free_document);
+}
+
+
+static void
+count_element (const char  *name,
+               const char **attribute_names,
+               const char **attribute_values,
+               gpointer     user_data)
+{
+  (*(int *) user_data)++;
+}
+
+
+static void
+test_binary_lazy (void)
+{
+  xmlDocPtr doc = xmlReadMemory (diagram, strlen (diagram), NULL, NULL, 0);
+  GBytes *bytes = dia_binary_encode (doc);
+  DiaContext *ctx = dia_context_new ("Test");
+  xmlDocPtr loaded;
+  xmlNodePtr root, back, hidden;
+  char *path = NULL;
+  char *expected, *result;
+  int fd, n_elements = 0;
+
+  fd = g_file_open_tmp ("dia-binary-XXXXXX.diab", &path, NULL);
+  g_assert_cmpint (fd, >=, 0);
+  g_close (fd, NULL);
+  g_assert_true (g_file_set_contents (path,
+                                      g_bytes_get_data (bytes, NULL),
+                                      g_bytes_get_size (bytes),
+                                      NULL));
+
+  loaded = dia_binary_load_document (path, ctx);
+  g_assert_nonnull (loaded);
+
+  /* The layers are there, but without content */
+  root = xmlDocGetRootElement (loaded);
+  back = xmlNextElementSibling (xmlFirstElementChild (root));
+  hidden = xmlNextElementSibling (back);
+  g_assert_cmpstr ((char *) back->name, ==, "layer");
+  g_assert_cmpstr ((char *) hidden->name, ==, "layer");
+  g_assert_true (dia_binary_doc_is_pending (loaded, back));
+  g_assert_true (dia_binary_doc_is_pending (loaded, hidden));
+  g_assert_null (back->children);
+  g_assert_false (dia_binary_doc_is_pending (loaded, root));
+
+  /* <object>, <attribute> and <string>, still without decoding */
+  g_assert_true (dia_binary_doc_scan_node (loaded, back, count_element, &n_elements));
+  g_assert_cmpint (n_elements, ==, 3);
+  g_assert_null (back->children);
+
+  g_assert_true (dia_binary_doc_decode_node (loaded, back, ctx));
+  g_assert_false (dia_binary_doc_is_pending (loaded, back));
+  g_assert_nonnull (back->children);
+  /* The hidden one stays as it is */
+  g_assert_true (dia_binary_doc_is_pending (loaded, hidden));
+
+  g_assert_true (dia_binary_doc_decode_node (loaded, hidden, ctx));
+  g_assert_false (dia_binary_doc_is_pending (loaded, hidden));
+
+  expected = doc_to_string (doc);
+  result = doc_to_string (loaded);
+  g_assert_cmpstr (result, ==, expected);
+
+  g_clear_pointer (&result, g_free);
+  g_clear_pointer (&expected, g_free);
+  g_clear_pointer (&loaded, dia_binary_free_document);
+  g_unlink (path);
+  g_clear_pointer (&path, g_free);
+  dia_context_release (ctx);
+  g_clear_pointer (&bytes, g_bytes_unref);
+  g_clear_pointer (&doc, xmlFreeDoc);
+}
+
+
+static xmlDocPtr
+make_large_diagram (int n_layers, int n_objects)
+{
+  GString *xml = g_string_new ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                               "<dia:diagram xmlns:dia=\"http://www.lysator.liu.se/~alla/dia/\">\n");
+  GRand *rand = g_rand_new_with_seed (42);
+  xmlDocPtr doc;
+
+  for (int l = 0; l < n_layers; l++) {
+    g_string_append_printf (xml, "<dia:layer name=\"Layer %d\" visible=\"true\">\n", l);
+    for (int i = 0; i < n_objects; i++) {
+      g_string_append_printf (xml,
+                              "<dia:object type=\"Standard - Box\" version=\"0\" id=\"O%d\">\n"
+                              "<dia:attribute name=\"elem_corner\">"
+                              "<dia:point val=\"%d.%d,%d.%d\"/>"
+                              "</dia:attribute>\n"
+                              "<dia:attribute name=\"elem_width\">"
+                              "<dia:real val=\"%d.5\"/>"
+                              "</dia:attribute>\n"
+                              "<dia:attribute name=\"border_color\">"
+                              "<dia:color val=\"#000000ff\"/>"
+                              "</dia:attribute>\n"
+                              "</dia:object>\n",
+                              l * n_objects + i,
+                              g_rand_int_range (rand, 0, 100),
+                              g_rand_int_range (rand, 0, 10),
+                              g_rand_int_range (rand, 0, 100),
+                              g_rand_int_range (rand, 0, 10),
+                              g_rand_int_range (rand, 1, 10));
+    }
+    g_string_append (xml, "</dia:layer>\n");
+  }
+  g_string_append (xml, "</dia:diagram>\n");
+
+  doc = xmlReadMemory (xml->str, xml->len, NULL, NULL, XML_PARSE_NOBLANKS);
+
+  g_rand_free (rand);
+  g_string_free (xml, TRUE);
+
+  return doc;
+}
+
+
+static void
+test_binary_perf (void)
+{
+  xmlDocPtr doc = make_large_diagram (10, 5000);
+  DiaContext *ctx = dia_context_new ("Test");
+  xmlChar *xml = NULL;
+  int xml_size = 0;
+  GBytes *bytes;
+  xmlDocPtr loaded;
+  double xml_save, xml_load, bin_save, bin_load;
+
+  g_test_timer_start ();
+  xmlDocDumpFormatMemory (doc, &xml, &xml_size, 1);
+  xml_save = g_test_timer_elapsed ();
+
+  g_test_timer_start ();
+  loaded = xmlReadMemory ((char *) xml, xml_size, NULL, NULL, XML_PARSE_NOBLANKS);
+  xml_load = g_test_timer_elapsed ();
+  g_clear_pointer (&loaded, xmlFreeDoc);
+
+  g_test_timer_start ();
+  bytes = dia_binary_encode (doc);
+  bin_save = g_test_timer_elapsed ();
+
+  g_test_timer_start ();
+  loaded = dia_binary_decode (bytes, ctx);
+  bin_load = g_test_timer_elapsed ();
+  g_assert_nonnull (loaded);
+  g_clear_pointer (&loaded, xmlFreeDoc);
+
+  g_test_message ("XML:    %10d bytes, save %.3fs, load %.3fs",
+                  xml_size, xml_save, xml_load);
+  g_test_message ("Binary: %10" G_GSIZE_FORMAT " bytes, save %.3fs, load %.3fs",
+                  g_bytes_get_size (bytes), bin_save, bin_load);
+  g_test_minimized_result (bin_load, "binary load %.3fs", bin_load);
+
+  g_assert_cmpuint (g_bytes_get_size (bytes), <, xml_size);
+
+  dia_context_release (ctx);
+  g_clear_pointer (&bytes, g_bytes_unref);
+  xmlFree (xml);
+  g_clear_pointer (&doc, xmlFreeDoc);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/dia/binary/round-trip", test_binary_round_trip);
+  g_test_add_func ("/dia/binary/damaged", test_binary_damaged);
+  g_test_add_func ("/dia/binary/blobs", test_binary_blobs);
+  g_test_add_func ("/dia/binary/lazy", test_binary_lazy);
+  if (g_test_perf ()) {
+    g_test_add_func ("/dia/binary/perf", test_binary_perf);
+  }
+
+  return g_test_run ();
+}
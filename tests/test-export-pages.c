@@ -0,0 +1,168 @@
+/* Dia -- an diagram creation/manipulation program
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * The pages of a PDF export are drawn in parallel, see cairo_export_pages().
+ * The file must be the same as with all pages drawn one after the other,
+ * also for objects with text and objects on the page boundaries.
+ */
+
+#include "config.h"
+
+#include <glib.h>
+#include <cairo-pdf.h>
+
+#include "diagramdata.h"
+#include "dia-layer.h"
+#include "dialib.h"
+#include "object.h"
+#include "plug-ins.h"
+#include "renderer/diacairo.h"
+
+/* Three by three pages */
+#define N_PAGES 3
+/* Objects along each side of a page */
+#define N_PER_PAGE 4
+
+/* UML measures its text, the custom shapes draw shared text elements */
+static const char *types[] = {
+  "UML - Class",
+  "Flowchart - Delay",
+  "Cybernetics - b-sens",
+};
+
+
+static DiagramData *
+make_diagram (void)
+{
+  DiagramData *data = g_object_new (DIA_TYPE_DIAGRAM_DATA, NULL);
+  DiaLayer *layer = dia_diagram_data_get_active_layer (data);
+  double step_x = data->paper.width / N_PER_PAGE;
+  double step_y = data->paper.height / N_PER_PAGE;
+  int n = 0;
+
+  for (int row = 0; row < N_PAGES * N_PER_PAGE; row++) {
+    for (int col = 0; col < N_PAGES * N_PER_PAGE; col++) {
+      DiaObjectType *type = object_get_type ((char *) types[n++ % G_N_ELEMENTS (types)]);
+      Handle *h1, *h2;
+      /* Every first one crosses the boundary to the previous page */
+      Point pos = { col * step_x - 1.0, row * step_y - 0.5 };
+
+      g_assert_nonnull (type);
+      dia_layer_add_object (layer,
+                            type->ops->create (&pos,
+                                               type->default_user_data,
+                                               &h1,
+                                               &h2));
+    }
+  }
+
+  data_update_extents (data);
+
+  return data;
+}
+
+
+static cairo_status_t
+write_to_array (void                *closure,
+                const unsigned char *bytes,
+                unsigned int         length)
+{
+  g_byte_array_append (closure, bytes, length);
+
+  return CAIRO_STATUS_SUCCESS;
+}
+
+
+static GBytes *
+export_pages (DiagramData *data, guint n_threads)
+{
+  GByteArray *array = g_byte_array_new ();
+  DiaCairoRenderer *renderer = g_object_new (DIA_CAIRO_TYPE_RENDERER, NULL);
+  double width = (data->paper.lmargin + data->paper.width * data->paper.scaling + data->paper.rmargin)
+                 * (72.0 / 2.54) + 0.5;
+  double height = (data->paper.tmargin + data->paper.height * data->paper.scaling + data->paper.bmargin)
+                  * (72.0 / 2.54) + 0.5;
+
+  renderer->dia = data;
+  renderer->scale = data->paper.scaling * (72.0 / 2.54);
+  renderer->surface = cairo_pdf_surface_create_for_stream (write_to_array,
+                                                           array,
+                                                           width,
+                                                           height);
+#if CAIRO_VERSION >= CAIRO_VERSION_ENCODE (1, 16, 0)
+  /* Otherwise it's now */
+  cairo_pdf_surface_set_metadata (renderer->surface,
+                                  CAIRO_PDF_METADATA_CREATE_DATE,
+                                  "2000-01-01T00:00:00");
+#endif
+
+  cairo_export_pages (data, renderer, width, height, n_threads);
+
+  cairo_surface_finish (renderer->surface);
+  g_assert_cmpint (cairo_surface_status (renderer->surface), ==, CAIRO_STATUS_SUCCESS);
+  g_clear_object (&renderer);
+
+  return g_byte_array_free_to_bytes (array);
+}
+
+
+static void
+test_export_pages_parallel (void)
+{
+  DiagramData *data = make_diagram ();
+  GArray *pages = data_get_page_bounds (data);
+  GBytes *serial, *parallel;
+
+  g_assert_cmpuint (pages->len, >=, N_PAGES * N_PAGES);
+
+  serial = export_pages (data, 1);
+  g_assert_cmpuint (g_bytes_get_size (serial), >, 0);
+
+  /* More than once, a race does not show every time */
+  for (int i = 0; i < 4; i++) {
+    parallel = export_pages (data, MAX (4, g_get_num_processors ()));
+
+    g_assert_true (g_bytes_equal (serial, parallel));
+
+    g_clear_pointer (&parallel, g_bytes_unref);
+  }
+
+  g_clear_pointer (&serial, g_bytes_unref);
+  g_array_unref (pages);
+  g_clear_object (&data);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  libdia_init (DIA_MESSAGE_STDERR);
+
+  /* The custom shapes come from DIA_SHAPE_PATH */
+  g_assert_cmpint (argc, ==, 2);
+  dia_register_plugins_in_dir (argv[1]);
+
+  g_test_add_func ("/dia/export/pages/parallel",
+                   test_export_pages_parallel);
+
+  return g_test_run ();
+}
@@ -0,0 +1,181 @@
+/* Dia -- an diagram creation/manipulation program
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * The SVG export draws objects just like an earlier one only once, in a
+ * <symbol>, the first stays inline and every later one is a <use>.  One
+ * of a kind objects stay inline.
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include "create.h"
+#include "diagramdata.h"
+#include "dialib.h"
+#include "filter.h"
+#include "plug-ins.h"
+#include "properties.h"
+
+#include "dia-test-utils.h"
+
+
+static char *tmp_dir = NULL;
+
+
+/* @n_boxes of the same size side by side, filled with @fills in turn */
+static DiagramData *
+make_diagram (int n_boxes, const Color *fills, int n_fills)
+{
+  GList *objects = NULL;
+
+  for (int i = 0; i < n_boxes; i++) {
+    DiaObject *box = create_standard_box (0.5 + i * 3.0, 0.5, 2.25, 1.75);
+    GPtrArray *props = g_ptr_array_new ();
+
+    prop_list_add_fill_colour (props, &fills[i % n_fills]);
+    dia_object_set_properties (box, props);
+    prop_list_free (props);
+
+    objects = g_list_append (objects, box);
+  }
+
+  return dia_test_diagram_new (objects);
+}
+
+
+static char *
+export_svg (DiagramData *data)
+{
+  DiaExportFilter *filter = filter_export_get_by_name ("dia-svg");
+  char *path = g_build_filename (tmp_dir, "symbols.svg", NULL);
+  GBytes *contents = NULL;
+  char *svg;
+
+  g_assert_nonnull (filter);
+  g_assert_true (dia_test_export (data, filter, path, &contents));
+
+  /* NUL terminated, for strstr() */
+  svg = g_strndup (g_bytes_get_data (contents, NULL), g_bytes_get_size (contents));
+
+  g_clear_pointer (&contents, g_bytes_unref);
+  g_clear_pointer (&path, g_free);
+
+  return svg;
+}
+
+
+static int
+count (const char *haystack, const char *needle)
+{
+  int n = 0;
+
+  for (const char *p = strstr (haystack, needle); p; p = strstr (p + 1, needle)) {
+    n++;
+  }
+
+  return n;
+}
+
+
+static const Color fills[] = {
+  { 1.0, 0.0, 0.0, 1.0 },
+  { 0.0, 1.0, 0.0, 1.0 },
+  { 0.0, 0.0, 1.0, 1.0 },
+};
+
+
+static void
+test_export_symbols (void)
+{
+  for (int n_boxes = 1; n_boxes <= 3; n_boxes++) {
+    DiagramData *data = make_diagram (n_boxes, fills, 1);
+    char *svg = export_svg (data);
+
+    g_test_message ("%d boxes", n_boxes);
+
+    /* The second one already makes the <symbol> */
+    g_assert_cmpint (count (svg, "<symbol "), ==, n_boxes > 1 ? 1 : 0);
+    g_assert_cmpint (count (svg, "<use "), ==, n_boxes - 1);
+    if (n_boxes > 1) {
+      g_assert_nonnull (strstr (svg, "xlink:href=\"#dia-symbol-0\""));
+    }
+
+    g_clear_pointer (&svg, g_free);
+    g_clear_object (&data);
+  }
+}
+
+
+static void
+test_export_symbols_different (void)
+{
+  DiagramData *data = make_diagram (3, fills, 3);
+  char *svg = export_svg (data);
+
+  /* Same type and size, but nothing to share */
+  g_assert_cmpint (count (svg, "<symbol "), ==, 0);
+  g_assert_cmpint (count (svg, "<use "), ==, 0);
+  g_clear_pointer (&svg, g_free);
+  g_clear_object (&data);
+
+  /* Only the two alike are shared, red, green, red, green, red */
+  data = make_diagram (5, fills, 2);
+  svg = export_svg (data);
+
+  g_assert_cmpint (count (svg, "<symbol "), ==, 2);
+  g_assert_cmpint (count (svg, "<use "), ==, 3);
+  g_clear_pointer (&svg, g_free);
+  g_clear_object (&data);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  int ret;
+
+  g_test_init (&argc, &argv, NULL);
+
+  libdia_init (DIA_MESSAGE_STDERR);
+
+  /* objects first, the export needs the standard objects to draw */
+  g_assert_cmpint (argc, ==, 3);
+  dia_register_plugins_in_dir (argv[1]);
+  g_assert_true (dia_test_register_plugins (argv[2]));
+
+  tmp_dir = g_dir_make_tmp ("dia-export-symbols-XXXXXX", NULL);
+  g_assert_nonnull (tmp_dir);
+
+  g_test_add_func ("/dia/export/svg/symbols",
+                   test_export_symbols);
+  g_test_add_func ("/dia/export/svg/symbols/different",
+                   test_export_symbols_different);
+
+  ret = g_test_run ();
+
+  g_rmdir (tmp_dir);
+  g_clear_pointer (&tmp_dir, g_free);
+
+  return ret;
+}
@@ -0,0 +1,223 @@
+/* Dia -- an diagram creation/manipulation program
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Runs every registered export filter many times at once on a thread pool
+ * and checks each result is byte-identical to a serial export done in the
+ * "C" locale.  Filters must neither touch process-global state such as
+ * LC_NUMERIC nor depend on it.
+ */
+
+#include "config.h"
+
+#include <locale.h>
+#include <string.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include "create.h"
+#include "diagramdata.h"
+#include "dialib.h"
+#include "filter.h"
+#include "plug-ins.h"
+
+#include "dia-test-utils.h"
+
+/* How often each filter runs concurrently */
+#define N_ROUNDS 4
+
+
+typedef struct _ExportJob ExportJob;
+struct _ExportJob {
+  DiaExportFilter *filter;
+  GBytes          *reference;
+  char            *path;
+  gboolean         matched;
+};
+
+
+static char *tmp_dir = NULL;
+static const char *comma_locales[] = {
+  "de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "fr_FR.utf8", "German",
+};
+
+
+static DiagramData *
+make_diagram (void)
+{
+  GList *objects = NULL;
+  Arrow arrow = { ARROW_FILLED_TRIANGLE, 0.5, 0.5 };
+  Point points[] = { { 1.25, 7.5 }, { 3.125, 9.75 }, { 5.5, 7.25 } };
+  BezPoint bez[] = {
+    { BEZ_MOVE_TO, { 6.5, 1.5 }, { 0, 0 }, { 0, 0 } },
+    { BEZ_CURVE_TO, { 7.25, 0.5 }, { 8.75, 2.5 }, { 9.5, 1.5 } },
+  };
+
+  objects = g_list_append (objects, create_standard_box (0.5, 0.5, 2.25, 1.75));
+  objects = g_list_append (objects, create_standard_ellipse (3.5, 0.5, 1.5, 2.125));
+  objects = g_list_append (objects, create_standard_polyline (G_N_ELEMENTS (points),
+                                                              points,
+                                                              &arrow,
+                                                              NULL));
+  objects = g_list_append (objects, create_standard_bezierline (G_N_ELEMENTS (bez),
+                                                                bez,
+                                                                NULL,
+                                                                &arrow));
+  objects = g_list_append (objects, create_standard_arc (6.5, 6.5, 9.5, 6.5, 1.125,
+                                                         NULL, NULL));
+  /* No text: layouts share Dia's global PangoContext, which is not
+   * thread-safe, independent of what the filters do */
+
+  return dia_test_diagram_new (objects);
+}
+
+
+static void
+run_job (gpointer job_data, gpointer user_data)
+{
+  ExportJob *job = job_data;
+  GBytes *res = NULL;
+
+  job->matched = dia_test_export (user_data, job->filter, job->path, &res) &&
+                 g_bytes_equal (res, job->reference);
+
+  g_clear_pointer (&res, g_bytes_unref);
+}
+
+
+static void
+test_export_threads (void)
+{
+  DiagramData *data = make_diagram ();
+  GPtrArray *jobs = g_ptr_array_new ();
+  GThreadPool *pool;
+  int n_filters = 0;
+
+  /* The references are made in the "C" locale, serially */
+  for (GList *l = filter_get_export_filters (); l != NULL; l = l->next) {
+    DiaExportFilter *filter = l->data;
+    const char *ext = filter->extensions[0];
+    char *name = g_strdup_printf ("reference.%s", ext);
+    char *path = g_build_filename (tmp_dir, name, NULL);
+    GBytes *first = NULL, *second = NULL;
+
+    /* Needs a dialog to choose the stylesheet */
+    if (g_strcmp0 (ext, "code") == 0) {
+      goto next;
+    }
+
+    if (!dia_test_export (data, filter, path, &first) ||
+        !dia_test_export (data, filter, path, &second) ||
+        !g_bytes_equal (first, second)) {
+      /* Failed, or embeds something like a time stamp */
+      g_test_message ("Skipping non-reproducible export '%s'", filter->description);
+      g_clear_pointer (&first, g_bytes_unref);
+      g_clear_pointer (&second, g_bytes_unref);
+      goto next;
+    }
+
+    for (int i = 0; i < N_ROUNDS; i++) {
+      ExportJob *job = g_new0 (ExportJob, 1);
+      char *job_name = g_strdup_printf ("job-%d-%d.%s", n_filters, i, ext);
+
+      job->filter = filter;
+      job->reference = g_bytes_ref (first);
+      job->path = g_build_filename (tmp_dir, job_name, NULL);
+      g_ptr_array_add (jobs, job);
+
+      g_clear_pointer (&job_name, g_free);
+    }
+    n_filters++;
+
+    g_clear_pointer (&first, g_bytes_unref);
+    g_clear_pointer (&second, g_bytes_unref);
+
+  next:
+    g_clear_pointer (&path, g_free);
+    g_clear_pointer (&name, g_free);
+  }
+
+  g_assert_cmpint (n_filters, >, 0);
+
+  /* ...and now all at once, with a decimal comma if we can get one */
+  for (gsize i = 0; i < G_N_ELEMENTS (comma_locales); i++) {
+    if (setlocale (LC_NUMERIC, comma_locales[i])) {
+      g_test_message ("Exporting with LC_NUMERIC=%s", comma_locales[i]);
+      break;
+    }
+  }
+
+  pool = g_thread_pool_new (run_job,
+                            data,
+                            MAX (2, g_get_num_processors ()),
+                            TRUE,
+                            NULL);
+  for (guint i = 0; i < jobs->len; i++) {
+    g_thread_pool_push (pool, g_ptr_array_index (jobs, i), NULL);
+  }
+  g_thread_pool_free (pool, FALSE, TRUE);
+
+  setlocale (LC_NUMERIC, "C");
+
+  for (guint i = 0; i < jobs->len; i++) {
+    ExportJob *job = g_ptr_array_index (jobs, i);
+
+    if (!job->matched) {
+      g_test_fail_printf ("Concurrent '%s' export differs from the serial one",
+                          job->filter->description);
+    }
+
+    g_clear_pointer (&job->reference, g_bytes_unref);
+    g_clear_pointer (&job->path, g_free);
+    g_free (job);
+  }
+
+  g_ptr_array_free (jobs, TRUE);
+  g_clear_object (&data);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  int ret;
+
+  g_test_init (&argc, &argv, NULL);
+
+  libdia_init (DIA_MESSAGE_STDERR);
+
+  /* objects first, the exports need the standard objects to draw */
+  g_assert_cmpint (argc, ==, 3);
+  dia_register_plugins_in_dir (argv[1]);
+  g_assert_true (dia_test_register_plugins (argv[2]));
+
+  tmp_dir = g_dir_make_tmp ("dia-export-threads-XXXXXX", NULL);
+  g_assert_nonnull (tmp_dir);
+
+  g_test_add_func ("/dia/export/threads",
+                   test_export_threads);
+
+  ret = g_test_run ();
+
+  g_rmdir (tmp_dir);
+  g_clear_pointer (&tmp_dir, g_free);
+
+  return ret;
+}
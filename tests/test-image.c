@@ -0,0 +1,390 @@
+/* Dia -- an diagram creation/manipulation program
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include <glib/gi18n-lib.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include "dialib.h"
+#include "dia_image.h"
+
+
+static char *
+write_png (const char *filename, int size, guint32 colour)
+{
+  GdkPixbuf *pixbuf = gdk_pixbuf_new (GDK_COLORSPACE_RGB, FALSE, 8, size, size);
+  GError *error = NULL;
+  char *name = NULL;
+
+  if (!filename) {
+    int fd = g_file_open_tmp ("test-image-XXXXXX.png", &name, &error);
+
+    g_assert_no_error (error);
+    g_close (fd, NULL);
+  } else {
+    name = g_strdup (filename);
+  }
+
+  gdk_pixbuf_fill (pixbuf, colour);
+  gdk_pixbuf_save (pixbuf, name, "png", &error, NULL);
+  g_assert_no_error (error);
+
+  g_clear_object (&pixbuf);
+
+  return name;
+}
+
+
+static void
+test_image_load_shared (void)
+{
+  char *filename = write_png (NULL, 4, 0xff000000);
+  DiaImage *first = dia_image_load (filename);
+  DiaImage *second = dia_image_load (filename);
+  DiaImage *changed;
+
+  g_assert_nonnull (first);
+  g_assert_true (first == second);
+  g_assert_cmpint (dia_image_width (first), ==, 4);
+
+  /* the file changed, so does the image (its size at least, if not the
+   * mtime within the same second) */
+  g_free (write_png (filename, 8, 0x00ff0000));
+  changed = dia_image_load (filename);
+  g_assert_nonnull (changed);
+  g_assert_true (changed != first);
+  g_assert_cmpint (dia_image_width (changed), ==, 8);
+
+  g_clear_object (&first);
+  g_clear_object (&second);
+  g_clear_object (&changed);
+
+  /* and comes back after the last one is gone */
+  changed = dia_image_load (filename);
+  g_assert_nonnull (changed);
+  g_assert_cmpint (dia_image_width (changed), ==, 8);
+  g_clear_object (&changed);
+
+  g_unlink (filename);
+  g_clear_pointer (&filename, g_free);
+}
+
+
+static void
+test_image_new_shared (void)
+{
+  GdkPixbuf *pixbuf = gdk_pixbuf_new (GDK_COLORSPACE_RGB, TRUE, 8, 3, 5);
+  GdkPixbuf *copy;
+  GdkPixbuf *other;
+  DiaImage *image, *same, *different;
+
+  gdk_pixbuf_fill (pixbuf, 0x336699ff);
+  copy = gdk_pixbuf_copy (pixbuf);
+  other = gdk_pixbuf_copy (pixbuf);
+  gdk_pixbuf_fill (other, 0x336699fe);
+
+  image = dia_image_new_shared (pixbuf);
+  same = dia_image_new_shared (copy);
+  different = dia_image_new_shared (other);
+
+  g_assert_true (image == same);
+  g_assert_true (image != different);
+  g_assert_true (dia_image_pixbuf (different) == other);
+
+  g_clear_object (&image);
+  g_clear_object (&same);
+  g_clear_object (&different);
+  g_clear_object (&pixbuf);
+  g_clear_object (&copy);
+  g_clear_object (&other);
+}
+
+
+static void
+test_image_cache_weak (void)
+{
+  GdkPixbuf *pixbuf = gdk_pixbuf_new (GDK_COLORSPACE_RGB, FALSE, 8, 2, 2);
+  DiaImage *image = dia_image_new_from_pixbuf (pixbuf);
+  DiaImage *found;
+
+  g_assert_null (dia_image_cache_lookup ("test:weak"));
+
+  dia_image_cache_add (image, "test:weak");
+  found = dia_image_cache_lookup ("test:weak");
+  g_assert_true (found == image);
+  g_clear_object (&found);
+
+  /* the cache doesn't keep it alive */
+  g_clear_object (&image);
+  g_assert_null (dia_image_cache_lookup ("test:weak"));
+
+  g_clear_object (&pixbuf);
+}
+
+
+static void
+test_image_mipmaps (void)
+{
+  GdkPixbuf *pixbuf = gdk_pixbuf_new (GDK_COLORSPACE_RGB, FALSE, 8, 64, 30);
+  DiaImage *image;
+  cairo_surface_t *full, *level;
+
+  gdk_pixbuf_fill (pixbuf, 0x80808000);
+  image = dia_image_new_from_pixbuf (pixbuf);
+  full = dia_image_get_surface (image);
+
+  /* never smaller than asked for */
+  g_assert_true (dia_image_get_surface_for_size (image, 100, 100) == full);
+  g_assert_true (dia_image_get_surface_for_size (image, 33, 10) == full);
+
+  level = dia_image_get_surface_for_size (image, 32, 15);
+  g_assert_cmpint (cairo_image_surface_get_width (level), ==, 32);
+  g_assert_cmpint (cairo_image_surface_get_height (level), ==, 15);
+  g_assert_true (dia_image_get_surface_for_size (image, 20, 10) == level);
+
+  /* rounding up, half of 15 is 8 */
+  level = dia_image_get_surface_for_size (image, 16, 8);
+  g_assert_cmpint (cairo_image_surface_get_width (level), ==, 16);
+  g_assert_cmpint (cairo_image_surface_get_height (level), ==, 8);
+
+  level = dia_image_get_surface_for_size (image, 0, 0);
+  g_assert_cmpint (cairo_image_surface_get_width (level), ==, 1);
+  g_assert_cmpint (cairo_image_surface_get_height (level), ==, 1);
+
+  g_clear_object (&image);
+  g_clear_object (&pixbuf);
+}
+
+
+static void
+test_image_deferred_file (void)
+{
+  char *filename = write_png (NULL, 40, 0x00ff00ff);
+  char *contents = NULL;
+  gsize len = 0;
+  GError *error = NULL;
+  DiaImage *image;
+  const GdkPixbuf *pixbuf;
+
+  g_assert_null (dia_image_load_deferred ("no-such-file.png"));
+
+  /* cut after the header: the size is known, the pixels are not there */
+  g_file_get_contents (filename, &contents, &len, &error);
+  g_assert_no_error (error);
+  g_file_set_contents (filename, contents, 64, &error);
+  g_assert_no_error (error);
+
+  image = dia_image_load_deferred (filename);
+  g_assert_nonnull (image);
+  g_assert_cmpint (dia_image_width (image), ==, 40);
+  g_assert_cmpint (dia_image_height (image), ==, 40);
+  g_assert_cmpstr (dia_image_get_mime_type (image), ==, "image/png");
+
+  /* shown broken, but at the same size */
+  pixbuf = dia_image_pixbuf (image);
+  g_assert_nonnull (pixbuf);
+  g_assert_cmpint (gdk_pixbuf_get_width (pixbuf), ==, 40);
+
+  g_clear_object (&image);
+  g_unlink (filename);
+  g_clear_pointer (&filename, g_free);
+  g_clear_pointer (&contents, g_free);
+}
+
+
+static void
+test_image_deferred_data (void)
+{
+  char *filename = write_png (NULL, 6, 0x112233ff);
+  char *contents = NULL;
+  gsize len = 0;
+  GError *error = NULL;
+  GBytes *data;
+  DiaImage *image;
+  const GdkPixbuf *pixbuf;
+  const guint8 *pixels;
+
+  g_file_get_contents (filename, &contents, &len, &error);
+  g_assert_no_error (error);
+  data = g_bytes_new_take (contents, len);
+
+  image = dia_image_new_deferred (data);
+  g_assert_nonnull (image);
+  g_assert_cmpint (dia_image_width (image), ==, 6);
+  g_assert_cmpint (dia_image_height (image), ==, 6);
+
+  pixbuf = dia_image_pixbuf (image);
+  pixels = gdk_pixbuf_read_pixels (pixbuf);
+  g_assert_cmpint (pixels[0], ==, 0x11);
+  g_assert_cmpint (pixels[1], ==, 0x22);
+  g_assert_cmpint (pixels[2], ==, 0x33);
+
+  g_clear_object (&image);
+  g_clear_pointer (&data, g_bytes_unref);
+
+  data = g_bytes_new_static ("not an image", 12);
+  g_assert_null (dia_image_new_deferred (data));
+  g_clear_pointer (&data, g_bytes_unref);
+
+  g_unlink (filename);
+  g_clear_pointer (&filename, g_free);
+}
+
+
+static void
+test_image_encoded (void)
+{
+  GdkPixbuf *pixbuf = gdk_pixbuf_new (GDK_COLORSPACE_RGB, FALSE, 8, 5, 3);
+  GdkPixbufLoader *loader;
+  DiaImage *image, *deferred;
+  GBytes *encoded, *again;
+  const char *mime_type = NULL;
+  GError *error = NULL;
+
+  gdk_pixbuf_fill (pixbuf, 0x10203000);
+  image = dia_image_new_from_pixbuf (pixbuf);
+  g_assert_null (dia_image_get_data (image));
+
+  /* encoded once */
+  encoded = dia_image_get_encoded (image, &mime_type);
+  g_assert_nonnull (encoded);
+  g_assert_cmpstr (mime_type, ==, "image/png");
+  again = dia_image_get_encoded (image, NULL);
+  g_assert_true (again == encoded);
+  g_clear_pointer (&again, g_bytes_unref);
+
+  loader = gdk_pixbuf_loader_new ();
+  gdk_pixbuf_loader_write_bytes (loader, encoded, &error);
+  g_assert_no_error (error);
+  gdk_pixbuf_loader_close (loader, &error);
+  g_assert_no_error (error);
+  g_assert_cmpint (gdk_pixbuf_get_width (gdk_pixbuf_loader_get_pixbuf (loader)), ==, 5);
+  g_clear_object (&loader);
+
+  /* and what was read is given back as it was */
+  deferred = dia_image_new_deferred (encoded);
+  again = dia_image_get_encoded (deferred, &mime_type);
+  g_assert_true (again == encoded);
+  g_assert_cmpstr (mime_type, ==, "image/png");
+
+  g_clear_pointer (&again, g_bytes_unref);
+  g_clear_pointer (&encoded, g_bytes_unref);
+  g_clear_object (&deferred);
+  g_clear_object (&image);
+  g_clear_object (&pixbuf);
+}
+
+
+static void
+test_image_encoded_file (void)
+{
+  char *filename = NULL;
+  GdkPixbuf *pixbuf = gdk_pixbuf_new (GDK_COLORSPACE_RGB, FALSE, 8, 16, 16);
+  char *contents = NULL;
+  gsize len = 0;
+  GError *error = NULL;
+  int fd = g_file_open_tmp ("test-image-XXXXXX.jpg", &filename, &error);
+  DiaImage *image;
+  GBytes *encoded;
+  const char *mime_type = NULL;
+
+  g_assert_no_error (error);
+  g_close (fd, NULL);
+  gdk_pixbuf_fill (pixbuf, 0x8040c000);
+  gdk_pixbuf_save (pixbuf, filename, "jpeg", &error, "quality", "95", NULL);
+  g_assert_no_error (error);
+
+  /* the file as it is, not a second generation JPEG */
+  image = dia_image_load (filename);
+  encoded = dia_image_get_encoded (image, &mime_type);
+  g_assert_cmpstr (mime_type, ==, "image/jpeg");
+  g_file_get_contents (filename, &contents, &len, &error);
+  g_assert_no_error (error);
+  g_assert_cmpmem (g_bytes_get_data (encoded, NULL),
+                   g_bytes_get_size (encoded),
+                   contents,
+                   len);
+
+  g_clear_pointer (&encoded, g_bytes_unref);
+  g_clear_pointer (&contents, g_free);
+  g_clear_object (&image);
+  g_clear_object (&pixbuf);
+  g_unlink (filename);
+  g_clear_pointer (&filename, g_free);
+}
+
+
+static void
+test_image_save_shared (void)
+{
+  GdkPixbuf *pixbuf = gdk_pixbuf_new (GDK_COLORSPACE_RGB, FALSE, 8, 3, 3);
+  GdkPixbuf *copy;
+  DiaImage *image, *same;
+  GError *error = NULL;
+  char *filename = NULL;
+  int fd;
+
+  gdk_pixbuf_fill (pixbuf, 0x996633ff);
+  copy = gdk_pixbuf_copy (pixbuf);
+  image = dia_image_new_shared (pixbuf);
+
+  fd = g_file_open_tmp ("test-image-XXXXXX.png", &filename, &error);
+  g_assert_no_error (error);
+  g_close (fd, NULL);
+
+  /* Written, but the shared image doesn't refer to the file now */
+  g_assert_true (dia_image_save (image, filename));
+  g_assert_true (g_file_test (filename, G_FILE_TEST_IS_REGULAR));
+  g_assert_cmpstr (dia_image_filename (image), ==, "(null)");
+
+  same = dia_image_new_shared (copy);
+  g_assert_true (same == image);
+  g_assert_cmpstr (dia_image_filename (same), ==, "(null)");
+
+  g_clear_object (&same);
+  g_clear_object (&image);
+  g_clear_object (&pixbuf);
+  g_clear_object (&copy);
+  g_unlink (filename);
+  g_clear_pointer (&filename, g_free);
+}
+
+
+int
+main (int argc, char** argv)
+{
+  g_test_init (&argc, &argv, NULL);
+
+  libdia_init (DIA_MESSAGE_STDERR);
+
+  g_test_add_func ("/dia/image/load-shared", test_image_load_shared);
+  g_test_add_func ("/dia/image/new-shared", test_image_new_shared);
+  g_test_add_func ("/dia/image/cache-weak", test_image_cache_weak);
+  g_test_add_func ("/dia/image/save-shared", test_image_save_shared);
+  g_test_add_func ("/dia/image/mipmaps", test_image_mipmaps);
+  g_test_add_func ("/dia/image/deferred-file", test_image_deferred_file);
+  g_test_add_func ("/dia/image/deferred-data", test_image_deferred_data);
+  g_test_add_func ("/dia/image/encoded", test_image_encoded);
+  g_test_add_func ("/dia/image/encoded-file", test_image_encoded_file);
+
+  return g_test_run ();
+}
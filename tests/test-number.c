@@ -0,0 +1,158 @@
+/* Dia -- an diagram creation/manipulation program
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include <math.h>
+
+#include "dia-number.h"
+
+
+struct format_test {
+  double value;
+  int decimals;
+  const char *expected;
+} format_cases[] = {
+  { 0.0, DIA_NUMBER_EXACT, "0" },
+  { -0.0, DIA_NUMBER_EXACT, "0" },
+  { 12.3, DIA_NUMBER_EXACT, "12.3" },
+  { 0.1 + 0.2, DIA_NUMBER_EXACT, "0.30000000000000004" },
+  { 1.0 / 3.0, DIA_NUMBER_EXACT, "0.3333333333333333" },
+  { -2.5, DIA_NUMBER_EXACT, "-2.5" },
+  { 1e-5, DIA_NUMBER_EXACT, "1e-05" },
+  { 1.0 / 3.0, 4, "0.3333" },
+  { 0.1 + 0.2, 4, "0.3" },
+  { 1.23456, 4, "1.2346" },
+  { -0.00001, 4, "0" },
+  { 25.0, 2, "25" },
+};
+
+
+static void
+test_number_format (gconstpointer user_data)
+{
+  const struct format_test *test = user_data;
+  char buffer[DIA_NUMBER_BUF_SIZE];
+
+  dia_number_format (buffer, sizeof (buffer), test->value, test->decimals);
+
+  g_assert_cmpstr (buffer, ==, test->expected);
+}
+
+
+struct parse_test {
+  const char *str;
+  double expected;
+  const char *rest;
+} parse_cases[] = {
+  { "0", 0.0, "" },
+  { "12.3", 12.3, "" },
+  { "-0.25;1", -0.25, ";1" },
+  { "1.5e3,2", 1500.0, ",2" },
+  { "  .5", 0.5, "" },
+  { "3.", 3.0, "" },
+  { "7e", 7.0, "e" },
+  { "1e-05", 1e-5, "" },
+  { "0x10", 16.0, "" },
+  { "0.30000000000000004", 0.1 + 0.2, "" },
+  { "123456789012345678901234", 123456789012345678901234.0, "" },
+};
+
+
+static void
+test_number_parse (gconstpointer user_data)
+{
+  const struct parse_test *test = user_data;
+  char *end = NULL;
+  double res = dia_number_parse (test->str, &end);
+
+  g_assert_cmpfloat (res, ==, test->expected);
+  g_assert_cmpstr (end, ==, test->rest);
+}
+
+
+static void
+test_number_round_trip (void)
+{
+  GRand *rand = g_rand_new_with_seed (42);
+
+  for (int i = 0; i < 100000; i++) {
+    char buffer[DIA_NUMBER_BUF_SIZE];
+    double value = g_rand_double_range (rand, -1.0, 1.0) *
+                     pow (10.0, g_rand_int_range (rand, -12, 12));
+
+    dia_number_format (buffer, sizeof (buffer), value, DIA_NUMBER_EXACT);
+
+    g_assert_cmpfloat (dia_number_parse (buffer, NULL), ==, value);
+    g_assert_cmpfloat (g_ascii_strtod (buffer, NULL), ==, value);
+  }
+
+  g_rand_free (rand);
+}
+
+
+static void
+test_number_parse_matches_strtod (void)
+{
+  GRand *rand = g_rand_new_with_seed (23);
+
+  for (int i = 0; i < 100000; i++) {
+    char buffer[G_ASCII_DTOSTR_BUF_SIZE];
+    double value = g_rand_double_range (rand, -1000.0, 1000.0);
+
+    g_ascii_formatd (buffer, sizeof (buffer), "%g", value);
+
+    g_assert_cmpfloat (dia_number_parse (buffer, NULL), ==,
+                       g_ascii_strtod (buffer, NULL));
+  }
+
+  g_rand_free (rand);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  for (size_t i = 0; i < G_N_ELEMENTS (format_cases); i++) {
+    char *path =
+      g_strdup_printf ("/dia/number/format/case_%" G_GSIZE_FORMAT, i);
+
+    g_test_add_data_func (path, &format_cases[i], test_number_format);
+
+    g_clear_pointer (&path, g_free);
+  }
+
+  for (size_t i = 0; i < G_N_ELEMENTS (parse_cases); i++) {
+    char *path =
+      g_strdup_printf ("/dia/number/parse/case_%" G_GSIZE_FORMAT, i);
+
+    g_test_add_data_func (path, &parse_cases[i], test_number_parse);
+
+    g_clear_pointer (&path, g_free);
+  }
+
+  g_test_add_func ("/dia/number/round-trip",
+                   test_number_round_trip);
+  g_test_add_func ("/dia/number/parse-matches-strtod",
+                   test_number_parse_matches_strtod);
+
+  return g_test_run ();
+}
@@ -0,0 +1,169 @@
+/* Dia -- an diagram creation/manipulation program
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * Level of detail in the display renderer: it must not change anything
+ * at the usual zoom levels, and with -m perf the frame times are reported
+ * from zoomed in to zoomed all the way out, with and without it.
+ */
+
+#include "config.h"
+
+#include <glib.h>
+
+#include "dialib.h"
+#include "plug-ins.h"
+
+#include "dia-test-utils.h"
+
+#define LOD_OBJECT_PIXELS 3.0
+#define LOD_TEXT_PIXELS 4.0
+
+
+static void
+frame_init_lod (DiaTestFrame *frame,
+                double        zoom,
+                double        lod_objects,
+                double        lod_text)
+{
+  dia_test_frame_init (frame, zoom);
+  g_object_set (frame->renderer,
+                "min-object-size", lod_objects,
+                "min-text-size", lod_text,
+                NULL);
+}
+
+
+static void
+test_render_lod_identical (void)
+{
+  DiagramData *data = dia_test_labels_new (10, 10, TRUE);
+  DiaTestFrame plain, lod;
+  cairo_surface_t *expected, *result;
+
+  /* Everything is a good deal bigger than the limits at 20 pixels/cm */
+  frame_init_lod (&plain, 20.0, 0.0, 0.0);
+  frame_init_lod (&lod, 20.0, LOD_OBJECT_PIXELS, LOD_TEXT_PIXELS);
+
+  dia_test_frame_render (&plain, data, plain.zoom);
+  dia_test_frame_render (&lod, data, lod.zoom);
+
+  expected = dia_test_frame_snapshot (&plain);
+  result = dia_test_frame_snapshot (&lod);
+  g_assert_true (dia_test_surfaces_equal (expected, result));
+
+  g_clear_pointer (&result, cairo_surface_destroy);
+  g_clear_pointer (&expected, cairo_surface_destroy);
+  dia_test_frame_clear (&lod);
+  dia_test_frame_clear (&plain);
+  g_clear_object (&data);
+}
+
+
+static void
+test_render_lod_simplified (void)
+{
+  DiagramData *data = dia_test_labels_new (10, 10, TRUE);
+  DiaTestFrame plain, lod;
+  cairo_surface_t *expected, *result;
+
+  /* Boxes of less than a pixel, text a fifth */
+  frame_init_lod (&plain, 0.25, 0.0, 0.0);
+  frame_init_lod (&lod, 0.25, LOD_OBJECT_PIXELS, LOD_TEXT_PIXELS);
+
+  dia_test_frame_render (&plain, data, plain.zoom);
+  dia_test_frame_render (&lod, data, lod.zoom);
+
+  expected = dia_test_frame_snapshot (&plain);
+  result = dia_test_frame_snapshot (&lod);
+  g_assert_false (dia_test_surfaces_equal (expected, result));
+
+  g_clear_pointer (&result, cairo_surface_destroy);
+  g_clear_pointer (&expected, cairo_surface_destroy);
+  dia_test_frame_clear (&lod);
+  dia_test_frame_clear (&plain);
+  g_clear_object (&data);
+}
+
+
+static double
+time_frames (DiagramData *data, double zoom, double lod_objects, double lod_text)
+{
+  DiaTestFrame frame;
+  double elapsed;
+
+  frame_init_lod (&frame, zoom, lod_objects, lod_text);
+
+  /* Warm up fonts and such */
+  dia_test_frame_render (&frame, data, zoom);
+
+  g_test_timer_start ();
+  for (int i = 0; i < 10; i++) {
+    dia_test_frame_render (&frame, data, zoom);
+  }
+  elapsed = g_test_timer_elapsed () / 10;
+
+  dia_test_frame_clear (&frame);
+
+  return elapsed;
+}
+
+
+static void
+test_render_lod_perf (void)
+{
+  DiagramData *data = dia_test_labels_new (200, 200, TRUE);
+  double zooms[] = { 20.0, 5.0, 1.0, 0.5, 0.1 };
+  double worst = 0.0;
+
+  for (gsize i = 0; i < G_N_ELEMENTS (zooms); i++) {
+    double plain = time_frames (data, zooms[i], 0.0, 0.0);
+    double lod = time_frames (data, zooms[i], LOD_OBJECT_PIXELS, LOD_TEXT_PIXELS);
+
+    g_test_message ("%6.2f pixels/cm: %8.2fms per frame, %8.2fms with LOD",
+                    zooms[i], plain * 1000, lod * 1000);
+    worst = MAX (worst, lod);
+  }
+
+  g_test_minimized_result (worst, "slowest LOD frame %.2fms", worst * 1000);
+
+  g_clear_object (&data);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  libdia_init (DIA_MESSAGE_STDERR);
+
+  g_assert_cmpint (argc, ==, 2);
+  dia_register_plugins_in_dir (argv[1]);
+
+  g_test_add_func ("/dia/render/lod/identical",
+                   test_render_lod_identical);
+  g_test_add_func ("/dia/render/lod/simplified",
+                   test_render_lod_simplified);
+  if (g_test_perf ()) {
+    g_test_add_func ("/dia/render/lod/perf", test_render_lod_perf);
+  }
+
+  return g_test_run ();
+}
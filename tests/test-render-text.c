@@ -0,0 +1,139 @@
+/* Dia -- an diagram creation/manipulation program
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/*
+ * The display renderer keeps text laid out from one frame to the next:
+ * later frames must look exactly like the first, also after zooming
+ * away and back.  With -m perf the first frame is compared to the
+ * following ones, which lay out nothing.
+ */
+
+#include "config.h"
+
+#include <glib.h>
+
+#include "dialib.h"
+#include "plug-ins.h"
+
+#include "dia-test-utils.h"
+
+
+static void
+get_layouts (DiaTestFrame *frame, guint64 *created, guint64 *reused)
+{
+  g_object_get (frame->renderer,
+                "text-layouts-created", created,
+                "text-layouts-reused", reused,
+                NULL);
+}
+
+
+static void
+test_render_text_reused (void)
+{
+  DiagramData *data = dia_test_labels_new (8, 16, FALSE);
+  DiaTestFrame frame;
+  cairo_surface_t *first, *again, *back;
+  guint64 created, reused, laid_out, lines;
+  guint64 n_created, n_reused;
+
+  dia_test_frame_init (&frame, 20.0);
+
+  dia_test_frame_render (&frame, data, 20.0);
+  first = dia_test_frame_snapshot (&frame);
+  get_layouts (&frame, &created, &reused);
+  g_assert_cmpuint (created, >, 0);
+  /* Some are alike already, with the same text, height and alignment */
+  laid_out = created;
+  lines = created + reused;
+
+  dia_test_frame_render (&frame, data, 20.0);
+  again = dia_test_frame_snapshot (&frame);
+  g_assert_true (dia_test_surfaces_equal (first, again));
+  /* Nothing laid out again */
+  get_layouts (&frame, &n_created, &n_reused);
+  g_assert_cmpuint (n_created, ==, created);
+  g_assert_cmpuint (n_reused, ==, reused + lines);
+
+  /* Zooming drops the layouts, and coming back makes them anew */
+  dia_test_frame_render (&frame, data, 13.0);
+  get_layouts (&frame, &created, &reused);
+  g_assert_cmpuint (created, >, n_created);
+
+  dia_test_frame_render (&frame, data, 20.0);
+  back = dia_test_frame_snapshot (&frame);
+  g_assert_true (dia_test_surfaces_equal (first, back));
+  get_layouts (&frame, &n_created, &n_reused);
+  g_assert_cmpuint (n_created - created, ==, laid_out);
+  g_assert_cmpuint (n_reused - reused, ==, lines - laid_out);
+
+  g_clear_pointer (&back, cairo_surface_destroy);
+  g_clear_pointer (&again, cairo_surface_destroy);
+  g_clear_pointer (&first, cairo_surface_destroy);
+  dia_test_frame_clear (&frame);
+  g_clear_object (&data);
+}
+
+
+static void
+test_render_text_perf (void)
+{
+  DiagramData *data = dia_test_labels_new (40, 100, FALSE);
+  DiaTestFrame frame;
+  double first, later;
+
+  dia_test_frame_init (&frame, 5.0);
+
+  g_test_timer_start ();
+  dia_test_frame_render (&frame, data, 5.0);
+  first = g_test_timer_elapsed ();
+
+  g_test_timer_start ();
+  for (int i = 0; i < 10; i++) {
+    dia_test_frame_render (&frame, data, 5.0);
+  }
+  later = g_test_timer_elapsed () / 10;
+
+  g_test_message ("First frame %.2fms, later frames %.2fms",
+                  first * 1000, later * 1000);
+  g_test_minimized_result (later, "text frame %.2fms", later * 1000);
+
+  dia_test_frame_clear (&frame);
+  g_clear_object (&data);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  libdia_init (DIA_MESSAGE_STDERR);
+
+  g_assert_cmpint (argc, ==, 2);
+  dia_register_plugins_in_dir (argv[1]);
+
+  g_test_add_func ("/dia/render/text/reused",
+                   test_render_text_reused);
+  if (g_test_perf ()) {
+    g_test_add_func ("/dia/render/text/perf", test_render_text_perf);
+  }
+
+  return g_test_run ();
+}
@@ -26,10 +26,14 @@
 
 #include <glib.h>
 #include <glib-object.h>
+#include <glib/gstdio.h>
 
 #include "dialib.h"
 #include "geometry.h"
 #include "dia_svg.h"
+#include "diasvgrenderer.h"
+#include "dia_image.h"
+#include "pattern.h"
 
 
 struct path_parse_test {
@@ -105,6 +109,236 @@ test_svg_parse_path (gconstpointer _p)
 }
 
 
+struct svg_stream_test {
+  gboolean draw;
+  gboolean pattern;
+  gboolean classes;
+  gboolean symbols;
+} svg_stream_cases[] = {
+  { TRUE,  FALSE, FALSE, FALSE },
+  { TRUE,  TRUE,  FALSE, FALSE },
+  { FALSE, FALSE, FALSE, FALSE },
+  { TRUE,  FALSE, TRUE,  FALSE },
+  { TRUE,  TRUE,  TRUE,  FALSE },
+  { TRUE,  FALSE, TRUE,  TRUE  },
+  { TRUE,  TRUE,  FALSE, TRUE  },
+};
+
+
+/* Like the SVG export: a group per layer, flushed after every object */
+static char *
+render_svg (const struct svg_stream_test *test,
+            DiaPattern                   *pattern,
+            gboolean                      stream)
+{
+  DiaSvgRenderer *renderer = g_object_new (DIA_TYPE_SVG_RENDERER, NULL);
+  Color fill = { 1.0, 0.5, 0.0, 1.0 };
+  Color stroke = { 0.0, 0.0, 0.0, 0.5 };
+  Point start = { 0.0, 4.0 }, end = { 4.0, 0.0 };
+  xmlNodePtr root;
+  GError *error = NULL;
+  char *filename = NULL;
+  char *contents = NULL;
+  int fd;
+
+  fd = g_file_open_tmp ("test-svg-XXXXXX.svg", &filename, &error);
+  g_assert_no_error (error);
+  g_close (fd, NULL);
+  /* or saving makes a backup */
+  g_unlink (filename);
+
+  renderer->filename = g_strdup (filename);
+  renderer->scale = 20.0;
+  renderer->doc = xmlNewDoc ((const xmlChar *) "1.0");
+  renderer->doc->standalone = FALSE;
+  root = renderer->root = xmlNewDocNode (renderer->doc, NULL, (const xmlChar *) "svg", NULL);
+  xmlDocSetRootElement (renderer->doc, root);
+  xmlSetProp (root, (const xmlChar *) "xmlns", (const xmlChar *) "http://www.w3.org/2000/svg");
+
+  if (stream) {
+    g_assert_true (dia_svg_renderer_begin_stream (renderer, &error));
+    g_assert_no_error (error);
+  }
+  if (test->classes) {
+    dia_svg_renderer_use_style_classes (renderer);
+  }
+
+  dia_renderer_begin_render (DIA_RENDERER (renderer), NULL);
+  if (test->pattern) {
+    dia_renderer_set_pattern (DIA_RENDERER (renderer), pattern);
+  }
+
+  for (int i = 0; test->draw && i < 2; i++) {
+    xmlNodePtr group = xmlNewNode (NULL, (const xmlChar *) "g");
+
+    xmlSetProp (group, (const xmlChar *) "id", (const xmlChar *) (i ? "empty" : "layer"));
+    renderer->root = group;
+    for (int j = 0; i == 0 && j < 3; j++) {
+      Point ul = { j, j }, lr = { j + 1.5, j + 0.5 };
+
+      /* like the drawing of a <symbol> */
+      if (test->symbols) {
+        renderer->offset = ul;
+      }
+      dia_renderer_draw_rect (DIA_RENDERER (renderer), &ul, &lr, &fill, &stroke);
+      renderer->offset.x = renderer->offset.y = 0.0;
+      dia_svg_renderer_flush (renderer, group);
+    }
+    renderer->root = root;
+    dia_svg_renderer_close_group (renderer, group, root);
+    dia_svg_renderer_flush (renderer, root);
+  }
+
+  if (test->draw) {
+    dia_renderer_draw_line (DIA_RENDERER (renderer), &start, &end, &stroke);
+  }
+  if (test->symbols) {
+    xmlNodePtr symbol = xmlNewNode (NULL, (const xmlChar *) "symbol");
+
+    xmlSetProp (symbol, (const xmlChar *) "id", (const xmlChar *) "test-symbol");
+    dia_svg_renderer_add_def (renderer, symbol);
+  }
+
+  dia_renderer_end_render (DIA_RENDERER (renderer));
+
+  g_file_get_contents (filename, &contents, NULL, &error);
+  g_assert_no_error (error);
+
+  g_unlink (filename);
+  g_clear_pointer (&filename, g_free);
+  g_clear_object (&renderer);
+
+  return contents;
+}
+
+
+static void
+test_svg_stream (gconstpointer _p)
+{
+  const struct svg_stream_test *test = _p;
+  Color red = { 1.0, 0.0, 0.0, 1.0 };
+  Color blue = { 0.0, 0.0, 1.0, 1.0 };
+  /* the same one both times, its id is the address */
+  DiaPattern *pattern = dia_pattern_new (DIA_LINEAR_GRADIENT, 0, 0.0, 0.0);
+  char *in_memory, *streamed;
+
+  dia_pattern_set_point (pattern, 1.0, 1.0);
+  dia_pattern_add_color (pattern, 0.0, &red);
+  dia_pattern_add_color (pattern, 1.0, &blue);
+
+  in_memory = render_svg (test, pattern, FALSE);
+  streamed = render_svg (test, pattern, TRUE);
+
+  g_assert_cmpstr (streamed, ==, in_memory);
+  if (test->draw) {
+    g_assert_nonnull (strstr (streamed, "<g id=\"empty\"/>"));
+  }
+  if (test->pattern || test->symbols) {
+    g_assert_nonnull (strstr (streamed, "<defs>"));
+  }
+  if (test->symbols) {
+    /* all three at the offset */
+    const char *rect = strstr (streamed, "x=\"0\" y=\"0\" width=\"30\"");
+
+    g_assert_nonnull (strstr (streamed, "<symbol id=\"test-symbol\"/>"));
+    for (int i = 0; i < 3; i++) {
+      g_assert_nonnull (rect);
+      rect = strstr (rect + 1, "x=\"0\" y=\"0\" width=\"30\"");
+    }
+    g_assert_null (rect);
+  }
+  if (test->classes) {
+    /* the rectangles share one, the line has its own */
+    g_assert_nonnull (strstr (streamed, "<style type=\"text/css\">"));
+    g_assert_nonnull (strstr (streamed, "<line class=\"s"));
+    g_assert_null (strstr (streamed, ".s2 {"));
+    if (!test->pattern) {
+      g_assert_null (strstr (streamed, "style=\""));
+    }
+  }
+
+  g_clear_pointer (&in_memory, g_free);
+  g_clear_pointer (&streamed, g_free);
+  g_clear_object (&pattern);
+}
+
+
+static void
+test_svg_image_defs (void)
+{
+  DiaSvgRenderer *renderer = g_object_new (DIA_TYPE_SVG_RENDERER, NULL);
+  GdkPixbuf *pixbuf = gdk_pixbuf_new (GDK_COLORSPACE_RGB, FALSE, 8, 4, 4);
+  GdkPixbuf *copy;
+  GdkPixbuf *other = gdk_pixbuf_new (GDK_COLORSPACE_RGB, FALSE, 8, 4, 4);
+  DiaImage *images[3];
+  GError *error = NULL;
+  char *filename = NULL;
+  char *contents = NULL;
+  const char *use;
+  int fd;
+
+  gdk_pixbuf_fill (pixbuf, 0xff800000);
+  gdk_pixbuf_fill (other, 0x0000ff00);
+  copy = gdk_pixbuf_copy (pixbuf);
+  /* two of them are the same pixels */
+  images[0] = dia_image_new_from_pixbuf (pixbuf);
+  images[1] = dia_image_new_from_pixbuf (copy);
+  images[2] = dia_image_new_from_pixbuf (other);
+
+  fd = g_file_open_tmp ("test-svg-XXXXXX.svg", &filename, &error);
+  g_assert_no_error (error);
+  g_close (fd, NULL);
+  g_unlink (filename);
+
+  renderer->filename = g_strdup (filename);
+  renderer->scale = 20.0;
+  renderer->doc = xmlNewDoc ((const xmlChar *) "1.0");
+  renderer->root = xmlNewDocNode (renderer->doc, NULL, (const xmlChar *) "svg", NULL);
+  xmlDocSetRootElement (renderer->doc, renderer->root);
+  dia_svg_renderer_use_image_defs (renderer);
+
+  dia_renderer_begin_render (DIA_RENDERER (renderer), NULL);
+  for (int i = 0; i < 6; i++) {
+    Point pos = { i, i };
+
+    dia_renderer_draw_image (DIA_RENDERER (renderer), &pos, 1.0 + i, 1.0, images[i % 3]);
+  }
+  dia_renderer_end_render (DIA_RENDERER (renderer));
+
+  g_file_get_contents (filename, &contents, NULL, &error);
+  g_assert_no_error (error);
+
+  /* one of each in <defs>, every drawing refers to it */
+  g_assert_nonnull (strstr (contents, "<symbol id=\"dia-image-0\" viewBox=\"0 0 4 4\""));
+  g_assert_nonnull (strstr (contents, "<symbol id=\"dia-image-1\""));
+  g_assert_null (strstr (contents, "dia-image-2"));
+  g_assert_nonnull (strstr (contents, "<use x=\"60\" y=\"60\" width=\"80\" height=\"20\" xlink:href=\"#dia-image-0\"/>"));
+  use = contents;
+  for (int i = 0; i < 6; i++) {
+    use = strstr (use, "<use ");
+    g_assert_nonnull (use);
+    use++;
+  }
+  g_assert_null (strstr (use, "<use "));
+  use = strstr (contents, "data:image/png;base64,");
+  g_assert_nonnull (use);
+  use = strstr (use + 1, "data:image/png;base64,");
+  g_assert_nonnull (use);
+  g_assert_null (strstr (use + 1, "data:image/png;base64,"));
+
+  g_unlink (filename);
+  g_clear_pointer (&filename, g_free);
+  g_clear_pointer (&contents, g_free);
+  g_clear_object (&renderer);
+  for (int i = 0; i < 3; i++) {
+    g_clear_object (&images[i]);
+  }
+  g_clear_object (&pixbuf);
+  g_clear_object (&copy);
+  g_clear_object (&other);
+}
+
+
 int
 main (int argc, char** argv)
 {
@@ -121,5 +355,16 @@ main (int argc, char** argv)
     g_clear_pointer (&path, g_free);
   }
 
+  for (size_t i = 0; i < G_N_ELEMENTS (svg_stream_cases); i++) {
+    char *path =
+      g_strdup_printf ("/dia/svg/renderer/stream_%" G_GSIZE_FORMAT, i);
+
+    g_test_add_data_func (path, &svg_stream_cases[i], test_svg_stream);
+
+    g_clear_pointer (&path, g_free);
+  }
+
+  g_test_add_func ("/dia/svg/renderer/image_defs", test_svg_image_defs);
+
   return g_test_run ();
 }